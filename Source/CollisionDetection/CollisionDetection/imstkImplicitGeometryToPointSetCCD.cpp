@@ -23,6 +23,7 @@ limitations under the License.
 #include "imstkCollisionData.h"
 #include "imstkImageData.h"
 #include "imstkParallelUtils.h"
+#include "imstkSparseSignedDistanceField.h"
 #include "imstkSurfaceMesh.h"
 
 namespace imstk
@@ -75,6 +76,10 @@ ImplicitGeometryToPointSetCCD::setupFunctions(std::shared_ptr<ImplicitGeometry>
     {
         m_centralGrad.setDx(sdf->getImage()->getSpacing());
     }
+    else if (auto sparseSdf = std::dynamic_pointer_cast<SparseSignedDistanceField>(implicitGeom))
+    {
+        m_centralGrad.setDx(sparseSdf->getSpacing());
+    }
 
     // If the point set does not have displacements (or has them but not the right type), add them
     m_displacementsPtr = std::dynamic_pointer_cast<VecDataArray<double, 3>>(pointSet->getVertexAttribute("displacements"));
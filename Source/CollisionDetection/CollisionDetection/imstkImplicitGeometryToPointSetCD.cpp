@@ -27,6 +27,7 @@ limitations under the License.
 #include "imstkParallelUtils.h"
 #include "imstkPointSet.h"
 #include "imstkSignedDistanceField.h"
+#include "imstkSparseSignedDistanceField.h"
 
 namespace imstk
 {
@@ -52,6 +53,10 @@ ImplicitGeometryToPointSetCD::computeCollisionDataAB(
     {
         m_centralGrad.setDx(sdf->getImage()->getSpacing() * 0.5);
     }
+    else if (auto sparseSdf = std::dynamic_pointer_cast<SparseSignedDistanceField>(implicitGeom))
+    {
+        m_centralGrad.setDx(sparseSdf->getSpacing() * 0.5);
+    }
 
     std::shared_ptr<VecDataArray<double, 3>> verticesPtr = pointSet->getVertexPositions();
     const VecDataArray<double, 3>&           vertices    = *verticesPtr;
@@ -98,6 +103,10 @@ ImplicitGeometryToPointSetCD::computeCollisionDataA(
     {
         m_centralGrad.setDx(sdf->getImage()->getSpacing() * 0.5);
     }
+    else if (auto sparseSdf = std::dynamic_pointer_cast<SparseSignedDistanceField>(implicitGeom))
+    {
+        m_centralGrad.setDx(sparseSdf->getSpacing() * 0.5);
+    }
 
     std::shared_ptr<VecDataArray<double, 3>> verticesPtr = pointSet->getVertexPositions();
     const VecDataArray<double, 3>&           vertices    = *verticesPtr;
@@ -138,6 +147,10 @@ ImplicitGeometryToPointSetCD::computeCollisionDataB(
     {
         m_centralGrad.setDx(sdf->getImage()->getSpacing() * 0.5);
     }
+    else if (auto sparseSdf = std::dynamic_pointer_cast<SparseSignedDistanceField>(implicitGeom))
+    {
+        m_centralGrad.setDx(sparseSdf->getSpacing() * 0.5);
+    }
 
     std::shared_ptr<VecDataArray<double, 3>> verticesPtr = pointSet->getVertexPositions();
     const VecDataArray<double, 3>&           vertices    = *verticesPtr;
@@ -102,6 +102,38 @@ private:
     const VecDataArray<double, 3>& m_Data;
 };
 
+///
+/// \brief Private helper class, providing operator() using in std::parallel_reduce
+///  for finding max L2 distance between corresponding elements of two arrays of Vec3r
+///
+class MaxL2DistanceFunctor
+{
+public:
+    MaxL2DistanceFunctor(const VecDataArray<double, 3>& dataA, const VecDataArray<double, 3>& dataB) : m_DataA(dataA), m_DataB(dataB) {}
+    MaxL2DistanceFunctor(MaxL2DistanceFunctor& pObj, tbb::split) : m_DataA(pObj.m_DataA), m_DataB(pObj.m_DataB) {}
+
+    // Prohibit copying
+    MaxL2DistanceFunctor() = delete;
+    MaxL2DistanceFunctor& operator=(const MaxL2DistanceFunctor&) = delete;
+
+    void operator()(const tbb::blocked_range<size_t>& r)
+    {
+        for (size_t i = r.begin(); i != r.end(); ++i)
+        {
+            double dist2 = (m_DataA[i] - m_DataB[i]).squaredNorm();
+            m_Result = m_Result > dist2 ? m_Result : dist2;
+        }
+    }
+
+    void join(MaxL2DistanceFunctor& pObj) { m_Result = m_Result > pObj.m_Result ? m_Result : pObj.m_Result; }
+    double getResult() const { return std::sqrt(m_Result); }
+
+private:
+    double m_Result = 0.0;
+    const VecDataArray<double, 3>& m_DataA;
+    const VecDataArray<double, 3>& m_DataB;
+};
+
 ///
 /// \brief Private helper class, providing operator() using in std::parallel_reduce
 ///  for finding axis-aligned bounding box of a point set
@@ -174,6 +206,17 @@ findMaxL2Norm(const VecDataArray<double, 3>& data)
     return pObj.getResult();
 }
 
+///
+/// \brief Find the maximum L2 distance between corresponding elements of two data arrays of the same size
+///
+inline double
+findMaxL2Distance(const VecDataArray<double, 3>& dataA, const VecDataArray<double, 3>& dataB)
+{
+    MaxL2DistanceFunctor pObj(dataA, dataB);
+    tbb::parallel_reduce(tbb::blocked_range<size_t>(0, dataA.size()), pObj);
+    return pObj.getResult();
+}
+
 ///
 /// \brief Find the bounding box of a point set
 ///
@@ -185,5 +228,66 @@ findAABB(const VecDataArray<double, 3>& points, Vec3d& lowerCorner, Vec3d& upper
     lowerCorner = pObj.getLowerCorner();
     upperCorner = pObj.getUpperCorner();
 }
+
+///
+/// \brief Find the maximum of function(i) over the indices in [0, count), IMSTK_DOUBLE_MIN if count is zero
+///
+template<typename Function>
+double
+findMax(const size_t count, const Function& function)
+{
+    return tbb::parallel_reduce(tbb::blocked_range<size_t>(0, count), IMSTK_DOUBLE_MIN,
+        [&](const tbb::blocked_range<size_t>& r, double maxValue)
+        {
+            for (size_t i = r.begin(); i != r.end(); i++)
+            {
+                maxValue = std::max(maxValue, function(i));
+            }
+            return maxValue;
+        },
+        [](const double a, const double b) { return std::max(a, b); });
+}
+
+///
+/// \brief Stream compaction, collect in increasing order the indices in [0, count) for which
+/// predicate(i) is true. The output slots are assigned by a parallel prefix sum
+///
+template<typename Predicate>
+void
+findIndices(const size_t count, const Predicate& predicate, std::vector<size_t>& indices)
+{
+    const size_t numIndices = tbb::parallel_reduce(tbb::blocked_range<size_t>(0, count), size_t(0),
+        [&](const tbb::blocked_range<size_t>& r, size_t n)
+        {
+            for (size_t i = r.begin(); i != r.end(); i++)
+            {
+                n += predicate(i) ? 1 : 0;
+            }
+            return n;
+        }, std::plus<size_t>());
+
+    indices.resize(numIndices);
+    if (numIndices == 0)
+    {
+        return;
+    }
+
+    tbb::parallel_scan(tbb::blocked_range<size_t>(0, count), size_t(0),
+        [&](const tbb::blocked_range<size_t>& r, size_t offset, const bool isFinalScan)
+        {
+            for (size_t i = r.begin(); i != r.end(); i++)
+            {
+                if (predicate(i))
+                {
+                    if (isFinalScan)
+                    {
+                        indices[offset] = i;
+                    }
+                    offset++;
+                }
+            }
+            return offset;
+        }, std::plus<size_t>());
+}
 } // end namespace ParallelUtils
 } // end namespace imstk
@@ -0,0 +1,82 @@
+/*=========================================================================
+
+   Library: iMSTK
+
+   Copyright (c) Kitware, Inc. & Center for Modeling, Simulation,
+   & Imaging in Medicine, Rensselaer Polytechnic Institute.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+=========================================================================*/
+
+#include "gtest/gtest.h"
+
+#include "imstkKDTree.h"
+
+using namespace imstk;
+
+///
+/// \brief Compare nearest point and sphere queries against brute force
+///
+TEST(imstkKDTreeTest, CompareWithBruteForce)
+{
+    auto randD = [] { return static_cast<double>(rand()) / static_cast<double>(RAND_MAX) * 2.0 - 1.0; };
+
+    VecDataArray<double, 3> points;
+    for (int i = 0; i < 2000; ++i)
+    {
+        points.push_back(Vec3d(randD(), randD(), randD()));
+    }
+
+    KDTree tree;
+    tree.build(points);
+    EXPECT_EQ(tree.getNumPoints(), 2000);
+
+    std::vector<size_t> result;
+    for (int iter = 0; iter < 100; ++iter)
+    {
+        const Vec3d pos(randD() * 1.5, randD() * 1.5, randD() * 1.5);
+
+        size_t expectedId    = 0;
+        double expectedDist2 = IMSTK_DOUBLE_MAX;
+        size_t numInSphere   = 0;
+        for (int i = 0; i < points.size(); ++i)
+        {
+            const double dist2 = (points[i] - pos).squaredNorm();
+            if (dist2 < expectedDist2)
+            {
+                expectedDist2 = dist2;
+                expectedId    = i;
+            }
+            numInSphere += (dist2 <= 0.04) ? 1 : 0;
+        }
+
+        size_t id    = 0;
+        double dist2 = 0.0;
+        EXPECT_TRUE(tree.findNearestPoint(pos, id, dist2));
+        EXPECT_EQ(id, expectedId);
+        EXPECT_EQ(dist2, expectedDist2);
+
+        tree.getPointsInSphere(result, pos, 0.2);
+        EXPECT_EQ(result.size(), numInSphere);
+        for (const auto& pointId : result)
+        {
+            EXPECT_LE((points[pointId] - pos).squaredNorm(), 0.04);
+        }
+    }
+
+    tree.clear();
+    size_t id    = 0;
+    double dist2 = 0.0;
+    EXPECT_FALSE(tree.findNearestPoint(Vec3d::Zero(), id, dist2));
+}
@@ -24,6 +24,7 @@
 #include "imstkVecDataArray.h"
 
 #include <gtest/gtest.h>
+#include <set>
 
 using namespace imstk;
 
@@ -333,6 +334,96 @@ public:
         testTriangle(false);
     }
 
+    void testQueries()
+    {
+        m_Octree->update();
+        const auto& vPoints    = m_Octree->m_vPrimitivePtrs[OctreePrimitiveType::Point];
+        const auto& vTriangles = m_Octree->m_vPrimitivePtrs[OctreePrimitiveType::Triangle];
+        auto        randD      = [] { return (static_cast<double>(rand()) / static_cast<double>(RAND_MAX) * 2.0 - 1.0) * BOUND; };
+
+        for (int iter = 0; iter < ITERATIONS; ++iter)
+        {
+            const Vec3d pos(randD(), randD(), randD());
+
+            // AABB query against brute force
+            const Vec3d                   lower = pos - Vec3d(3.0, 3.0, 3.0);
+            const Vec3d                   upper = pos + Vec3d(3.0, 3.0, 3.0);
+            std::vector<OctreePrimitive*> result;
+            m_Octree->getPrimitivesInAABB(result, OctreePrimitiveType::Triangle, lower, upper);
+            std::set<OctreePrimitive*> expected;
+            for (const auto& pPrimitive : vTriangles)
+            {
+                if (pPrimitive->m_UpperCorner[0] >= lower[0] && pPrimitive->m_UpperCorner[1] >= lower[1] && pPrimitive->m_UpperCorner[2] >= lower[2]
+                    && pPrimitive->m_LowerCorner[0] <= upper[0] && pPrimitive->m_LowerCorner[1] <= upper[1] && pPrimitive->m_LowerCorner[2] <= upper[2])
+                {
+                    expected.insert(pPrimitive);
+                }
+            }
+            EXPECT_EQ(std::set<OctreePrimitive*>(result.begin(), result.end()), expected);
+
+            // K nearest points against brute force
+            const uint32_t      k = 5;
+            std::vector<double> dists;
+            for (const auto& pPrimitive : vPoints)
+            {
+                dists.push_back((pos - Vec3d(pPrimitive->m_Position[0], pPrimitive->m_Position[1], pPrimitive->m_Position[2])).norm());
+            }
+            std::sort(dists.begin(), dists.end());
+            m_Octree->getKNearestPoints(result, pos, k);
+            EXPECT_EQ(result.size(), std::min(static_cast<size_t>(k), vPoints.size()));
+            for (size_t i = 0; i < result.size(); ++i)
+            {
+                EXPECT_NEAR((pos - Vec3d(result[i]->m_Position[0], result[i]->m_Position[1], result[i]->m_Position[2])).norm(), dists[i], 1.0e-10);
+            }
+
+            double distance = 0.0;
+            m_Octree->getClosestPrimitive(OctreePrimitiveType::Point, pos, distance);
+            EXPECT_NEAR(distance, dists[0], 1.0e-10);
+
+            // Closest triangle and ray cast against brute force, sampling the triangles densely
+            double      minDist = IMSTK_DOUBLE_MAX;
+            double      minT    = IMSTK_DOUBLE_MAX;
+            const Vec3d dir     = Vec3d(randD(), randD(), randD()).normalized();
+            for (int i = 0; i < m_Mesh->getNumTriangles(); ++i)
+            {
+                const Vec3i& face = (*m_Mesh->getTriangleIndices())[i];
+                const Vec3d  a    = m_Mesh->getVertexPosition(face[0]);
+                const Vec3d  b    = m_Mesh->getVertexPosition(face[1]);
+                const Vec3d  c    = m_Mesh->getVertexPosition(face[2]);
+                for (int u = 0; u <= 50; ++u)
+                {
+                    for (int v = 0; u + v <= 50; ++v)
+                    {
+                        minDist = std::min(minDist, (pos - (a + (b - a) * (u / 50.0) + (c - a) * (v / 50.0))).norm());
+                    }
+                }
+
+                const Vec3d  n = (b - a).cross(c - a);
+                const double t = n.dot(a - pos) / n.dot(dir);
+                const Vec3d  p = pos + dir * t;
+                if (t >= 0.0 && n.dot((b - a).cross(p - a)) >= 0.0 && n.dot((c - b).cross(p - b)) >= 0.0 && n.dot((a - c).cross(p - c)) >= 0.0)
+                {
+                    minT = std::min(minT, t);
+                }
+            }
+            m_Octree->getClosestPrimitive(OctreePrimitiveType::Triangle, pos, distance);
+            EXPECT_LE(distance, minDist + 1.0e-10);
+            EXPECT_GE(distance, minDist - BOUND * 0.1);
+
+            double     t    = 0.0;
+            const auto pHit = m_Octree->castRay(pos, dir, 100.0 * BOUND, t);
+            if (minT == IMSTK_DOUBLE_MAX)
+            {
+                EXPECT_EQ(pHit, nullptr);
+            }
+            else
+            {
+                EXPECT_NE(pHit, nullptr);
+                EXPECT_NEAR(t, minT, 1.0e-8);
+            }
+        }
+    }
+
 protected:
     std::shared_ptr<LooseOctree> m_Octree;
     std::shared_ptr<PointSet>    m_PointSet;
@@ -364,3 +455,18 @@ TEST_F(LooseOctreeTest, TestTeleportingPrimitives)
         randomizePositions(m_Mesh);
     }
 }
+
+///
+/// \brief Test spatial queries against brute force while primitives moving around randomly
+///
+TEST_F(LooseOctreeTest, TestSpatialQueries)
+{
+    buildExample();
+    m_Octree->setAlwaysRebuild(false);
+    for (int iter = 0; iter < ITERATIONS; ++iter)
+    {
+        testQueries();
+        randomizePositions(m_PointSet);
+        randomizePositions(m_Mesh);
+    }
+}
@@ -21,7 +21,9 @@
 
 #include "gtest/gtest.h"
 
+#include "imstkSpatialHashTableOpenAddressing.h"
 #include "imstkSpatialHashTableSeparateChaining.h"
+#include "imstkCSRNeighborList.h"
 #include "imstkGridBasedNeighborSearch.h"
 #include "imstkVecDataArray.h"
 
@@ -93,6 +95,39 @@ neighborSearchGridBased(VecDataArray<double, 3>& particles, std::vector<std::vec
     gridSearch.getNeighbors(neighbors, particles);
 }
 
+///
+/// \brief Search neighbors using grid-based approach with Morton ordered cells
+///
+void
+neighborSearchGridBasedMorton(VecDataArray<double, 3>& particles, std::vector<std::vector<size_t>>& neighbors)
+{
+    neighbors.resize(particles.size());
+    const double                   radius = 4.000000000000001 * PARTICLE_RADIUS;
+    static GridBasedNeighborSearch gridSearch;
+    gridSearch.setSearchRadius(radius);
+    gridSearch.setUseMortonOrder(true);
+    gridSearch.getNeighbors(neighbors, particles);
+}
+
+///
+/// \brief Search neighbors using grid-based approach into a CSR neighbor list
+///
+void
+neighborSearchGridBasedCSR(VecDataArray<double, 3>& particles, std::vector<std::vector<size_t>>& neighbors)
+{
+    const double                   radius = 4.000000000000001 * PARTICLE_RADIUS;
+    static GridBasedNeighborSearch gridSearch;
+    static CSRNeighborList         neighborList;
+    gridSearch.setSearchRadius(radius);
+    gridSearch.getNeighbors(neighborList, particles);
+
+    neighbors.resize(particles.size());
+    for (size_t p = 0; p < neighborList.getNumPoints(); ++p)
+    {
+        neighbors[p].assign(neighborList.getNeighbors(p), neighborList.getNeighbors(p) + neighborList.getNumNeighbors(p));
+    }
+}
+
 ///
 /// \brief Search neighbors using spatial hashing approach
 ///
@@ -119,6 +154,50 @@ neighborSearchSpatialHashing(VecDataArray<double, 3>& particles, std::vector<std
     }
 }
 
+///
+/// \brief Search neighbors using open addressing spatial hashing with batched queries
+///
+void
+neighborSearchSpatialHashingOpenAddressing(VecDataArray<double, 3>& particles, std::vector<std::vector<size_t>>& neighbors)
+{
+    const double                          radius = 4.000000000000001 * PARTICLE_RADIUS;
+    static SpatialHashTableOpenAddressing hashTable;
+    static CSRNeighborList                neighborList;
+
+    hashTable.clear();
+    hashTable.setCellSize(radius, radius, radius);
+    hashTable.insertPoints(particles);
+    hashTable.getPointsInSpheres(neighborList, particles, radius);
+
+    neighbors.resize(particles.size());
+    for (size_t p = 0; p < neighborList.getNumPoints(); ++p)
+    {
+        neighbors[p].assign(neighborList.getNeighbors(p), neighborList.getNeighbors(p) + neighborList.getNumNeighbors(p));
+    }
+}
+
+///
+/// \brief Search neighbors using open addressing spatial hashing, inserting the particles one by one
+///
+void
+neighborSearchSpatialHashingOpenAddressingSingleInsert(VecDataArray<double, 3>& particles, std::vector<std::vector<size_t>>& neighbors)
+{
+    const double                   radius = 4.000000000000001 * PARTICLE_RADIUS;
+    SpatialHashTableOpenAddressing hashTable;
+    hashTable.setCellSize(radius, radius, radius);
+    for (int p = 0; p < particles.size(); ++p)
+    {
+        hashTable.insertPoint(particles[p]);
+    }
+    EXPECT_EQ(hashTable.getNumPoints(), static_cast<size_t>(particles.size()));
+
+    neighbors.resize(particles.size());
+    for (int p = 0; p < particles.size(); ++p)
+    {
+        hashTable.getPointsInSphere(neighbors[p], particles[p], radius);
+    }
+}
+
 ///
 /// \brief For each particle in setA, search neighbors in setB using brute-force approach
 ///
@@ -231,15 +310,27 @@ TEST(imstkNeighborSearchTest, CompareGridSearchAndSpatialHashing)
     std::vector<std::vector<size_t>> neighbors0;
     std::vector<std::vector<size_t>> neighbors1;
     std::vector<std::vector<size_t>> neighbors2;
+    std::vector<std::vector<size_t>> neighbors3;
+    std::vector<std::vector<size_t>> neighbors4;
+    std::vector<std::vector<size_t>> neighbors5;
+    std::vector<std::vector<size_t>> neighbors6;
 
     for (int iter = 0; iter < ITERATIONS; ++iter)
     {
         neighborSearchBruteForce(particles, neighbors0);
         neighborSearchGridBased(particles, neighbors1);
         neighborSearchSpatialHashing(particles, neighbors2);
+        neighborSearchGridBasedMorton(particles, neighbors3);
+        neighborSearchGridBasedCSR(particles, neighbors4);
+        neighborSearchSpatialHashingOpenAddressing(particles, neighbors5);
+        neighborSearchSpatialHashingOpenAddressingSingleInsert(particles, neighbors6);
 
         EXPECT_EQ(verify(neighbors1, neighbors0), true);
         EXPECT_EQ(verify(neighbors2, neighbors0), true);
+        EXPECT_EQ(verify(neighbors3, neighbors0), true);
+        EXPECT_EQ(verify(neighbors4, neighbors0), true);
+        EXPECT_EQ(verify(neighbors5, neighbors0), true);
+        EXPECT_EQ(verify(neighbors6, neighbors0), true);
         advancePositions(particles);
     }
 }
@@ -0,0 +1,146 @@
+/*=========================================================================
+
+   Library: iMSTK
+
+   Copyright (c) Kitware, Inc. & Center for Modeling, Simulation,
+   & Imaging in Medicine, Rensselaer Polytechnic Institute.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+=========================================================================*/
+
+#pragma once
+
+#include "imstkParallelFor.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace imstk
+{
+///
+/// \class CSRNeighborList
+///
+/// \brief Neighbor lists of a set of points stored in compressed sparse row layout
+/// The neighbors of point i are getIndices()[getOffsets()[i], getOffsets()[i + 1]).
+/// Building reuses all storage, so at steady state no allocations occur
+///
+class CSRNeighborList
+{
+public:
+    CSRNeighborList() = default;
+    ~CSRNeighborList() = default;
+
+public:
+    ///
+    /// \brief Returns the number of points with neighbor lists
+    ///
+    size_t getNumPoints() const { return m_Offsets.empty() ? 0 : m_Offsets.size() - 1; }
+
+    ///
+    /// \brief Returns the total number of neighbors over all points
+    ///
+    size_t getTotalNumNeighbors() const { return m_Indices.size(); }
+
+    ///
+    /// \brief Returns the number of neighbors of point i
+    ///
+    uint32_t getNumNeighbors(const size_t i) const { return m_Offsets[i + 1] - m_Offsets[i]; }
+
+    ///
+    /// \brief Returns a pointer to the first neighbor of point i
+    ///
+    const uint32_t* getNeighbors(const size_t i) const { return m_Indices.data() + m_Offsets[i]; }
+
+    ///
+    /// \brief Get the offsets (size numPoints + 1) and flat neighbor indices
+    ///@{
+    const std::vector<uint32_t>& getOffsets() const { return m_Offsets; }
+    const std::vector<uint32_t>& getIndices() const { return m_Indices; }
+    ///@}
+
+    ///
+    /// \brief Remove all lists
+    ///
+    void clear()
+    {
+        m_Offsets.clear();
+        m_Indices.clear();
+    }
+
+    ///
+    /// \brief Build the lists, points are processed in parallel chunks
+    /// \param numPoints Number of points to build lists for
+    /// \param collectNeighbors Function (size_t i, std::vector<uint32_t>& list) that
+    /// appends the neighbors of point i to list
+    ///
+    template<typename Function>
+    void build(const size_t numPoints, Function&& collectNeighbors)
+    {
+        const size_t numChunks = (numPoints + ChunkSize - 1) / ChunkSize;
+        m_Offsets.resize(numPoints + 1);
+        m_Offsets[0] = 0;
+        if (m_ChunkBuffers.size() < numChunks)
+        {
+            m_ChunkBuffers.resize(numChunks);
+        }
+        m_ChunkOffsets.resize(numChunks + 1);
+
+        // Collect the neighbors of every chunk into its own buffer, counts are stored in the offsets
+        ParallelUtils::parallelFor(numChunks,
+            [&](const size_t chunk)
+            {
+                std::vector<uint32_t>& buffer = m_ChunkBuffers[chunk];
+                buffer.resize(0);
+                const size_t end = std::min((chunk + 1) * ChunkSize, numPoints);
+                for (size_t i = chunk * ChunkSize; i < end; i++)
+                {
+                    const size_t prevSize = buffer.size();
+                    collectNeighbors(i, buffer);
+                    m_Offsets[i + 1] = static_cast<uint32_t>(buffer.size() - prevSize);
+                }
+            });
+
+        m_ChunkOffsets[0] = 0;
+        for (size_t chunk = 0; chunk < numChunks; chunk++)
+        {
+            m_ChunkOffsets[chunk + 1] = m_ChunkOffsets[chunk] + static_cast<uint32_t>(m_ChunkBuffers[chunk].size());
+        }
+        m_Indices.resize(m_ChunkOffsets[numChunks]);
+
+        // Turn the counts into offsets and gather the chunk buffers
+        ParallelUtils::parallelFor(numChunks,
+            [&](const size_t chunk)
+            {
+                uint32_t     offset = m_ChunkOffsets[chunk];
+                const size_t end    = std::min((chunk + 1) * ChunkSize, numPoints);
+                for (size_t i = chunk * ChunkSize; i < end; i++)
+                {
+                    offset += m_Offsets[i + 1];
+                    m_Offsets[i + 1] = offset;
+                }
+                std::copy(m_ChunkBuffers[chunk].begin(), m_ChunkBuffers[chunk].end(), m_Indices.begin() + m_ChunkOffsets[chunk]);
+            });
+    }
+
+private:
+    static constexpr size_t ChunkSize = 256; ///> Number of points per parallel chunk when building
+
+    std::vector<uint32_t> m_Offsets;         ///> Offset of each point's list in m_Indices
+    std::vector<uint32_t> m_Indices;         ///> Neighbor indices of all points
+
+    std::vector<std::vector<uint32_t>> m_ChunkBuffers; ///> Scratch neighbor storage per chunk
+    std::vector<uint32_t>              m_ChunkOffsets; ///> Offset of each chunk in m_Indices
+};
+} // end namespace imstk
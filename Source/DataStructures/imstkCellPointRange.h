@@ -0,0 +1,50 @@
+/*=========================================================================
+
+   Library: iMSTK
+
+   Copyright (c) Kitware, Inc. & Center for Modeling, Simulation,
+   & Imaging in Medicine, Rensselaer Polytechnic Institute.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+=========================================================================*/
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+namespace imstk
+{
+///
+/// \struct CellPointRange
+///
+/// \brief Range of a point array counting sorted by cell that belongs to one cell.
+/// The count is incremented concurrently while the points are binned, copies are
+/// not atomic so containers of ranges can still be resized and assigned
+///
+struct CellPointRange
+{
+    CellPointRange() = default;
+    CellPointRange(const CellPointRange& other) : first(other.first), count(other.count.load(std::memory_order_relaxed)) {}
+    CellPointRange& operator=(const CellPointRange& other)
+    {
+        first = other.first;
+        count.store(other.count.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        return *this;
+    }
+
+    uint32_t first = 0;          ///> Index of the first point of the cell in the sorted array
+    std::atomic<uint32_t> count { 0 }; ///> Number of points in the cell
+};
+} // end namespace imstk
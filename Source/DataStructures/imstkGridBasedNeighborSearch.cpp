@@ -21,9 +21,21 @@
 
 #include "imstkGridBasedNeighborSearch.h"
 #include "imstkParallelUtils.h"
+#include "imstkReordering.h"
+
+#include <algorithm>
 
 namespace imstk
 {
+///
+/// \brief Returns the Morton code of a 3D cell index
+///
+static uint64_t
+getMortonCode(const uint64_t i, const uint64_t j, const uint64_t k)
+{
+    return Reordering::spreadBits(i) | (Reordering::spreadBits(j) << 1) | (Reordering::spreadBits(k) << 2);
+}
+
 void
 GridBasedNeighborSearch::setSearchRadius(const double radius)
 {
@@ -47,86 +59,215 @@ GridBasedNeighborSearch::getNeighbors(std::vector<std::vector<size_t>>& result,
 
 void
 GridBasedNeighborSearch::getNeighbors(std::vector<std::vector<size_t>>& result, const VecDataArray<double, 3>& setA, const VecDataArray<double, 3>& setB)
+{
+    buildCellLists(setB);
+
+    // for each point in setA, collect setB neighbors within the search radius
+    result.resize(setA.size());
+    ParallelUtils::parallelFor(setA.size(),
+        [&](const size_t p)
+        {
+            auto& pneighbors = result[p];
+
+            // important: must clear the old result (if applicable)
+            pneighbors.resize(0);
+
+            const Vec3d ppos = setA[p];
+            forEachPointInNeighborCells(ppos, [&](const uint32_t q)
+            {
+                const Vec3d diff = ppos - setB[q];
+                const auto d2    = diff[0] * diff[0] + diff[1] * diff[1] + diff[2] * diff[2];
+                if (d2 < m_SearchRadiusSqr)
+                {
+                    pneighbors.push_back(q);
+                }
+            });
+    });
+}
+
+void
+GridBasedNeighborSearch::getNeighbors(CSRNeighborList& result, const VecDataArray<double, 3>& points)
+{
+    getNeighbors(result, points, points);
+}
+
+void
+GridBasedNeighborSearch::getNeighbors(CSRNeighborList& result, const VecDataArray<double, 3>& setA, const VecDataArray<double, 3>& setB)
+{
+    buildCellLists(setB);
+
+    result.build(static_cast<size_t>(setA.size()),
+        [&](const size_t p, std::vector<uint32_t>& pneighbors)
+        {
+            const Vec3d ppos = setA[p];
+            forEachPointInNeighborCells(ppos, [&](const uint32_t q)
+            {
+                const Vec3d diff = ppos - setB[q];
+                const auto d2    = diff[0] * diff[0] + diff[1] * diff[1] + diff[2] * diff[2];
+                if (d2 < m_SearchRadiusSqr)
+                {
+                    pneighbors.push_back(q);
+                }
+            });
+        });
+}
+
+void
+GridBasedNeighborSearch::buildCellLists(const VecDataArray<double, 3>& points)
 {
     LOG_IF(FATAL, (std::abs(m_SearchRadius) < 1e-8)) << "Neighbor search radius is zero";
 
-    // firstly compute the bounding box of points in setB
+    // firstly compute the bounding box of points
     Vec3d lowerCorner;
     Vec3d upperCorner;
-    ParallelUtils::findAABB(setB, lowerCorner, upperCorner);
+    ParallelUtils::findAABB(points, lowerCorner, upperCorner);
 
     // the upper corner need to be expanded a bit, to avoid round-off error during computation
     upperCorner += Vec3d(m_SearchRadius, m_SearchRadius, m_SearchRadius) * 0.1;
 
-    // resize grid to fit the bounding box covering setB
+    // resize grid to fit the bounding box covering the points
     m_Grid.initialize(lowerCorner, upperCorner, m_SearchRadius);
+    computeCellOrder();
+
+    const size_t                 numPoints = static_cast<size_t>(points.size());
+    std::vector<CellPointRange>& cells     = m_Grid.getAllCellData();
+    m_PointCellIds.resize(numPoints);
+    m_PointSlots.resize(numPoints);
+    m_SortedIndices.resize(numPoints);
 
-    // clear all particle lists in each grid cell
-    ParallelUtils::parallelFor(m_Grid.getAllCellData().size(),
+    // reset the point count of each cell
+    ParallelUtils::parallelFor(cells.size(),
         [&](const size_t cellIdx)
         {
-            m_Grid.getCellData(cellIdx).particleIndices.resize(0);
+            cells[cellIdx].count.store(0, std::memory_order_relaxed);
         });
 
-    // collect particle indices of points in setB into their corresponding cells
-    ParallelUtils::parallelFor(setB.size(),
+    // count the points per cell, the pre-increment count gives the slot of the point within its cell
+    ParallelUtils::parallelFor(numPoints,
         [&](const size_t p)
         {
-            auto& cellData = m_Grid.getCellData(setB[p]);
-            cellData.lock.lock();
-            cellData.particleIndices.push_back(p);
-            cellData.lock.unlock();
+            const uint32_t cellIdx = m_Grid.template getCellLinearizedIndex<unsigned int>(points[p]);
+            m_PointCellIds[p] = cellIdx;
+            m_PointSlots[p]   = cells[cellIdx].count.fetch_add(1, std::memory_order_relaxed);
         });
 
-    // for each point in setA, collect setB neighbors within the search radius
-    result.resize(setA.size());
-    ParallelUtils::parallelFor(setA.size(),
+    // prefix sum of the counts gives the first index of each cell in the sorted array
+    uint32_t offset = 0;
+    if (m_CellOrder.empty())
+    {
+        for (CellPointRange& cell : cells)
+        {
+            cell.first = offset;
+            offset    += cell.count.load(std::memory_order_relaxed);
+        }
+    }
+    else
+    {
+        for (const uint32_t cellIdx : m_CellOrder)
+        {
+            cells[cellIdx].first = offset;
+            offset += cells[cellIdx].count.load(std::memory_order_relaxed);
+        }
+    }
+
+    // scatter the points into their sorted location
+    ParallelUtils::parallelFor(numPoints,
         [&](const size_t p)
         {
-            auto& pneighbors = result[p];
+            m_SortedIndices[cells[m_PointCellIds[p]].first + m_PointSlots[p]] = static_cast<uint32_t>(p);
+        });
+}
 
-            // important: must clear the old result (if applicable)
-            pneighbors.resize(0);
+void
+GridBasedNeighborSearch::computeCellOrder()
+{
+    if (!m_UseMortonOrder)
+    {
+        m_CellOrder.clear();
+        return;
+    }
 
-            const auto ppos    = setA[p];
-            const auto cellIdx = m_Grid.template getCell3DIndices<int>(ppos);
+    // Only recompute when the grid resolution changes
+    const std::array<unsigned int, 3> resolution = m_Grid.getResolution();
+    if (resolution == m_CellOrderResolution && m_CellOrder.size() == m_Grid.getNumTotalCells())
+    {
+        return;
+    }
+    m_CellOrderResolution = resolution;
 
-            for (int k = -1; k <= 1; ++k)
+    std::vector<uint64_t> codes(m_Grid.getNumTotalCells());
+    m_CellOrder.resize(m_Grid.getNumTotalCells());
+    ParallelUtils::parallelFor(resolution[2],
+        [&](const unsigned int k)
+        {
+            for (unsigned int j = 0; j < resolution[1]; j++)
             {
-                int cellZ = cellIdx[2] + k;
-                if (!m_Grid.template isValidCellIndex<2>(cellZ))
+                for (unsigned int i = 0; i < resolution[0]; i++)
                 {
-                    continue;
+                    const unsigned int cellIdx = m_Grid.getCellLinearizedIndex(i, j, k);
+                    codes[cellIdx]       = getMortonCode(i, j, k);
+                    m_CellOrder[cellIdx] = cellIdx;
                 }
-                for (int j = -1; j <= 1; ++j)
+            }
+        });
+    std::sort(m_CellOrder.begin(), m_CellOrder.end(),
+        [&](const uint32_t a, const uint32_t b) { return codes[a] < codes[b]; });
+}
+
+template<typename Function>
+void
+GridBasedNeighborSearch::forEachPointInNeighborCells(const Vec3d& pos, Function&& func) const
+{
+    const auto cellIdx = m_Grid.template getCell3DIndices<int>(pos);
+    const auto& cells  = m_Grid.getAllCellData();
+
+    // x-adjacent cells are contiguous in linear order, so a whole row of cells is one range
+    const bool linearOrder = m_CellOrder.empty();
+    const int  cellXMin    = std::max(cellIdx[0] - 1, 0);
+    const int  cellXMax    = std::min(cellIdx[0] + 1, static_cast<int>(m_Grid.getResolution()[0]) - 1);
+    if (cellXMin > cellXMax)
+    {
+        return;
+    }
+
+    for (int k = -1; k <= 1; ++k)
+    {
+        int cellZ = cellIdx[2] + k;
+        if (!m_Grid.template isValidCellIndex<2>(cellZ))
+        {
+            continue;
+        }
+        for (int j = -1; j <= 1; ++j)
+        {
+            int cellY = cellIdx[1] + j;
+            if (!m_Grid.template isValidCellIndex<1>(cellY))
+            {
+                continue;
+            }
+
+            if (linearOrder)
+            {
+                const CellPointRange& firstCell = cells[m_Grid.getCellLinearizedIndex(cellXMin, cellY, cellZ)];
+                const CellPointRange& lastCell  = cells[m_Grid.getCellLinearizedIndex(cellXMax, cellY, cellZ)];
+                const uint32_t        end       = lastCell.first + lastCell.count.load(std::memory_order_relaxed);
+                for (uint32_t idx = firstCell.first; idx < end; idx++)
                 {
-                    int cellY = cellIdx[1] + j;
-                    if (!m_Grid.template isValidCellIndex<1>(cellY))
-                    {
-                        continue;
-                    }
-                    for (int i = -1; i <= 1; ++i)
+                    func(m_SortedIndices[idx]);
+                }
+            }
+            else
+            {
+                for (int cellX = cellXMin; cellX <= cellXMax; cellX++)
+                {
+                    const CellPointRange& cell = cells[m_Grid.getCellLinearizedIndex(cellX, cellY, cellZ)];
+                    const uint32_t        end  = cell.first + cell.count.load(std::memory_order_relaxed);
+                    for (uint32_t idx = cell.first; idx < end; idx++)
                     {
-                        int cellX = cellIdx[0] + i;
-                        if (!m_Grid.template isValidCellIndex<0>(cellX))
-                        {
-                            continue;
-                        }
-
-                        // get index q of point in setB
-                        for (auto q : m_Grid.getCellData(cellX, cellY, cellZ).particleIndices)
-                        {
-                            const auto qpos  = setB[q];
-                            const Vec3d diff = ppos - qpos;
-                            const auto d2    = diff[0] * diff[0] + diff[1] * diff[1] + diff[2] * diff[2];
-                            if (d2 < m_SearchRadiusSqr)
-                            {
-                                pneighbors.push_back(q);
-                            }
-                        }
+                        func(m_SortedIndices[idx]);
                     }
                 }
             }
-    });
+        }
+    }
 }
 } // end namespace imstk
@@ -21,7 +21,8 @@
 
 #pragma once
 
-#include "imstkSpinLock.h"
+#include "imstkCellPointRange.h"
+#include "imstkCSRNeighborList.h"
 #include "imstkUniformSpatialGrid.h"
 #include "imstkVecDataArray.h"
 
@@ -29,6 +30,9 @@ namespace imstk
 {
 ///
 /// \brief Class for searching neighbors using regular grid
+/// The points are counting sorted by the cell they fall in, such that the
+/// points of each cell are stored contiguously in a single flat array.
+/// Cells may optionally be laid out in Morton (z-curve) order
 ///
 class GridBasedNeighborSearch
 {
@@ -52,6 +56,14 @@ public:
     ///
     double getSearchRadius() const { return m_SearchRadius; }
 
+    ///
+    /// \brief Set/Get whether the cells are laid out in Morton order instead of
+    /// x-fastest linear order in the sorted point array
+    ///@{
+    void setUseMortonOrder(const bool useMortonOrder) { m_UseMortonOrder = useMortonOrder; }
+    bool getUseMortonOrder() const { return m_UseMortonOrder; }
+    ///@}
+
     ///
     /// \brief Search neighbors for each points within the search radius
     /// \param points The given points to search for neighbors
@@ -74,17 +86,54 @@ public:
     ///
     void getNeighbors(std::vector<std::vector<size_t>>& result, const VecDataArray<double, 3>& setA, const VecDataArray<double, 3>& setB);
 
+    ///
+    /// \brief Search neighbors for each point within the search radius, output in CSR layout
+    /// \param result The neighbor lists of each point
+    /// \param points The given points to search for neighbors
+    ///
+    void getNeighbors(CSRNeighborList& result, const VecDataArray<double, 3>& points);
+
+    ///
+    /// \brief Search neighbors from setB for each point in setA within the search radius, output in CSR layout
+    /// \param result The neighbor lists of each point in setA
+    /// \param setA The point set for which performing neighbor search
+    /// \param setB The point set where neighbor indices will be collected
+    ///
+    void getNeighbors(CSRNeighborList& result, const VecDataArray<double, 3>& setA, const VecDataArray<double, 3>& setB);
+
+    ///
+    /// \brief Get the indices of the points of the last searched setB sorted by cell
+    ///
+    const std::vector<uint32_t>& getSortedIndices() const { return m_SortedIndices; }
+
+protected:
+    ///
+    /// \brief Build the grid and counting sort the points by cell
+    ///
+    void buildCellLists(const VecDataArray<double, 3>& points);
+
+    ///
+    /// \brief Compute the order cells are laid out in the sorted point array
+    ///
+    void computeCellOrder();
+
+    ///
+    /// \brief Call func for every point index of setB in the cells adjacent to the cell of pos
+    ///
+    template<typename Function>
+    void forEachPointInNeighborCells(const Vec3d& pos, Function&& func) const;
+
 private:
     double m_SearchRadius    = 0.0;
     double m_SearchRadiusSqr = 0.0;
+    bool   m_UseMortonOrder  = false;
+
+    UniformSpatialGrid<CellPointRange> m_Grid;
 
-    // Data store in each grid cell
-    // This entire struct can be replaced by tbb::concurrent_vector<size_t>, however, with lower performance
-    struct CellData
-    {
-        std::vector<size_t> particleIndices; // Store list of particles
-        ParallelUtils::SpinLock lock;        // An atomic lock for thread-safe writing
-    };
-    UniformSpatialGrid<CellData> m_Grid;
+    std::vector<uint32_t>       m_PointCellIds;      ///> Linearized cell index of each point
+    std::vector<uint32_t>       m_PointSlots;        ///> Index of each point within its cell
+    std::vector<uint32_t>       m_SortedIndices;     ///> Point indices sorted by cell
+    std::vector<uint32_t>       m_CellOrder;         ///> Cells in Morton order (empty for linear order)
+    std::array<unsigned int, 3> m_CellOrderResolution = { { 0, 0, 0 } };
 };
 } // end namespace imstk
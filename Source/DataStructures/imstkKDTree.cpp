@@ -0,0 +1,199 @@
+/*=========================================================================
+
+   Library: iMSTK
+
+   Copyright (c) Kitware, Inc. & Center for Modeling, Simulation,
+   & Imaging in Medicine, Rensselaer Polytechnic Institute.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+=========================================================================*/
+
+#include "imstkKDTree.h"
+#include "imstkLogger.h"
+#include "imstkSpatialQueryUtils.h"
+
+#include <algorithm>
+
+namespace imstk
+{
+KDTree::KDTree(const uint32_t maxLeafSize) : m_MaxLeafSize(maxLeafSize)
+{
+    CHECK(maxLeafSize > 0) << "Invalid leaf size";
+}
+
+void
+KDTree::build(const VecDataArray<double, 3>& points)
+{
+    clear();
+    if (points.size() == 0)
+    {
+        return;
+    }
+
+    m_Points.resize(points.size());
+    m_Indices.resize(points.size());
+    for (int i = 0; i < points.size(); ++i)
+    {
+        m_Points[i]  = points[i];
+        m_Indices[i] = static_cast<uint32_t>(i);
+    }
+    m_Nodes.reserve(2 * (points.size() / m_MaxLeafSize + 1));
+    buildNode(0, static_cast<uint32_t>(points.size()));
+
+    // Store the points in tree order for locality
+    for (size_t i = 0; i < m_Indices.size(); ++i)
+    {
+        m_Points[i] = points[m_Indices[i]];
+    }
+}
+
+uint32_t
+KDTree::buildNode(const uint32_t begin, const uint32_t end)
+{
+    // m_Points is still in input order here, so points are read through their IDs
+    const auto nodeIdx = static_cast<uint32_t>(m_Nodes.size());
+    m_Nodes.push_back(Node());
+    m_Nodes[nodeIdx].begin = begin;
+    m_Nodes[nodeIdx].end   = end;
+    m_Nodes[nodeIdx].right = 0;
+
+    Vec3d lowerCorner = Vec3d::Constant(IMSTK_DOUBLE_MAX);
+    Vec3d upperCorner = Vec3d::Constant(-IMSTK_DOUBLE_MAX);
+    for (uint32_t i = begin; i < end; ++i)
+    {
+        lowerCorner = lowerCorner.cwiseMin(m_Points[m_Indices[i]]);
+        upperCorner = upperCorner.cwiseMax(m_Points[m_Indices[i]]);
+    }
+    m_Nodes[nodeIdx].lowerCorner = lowerCorner;
+    m_Nodes[nodeIdx].upperCorner = upperCorner;
+
+    if (end - begin <= m_MaxLeafSize)
+    {
+        return nodeIdx;
+    }
+
+    // Median split along the largest extent
+    int axis;
+    (upperCorner - lowerCorner).maxCoeff(&axis);
+    const uint32_t mid = begin + (end - begin) / 2;
+    std::nth_element(m_Indices.begin() + begin, m_Indices.begin() + mid, m_Indices.begin() + end,
+        [&](const uint32_t a, const uint32_t b) { return m_Points[a][axis] < m_Points[b][axis]; });
+
+    buildNode(begin, mid);
+    const uint32_t right = buildNode(mid, end);
+    m_Nodes[nodeIdx].right = right;
+    return nodeIdx;
+}
+
+void
+KDTree::clear()
+{
+    m_Nodes.resize(0);
+    m_Points.resize(0);
+    m_Indices.resize(0);
+}
+
+bool
+KDTree::findNearestPoint(const Vec3d& pos, size_t& id, double& squaredDistance) const
+{
+    if (m_Nodes.empty())
+    {
+        return false;
+    }
+
+    uint32_t bestIdx   = 0;
+    double   bestDist2 = IMSTK_DOUBLE_MAX;
+
+    // Depth first traversal visiting the nearer child first, pruned by the closest point so far
+    std::pair<double, uint32_t> nodeStack[64];
+    uint32_t                    stackSize = 0;
+    nodeStack[stackSize++] = std::make_pair(0.0, 0u);
+    while (stackSize > 0) {
+        const auto entry = nodeStack[--stackSize];
+        if (entry.first >= bestDist2)
+        {
+            continue;
+        }
+
+        const Node& node = m_Nodes[entry.second];
+        if (node.right == 0)
+        {
+            for (uint32_t i = node.begin; i < node.end; ++i)
+            {
+                const double dist2 = (m_Points[i] - pos).squaredNorm();
+                if (dist2 < bestDist2)
+                {
+                    bestDist2 = dist2;
+                    bestIdx   = i;
+                }
+            }
+            continue;
+        }
+
+        const uint32_t left       = entry.second + 1;
+        const double   leftDist2  = SpatialQueryUtils::squaredDistanceToBox(pos, m_Nodes[left].lowerCorner, m_Nodes[left].upperCorner);
+        const double   rightDist2 = SpatialQueryUtils::squaredDistanceToBox(pos, m_Nodes[node.right].lowerCorner, m_Nodes[node.right].upperCorner);
+        if (leftDist2 < rightDist2)
+        {
+            nodeStack[stackSize++] = std::make_pair(rightDist2, node.right);
+            nodeStack[stackSize++] = std::make_pair(leftDist2, left);
+        }
+        else
+        {
+            nodeStack[stackSize++] = std::make_pair(leftDist2, left);
+            nodeStack[stackSize++] = std::make_pair(rightDist2, node.right);
+        }
+    }
+
+    id = m_Indices[bestIdx];
+    squaredDistance = bestDist2;
+    return true;
+}
+
+void
+KDTree::getPointsInSphere(std::vector<size_t>& result, const Vec3d& pos, const double radius) const
+{
+    result.resize(0);
+    if (m_Nodes.empty())
+    {
+        return;
+    }
+
+    const double radius2 = radius * radius;
+    uint32_t     nodeStack[64];
+    uint32_t     stackSize = 0;
+    nodeStack[stackSize++] = 0;
+    while (stackSize > 0) {
+        const Node& node = m_Nodes[nodeStack[--stackSize]];
+        if (SpatialQueryUtils::squaredDistanceToBox(pos, node.lowerCorner, node.upperCorner) > radius2)
+        {
+            continue;
+        }
+
+        if (node.right == 0)
+        {
+            for (uint32_t i = node.begin; i < node.end; ++i)
+            {
+                if ((m_Points[i] - pos).squaredNorm() <= radius2)
+                {
+                    result.push_back(m_Indices[i]);
+                }
+            }
+            continue;
+        }
+        nodeStack[stackSize++] = node.right;
+        nodeStack[stackSize++] = static_cast<uint32_t>(&node - m_Nodes.data()) + 1;
+    }
+}
+}
@@ -0,0 +1,98 @@
+/*=========================================================================
+
+   Library: iMSTK
+
+   Copyright (c) Kitware, Inc. & Center for Modeling, Simulation,
+   & Imaging in Medicine, Rensselaer Polytechnic Institute.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+=========================================================================*/
+
+#pragma once
+
+#include "imstkMath.h"
+#include "imstkVecDataArray.h"
+
+namespace imstk
+{
+///
+/// \class KDTree
+///
+/// \brief Static KD-tree over a set of points for nearest point queries
+/// The tree is built once by median splits along the largest extent of each node,
+/// points are stored contiguously in tree order so that each leaf is a single range.
+/// Rebuild it whenever the points move
+///
+class KDTree
+{
+public:
+    ///
+    /// \brief Constructor
+    /// \param maxLeafSize Maximum number of points in a leaf node
+    ///
+    explicit KDTree(const uint32_t maxLeafSize = 8);
+
+    ///
+    /// \brief Build the tree from an array of points, point IDs are their indices in the array
+    ///
+    void build(const VecDataArray<double, 3>& points);
+
+    ///
+    /// \brief Clear the tree
+    ///
+    void clear();
+
+    ///
+    /// \brief Returns the number of points in the tree
+    ///
+    size_t getNumPoints() const { return m_Points.size(); }
+
+    ///
+    /// \brief Find the point closest to a position
+    /// \param pos The query position
+    /// \param id ID of the closest point
+    /// \param squaredDistance Squared distance to the closest point
+    /// \return False if the tree is empty
+    ///
+    bool findNearestPoint(const Vec3d& pos, size_t& id, double& squaredDistance) const;
+
+    ///
+    /// \brief Find IDs of all points in a sphere centered at pos and having given radius
+    /// \param result The list to contain search result
+    /// \param pos The center of the sphere
+    /// \param radius The search radius
+    ///
+    void getPointsInSphere(std::vector<size_t>& result, const Vec3d& pos, const double radius) const;
+
+protected:
+    ///
+    /// \brief Recursively build the subtree of the points in [begin, end), returns the node index
+    ///
+    uint32_t buildNode(const uint32_t begin, const uint32_t end);
+
+    struct Node
+    {
+        Vec3d lowerCorner;  ///> Lower corner of the bounding box of the node's points
+        Vec3d upperCorner;  ///> Upper corner of the bounding box of the node's points
+        uint32_t begin;     ///> First point of the node
+        uint32_t end;       ///> One past the last point of the node
+        uint32_t right;     ///> Index of the right child, the left child directly follows the node. Zero for leaves
+    };
+
+    uint32_t              m_MaxLeafSize; ///> Maximum number of points in a leaf node
+    std::vector<Node>     m_Nodes;       ///> Nodes in depth first order, the root first
+    std::vector<Vec3d>    m_Points;      ///> Points in tree order
+    std::vector<uint32_t> m_Indices;     ///> IDs of the points in tree order
+};
+}
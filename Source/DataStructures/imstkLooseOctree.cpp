@@ -20,11 +20,106 @@
 =========================================================================*/
 
 #include "imstkLooseOctree.h"
+#include "imstkImplicitGeometry.h"
 #include "imstkLogger.h"
+#include "imstkSpatialQueryUtils.h"
 #include "imstkSurfaceMesh.h"
 
+#include <queue>
+
 namespace imstk
 {
+namespace
+{
+///
+/// \brief Compute the index of the child node of a node that loosely contains a non-point primitive
+/// \return False if the primitive straddles over multiple children nodes and must be kept at the node
+///
+bool
+getNonPointChildIndex(const Vec3d& center, const double halfWidth,
+                      const std::array<double, 3>& lowerCorner, const std::array<double, 3>& upperCorner, uint32_t& childIdx)
+{
+    childIdx = 0;
+    for (uint32_t dim = 0; dim < 3; ++dim)
+    {
+        const double priCenter = (lowerCorner[dim] + upperCorner[dim]) * 0.5;
+        if (center[dim] < priCenter)
+        {
+            if (center[dim] - (halfWidth * 0.5) > lowerCorner[dim]
+                || center[dim] + (halfWidth * 1.5) < upperCorner[dim])
+            {
+                return false;
+            }
+            childIdx |= (1 << dim);
+        }
+        else
+        {
+            if (center[dim] + (halfWidth * 0.5) < upperCorner[dim]
+                || center[dim] - (halfWidth * 1.5) > lowerCorner[dim])
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+///
+/// \brief Closest point to p on the triangle abc
+///
+Vec3d
+closestPointOnTriangle(const Vec3d& p, const Vec3d& a, const Vec3d& b, const Vec3d& c)
+{
+    const Vec3d  ab = b - a;
+    const Vec3d  ac = c - a;
+    const Vec3d  ap = p - a;
+    const double d1 = ab.dot(ap);
+    const double d2 = ac.dot(ap);
+    if (d1 <= 0.0 && d2 <= 0.0)
+    {
+        return a;
+    }
+
+    const Vec3d  bp = p - b;
+    const double d3 = ab.dot(bp);
+    const double d4 = ac.dot(bp);
+    if (d3 >= 0.0 && d4 <= d3)
+    {
+        return b;
+    }
+
+    const double vc = d1 * d4 - d3 * d2;
+    if (vc <= 0.0 && d1 >= 0.0 && d3 <= 0.0)
+    {
+        return a + ab * (d1 / (d1 - d3));
+    }
+
+    const Vec3d  cp = p - c;
+    const double d5 = ab.dot(cp);
+    const double d6 = ac.dot(cp);
+    if (d6 >= 0.0 && d5 <= d6)
+    {
+        return c;
+    }
+
+    const double vb = d5 * d2 - d1 * d6;
+    if (vb <= 0.0 && d2 >= 0.0 && d6 <= 0.0)
+    {
+        return a + ac * (d2 / (d2 - d6));
+    }
+
+    const double va = d3 * d6 - d5 * d4;
+    if (va <= 0.0 && (d4 - d3) >= 0.0 && (d5 - d6) >= 0.0)
+    {
+        return b + (c - b) * ((d4 - d3) / ((d4 - d3) + (d5 - d6)));
+    }
+
+    const double denom = 1.0 / (va + vb + vc);
+    return a + ab * (vb * denom) + ac * (vc * denom);
+}
+
+}
+
 OctreeNode::OctreeNode(LooseOctree* const tree, OctreeNode* const pParent, const Vec3d& nodeCenter,
                        const double halfWidth, const uint32_t depth) :
     m_pTree(tree),
@@ -192,7 +287,8 @@ OctreeNode::insertPoint(OctreePrimitive* const pPrimitive)
     // Type alias, to reduce copy/past errors
     static const auto type = OctreePrimitiveType::Point;
 
-    if (m_Depth == m_MaxDepth)
+    // Points outside of the node (only possible at the root node) are kept, as no child could contain them
+    if (m_Depth == m_MaxDepth || !contains(pPrimitive->m_Position))
     {
         keepPrimitive(pPrimitive, type);
         return;
@@ -217,12 +313,8 @@ OctreeNode::insertPoint(OctreePrimitive* const pPrimitive)
 void
 OctreeNode::insertNonPointPrimitive(OctreePrimitive* const pPrimitive, const OctreePrimitiveType type)
 {
-    const auto  lowerCorner = pPrimitive->m_LowerCorner;
-    const auto  upperCorner = pPrimitive->m_UpperCorner;
-    const Vec3d priCenter(
-        (lowerCorner[0] + upperCorner[0]) * 0.5,
-        (lowerCorner[1] + upperCorner[1]) * 0.5,
-        (lowerCorner[2] + upperCorner[2]) * 0.5);
+    const auto lowerCorner = pPrimitive->m_LowerCorner;
+    const auto upperCorner = pPrimitive->m_UpperCorner;
 
 #if defined(DEBUG) || defined(_DEBUG) || !defined(NDEBUG)
     LOG_IF(FATAL, (this != m_pTree->m_pRootNode && !looselyContains(lowerCorner, upperCorner)))
@@ -235,37 +327,9 @@ OctreeNode::insertNonPointPrimitive(OctreePrimitive* const pPrimitive, const Oct
         return;
     }
 
-    uint32_t childIdx  = 0;
-    bool     bStraddle = false;
-
-    for (uint32_t dim = 0; dim < 3; ++dim)
-    {
-        if (m_Center[dim] < priCenter[dim])
-        {
-            if (m_Center[dim] - (m_HalfWidth * 0.5) > lowerCorner[dim]
-                || m_Center[dim] + (m_HalfWidth * 1.5) < upperCorner[dim])
-            {
-                bStraddle = true;
-                break;
-            }
-            else
-            {
-                childIdx |= (1 << dim);
-            }
-        }
-        else
-        {
-            if (m_Center[dim] + (m_HalfWidth * 0.5) < upperCorner[dim]
-                || m_Center[dim] - (m_HalfWidth * 1.5) > lowerCorner[dim])
-            {
-                bStraddle = true;
-                break;
-            }
-        }
-    }
-
     // If the primive straddles over multiple children nodes, we must keep it at the current node
-    if (bStraddle)
+    uint32_t childIdx = 0;
+    if (!getNonPointChildIndex(m_Center, m_HalfWidth, lowerCorner, upperCorner, childIdx))
     {
         keepPrimitive(pPrimitive, type);
         return;
@@ -587,8 +651,8 @@ LooseOctree::populatePointPrimitives()
             const auto pointset    = static_cast<PointSet*>(pPrimitive->m_pGeometry);
             const auto point       = pointset->getVertexPosition(pPrimitive->m_Idx);
             pPrimitive->m_Position = { point[0], point[1], point[2] };
-            m_pRootNode->insertPoint(pPrimitive);
         });
+    insertPrimitivesInBulk(vPrimitivePtrs, OctreePrimitiveType::Point);
 }
 
 void
@@ -601,21 +665,132 @@ LooseOctree::populateNonPointPrimitives(const OctreePrimitiveType type)
     }
     ParallelUtils::parallelFor(vPrimitivePtrs.size(),
         [&](const size_t idx) {
-            const auto pPrimitive = vPrimitivePtrs[idx];
-            computePrimitiveBoundingBox(pPrimitive, type);
-            m_pRootNode->insertNonPointPrimitive(pPrimitive, type);
+            computePrimitiveBoundingBox(vPrimitivePtrs[idx], type);
+        });
+    insertPrimitivesInBulk(vPrimitivePtrs, type);
+}
+
+void
+LooseOctree::insertPrimitivesInBulk(const std::vector<OctreePrimitive*>& vPrimitivePtrs, const OctreePrimitiveType type)
+{
+    // The node keys hold 3 bits per level below the root plus 5 bits of depth
+    if (m_MaxDepth > 20u)
+    {
+        ParallelUtils::parallelFor(vPrimitivePtrs.size(),
+            [&](const size_t idx) {
+                (type == OctreePrimitiveType::Point) ? m_pRootNode->insertPoint(vPrimitivePtrs[idx]) :
+                m_pRootNode->insertNonPointPrimitive(vPrimitivePtrs[idx], type);
+            });
+        return;
+    }
+
+    // Locate the node of every primitive, then sort such that primitives of the same node
+    // are adjacent and nodes of the same subtree are close together
+    m_vBulkKeys.resize(vPrimitivePtrs.size());
+    ParallelUtils::parallelFor(vPrimitivePtrs.size(),
+        [&](const size_t idx) {
+            m_vBulkKeys[idx] = { computeNodeKey(vPrimitivePtrs[idx], type), vPrimitivePtrs[idx] };
+        });
+    tbb::parallel_sort(m_vBulkKeys.begin(), m_vBulkKeys.end());
+
+    m_vBulkRunStarts.resize(0);
+    for (size_t idx = 0; idx < m_vBulkKeys.size(); ++idx)
+    {
+        if (idx == 0 || m_vBulkKeys[idx].first != m_vBulkKeys[idx - 1].first)
+        {
+            m_vBulkRunStarts.push_back(static_cast<uint32_t>(idx));
+        }
+    }
+    m_vBulkRunStarts.push_back(static_cast<uint32_t>(m_vBulkKeys.size()));
+
+    // Every run has its own node, so its primitives are linked without locking the primitive list
+    ParallelUtils::parallelFor(m_vBulkRunStarts.size() - 1,
+        [&](const size_t run) {
+            const uint32_t runStart = m_vBulkRunStarts[run];
+            const uint32_t runEnd   = m_vBulkRunStarts[run + 1];
+            const uint64_t key      = m_vBulkKeys[runStart].first;
+            const uint32_t depth    = static_cast<uint32_t>(key & 31u);
+            const uint64_t code     = key >> 5;
+
+            OctreeNode* pNode = m_pRootNode;
+            for (uint32_t level = 1; level < depth; ++level)
+            {
+                pNode->split();
+                const auto childIdx = static_cast<uint32_t>((code >> (3u * (m_MaxDepth - 1u - level))) & 7u);
+                pNode = &pNode->m_pChildren->m_Nodes[childIdx];
+            }
+
+            OctreePrimitive* pHead = pNode->m_pPrimitiveListHeads[type];
+            for (uint32_t idx = runEnd; idx > runStart; --idx)
+            {
+                const auto pPrimitive = m_vBulkKeys[idx - 1].second;
+                pPrimitive->m_pNode  = pNode;
+                pPrimitive->m_bValid = true;
+                pPrimitive->m_pNext  = pHead;
+                pHead = pPrimitive;
+            }
+            pNode->m_pPrimitiveListHeads[type] = pHead;
+            pNode->m_PrimitiveCounts[type]    += runEnd - runStart;
         });
 }
 
+uint64_t
+LooseOctree::computeNodeKey(const OctreePrimitive* const pPrimitive, const OctreePrimitiveType type) const
+{
+    // Mirrors OctreeNode::insertPoint/insertNonPointPrimitive and the child center computation of OctreeNode::split
+    Vec3d    center    = m_pRootNode->m_Center;
+    double   halfWidth = m_pRootNode->m_HalfWidth;
+    uint32_t depth     = 1u;
+    uint64_t code      = 0;
+
+    if (type != OctreePrimitiveType::Point || m_pRootNode->contains(pPrimitive->m_Position))
+    {
+        while (depth < m_MaxDepth)
+        {
+            uint32_t childIdx = 0;
+            if (type == OctreePrimitiveType::Point)
+            {
+                for (uint32_t dim = 0; dim < 3; ++dim)
+                {
+                    if (center[dim] < pPrimitive->m_Position[dim])
+                    {
+                        childIdx |= (1 << dim);
+                    }
+                }
+            }
+            else if (!getNonPointChildIndex(center, halfWidth, pPrimitive->m_LowerCorner, pPrimitive->m_UpperCorner, childIdx))
+            {
+                break;
+            }
+
+            const auto childHalfWidth = halfWidth * static_cast<double>(0.5);
+            center[0] += (childIdx & 1) ? childHalfWidth : -childHalfWidth;
+            center[1] += (childIdx & 2) ? childHalfWidth : -childHalfWidth;
+            center[2] += (childIdx & 4) ? childHalfWidth : -childHalfWidth;
+            halfWidth  = childHalfWidth;
+            code       = (code << 3) | childIdx;
+            ++depth;
+        }
+    }
+
+    return ((code << (3u * (m_MaxDepth - depth))) << 5) | depth;
+}
+
 void
 LooseOctree::incrementalUpdate()
 {
     // For all primitives, update their positions (if point) or bounding box (if non-point)
     // Then, check their validity (valid primitive = it is still loosely contained in the node's bounding box)
+    m_vInvalidatedNodes.clear();
     updatePositionAndCheckValidity();
     updateBoundingBoxAndCheckValidity(OctreePrimitiveType::Triangle);
     updateBoundingBoxAndCheckValidity(OctreePrimitiveType::Analytical);
 
+    // Only the nodes that contained invalid primitives have to be visited from here on
+    m_vDirtyNodes.assign(m_vInvalidatedNodes.begin(), m_vInvalidatedNodes.end());
+    tbb::parallel_sort(m_vDirtyNodes.begin(), m_vDirtyNodes.end());
+    m_vDirtyNodes.erase(std::unique(m_vDirtyNodes.begin(), m_vDirtyNodes.end()), m_vDirtyNodes.end());
+
     // Remove all invalid primitives from tree nodes
     removeInvalidPrimitivesFromNodes();
 
@@ -624,8 +799,8 @@ LooseOctree::incrementalUpdate()
     reinsertInvalidPrimitives(OctreePrimitiveType::Triangle);
     reinsertInvalidPrimitives(OctreePrimitiveType::Analytical);
 
-    // Recursively remove all empty nodes, returning them to memory pool for recycling
-    m_pRootNode->removeEmptyDescendants();
+    // Remove the nodes that became empty, returning them to memory pool for recycling
+    removeEmptyDirtyNodes();
 }
 
 void
@@ -645,23 +820,12 @@ LooseOctree::updatePositionAndCheckValidity()
             // Cache the position
             pPrimitive->m_Position = { point[0], point[1], point[2] };
 
-            auto pNode = pPrimitive->m_pNode;
-            if (!pNode->looselyContains(point) && pNode != m_pRootNode)
-            {
-                // Go up, find the node tightly containing it (or stop if reached root node)
-                while (pNode != m_pRootNode) {
-                    pNode = pNode->m_pParent; // Go up one level
-                    if (pNode->contains(point) || pNode == m_pRootNode)
-                    {
-                        pPrimitive->m_bValid = false;
-                        pPrimitive->m_pNode  = pNode;
-                        break;
-                    }
-                }
-            }
-            else
+            // Points kept at the root node are outside of the tree bounds, they are always reinserted
+            const auto pNode = pPrimitive->m_pNode;
+            pPrimitive->m_bValid = pNode != m_pRootNode && pNode->looselyContains(point);
+            if (!pPrimitive->m_bValid)
             {
-                pPrimitive->m_bValid = (pNode != m_pRootNode) ? true : false;
+                m_vInvalidatedNodes.push_back(pNode);
             }
         });
 }
@@ -680,136 +844,397 @@ LooseOctree::updateBoundingBoxAndCheckValidity(const OctreePrimitiveType type)
             computePrimitiveBoundingBox(pPrimitive, type);
             const auto lowerCorner = pPrimitive->m_LowerCorner;
             const auto upperCorner = pPrimitive->m_UpperCorner;
-            const Vec3d center(
-                (lowerCorner[0] + upperCorner[0]) * 0.5,
-                (lowerCorner[1] + upperCorner[1]) * 0.5,
-                (lowerCorner[2] + upperCorner[2]) * 0.5);
 
-            auto pNode = pPrimitive->m_pNode;
+            const auto pNode = pPrimitive->m_pNode;
             if (!pNode->looselyContains(lowerCorner, upperCorner) && pNode != m_pRootNode)
             {
-                // Go up, find the node tightly containing it (or stop if reached root node)
-                while (pNode != m_pRootNode) {
-                    pNode = pNode->m_pParent; // Go up one level
-
-                    if (pNode->contains(lowerCorner, upperCorner) || pNode == m_pRootNode)
-                    {
-                        pPrimitive->m_bValid = false;
-                        pPrimitive->m_pNode  = pNode;
-                        break;
-                    }
-                }
+                pPrimitive->m_bValid = false;
             }
             // If node still contains primitive + node depth reaches maxDepth
             else if (pNode->m_Depth == m_MaxDepth)
             {
                 pPrimitive->m_bValid = true;
             }
-            // If node still contains primitive but node depth does not reach maxDepth,
-            // then check if the primitive straddles over children nodes
+            // If node still contains primitive but node depth does not reach maxDepth, then check if the
+            // primitive straddles over children nodes, if not it has to be moved down to a child node
             else
             {
-                bool bStraddle = false;
+                uint32_t childIdx = 0;
+                pPrimitive->m_bValid = !getNonPointChildIndex(pNode->m_Center, pNode->m_HalfWidth, lowerCorner, upperCorner, childIdx);
+            }
 
-                for (uint32_t dim = 0; dim < 3; ++dim)
+            if (!pPrimitive->m_bValid)
+            {
+                m_vInvalidatedNodes.push_back(pNode);
+            }
+        });
+}
+
+void
+LooseOctree::removeInvalidPrimitivesFromNodes()
+{
+    auto removeInvalidPrimitives =
+        [](OctreeNode& pNode) {
+            for (int type = 0; type < OctreePrimitiveType::NumPrimitiveTypes; ++type)
+            {
+                const auto pOldHead = pNode.m_pPrimitiveListHeads[type];
+                if (!pOldHead)
                 {
-                    if (m_Center[dim] < center[dim])
-                    {
-                        if (pNode->m_Center[dim] - (pNode->m_HalfWidth * 0.5) > lowerCorner[dim]
-                            || pNode->m_Center[dim] + (pNode->m_HalfWidth * 1.5) < upperCorner[dim])
-                        {
-                            bStraddle = true;
-                            break;
-                        }
-                    }
-                    else
+                    continue;
+                }
+
+                OctreePrimitive* pIter    = pOldHead;
+                OctreePrimitive* pNewHead = nullptr;
+                uint32_t count = 0;
+                while (pIter) {
+                    const auto pNext = pIter->m_pNext;
+                    if (pIter->m_bValid)
                     {
-                        if (pNode->m_Center[dim] + (pNode->m_HalfWidth * 0.5) < upperCorner[dim]
-                            || pNode->m_Center[dim] - (pNode->m_HalfWidth * 1.5) > lowerCorner[dim])
-                        {
-                            bStraddle = true;
-                            break;
-                        }
+                        pIter->m_pNext = pNewHead;
+                        pNewHead       = pIter;
+                        ++count;
                     }
+                    pIter = pNext;
                 }
+                pNode.m_pPrimitiveListHeads[type] = pNewHead;
+                pNode.m_PrimitiveCounts[type]     = count;
+            }
+        };
 
-                // If the primitive straddles over children nodes, it cannot be moved down to any child node
-                if (bStraddle)
-                {
-                    pPrimitive->m_bValid = true;
-                }
-                else
+    ParallelUtils::parallelFor(m_vDirtyNodes.size(),
+        [&](const size_t idx) {
+            removeInvalidPrimitives(*m_vDirtyNodes[idx]);
+        });
+}
+
+void
+LooseOctree::removeEmptyDirtyNodes()
+{
+    // Going up from every dirty node, remove the children of a node while they are all empty leaf nodes
+    // A node whose parent is a leaf node has already been returned to the memory pool
+    for (const auto pDirtyNode : m_vDirtyNodes)
+    {
+        auto pNode = pDirtyNode;
+        while (pNode != m_pRootNode && !pNode->m_pParent->isLeaf()) {
+            const auto pParent    = pNode->m_pParent;
+            bool       bAllEmpty  = true;
+            for (uint32_t childIdx = 0; childIdx < 8u && bAllEmpty; ++childIdx)
+            {
+                const auto& childNode = pParent->m_pChildren->m_Nodes[childIdx];
+                bAllEmpty &= childNode.isLeaf();
+                for (int type = 0; type < OctreePrimitiveType::NumPrimitiveTypes; ++type)
                 {
-                    // Move the primitive down to a child node
-                    pPrimitive->m_bValid = false;
-                    pPrimitive->m_pNode  = pNode;
+                    bAllEmpty &= (childNode.m_PrimitiveCounts[type] == 0);
                 }
             }
-        });
+            if (!bAllEmpty)
+            {
+                break;
+            }
+            returnChildrenToPool(pParent->m_pChildren);
+            pParent->m_bIsLeaf = true;
+            pNode = pParent;
+        }
+    }
 }
 
 void
-LooseOctree::removeInvalidPrimitivesFromNodes()
+LooseOctree::reinsertInvalidPrimitives(const OctreePrimitiveType type)
 {
-    if (m_sActiveTreeNodeBlocks.size() == 0)
+    const auto& vPrimitivePtrs = m_vPrimitivePtrs[type];
+    if (vPrimitivePtrs.size() == 0)
     {
         return;
     }
-    tbb::parallel_for(m_sActiveTreeNodeBlocks.range(),
-        [&](decltype(m_sActiveTreeNodeBlocks)::const_range_type& r) {
-            for (auto it = r.begin(), iEnd = r.end(); it != iEnd; ++it)
+
+    m_vBulkPrimitivePtrs.resize(0);
+    for (const auto pPrimitive : vPrimitivePtrs)
+    {
+        if (!pPrimitive->m_bValid)
+        {
+            m_vBulkPrimitivePtrs.push_back(pPrimitive);
+        }
+    }
+    insertPrimitivesInBulk(m_vBulkPrimitivePtrs, type);
+}
+
+void
+LooseOctree::getPrimitivesInAABB(std::vector<OctreePrimitive*>& result, const OctreePrimitiveType type,
+                                 const Vec3d& lowerCorner, const Vec3d& upperCorner) const
+{
+    result.resize(0);
+
+    const std::array<double, 3> lower = { lowerCorner[0], lowerCorner[1], lowerCorner[2] };
+    const std::array<double, 3> upper = { upperCorner[0], upperCorner[1], upperCorner[2] };
+
+    // Nodes other than the root node loosely contain all primitives of their subtree
+    std::vector<OctreeNode*> nodeStack(1, m_pRootNode);
+    while (!nodeStack.empty()) {
+        const auto pNode = nodeStack.back();
+        nodeStack.pop_back();
+        if (pNode != m_pRootNode && !pNode->looselyOverlaps(lower, upper))
+        {
+            continue;
+        }
+
+        for (auto pPrimitive = pNode->m_pPrimitiveListHeads[type]; pPrimitive; pPrimitive = pPrimitive->m_pNext)
+        {
+            const auto& primitiveLower = (type == OctreePrimitiveType::Point) ? pPrimitive->m_Position : pPrimitive->m_LowerCorner;
+            const auto& primitiveUpper = (type == OctreePrimitiveType::Point) ? pPrimitive->m_Position : pPrimitive->m_UpperCorner;
+            if (primitiveUpper[0] >= lower[0] && primitiveUpper[1] >= lower[1] && primitiveUpper[2] >= lower[2]
+                && primitiveLower[0] <= upper[0] && primitiveLower[1] <= upper[1] && primitiveLower[2] <= upper[2])
             {
-                const auto pNodeBlock = *it;
-                for (uint32_t childIdx = 0; childIdx < 8u; ++childIdx)
-                {
-                    auto& pNode = pNodeBlock->m_Nodes[childIdx];
-                    for (int type = 0; type < OctreePrimitiveType::NumPrimitiveTypes; ++type)
-                    {
-                        const auto pOldHead = pNode.m_pPrimitiveListHeads[type];
-                        if (!pOldHead)
-                        {
-                            continue;
-                        }
+                result.push_back(pPrimitive);
+            }
+        }
 
-                        OctreePrimitive* pIter    = pOldHead;
-                        OctreePrimitive* pNewHead = nullptr;
-                        uint32_t count = 0;
-                        while (pIter) {
-                            const auto pNext = pIter->m_pNext;
-                            if (pIter->m_bValid)
-                            {
-                                pIter->m_pNext = pNewHead;
-                                pNewHead       = pIter;
-                                ++count;
-                            }
-                            pIter = pNext;
-                        }
-                        pNode.m_pPrimitiveListHeads[type] = pNewHead;
-                        pNode.m_PrimitiveCounts[type]     = count;
-                    }
-                }
+        if (!pNode->isLeaf())
+        {
+            for (uint32_t childIdx = 0; childIdx < 8u; ++childIdx)
+            {
+                nodeStack.push_back(&pNode->m_pChildren->m_Nodes[childIdx]);
             }
+        }
+    }
+}
+
+void
+LooseOctree::getPrimitivesInAABBs(std::vector<std::vector<OctreePrimitive*>>& result, const OctreePrimitiveType type,
+                                  const VecDataArray<double, 3>& lowerCorners, const VecDataArray<double, 3>& upperCorners) const
+{
+    CHECK(lowerCorners.size() == upperCorners.size()) << "Number of lower and upper corners differ";
+
+    result.resize(lowerCorners.size());
+    ParallelUtils::parallelFor(lowerCorners.size(),
+        [&](const size_t idx) {
+            getPrimitivesInAABB(result[idx], type, lowerCorners[idx], upperCorners[idx]);
         });
 }
 
 void
-LooseOctree::reinsertInvalidPrimitives(const OctreePrimitiveType type)
+LooseOctree::getKNearestPoints(std::vector<OctreePrimitive*>& result, const Vec3d& pos, const uint32_t k) const
 {
-    const auto& vPrimitivePtrs = m_vPrimitivePtrs[type];
-    if (vPrimitivePtrs.size() == 0)
+    result.resize(0);
+    if (k == 0)
     {
         return;
     }
-    ParallelUtils::parallelFor(vPrimitivePtrs.size(),
+
+    // Best first traversal, nodes are visited by increasing distance to their loose bounds
+    // and the k nearest points found so far are kept in a max heap
+    using NodeEntry      = std::pair<double, OctreeNode*>;
+    using PrimitiveEntry = std::pair<double, OctreePrimitive*>;
+    std::priority_queue<NodeEntry, std::vector<NodeEntry>, std::greater<NodeEntry>> nodeQueue;
+    std::vector<PrimitiveEntry>                                                     nearest;
+    nearest.reserve(k);
+
+    nodeQueue.push(NodeEntry(0.0, m_pRootNode));
+    while (!nodeQueue.empty()) {
+        const NodeEntry entry = nodeQueue.top();
+        nodeQueue.pop();
+        if (nearest.size() == k && entry.first > nearest.front().first)
+        {
+            break;
+        }
+
+        const auto pNode = entry.second;
+        for (auto pPrimitive = pNode->m_pPrimitiveListHeads[OctreePrimitiveType::Point]; pPrimitive; pPrimitive = pPrimitive->m_pNext)
+        {
+            const double dist2 = (pos - Vec3d(pPrimitive->m_Position[0], pPrimitive->m_Position[1], pPrimitive->m_Position[2])).squaredNorm();
+            if (nearest.size() < k)
+            {
+                nearest.push_back(PrimitiveEntry(dist2, pPrimitive));
+                std::push_heap(nearest.begin(), nearest.end());
+            }
+            else if (dist2 < nearest.front().first)
+            {
+                std::pop_heap(nearest.begin(), nearest.end());
+                nearest.back() = PrimitiveEntry(dist2, pPrimitive);
+                std::push_heap(nearest.begin(), nearest.end());
+            }
+        }
+
+        if (!pNode->isLeaf())
+        {
+            for (uint32_t childIdx = 0; childIdx < 8u; ++childIdx)
+            {
+                const auto   pChildNode = &pNode->m_pChildren->m_Nodes[childIdx];
+                const double dist2      = SpatialQueryUtils::squaredDistanceToBox(pos, pChildNode->m_LowerExtendedBound, pChildNode->m_UpperExtendedBound);
+                if (nearest.size() < k || dist2 <= nearest.front().first)
+                {
+                    nodeQueue.push(NodeEntry(dist2, pChildNode));
+                }
+            }
+        }
+    }
+
+    std::sort_heap(nearest.begin(), nearest.end());
+    for (const auto& primitiveEntry : nearest)
+    {
+        result.push_back(primitiveEntry.second);
+    }
+}
+
+void
+LooseOctree::getKNearestPoints(std::vector<std::vector<OctreePrimitive*>>& result, const VecDataArray<double, 3>& positions, const uint32_t k) const
+{
+    result.resize(positions.size());
+    ParallelUtils::parallelFor(positions.size(),
         [&](const size_t idx) {
-            const auto pPrimitive = vPrimitivePtrs[idx];
-            if (pPrimitive->m_bValid)
+            getKNearestPoints(result[idx], positions[idx], k);
+        });
+}
+
+OctreePrimitive*
+LooseOctree::getClosestPrimitive(const OctreePrimitiveType type, const Vec3d& pos, double& distance) const
+{
+    auto primitiveSquaredDistance =
+        [&](const OctreePrimitive* const pPrimitive) -> double
+        {
+            if (type == OctreePrimitiveType::Point)
             {
-                return;
+                return (pos - Vec3d(pPrimitive->m_Position[0], pPrimitive->m_Position[1], pPrimitive->m_Position[2])).squaredNorm();
             }
+            else if (type == OctreePrimitiveType::Triangle)
+            {
+                const auto  surfMesh = static_cast<SurfaceMesh*>(pPrimitive->m_pGeometry);
+                const auto& face     = (*surfMesh->getTriangleIndices())[pPrimitive->m_Idx];
+                return (pos - closestPointOnTriangle(pos, surfMesh->getVertexPosition(face[0]),
+                    surfMesh->getVertexPosition(face[1]), surfMesh->getVertexPosition(face[2]))).squaredNorm();
+            }
+            const auto implicitGeom = dynamic_cast<ImplicitGeometry*>(pPrimitive->m_pGeometry);
+            if (implicitGeom)
+            {
+                const double value = std::max(implicitGeom->getFunctionValue(pos), 0.0);
+                return value * value;
+            }
+            return SpatialQueryUtils::squaredDistanceToBox(pos,
+                Vec3d(pPrimitive->m_LowerCorner[0], pPrimitive->m_LowerCorner[1], pPrimitive->m_LowerCorner[2]),
+                Vec3d(pPrimitive->m_UpperCorner[0], pPrimitive->m_UpperCorner[1], pPrimitive->m_UpperCorner[2]));
+        };
 
-            const auto pNode = pPrimitive->m_pNode;
-            (type == OctreePrimitiveType::Point) ? pNode->insertPoint(pPrimitive) : pNode->insertNonPointPrimitive(pPrimitive, type);
+    // Best first traversal, nodes are visited by increasing distance to their loose bounds
+    using NodeEntry = std::pair<double, OctreeNode*>;
+    std::priority_queue<NodeEntry, std::vector<NodeEntry>, std::greater<NodeEntry>> nodeQueue;
+    OctreePrimitive*                                                                pClosest = nullptr;
+    double                                                                          minDist2 = IMSTK_DOUBLE_MAX;
+
+    nodeQueue.push(NodeEntry(0.0, m_pRootNode));
+    while (!nodeQueue.empty()) {
+        const NodeEntry entry = nodeQueue.top();
+        nodeQueue.pop();
+        if (entry.first > minDist2)
+        {
+            break;
+        }
+
+        const auto pNode = entry.second;
+        for (auto pPrimitive = pNode->m_pPrimitiveListHeads[type]; pPrimitive; pPrimitive = pPrimitive->m_pNext)
+        {
+            const double dist2 = primitiveSquaredDistance(pPrimitive);
+            if (dist2 < minDist2)
+            {
+                minDist2 = dist2;
+                pClosest = pPrimitive;
+            }
+        }
+
+        if (!pNode->isLeaf())
+        {
+            for (uint32_t childIdx = 0; childIdx < 8u; ++childIdx)
+            {
+                const auto   pChildNode = &pNode->m_pChildren->m_Nodes[childIdx];
+                const double dist2      = SpatialQueryUtils::squaredDistanceToBox(pos, pChildNode->m_LowerExtendedBound, pChildNode->m_UpperExtendedBound);
+                if (dist2 <= minDist2)
+                {
+                    nodeQueue.push(NodeEntry(dist2, pChildNode));
+                }
+            }
+        }
+    }
+
+    distance = pClosest ? std::sqrt(minDist2) : IMSTK_DOUBLE_MAX;
+    return pClosest;
+}
+
+void
+LooseOctree::getClosestPrimitives(std::vector<OctreePrimitive*>& result, std::vector<double>& distances,
+                                  const OctreePrimitiveType type, const VecDataArray<double, 3>& positions) const
+{
+    result.resize(positions.size());
+    distances.resize(positions.size());
+    ParallelUtils::parallelFor(positions.size(),
+        [&](const size_t idx) {
+            result[idx] = getClosestPrimitive(type, positions[idx], distances[idx]);
+        });
+}
+
+OctreePrimitive*
+LooseOctree::castRay(const Vec3d& origin, const Vec3d& direction, const double maxT, double& t) const
+{
+    const Vec3d invDirection = direction.cwiseInverse();
+
+    OctreePrimitive* pHit = nullptr;
+    t = maxT;
+
+    // Depth first traversal visiting children nodes in order of ray entry, pruned by the closest hit so far
+    using NodeEntry = std::pair<double, OctreeNode*>;
+    std::vector<NodeEntry> nodeStack(1, NodeEntry(0.0, m_pRootNode));
+    while (!nodeStack.empty()) {
+        const NodeEntry entry = nodeStack.back();
+        nodeStack.pop_back();
+        if (entry.first > t)
+        {
+            continue;
+        }
+
+        const auto pNode = entry.second;
+        for (auto pPrimitive = pNode->m_pPrimitiveListHeads[OctreePrimitiveType::Triangle]; pPrimitive; pPrimitive = pPrimitive->m_pNext)
+        {
+            const auto  surfMesh = static_cast<SurfaceMesh*>(pPrimitive->m_pGeometry);
+            const auto& face     = (*surfMesh->getTriangleIndices())[pPrimitive->m_Idx];
+            double      tHit     = 0.0;
+            if (SpatialQueryUtils::rayIntersectsTriangle(origin, direction, surfMesh->getVertexPosition(face[0]),
+                surfMesh->getVertexPosition(face[1]), surfMesh->getVertexPosition(face[2]), t, tHit))
+            {
+                t    = tHit;
+                pHit = pPrimitive;
+            }
+        }
+
+        if (!pNode->isLeaf())
+        {
+            // Push the farthest children first such that the nearest is visited first
+            NodeEntry childEntries[8];
+            uint32_t  numChildEntries = 0;
+            for (uint32_t childIdx = 0; childIdx < 8u; ++childIdx)
+            {
+                const auto pChildNode = &pNode->m_pChildren->m_Nodes[childIdx];
+                double     tEntry     = 0.0;
+                if (SpatialQueryUtils::rayIntersectsBox(origin, invDirection, pChildNode->m_LowerExtendedBound, pChildNode->m_UpperExtendedBound, t, tEntry))
+                {
+                    childEntries[numChildEntries++] = NodeEntry(tEntry, pChildNode);
+                }
+            }
+            std::sort(childEntries, childEntries + numChildEntries, std::greater<NodeEntry>());
+            nodeStack.insert(nodeStack.end(), childEntries, childEntries + numChildEntries);
+        }
+    }
+
+    return pHit;
+}
+
+void
+LooseOctree::castRays(std::vector<OctreePrimitive*>& result, std::vector<double>& ts,
+                      const VecDataArray<double, 3>& origins, const VecDataArray<double, 3>& directions, const double maxT) const
+{
+    CHECK(origins.size() == directions.size()) << "Number of ray origins and directions differ";
+
+    result.resize(origins.size());
+    ts.resize(origins.size());
+    ParallelUtils::parallelFor(origins.size(),
+        [&](const size_t idx) {
+            result[idx] = castRay(origins[idx], directions[idx], maxT, ts[idx]);
         });
 }
 
@@ -23,6 +23,7 @@
 
 #include "imstkMath.h"
 #include "imstkParallelUtils.h"
+#include "imstkVecDataArray.h"
 
 #include <array>
 #include <unordered_set>
@@ -444,6 +445,70 @@ public:
     ///
     void update();
 
+    ///
+    /// \brief Find the primitives of the given type overlapping an AABB
+    /// Points are tested by position, other primitives by their bounding box as of the last build/update
+    /// \param result The primitives found
+    /// \param type The type of primitives to search
+    /// \param lowerCorner The lower corner of the box
+    /// \param upperCorner The upper corner of the box
+    ///
+    void getPrimitivesInAABB(std::vector<OctreePrimitive*>& result, const OctreePrimitiveType type,
+                             const Vec3d& lowerCorner, const Vec3d& upperCorner) const;
+
+    ///
+    /// \brief Batched version of getPrimitivesInAABB, the queries are done in parallel
+    ///
+    void getPrimitivesInAABBs(std::vector<std::vector<OctreePrimitive*>>& result, const OctreePrimitiveType type,
+                              const VecDataArray<double, 3>& lowerCorners, const VecDataArray<double, 3>& upperCorners) const;
+
+    ///
+    /// \brief Find the k point primitives nearest to a position, sorted by increasing distance
+    /// \param result The points found, fewer than k if the tree has less points
+    /// \param pos The query position
+    /// \param k The number of points to find
+    ///
+    void getKNearestPoints(std::vector<OctreePrimitive*>& result, const Vec3d& pos, const uint32_t k) const;
+
+    ///
+    /// \brief Batched version of getKNearestPoints, the queries are done in parallel
+    ///
+    void getKNearestPoints(std::vector<std::vector<OctreePrimitive*>>& result, const VecDataArray<double, 3>& positions, const uint32_t k) const;
+
+    ///
+    /// \brief Find the primitive of the given type closest to a position
+    /// Triangles use their current vertex positions, analytical geometries their implicit
+    /// function if available, or else their bounding box
+    /// \param type The type of primitives to search
+    /// \param pos The query position
+    /// \param distance The distance to the closest primitive
+    /// \return The closest primitive, nullptr if there is no primitive of that type
+    ///
+    OctreePrimitive* getClosestPrimitive(const OctreePrimitiveType type, const Vec3d& pos, double& distance) const;
+
+    ///
+    /// \brief Batched version of getClosestPrimitive, the queries are done in parallel
+    ///
+    void getClosestPrimitives(std::vector<OctreePrimitive*>& result, std::vector<double>& distances,
+                              const OctreePrimitiveType type, const VecDataArray<double, 3>& positions) const;
+
+    ///
+    /// \brief Find the first triangle primitive hit by the ray origin + t * direction, t in [0, maxT]
+    /// A segment [a, b] is cast with origin = a, direction = b - a and maxT = 1
+    /// \param origin Origin of the ray
+    /// \param direction Direction of the ray, need not be normalized
+    /// \param maxT The maximum ray parameter
+    /// \param t The ray parameter of the hit
+    /// \return The hit triangle primitive, nullptr if there is no hit
+    ///
+    OctreePrimitive* castRay(const Vec3d& origin, const Vec3d& direction, const double maxT, double& t) const;
+
+    ///
+    /// \brief Batched version of castRay, the queries are done in parallel
+    ///
+    void castRays(std::vector<OctreePrimitive*>& result, std::vector<double>& ts,
+                  const VecDataArray<double, 3>& origins, const VecDataArray<double, 3>& directions, const double maxT) const;
+
 protected:
     ///
     /// \brief Add geometry to the internal geometry list to check for duplication
@@ -471,6 +536,20 @@ protected:
     ///
     void populateNonPointPrimitives(const OctreePrimitiveType type);
 
+    ///
+    /// \brief Insert primitives into the tree in bulk
+    /// The node each primitive goes to by a top-down insertion is computed in parallel and encoded
+    /// as a Morton ordered key, the primitives are sorted by key, then each run of primitives
+    /// sharing a node is linked into that node at once, in parallel over the runs
+    ///
+    void insertPrimitivesInBulk(const std::vector<OctreePrimitive*>& vPrimitivePtrs, const OctreePrimitiveType type);
+
+    ///
+    /// \brief Compute the key of the node a primitive goes to by a top-down insertion from the root node
+    /// The key stores the child indices along the path from the root (aligned to max depth) and the depth of the node
+    ///
+    uint64_t computeNodeKey(const OctreePrimitive* const pPrimitive, const OctreePrimitiveType type) const;
+
     ///
     /// \brief Incrementally update octree from current state
     ///
@@ -478,13 +557,14 @@ protected:
 
     ///
     /// \brief For each point primitive, update its position from its parent geometry and check if it is still loosely contained in the tree node
-    /// If the primitive is not loosely contained in tree node, set it to invalid state and set m_pNode to the lowest ancestor node that tightly contains it
+    /// If the primitive is not loosely contained in tree node, set it to invalid state and record its node as invalidated
     ///
     void updatePositionAndCheckValidity();
 
     ///
     /// \brief For each non-point primitive, update its bounding box from its parent geometry and check if it is still loosely contained in the tree node
-    /// If the primitive is not loosely contained in tree node, set it to invalid state and set m_pNode to the lowest ancestor node that tightly contains it
+    /// If the primitive is not loosely contained in tree node, or could be moved down to a child node, set it to invalid state
+    /// and record its node as invalidated
     ///
     void updateBoundingBoxAndCheckValidity(const OctreePrimitiveType type);
 
@@ -494,8 +574,13 @@ protected:
     void removeInvalidPrimitivesFromNodes();
 
     ///
-    /// \brief For each invalid primitive, insert it back to the tree in a top-down manner
-    /// starting from the lowest ancestor node that tightly contains it (that node was found during validity check)
+    /// \brief Remove the descendants of the ancestors of nodes that previously contained invalid primitives,
+    /// if they have become empty
+    ///
+    void removeEmptyDirtyNodes();
+
+    ///
+    /// \brief Insert all invalid primitives back to the tree in bulk, in a top-down manner from the root node
     ///
     void reinsertInvalidPrimitives(const OctreePrimitiveType type);
 
@@ -559,6 +644,15 @@ protected:
     /// List of all indices of the added geometries, to check for duplication such that one geometry cannot be mistakenly added multiple times
     std::unordered_set<uint32_t> m_sGeometryIndices;
 
+    /// Buffers for bulk insertion: primitives to insert, (node key, primitive) pairs and the starts of runs sharing a node
+    std::vector<OctreePrimitive*>                      m_vBulkPrimitivePtrs;
+    std::vector<std::pair<uint64_t, OctreePrimitive*>> m_vBulkKeys;
+    std::vector<uint32_t>                              m_vBulkRunStarts;
+
+    /// Nodes that contained primitives invalidated during an incremental update, and the same without duplicates
+    tbb::concurrent_vector<OctreeNode*> m_vInvalidatedNodes;
+    std::vector<OctreeNode*>            m_vDirtyNodes;
+
     bool m_bAlwaysRebuild = false;                        ///> If true, the octree is always be rebuit from scratch every time calling to update()
     bool m_bCompleteBuild = false;                        ///> This is set to true after tree has been built, otherwise false
 
@@ -20,9 +20,10 @@
 
 =========================================================================*/
 
+#include "imstkCSRNeighborList.h"
 #include "imstkGridBasedNeighborSearch.h"
-#include "imstkSpatialHashTableSeparateChaining.h"
 #include "imstkNeighborSearch.h"
+#include "imstkSpatialHashTableOpenAddressing.h"
 #include "imstkParallelUtils.h"
 
 namespace imstk
@@ -37,7 +38,7 @@ NeighborSearch::NeighborSearch(NeighborSearch::Method searchMethod, double searc
     }
     else
     {
-        m_SpatialHashSearcher = std::make_shared<SpatialHashTableSeparateChaining>();
+        m_SpatialHashSearcher = std::make_shared<SpatialHashTableOpenAddressing>();
         m_SpatialHashSearcher->setCellSize(m_SearchRadius, m_SearchRadius, m_SearchRadius);
     }
 }
@@ -82,6 +83,7 @@ NeighborSearch::getNeighbors(std::vector<std::vector<size_t>>& result, const Vec
         m_SpatialHashSearcher->clear();
         m_SpatialHashSearcher->insertPoints(setB);
 
+        result.resize(setA.size());
         ParallelUtils::parallelFor(setA.size(),
             [&](const size_t p) {
                 // For each point in setA, find neighbors in setB
@@ -89,4 +91,26 @@ NeighborSearch::getNeighbors(std::vector<std::vector<size_t>>& result, const Vec
             });
     }
 }
+
+void
+NeighborSearch::getNeighbors(CSRNeighborList& result, const VecDataArray<double, 3>& points)
+{
+    getNeighbors(result, points, points);
+}
+
+void
+NeighborSearch::getNeighbors(CSRNeighborList& result, const VecDataArray<double, 3>& setA, const VecDataArray<double, 3>& setB)
+{
+    if (m_Method == Method::UniformGridBasedSearch)
+    {
+        m_GridBasedSearcher->getNeighbors(result, setA, setB);
+    }
+    else
+    {
+        m_SpatialHashSearcher->clear();
+        m_SpatialHashSearcher->insertPoints(setB);
+
+        m_SpatialHashSearcher->getPointsInSpheres(result, setA, m_SearchRadius);
+    }
+}
 } // end namespace imstk
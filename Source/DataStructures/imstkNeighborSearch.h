@@ -26,8 +26,9 @@
 
 namespace imstk
 {
+class CSRNeighborList;
 class GridBasedNeighborSearch;
-class SpatialHashTableSeparateChaining;
+class SpatialHashTableOpenAddressing;
 
 ///
 /// \class NeighborSearch
@@ -80,11 +81,26 @@ public:
     ///
     void getNeighbors(std::vector<std::vector<size_t>>& result, const VecDataArray<double, 3>& setA, const VecDataArray<double, 3>& setB);
 
+    ///
+    /// \brief Search neighbors for each point within the search radius, output in CSR layout
+    /// \param result The neighbor lists of each point
+    /// \param points The given points to search for neighbors
+    ///
+    void getNeighbors(CSRNeighborList& result, const VecDataArray<double, 3>& points);
+
+    ///
+    /// \brief Search neighbors from setB for each point in setA within the search radius, output in CSR layout
+    /// \param result The neighbor lists of each point in setA
+    /// \param setA The point set for which performing neighbor search
+    /// \param setB The point set where neighbor indices will be collected
+    ///
+    void getNeighbors(CSRNeighborList& result, const VecDataArray<double, 3>& setA, const VecDataArray<double, 3>& setB);
+
 private:
     Method m_Method;
     double m_SearchRadius = 0.0;
 
     std::shared_ptr<GridBasedNeighborSearch> m_GridBasedSearcher;
-    std::shared_ptr<SpatialHashTableSeparateChaining> m_SpatialHashSearcher;
+    std::shared_ptr<SpatialHashTableOpenAddressing> m_SpatialHashSearcher;
 };
 } // end namespace imstk
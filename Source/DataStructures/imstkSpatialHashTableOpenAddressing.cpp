@@ -0,0 +1,359 @@
+/*=========================================================================
+
+   Library: iMSTK
+
+   Copyright (c) Kitware, Inc. & Center for Modeling, Simulation,
+   & Imaging in Medicine, Rensselaer Polytechnic Institute.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+=========================================================================*/
+
+#include "imstkSpatialHashTableOpenAddressing.h"
+#include "imstkParallelUtils.h"
+
+namespace imstk
+{
+namespace
+{
+constexpr int      CellKeyBits = 21;
+constexpr int      CellKeyBias = 1 << (CellKeyBits - 1);
+constexpr uint64_t CellKeyMask = (static_cast<uint64_t>(1) << CellKeyBits) - 1;
+}
+
+SpatialHashTableOpenAddressing::SpatialHashTableOpenAddressing() : SpatialHashTable()
+{
+    this->clear();
+}
+
+void
+SpatialHashTableOpenAddressing::insertPoints(const VecDataArray<double, 3>& points)
+{
+    const size_t prevNumPoints = m_Points.size();
+    m_Points.resize(prevNumPoints + points.size());
+    for (int i = 0; i < points.size(); i++)
+    {
+        m_Points[prevNumPoints + i] = points[i];
+    }
+    rehash();
+}
+
+void
+SpatialHashTableOpenAddressing::insertPoint(const Vec3d& point)
+{
+    // There are never more cells than points, growing the table when the points exceed half the
+    // slots keeps the load factor at or below one half with an amortized constant cost per point
+    const size_t id = m_Points.size();
+    m_Points.push_back(point);
+    if (2 * m_Points.size() > m_SlotKeys.size())
+    {
+        rehash();
+        return;
+    }
+
+    // Otherwise link the point in the pending list of its cell, it is sorted on the next rehash
+    const size_t slot = insertCellKey(getCellKey(getCellCoords(point)));
+    if (m_SlotPendingHeads[slot] == EmptyPoint && m_SlotCells[slot].count.load(std::memory_order_relaxed) == 0)
+    {
+        m_NumCells++;
+    }
+    m_PendingNext.push_back(m_SlotPendingHeads[slot]);
+    m_SlotPendingHeads[slot] = static_cast<uint32_t>(id);
+}
+
+void
+SpatialHashTableOpenAddressing::clear()
+{
+    m_Points.resize(0);
+    m_SortedPoints.resize(0);
+    m_SortedIndices.resize(0);
+    m_SlotKeys.assign(1, EmptyKey);
+    m_SlotCells.assign(1, CellPointRange());
+    m_SlotPendingHeads.assign(1, EmptyPoint);
+    m_PendingNext.resize(0);
+    m_NumCells = 0;
+}
+
+void
+SpatialHashTableOpenAddressing::setCellSize(double x, double y, double z)
+{
+    m_cellSize[0] = x;
+    m_cellSize[1] = y;
+    m_cellSize[2] = z;
+
+    rehash();
+}
+
+void
+SpatialHashTableOpenAddressing::rehash()
+{
+    const size_t numPoints = m_Points.size();
+
+    // Keep the load factor at or below one half, there are never more cells than points
+    size_t capacity = 16;
+    while (capacity < 2 * numPoints)
+    {
+        capacity <<= 1;
+    }
+    m_SlotKeys.assign(capacity, EmptyKey);
+    m_SlotCells.assign(capacity, CellPointRange());
+    m_SlotPendingHeads.assign(capacity, EmptyPoint);
+    m_PendingNext.resize(0);
+    m_PointSlots.resize(numPoints);
+    m_PointCellOffsets.resize(numPoints);
+    m_SortedPoints.resize(numPoints);
+    m_SortedIndices.resize(numPoints);
+
+    // Insert the cell of every point, the pre-increment count gives the index of the point within its cell
+    ParallelUtils::parallelFor(numPoints,
+        [&](const size_t p)
+        {
+            const size_t slot = insertCellKey(getCellKey(getCellCoords(m_Points[p])));
+            m_PointSlots[p]       = static_cast<uint32_t>(slot);
+            m_PointCellOffsets[p] = m_SlotCells[slot].count.fetch_add(1, std::memory_order_relaxed);
+        });
+
+    // Prefix sum of the counts gives the range of each cell in the sorted arrays
+    uint32_t first = 0;
+    m_NumCells = 0;
+    for (size_t slot = 0; slot < capacity; slot++)
+    {
+        const uint32_t count = m_SlotCells[slot].count.load(std::memory_order_relaxed);
+        m_SlotCells[slot].first = first;
+        first      += count;
+        m_NumCells += (count > 0) ? 1 : 0;
+    }
+
+    ParallelUtils::parallelFor(numPoints,
+        [&](const size_t p)
+        {
+            const uint32_t idx = m_SlotCells[m_PointSlots[p]].first + m_PointCellOffsets[p];
+            m_SortedPoints[idx]  = m_Points[p];
+            m_SortedIndices[idx] = static_cast<uint32_t>(p);
+        });
+}
+
+Vec3i
+SpatialHashTableOpenAddressing::getCellCoords(const Vec3d& pos) const
+{
+    // Clamp before casting so far away points do not overflow, cells wrap around in the key anyways
+    Vec3i cell;
+    for (int d = 0; d < 3; d++)
+    {
+        cell[d] = static_cast<int>(std::max(std::min(std::floor(pos[d] / m_cellSize[d]), 1.0e9), -1.0e9));
+    }
+    return cell;
+}
+
+uint64_t
+SpatialHashTableOpenAddressing::getCellKey(const Vec3i& cell)
+{
+    return (static_cast<uint64_t>(cell[0] + CellKeyBias) & CellKeyMask)
+           | ((static_cast<uint64_t>(cell[1] + CellKeyBias) & CellKeyMask) << CellKeyBits)
+           | ((static_cast<uint64_t>(cell[2] + CellKeyBias) & CellKeyMask) << (2 * CellKeyBits));
+}
+
+uint64_t
+SpatialHashTableOpenAddressing::hashCellKey(uint64_t key)
+{
+    // splitmix64 finalizer, every input bit affects every output bit
+    key ^= key >> 30;
+    key *= 0xbf58476d1ce4e5b9ULL;
+    key ^= key >> 27;
+    key *= 0x94d049bb133111ebULL;
+    key ^= key >> 31;
+    return key;
+}
+
+size_t
+SpatialHashTableOpenAddressing::insertCellKey(const uint64_t key)
+{
+    const size_t mask = m_SlotKeys.size() - 1;
+    size_t       slot = static_cast<size_t>(hashCellKey(key)) & mask;
+    while (true)
+    {
+        std::atomic<uint64_t>& slotKey = m_SlotKeys[slot].key;
+        uint64_t               current = slotKey.load(std::memory_order_relaxed);
+        if (current == EmptyKey && slotKey.compare_exchange_strong(current, key, std::memory_order_relaxed))
+        {
+            return slot;
+        }
+        // Either occupied before, or another thread claimed the slot first (current now holds its key)
+        if (current == key)
+        {
+            return slot;
+        }
+        slot = (slot + 1) & mask;
+    }
+}
+
+size_t
+SpatialHashTableOpenAddressing::findCellKey(const uint64_t key) const
+{
+    const size_t mask = m_SlotKeys.size() - 1;
+    size_t       slot = static_cast<size_t>(hashCellKey(key)) & mask;
+    uint64_t     current;
+    while ((current = m_SlotKeys[slot].key.load(std::memory_order_relaxed)) != EmptyKey)
+    {
+        if (current == key)
+        {
+            return slot;
+        }
+        slot = (slot + 1) & mask;
+    }
+    return EmptySlot;
+}
+
+template<typename Function>
+void
+SpatialHashTableOpenAddressing::forEachPointInCells(const Vec3d& lower, const Vec3d& upper, Function&& func) const
+{
+    const Vec3i lowerCell = getCellCoords(lower);
+    const Vec3i upperCell = getCellCoords(upper);
+
+    // When the box spans more cells than are occupied, scanning all points is cheaper than probing
+    double numCellsInBox = 1.0;
+    for (int d = 0; d < 3; d++)
+    {
+        numCellsInBox *= static_cast<double>(upperCell[d] - lowerCell[d] + 1);
+    }
+    if (numCellsInBox > static_cast<double>(m_NumCells) || (upperCell - lowerCell).maxCoeff() >= (1 << CellKeyBits))
+    {
+        for (size_t i = 0; i < m_SortedIndices.size(); i++)
+        {
+            func(m_SortedIndices[i], m_SortedPoints[i]);
+        }
+        for (size_t id = m_SortedIndices.size(); id < m_Points.size(); id++)
+        {
+            func(static_cast<uint32_t>(id), m_Points[id]);
+        }
+        return;
+    }
+
+    Vec3i cell;
+    for (cell[2] = lowerCell[2]; cell[2] <= upperCell[2]; cell[2]++)
+    {
+        for (cell[1] = lowerCell[1]; cell[1] <= upperCell[1]; cell[1]++)
+        {
+            for (cell[0] = lowerCell[0]; cell[0] <= upperCell[0]; cell[0]++)
+            {
+                const size_t slot = findCellKey(getCellKey(cell));
+                if (slot == EmptySlot)
+                {
+                    continue;
+                }
+                const CellPointRange& cellData = m_SlotCells[slot];
+                const uint32_t        end      = cellData.first + cellData.count.load(std::memory_order_relaxed);
+                for (uint32_t i = cellData.first; i < end; i++)
+                {
+                    func(m_SortedIndices[i], m_SortedPoints[i]);
+                }
+                for (uint32_t id = m_SlotPendingHeads[slot]; id != EmptyPoint; id = m_PendingNext[id - m_SortedIndices.size()])
+                {
+                    func(id, m_Points[id]);
+                }
+            }
+        }
+    }
+}
+
+std::vector<size_t>
+SpatialHashTableOpenAddressing::getPointsInAABB(const Vec3d& corner1, const Vec3d& corner2) const
+{
+    std::vector<size_t> result;
+    getPointsInAABB(result, corner1, corner2);
+    return result;
+}
+
+void
+SpatialHashTableOpenAddressing::getPointsInAABB(std::vector<size_t>& result, const Vec3d& corner1, const Vec3d& corner2) const
+{
+    const Vec3d lower = corner1.cwiseMin(corner2);
+    const Vec3d upper = corner1.cwiseMax(corner2);
+
+    // clear the old result (if applicable)
+    result.resize(0);
+    forEachPointInCells(lower, upper, [&](const uint32_t id, const Vec3d& pos)
+        {
+            if ((pos.array() >= lower.array()).all() && (pos.array() <= upper.array()).all())
+            {
+                result.push_back(id);
+            }
+        });
+}
+
+std::vector<size_t>
+SpatialHashTableOpenAddressing::getPointsInSphere(const Vec3d& ppos, const double radius) const
+{
+    std::vector<size_t> result;
+    getPointsInSphere(result, ppos, radius);
+    return result;
+}
+
+void
+SpatialHashTableOpenAddressing::getPointsInSphere(std::vector<size_t>& result, const Vec3d& ppos, const double radius) const
+{
+    const double radiusSqr = radius * radius;
+    const Vec3d  extent(radius, radius, radius);
+
+    // clear the old result (if applicable)
+    result.resize(0);
+    forEachPointInCells(ppos - extent, ppos + extent, [&](const uint32_t id, const Vec3d& pos)
+        {
+            if ((ppos - pos).squaredNorm() < radiusSqr)
+            {
+                result.push_back(id);
+            }
+        });
+}
+
+void
+SpatialHashTableOpenAddressing::getPointsInSpheres(CSRNeighborList& result, const VecDataArray<double, 3>& centers, const double radius) const
+{
+    const double radiusSqr = radius * radius;
+    const Vec3d  extent(radius, radius, radius);
+
+    result.build(static_cast<size_t>(centers.size()),
+        [&](const size_t p, std::vector<uint32_t>& ids)
+        {
+            const Vec3d ppos = centers[p];
+            forEachPointInCells(ppos - extent, ppos + extent, [&](const uint32_t id, const Vec3d& pos)
+            {
+                if ((ppos - pos).squaredNorm() < radiusSqr)
+                {
+                    ids.push_back(id);
+                }
+            });
+        });
+}
+
+void
+SpatialHashTableOpenAddressing::getPointsInAABBs(CSRNeighborList& result, const VecDataArray<double, 3>& lowerCorners, const VecDataArray<double, 3>& upperCorners) const
+{
+    CHECK(lowerCorners.size() == upperCorners.size()) << "Number of lower and upper corners differ";
+
+    result.build(static_cast<size_t>(lowerCorners.size()),
+        [&](const size_t p, std::vector<uint32_t>& ids)
+        {
+            const Vec3d lower = lowerCorners[p];
+            const Vec3d upper = upperCorners[p];
+            forEachPointInCells(lower, upper, [&](const uint32_t id, const Vec3d& pos)
+            {
+                if ((pos.array() >= lower.array()).all() && (pos.array() <= upper.array()).all())
+                {
+                    ids.push_back(id);
+                }
+            });
+        });
+}
+}
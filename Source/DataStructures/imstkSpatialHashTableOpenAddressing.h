@@ -0,0 +1,196 @@
+/*=========================================================================
+
+   Library: iMSTK
+
+   Copyright (c) Kitware, Inc. & Center for Modeling, Simulation,
+   & Imaging in Medicine, Rensselaer Polytechnic Institute.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+=========================================================================*/
+
+#pragma once
+
+#include "imstkSpatialHashTable.h"
+#include "imstkCellPointRange.h"
+#include "imstkCSRNeighborList.h"
+#include "imstkMath.h"
+#include "imstkVecDataArray.h"
+
+#include <atomic>
+
+namespace imstk
+{
+///
+/// \class SpatialHashTableOpenAddressing
+///
+/// \brief Implementation of SpatialHashTable using open addressing
+/// The occupied cells are stored in a flat, linearly probed table keyed by a 64-bit cell key.
+/// Points are counting sorted by cell into a contiguous array, so a cell is a single range
+/// of points. Bulk insertion rebuilds the table in parallel, single points are appended to a
+/// list of their cell until the table needs to grow
+///
+class SpatialHashTableOpenAddressing : public SpatialHashTable
+{
+public:
+    ///
+    /// \brief Default constructor
+    ///
+    SpatialHashTableOpenAddressing();
+
+    ///
+    /// \brief Insert an array of points, IDs continue from the previously inserted points
+    /// \param points An array of point
+    ///
+    void insertPoints(const VecDataArray<double, 3>& points);
+
+    ///
+    /// \brief Insert a point, the table is only rebuilt when its load factor would exceed one half
+    /// \param point A point
+    ///
+    void insertPoint(const Vec3d& point);
+
+    ///
+    /// \brief Returns the number of inserted points
+    ///
+    size_t getNumPoints() const { return m_Points.size(); }
+
+    ///
+    /// \brief Returns the number of occupied cells
+    ///
+    size_t getNumCells() const { return m_NumCells; }
+
+    ///
+    /// \brief Finds IDs of all points in an AABB
+    /// \param corner1 One corner to the box
+    /// \param corner2 The other corner to the box
+    ///
+    std::vector<size_t> getPointsInAABB(const Vec3d& corner1, const Vec3d& corner2) const;
+
+    ///
+    /// \brief Finds IDs of all points in an AABB
+    /// \param result The list to contain search result
+    /// \param corner1 One corner to the box
+    /// \param corner2 The other corner to the box
+    ///
+    void getPointsInAABB(std::vector<size_t>& result, const Vec3d& corner1, const Vec3d& corner2) const;
+
+    ///
+    /// \brief Find IDs of all points in a sphere centered at ppos and having given radius
+    /// \param pos Postision of the given point
+    /// \param radius The search radius
+    ///
+    std::vector<size_t> getPointsInSphere(const Vec3d& ppos, const double radius) const;
+
+    ///
+    /// \brief Find IDs of all points in a sphere centered at ppos and having given radius
+    /// \param result The list to contain search result
+    /// \param pos Postision of the given point
+    /// \param radius The search radius
+    ///
+    void getPointsInSphere(std::vector<size_t>& result, const Vec3d& ppos, const double radius) const;
+
+    ///
+    /// \brief Find IDs of all points in spheres of the same radius, queries are done in parallel
+    /// \param result The IDs found for each sphere
+    /// \param centers The centers of the spheres
+    /// \param radius The search radius
+    ///
+    void getPointsInSpheres(CSRNeighborList& result, const VecDataArray<double, 3>& centers, const double radius) const;
+
+    ///
+    /// \brief Find IDs of all points in a set of AABBs, queries are done in parallel
+    /// \param result The IDs found for each AABB
+    /// \param lowerCorners The lower corners of the boxes
+    /// \param upperCorners The upper corners of the boxes
+    ///
+    void getPointsInAABBs(CSRNeighborList& result, const VecDataArray<double, 3>& lowerCorners, const VecDataArray<double, 3>& upperCorners) const;
+
+    ///
+    /// \brief Clears the table
+    ///
+    void clear();
+
+    ///
+    /// \brief Set the dimensions of each cell and rebuild the table
+    /// \param x,y,z Dimensions for each cell
+    ///
+    virtual void setCellSize(double x, double y, double z) override;
+
+protected:
+    ///
+    /// \brief Rebuild the table from the inserted points
+    ///
+    virtual void rehash() override;
+
+    ///
+    /// \brief Call func(id, point) for every point in the cells overlapping the box [lower, upper]
+    ///
+    template<typename Function>
+    void forEachPointInCells(const Vec3d& lower, const Vec3d& upper, Function&& func) const;
+
+    ///
+    /// \brief Returns the cell coordinates of a position
+    ///
+    Vec3i getCellCoords(const Vec3d& pos) const;
+
+    ///
+    /// \brief Packs cell coordinates into a key, 21 bits per axis
+    ///
+    static uint64_t getCellKey(const Vec3i& cell);
+
+    ///
+    /// \brief Returns the well mixed hash of a cell key
+    ///
+    static uint64_t hashCellKey(uint64_t key);
+
+    ///
+    /// \brief Returns the slot of a cell key, inserting it if absent. Thread safe
+    ///
+    size_t insertCellKey(const uint64_t key);
+
+    ///
+    /// \brief Returns the slot of a cell key, or EmptySlot if absent
+    ///
+    size_t findCellKey(const uint64_t key) const;
+
+    static constexpr uint64_t EmptyKey   = ~static_cast<uint64_t>(0); ///> Key of unoccupied slots
+    static constexpr size_t   EmptySlot  = ~static_cast<size_t>(0);
+    static constexpr uint32_t EmptyPoint = ~static_cast<uint32_t>(0); ///> End of the pending point lists
+
+    // Cell key of a slot, slots are claimed concurrently while the points are inserted
+    struct SlotKey
+    {
+        SlotKey(const uint64_t k = EmptyKey) : key(k) {}
+        SlotKey(const SlotKey& other) : key(other.key.load(std::memory_order_relaxed)) {}
+        SlotKey& operator=(const SlotKey& other)
+        {
+            key.store(other.key.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            return *this;
+        }
+
+        std::atomic<uint64_t> key;
+    };
+
+    std::vector<Vec3d>          m_Points;           ///> Inserted points, in insertion order
+    std::vector<Vec3d>          m_SortedPoints;     ///> Points sorted by cell at the last rehash
+    std::vector<uint32_t>       m_SortedIndices;    ///> IDs of the points sorted by cell at the last rehash
+    std::vector<SlotKey>        m_SlotKeys;         ///> Cell key of each slot
+    std::vector<CellPointRange> m_SlotCells;        ///> Sorted point range of each slot
+    std::vector<uint32_t>       m_SlotPendingHeads; ///> Last point inserted in each slot since the last rehash
+    std::vector<uint32_t>       m_PendingNext;      ///> Previous point of the same slot for points inserted since the last rehash
+    std::vector<uint32_t>       m_PointSlots;       ///> Slot of each point
+    std::vector<uint32_t>       m_PointCellOffsets; ///> Index of each point within its cell
+    size_t m_NumCells = 0;
+};
+}
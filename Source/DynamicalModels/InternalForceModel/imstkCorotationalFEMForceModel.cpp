@@ -50,7 +50,7 @@ CorotationalFEMForceModel::getTangentStiffnessMatrix(const Vectord& u, SparseMat
 {
     double* data = const_cast<double*>(u.data());
     m_corotationalLinearFEM->ComputeEnergyAndForceAndStiffnessMatrix(data, nullptr, nullptr, m_vegaTangentStiffnessMatrix.get(), m_warp);
-    InternalForceModel::updateValuesFromMatrix(m_vegaTangentStiffnessMatrix, tangentStiffnessMatrix.valuePtr());
+    this->scatterTangentStiffness(*m_vegaTangentStiffnessMatrix, tangentStiffnessMatrix);
 }
 
 void
@@ -64,7 +64,7 @@ CorotationalFEMForceModel::getForceAndMatrix(const Vectord& u, Vectord& internal
 {
     double* data = const_cast<double*>(u.data());
     m_corotationalLinearFEM->ComputeEnergyAndForceAndStiffnessMatrix(data, nullptr, internalForce.data(), m_vegaTangentStiffnessMatrix.get(), m_warp);
-    InternalForceModel::updateValuesFromMatrix(m_vegaTangentStiffnessMatrix, tangentStiffnessMatrix.valuePtr());
+    this->scatterTangentStiffness(*m_vegaTangentStiffnessMatrix, tangentStiffnessMatrix);
 }
 
 void
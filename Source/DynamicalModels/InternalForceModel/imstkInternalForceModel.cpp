@@ -20,29 +20,116 @@
 =========================================================================*/
 
 #include "imstkInternalForceModel.h"
+#include "imstkLogger.h"
+#include "imstkParallelUtils.h"
+
+#include <algorithm>
+#include <numeric>
 
 namespace imstk
 {
 void
-InternalForceModel::updateValuesFromMatrix(std::shared_ptr<vega::SparseMatrix> vegaMatrix, double* values)
+InternalForceModel::initializeTangentStiffness(std::shared_ptr<vega::SparseMatrix> K, SparseMatrixd& tangentStiffnessMatrix)
+{
+    CHECK(K != nullptr) << "Tangent stiffness matrix topology not available!";
+
+    buildEigenMatrixFromVegaMatrix(*K, tangentStiffnessMatrix, &m_tangentStiffnessScatterMap);
+    this->setTangentStiffness(K);
+
+    // Vega keeps the columns of a row sorted, so its rows usually are the CSR rows and the
+    // values are copied row by row without going through the map
+    bool sameOrder = true;
+    for (size_t i = 0; i < m_tangentStiffnessScatterMap.size() && sameOrder; ++i)
+    {
+        sameOrder = m_tangentStiffnessScatterMap[i] == static_cast<int>(i);
+    }
+    if (sameOrder)
+    {
+        m_tangentStiffnessScatterMap.clear();
+    }
+}
+
+void
+InternalForceModel::buildEigenMatrixFromVegaMatrix(const vega::SparseMatrix& vegaMatrix,
+                                                   SparseMatrixd&            eigenMatrix,
+                                                   std::vector<int>*         scatterMap)
 {
-    auto rowLengths    = vegaMatrix->GetRowLengths();
-    auto nonZeroValues = vegaMatrix->GetEntries();
+    const int numRows       = vegaMatrix.GetNumRows();
+    const int numEntries    = vegaMatrix.GetNumEntries();
+    auto      rowLengths    = vegaMatrix.GetRowLengths();
+    auto      columnIndices = vegaMatrix.GetColumnIndices();
+    auto      nonZeroValues = vegaMatrix.GetEntries();
+
+    // Both formats store the rows contiguously, so the CSR arrays are written directly
+    // instead of going through triplets. Only the order within a row may differ.
+    eigenMatrix.resize(numRows, vegaMatrix.GetNumColumns());
+    eigenMatrix.resizeNonZeros(numEntries);
+    if (scatterMap)
+    {
+        scatterMap->resize(numEntries);
+    }
 
-    // Flatten the internal non-zeros value array and store it in values.
-    int offset = 0;
+    auto outerIndex = eigenMatrix.outerIndexPtr();
+    auto innerIndex = eigenMatrix.innerIndexPtr();
+    auto values     = eigenMatrix.valuePtr();
 
-    for (int row = 0, end = vegaMatrix->GetNumRows(); row < end; ++row)
+    std::vector<int> order;
+    outerIndex[0] = 0;
+    for (int row = 0; row < numRows; ++row)
     {
-        /// This operation should not add new values to the array since the matrices
-        /// structures should remain the same. It just replaces the values in the array.
-        for (int j = 0, end_j = rowLengths[row]; j < end_j; ++j)
+        const int offset    = outerIndex[row];
+        const int rowLength = rowLengths[row];
+
+        order.resize(rowLength);
+        std::iota(order.begin(), order.end(), 0);
+        std::sort(order.begin(), order.end(),
+            [&](const int a, const int b) { return columnIndices[row][a] < columnIndices[row][b]; });
+
+        for (int k = 0; k < rowLength; ++k)
         {
-            values[j + offset] = nonZeroValues[row][j];
+            innerIndex[offset + k] = columnIndices[row][order[k]];
+            values[offset + k]     = nonZeroValues[row][order[k]];
+            if (scatterMap)
+            {
+                (*scatterMap)[offset + order[k]] = offset + k;
+            }
         }
+        outerIndex[row + 1] = offset + rowLength;
+    }
+}
 
-        offset += rowLengths[row];
+void
+InternalForceModel::scatterTangentStiffness(const vega::SparseMatrix& vegaMatrix, SparseMatrixd& tangentStiffnessMatrix) const
+{
+    CHECK(tangentStiffnessMatrix.rows() == vegaMatrix.GetNumRows()
+        && (m_tangentStiffnessScatterMap.empty()
+            || static_cast<int>(m_tangentStiffnessScatterMap.size()) == tangentStiffnessMatrix.nonZeros()))
+        << "Tangent stiffness is not initialized, call initializeTangentStiffness first";
+
+    auto rowLengths    = vegaMatrix.GetRowLengths();
+    auto nonZeroValues = vegaMatrix.GetEntries();
+    auto outerIndex    = tangentStiffnessMatrix.outerIndexPtr();
+    auto values        = tangentStiffnessMatrix.valuePtr();
+
+    // The pattern never changes after initialization, only the values are written
+    if (m_tangentStiffnessScatterMap.empty())
+    {
+        ParallelUtils::parallelFor(vegaMatrix.GetNumRows(),
+            [&](const int row)
+            {
+                std::copy_n(nonZeroValues[row], rowLengths[row], values + outerIndex[row]);
+            });
+        return;
     }
+    ParallelUtils::parallelFor(vegaMatrix.GetNumRows(),
+        [&](const int row)
+        {
+            const int* scatter = m_tangentStiffnessScatterMap.data() + outerIndex[row];
+            for (int j = 0, end_j = rowLengths[row]; j < end_j; ++j)
+            {
+                values[scatter[j]] = nonZeroValues[row][j];
+            }
+        });
 }
 
 void
@@ -51,4 +138,22 @@ InternalForceModel::getForceAndMatrix(const Vectord& u, Vectord& internalForce,
     this->getInternalForce(u, internalForce);
     this->getTangentStiffnessMatrix(u, tangentStiffnessMatrix);
 }
+
+void
+InternalForceModel::linearize(const Vectord&, Vectord*)
+{
+    LOG(FATAL) << "The internal force model does not support matrix-free products";
+}
+
+void
+InternalForceModel::multiplyTangentStiffness(const Vectord&, Vectord&) const
+{
+    LOG(FATAL) << "The internal force model does not support matrix-free products";
+}
+
+void
+InternalForceModel::getTangentStiffnessDiagonal(Vectord&) const
+{
+    LOG(FATAL) << "The internal force model does not support matrix-free products";
+}
 } // imstk
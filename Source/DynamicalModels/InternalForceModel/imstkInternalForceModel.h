@@ -77,13 +77,55 @@ public:
     virtual void getForceAndMatrix(const Vectord& u, Vectord& internalForce, SparseMatrixd& tangentStiffnessMatrix);
 
     ///
-    /// \brief Update the values of the Eigen sparse matrix given the linearized array of data from the Vega matrix
+    /// \brief Specify tangent stiffness matrix
     ///
-    static void updateValuesFromMatrix(std::shared_ptr<vega::SparseMatrix> vegaMatrix, double* values);
+    virtual void setTangentStiffness(std::shared_ptr<vega::SparseMatrix> K) = 0;
 
     ///
-    /// \brief Specify tangent stiffness matrix
+    /// \brief Whether the model can apply its tangent stiffness without assembling it,
+    /// see linearize, multiplyTangentStiffness and getTangentStiffnessDiagonal
     ///
-    virtual void setTangentStiffness(std::shared_ptr<vega::SparseMatrix> K) = 0;
+    virtual bool isMatrixFree() const { return false; }
+
+    ///
+    /// \brief Store the state \p u the tangent stiffness products are evaluated at,
+    /// the internal force is computed in the same pass if \p internalForce is given
+    ///
+    virtual void linearize(const Vectord& u, Vectord* internalForce = nullptr);
+
+    ///
+    /// \brief Compute \p y = K x with K the tangent stiffness at the last linearized state
+    ///
+    virtual void multiplyTangentStiffness(const Vectord& x, Vectord& y) const;
+
+    ///
+    /// \brief Get the diagonal of the tangent stiffness at the last linearized state
+    ///
+    virtual void getTangentStiffnessDiagonal(Vectord& diagonal) const;
+
+    ///
+    /// \brief Allocate the Eigen CSR matrix \p tangentStiffnessMatrix once with the pattern of
+    /// the Vega matrix \p K and hand \p K to the force model. Models built on Vega still assemble
+    /// into \p K and copy its values with scatterTangentStiffness on every update, while
+    /// TetrahedralFEMForceModel assembles its elements straight into the CSR values
+    ///
+    void initializeTangentStiffness(std::shared_ptr<vega::SparseMatrix> K, SparseMatrixd& tangentStiffnessMatrix);
+
+    ///
+    /// \brief Build a compressed Eigen matrix with the same pattern and values as \p vegaMatrix
+    /// \param scatterMap if given, filled with the index in the Eigen value array of every
+    /// Vega entry, Vega entries being enumerated row by row
+    ///
+    static void buildEigenMatrixFromVegaMatrix(const vega::SparseMatrix& vegaMatrix, SparseMatrixd& eigenMatrix,
+                                               std::vector<int>* scatterMap = nullptr);
+
+protected:
+    ///
+    /// \brief Copy the entries of \p vegaMatrix into the preallocated value array
+    /// of \p tangentStiffnessMatrix, rows are processed in parallel
+    ///
+    void scatterTangentStiffness(const vega::SparseMatrix& vegaMatrix, SparseMatrixd& tangentStiffnessMatrix) const;
+
+    std::vector<int> m_tangentStiffnessScatterMap; ///> Index in the Eigen value array of every Vega entry, empty if the rows are copied as is
 };
 } //imstk
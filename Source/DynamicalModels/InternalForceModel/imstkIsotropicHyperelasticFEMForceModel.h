@@ -77,7 +77,7 @@ public:
     {
         double* data = const_cast<double*>(u.data());
         m_isotropicHyperelasticFEM->GetTangentStiffnessMatrix(data, m_vegaTangentStiffnessMatrix.get());
-        InternalForceModel::updateValuesFromMatrix(m_vegaTangentStiffnessMatrix, tangentStiffnessMatrix.valuePtr());
+        this->scatterTangentStiffness(*m_vegaTangentStiffnessMatrix, tangentStiffnessMatrix);
     }
 
     ///
@@ -95,7 +95,7 @@ public:
     {
         double* data = const_cast<double*>(u.data());
         m_isotropicHyperelasticFEM->GetForceAndTangentStiffnessMatrix(data, internalForce.data(), m_vegaTangentStiffnessMatrix.get());
-        InternalForceModel::updateValuesFromMatrix(m_vegaTangentStiffnessMatrix, tangentStiffnessMatrix.valuePtr());
+        this->scatterTangentStiffness(*m_vegaTangentStiffnessMatrix, tangentStiffnessMatrix);
     }
 
     ///
@@ -69,7 +69,7 @@ public:
     ///
     inline void getTangentStiffnessMatrix(const Vectord& u, SparseMatrixd& tangentStiffnessMatrix) override
     {
-        InternalForceModel::updateValuesFromMatrix(m_stiffnessMatrix, tangentStiffnessMatrix.valuePtr());
+        this->scatterTangentStiffness(*m_stiffnessMatrix, tangentStiffnessMatrix);
     }
 
 #ifdef WIN32
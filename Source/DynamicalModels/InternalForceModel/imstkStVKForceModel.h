@@ -71,7 +71,7 @@ public:
     {
         double* data = const_cast<double*>(u.data());
         m_vegaStVKStiffnessMatrix->ComputeStiffnessMatrix(data, m_vegaTangentStiffnessMatrix.get());
-        InternalForceModel::updateValuesFromMatrix(m_vegaTangentStiffnessMatrix, tangentStiffnessMatrix.valuePtr());
+        this->scatterTangentStiffness(*m_vegaTangentStiffnessMatrix, tangentStiffnessMatrix);
     }
 
     ///
@@ -0,0 +1,71 @@
+/*=========================================================================
+
+   Library: iMSTK
+
+   Copyright (c) Kitware, Inc. & Center for Modeling, Simulation,
+   & Imaging in Medicine, Rensselaer Polytechnic Institute.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+=========================================================================*/
+
+#pragma once
+
+#include "imstkMath.h"
+#include "imstkVecDataArray.h"
+
+namespace imstk
+{
+///
+/// \brief Kinematics of linear tetrahedral elements shared by the tetrahedral force models
+///
+namespace TetrahedralElement
+{
+///
+/// \brief Compute the gradients of the four linear shape functions of \p tet in its rest
+/// configuration \p vertices, one row per vertex. The deformation gradient of displaced
+/// positions x is then sum_a x_a gradients.row(a)
+/// \return Determinant of the rest edge matrix Dm, six times the signed rest volume
+///
+inline double
+computeShapeGradients(const VecDataArray<double, 3>& vertices, const Vec4i& tet, Eigen::Matrix<double, 4, 3>& gradients)
+{
+    Mat3d Dm;
+    Dm.col(0) = vertices[tet[1]] - vertices[tet[0]];
+    Dm.col(1) = vertices[tet[2]] - vertices[tet[0]];
+    Dm.col(2) = vertices[tet[3]] - vertices[tet[0]];
+
+    // Rows of Dm^-1 are the gradients of the shape functions of vertices 1, 2 and 3
+    const Mat3d DmInv = Dm.inverse();
+    gradients.bottomRows<3>() = DmInv;
+    gradients.row(0) = -DmInv.colwise().sum();
+    return Dm.determinant();
+}
+
+///
+/// \brief Rotation closest to \p F, reflections are removed
+///
+inline Mat3d
+polarRotation(const Mat3d& F)
+{
+    Eigen::JacobiSVD<Mat3d> svd(F, Eigen::ComputeFullU | Eigen::ComputeFullV);
+    Mat3d                   U = svd.matrixU();
+    const Mat3d             V = svd.matrixV();
+    if ((U * V.transpose()).determinant() < 0.0)
+    {
+        U.col(2) = -U.col(2);
+    }
+    return U * V.transpose();
+}
+} // TetrahedralElement
+} // imstk
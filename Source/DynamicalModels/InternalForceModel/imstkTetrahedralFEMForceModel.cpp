@@ -0,0 +1,500 @@
+/*=========================================================================
+
+   Library: iMSTK
+
+   Copyright (c) Kitware, Inc. & Center for Modeling, Simulation,
+   & Imaging in Medicine, Rensselaer Polytechnic Institute.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+=========================================================================*/
+
+#include "imstkTetrahedralFEMForceModel.h"
+#include "imstkLogger.h"
+#include "imstkParallelUtils.h"
+#include "imstkTetrahedralElement.h"
+#include "imstkTetrahedralMesh.h"
+#include "imstkVecDataArray.h"
+
+#include <sparseMatrix.h>
+
+namespace imstk
+{
+namespace
+{
+using Vec12d = Eigen::Matrix<double, 12, 1>;
+using Mat12d = Eigen::Matrix<double, 12, 12>;
+
+///
+/// \brief Smallest singular value a Neo-Hookean element may be compressed to
+///
+constexpr double c_minSingularValue = 0.1;
+
+///
+/// \brief Replace an inverted or nearly degenerate \p F by the closest deformation
+/// gradient whose singular values are at least c_minSingularValue
+///
+Mat3d
+clampDeformationGradient(const Mat3d& F)
+{
+    Eigen::JacobiSVD<Mat3d> svd(F, Eigen::ComputeFullU | Eigen::ComputeFullV);
+    Mat3d                   U     = svd.matrixU();
+    Vec3d                   sigma = svd.singularValues();
+    const Mat3d             V     = svd.matrixV();
+    if (U.determinant() * V.determinant() < 0.0)
+    {
+        // Inverted element, the smallest singular value carries the reflection
+        U.col(2)  = -U.col(2);
+        sigma[2] = -sigma[2];
+    }
+    sigma = sigma.cwiseMax(c_minSingularValue);
+    return U * sigma.asDiagonal() * V.transpose();
+}
+}
+
+TetrahedralFEMForceModel::TetrahedralFEMForceModel(std::shared_ptr<TetrahedralMesh> mesh, const Material material,
+                                                   const double youngModulus, const double poissonRatio) : InternalForceModel(),
+    m_material(material),
+    m_mu(youngModulus / (2.0 * (1.0 + poissonRatio))),
+    m_lambda(youngModulus * poissonRatio / ((1.0 + poissonRatio) * (1.0 - 2.0 * poissonRatio)))
+{
+    CHECK(mesh != nullptr) << "TetrahedralFEMForceModel requires a tetrahedral mesh";
+
+    const VecDataArray<double, 3>& vertices = *mesh->getVertexPositions();
+    const VecDataArray<int, 4>&    tets     = *mesh->getTetrahedraIndices();
+
+    m_elements.resize(tets.size());
+    m_restVolumes.resize(tets.size());
+    m_shapeGradients.resize(tets.size());
+    for (int e = 0; e < tets.size(); ++e)
+    {
+        const double det = TetrahedralElement::computeShapeGradients(vertices, tets[e], m_shapeGradients[e]);
+        LOG_IF(WARNING, std::abs(det) < std::numeric_limits<double>::epsilon())
+            << "Degenerate tetrahedron " << e << " in TetrahedralFEMForceModel";
+
+        m_elements[e]    = tets[e];
+        m_restVolumes[e] = std::abs(det) / 6.0;
+    }
+
+    computeElementColors();
+    computeStiffnessPattern();
+}
+
+void
+TetrahedralFEMForceModel::getInternalForce(const Vectord& u, Vectord& internalForce)
+{
+    assemble(u, &internalForce, nullptr);
+}
+
+void
+TetrahedralFEMForceModel::getTangentStiffnessMatrix(const Vectord& u, SparseMatrixd& tangentStiffnessMatrix)
+{
+    assemble(u, nullptr, &tangentStiffnessMatrix);
+}
+
+void
+TetrahedralFEMForceModel::getForceAndMatrix(const Vectord& u, Vectord& internalForce, SparseMatrixd& tangentStiffnessMatrix)
+{
+    assemble(u, &internalForce, &tangentStiffnessMatrix);
+}
+
+void
+TetrahedralFEMForceModel::getTangentStiffnessMatrixTopology(vega::SparseMatrix** tangentStiffnessMatrix)
+{
+    const int                 numRows = static_cast<int>(m_rowOffsets.size()) - 1;
+    vega::SparseMatrixOutline outline(numRows);
+    for (int row = 0; row < numRows; ++row)
+    {
+        for (int k = m_rowOffsets[row]; k < m_rowOffsets[row + 1]; ++k)
+        {
+            outline.AddEntry(row, m_columnIndices[k]);
+        }
+    }
+    *tangentStiffnessMatrix = new vega::SparseMatrix(&outline);
+}
+
+void
+TetrahedralFEMForceModel::assemble(const Vectord& u, Vectord* internalForce, SparseMatrixd* tangentStiffnessMatrix) const
+{
+    double* values = nullptr;
+    if (tangentStiffnessMatrix)
+    {
+        CHECK(tangentStiffnessMatrix->isCompressed()
+            && tangentStiffnessMatrix->nonZeros() == static_cast<Eigen::Index>(m_columnIndices.size()))
+            << "Tangent stiffness does not have the pattern given by getTangentStiffnessMatrixTopology";
+        values = tangentStiffnessMatrix->valuePtr();
+        std::fill_n(values, tangentStiffnessMatrix->nonZeros(), 0.0);
+    }
+    if (internalForce)
+    {
+        internalForce->resize(u.size());
+        internalForce->setZero();
+    }
+
+    // Elements of one color share no vertex, hence neither force entries nor stiffness nonzeros
+    for (const std::vector<int>& color : m_elementColors)
+    {
+        ParallelUtils::parallelFor(color.size(),
+            [&](const size_t i)
+            {
+                const int e = color[i];
+                Vec12d    force;
+                Mat12d    stiffness;
+                computeElement(e, u, force, values ? &stiffness : nullptr);
+
+                if (internalForce)
+                {
+                    for (int a = 0; a < 4; ++a)
+                    {
+                        internalForce->segment<3>(3 * m_elements[e][a]) += force.segment<3>(3 * a);
+                    }
+                }
+                if (values)
+                {
+                    const int*    scatter = m_elementScatter.data() + 144 * e;
+                    const double* local   = stiffness.data();
+                    for (int k = 0; k < 144; ++k)
+                    {
+                        values[scatter[k]] += local[k];
+                    }
+                }
+            });
+    }
+}
+
+void
+TetrahedralFEMForceModel::linearize(const Vectord& u, Vectord* internalForce)
+{
+    m_linearization.resize(m_elements.size());
+    if (internalForce)
+    {
+        internalForce->resize(u.size());
+        internalForce->setZero();
+    }
+
+    for (const std::vector<int>& color : m_elementColors)
+    {
+        ParallelUtils::parallelFor(color.size(),
+            [&](const size_t i)
+            {
+                const int   e = color[i];
+                const Mat3d P = linearizeElement(e, u, m_linearization[e]);
+                if (internalForce)
+                {
+                    const Vec4i& tet = m_elements[e];
+                    for (int a = 0; a < 4; ++a)
+                    {
+                        internalForce->segment<3>(3 * tet[a]) += m_restVolumes[e] * P * m_shapeGradients[e].row(a).transpose();
+                    }
+                }
+            });
+    }
+}
+
+void
+TetrahedralFEMForceModel::multiplyTangentStiffness(const Vectord& x, Vectord& y) const
+{
+    CHECK(m_linearization.size() == m_elements.size()) << "Tangent stiffness product requires a prior linearize";
+
+    y.resize(x.size());
+    y.setZero();
+    for (const std::vector<int>& color : m_elementColors)
+    {
+        ParallelUtils::parallelFor(color.size(),
+            [&](const size_t i)
+            {
+                const int                          e   = color[i];
+                const Vec4i&                       tet = m_elements[e];
+                const Eigen::Matrix<double, 4, 3>& B   = m_shapeGradients[e];
+
+                // dF = sum_b x_b b_b^T, the element product is V dP b_a
+                Mat3d dF = Mat3d::Zero();
+                for (int b = 0; b < 4; ++b)
+                {
+                    dF.noalias() += x.segment<3>(3 * tet[b]) * B.row(b);
+                }
+                const Mat3d dP = m_restVolumes[e] * stressDifferential(m_linearization[e], dF);
+                for (int a = 0; a < 4; ++a)
+                {
+                    y.segment<3>(3 * tet[a]) += dP * B.row(a).transpose();
+                }
+            });
+    }
+}
+
+void
+TetrahedralFEMForceModel::getTangentStiffnessDiagonal(Vectord& diagonal) const
+{
+    CHECK(m_linearization.size() == m_elements.size()) << "Tangent stiffness diagonal requires a prior linearize";
+
+    diagonal.resize(static_cast<Eigen::Index>(m_rowOffsets.size()) - 1);
+    diagonal.setZero();
+    for (const std::vector<int>& color : m_elementColors)
+    {
+        ParallelUtils::parallelFor(color.size(),
+            [&](const size_t i)
+            {
+                const int e = color[i];
+                for (int a = 0; a < 4; ++a)
+                {
+                    diagonal.segment<3>(3 * m_elements[e][a]) +=
+                        m_restVolumes[e] * stiffnessBlock(e, m_linearization[e], a, a).diagonal();
+                }
+            });
+    }
+}
+
+void
+TetrahedralFEMForceModel::computeElement(const int elementId, const Vectord& u,
+                                         Vec12d& force, Mat12d* stiffness) const
+{
+    ElementLinearization lin;
+    const Mat3d          P   = linearizeElement(elementId, u, lin);
+    const double         vol = m_restVolumes[elementId];
+    for (int a = 0; a < 4; ++a)
+    {
+        force.segment<3>(3 * a) = vol * P * m_shapeGradients[elementId].row(a).transpose();
+    }
+    if (stiffness)
+    {
+        for (int a = 0; a < 4; ++a)
+        {
+            for (int b = 0; b < 4; ++b)
+            {
+                stiffness->block<3, 3>(3 * a, 3 * b) = vol * stiffnessBlock(elementId, lin, a, b);
+            }
+        }
+    }
+}
+
+Mat3d
+TetrahedralFEMForceModel::linearizeElement(const int elementId, const Vectord& u, ElementLinearization& lin) const
+{
+    const Vec4i&                       tet = m_elements[elementId];
+    const Eigen::Matrix<double, 4, 3>& B   = m_shapeGradients[elementId];
+
+    // F = I + sum_a u_a b_a^T
+    Mat3d F = Mat3d::Identity();
+    for (int a = 0; a < 4; ++a)
+    {
+        F.noalias() += u.segment<3>(3 * tet[a]) * B.row(a);
+    }
+
+    switch (m_material)
+    {
+    case Material::Corotational:
+    {
+        // Linear stress of the unrotated strain, the rotation derivative is neglected in the stiffness
+        lin.F = TetrahedralElement::polarRotation(F);
+        const Mat3d strain = 0.5 * (lin.F.transpose() * F + F.transpose() * lin.F) - Mat3d::Identity();
+        return lin.F * (m_lambda * strain.trace() * Mat3d::Identity() + 2.0 * m_mu * strain);
+    }
+    case Material::StVK:
+    {
+        const Mat3d E = 0.5 * (F.transpose() * F - Mat3d::Identity());
+        lin.F = F;
+        lin.S = m_lambda * E.trace() * Mat3d::Identity() + 2.0 * m_mu * E;
+        return F * lin.S;
+    }
+    case Material::NeoHookean:
+    default:
+    {
+        if (F.determinant() < c_minSingularValue * c_minSingularValue * c_minSingularValue)
+        {
+            F = clampDeformationGradient(F);
+        }
+        lin.F    = F;
+        lin.S    = F.inverse().transpose();
+        lin.logJ = std::log(F.determinant());
+        return m_mu * F + (m_lambda * lin.logJ - m_mu) * lin.S;
+    }
+    }
+}
+
+Mat3d
+TetrahedralFEMForceModel::stiffnessBlock(const int elementId, const ElementLinearization& lin, const int a, const int b) const
+{
+    const Eigen::Matrix<double, 4, 3>& B  = m_shapeGradients[elementId];
+    const Vec3d                        ba = B.row(a).transpose();
+    const Vec3d                        bb = B.row(b).transpose();
+
+    Mat3d K;
+    switch (m_material)
+    {
+    case Material::Corotational:
+    {
+        // R K0 R^T
+        K = m_lambda * ba * bb.transpose() + m_mu * bb * ba.transpose();
+        K.diagonal().array() += m_mu * ba.dot(bb);
+        K = lin.F * K * lin.F.transpose();
+        break;
+    }
+    case Material::StVK:
+    {
+        const Vec3d Fba = lin.F * ba;
+        const Vec3d Fbb = lin.F * bb;
+        K = m_lambda * Fba * Fbb.transpose() + m_mu * Fbb * Fba.transpose() + m_mu * ba.dot(bb) * lin.F * lin.F.transpose();
+        K.diagonal().array() += bb.dot(lin.S * ba);
+        break;
+    }
+    case Material::NeoHookean:
+    default:
+    {
+        const Vec3d ga = lin.S * ba;
+        const Vec3d gb = lin.S * bb;
+        K = (m_mu - m_lambda * lin.logJ) * gb * ga.transpose() + m_lambda * ga * gb.transpose();
+        K.diagonal().array() += m_mu * ba.dot(bb);
+        break;
+    }
+    }
+    return K;
+}
+
+Mat3d
+TetrahedralFEMForceModel::stressDifferential(const ElementLinearization& lin, const Mat3d& dF) const
+{
+    switch (m_material)
+    {
+    case Material::Corotational:
+    {
+        const Mat3d dE = 0.5 * (lin.F.transpose() * dF + dF.transpose() * lin.F);
+        return lin.F * (m_lambda * dE.trace() * Mat3d::Identity() + 2.0 * m_mu * dE);
+    }
+    case Material::StVK:
+    {
+        const Mat3d dE = 0.5 * (lin.F.transpose() * dF + dF.transpose() * lin.F);
+        return dF * lin.S + lin.F * (m_lambda * dE.trace() * Mat3d::Identity() + 2.0 * m_mu * dE);
+    }
+    case Material::NeoHookean:
+    default:
+        return m_mu * dF + (m_mu - m_lambda * lin.logJ) * lin.S * dF.transpose() * lin.S
+               + m_lambda * lin.S.cwiseProduct(dF).sum() * lin.S;
+    }
+}
+
+void
+TetrahedralFEMForceModel::computeElementColors()
+{
+    int numVertices = 0;
+    for (const Vec4i& tet : m_elements)
+    {
+        numVertices = std::max(numVertices, tet.maxCoeff() + 1);
+    }
+
+    // Colors already taken by the elements around each vertex
+    std::vector<std::vector<int>> vertexColors(numVertices);
+    std::vector<bool>             taken;
+    m_elementColors.clear();
+    for (int e = 0; e < static_cast<int>(m_elements.size()); ++e)
+    {
+        taken.assign(m_elementColors.size() + 1, false);
+        for (int a = 0; a < 4; ++a)
+        {
+            for (const int c : vertexColors[m_elements[e][a]])
+            {
+                taken[c] = true;
+            }
+        }
+        const int color = static_cast<int>(std::find(taken.begin(), taken.end(), false) - taken.begin());
+        if (color == static_cast<int>(m_elementColors.size()))
+        {
+            m_elementColors.emplace_back();
+        }
+        m_elementColors[color].push_back(e);
+        for (int a = 0; a < 4; ++a)
+        {
+            vertexColors[m_elements[e][a]].push_back(color);
+        }
+    }
+}
+
+void
+TetrahedralFEMForceModel::computeStiffnessPattern()
+{
+    int numVertices = 0;
+    for (const Vec4i& tet : m_elements)
+    {
+        numVertices = std::max(numVertices, tet.maxCoeff() + 1);
+    }
+
+    // Vertex adjacency, every vertex is its own neighbor
+    std::vector<std::vector<int>> neighbors(numVertices);
+    for (int v = 0; v < numVertices; ++v)
+    {
+        neighbors[v].push_back(v);
+    }
+    for (const Vec4i& tet : m_elements)
+    {
+        for (int a = 0; a < 4; ++a)
+        {
+            for (int b = 0; b < 4; ++b)
+            {
+                neighbors[tet[a]].push_back(tet[b]);
+            }
+        }
+    }
+    for (std::vector<int>& n : neighbors)
+    {
+        std::sort(n.begin(), n.end());
+        n.erase(std::unique(n.begin(), n.end()), n.end());
+    }
+
+    // Each vertex contributes three rows of 3 * #neighbors sorted columns
+    m_rowOffsets.resize(3 * numVertices + 1);
+    m_rowOffsets[0] = 0;
+    for (int v = 0; v < numVertices; ++v)
+    {
+        for (int i = 0; i < 3; ++i)
+        {
+            m_rowOffsets[3 * v + i + 1] = m_rowOffsets[3 * v + i] + 3 * static_cast<int>(neighbors[v].size());
+        }
+    }
+    m_columnIndices.resize(m_rowOffsets.back());
+    for (int v = 0; v < numVertices; ++v)
+    {
+        for (int i = 0; i < 3; ++i)
+        {
+            int* cols = m_columnIndices.data() + m_rowOffsets[3 * v + i];
+            for (const int w : neighbors[v])
+            {
+                *cols++ = 3 * w;
+                *cols++ = 3 * w + 1;
+                *cols++ = 3 * w + 2;
+            }
+        }
+    }
+
+    // Nonzero index of every entry of the local stiffness, column major to match Eigen storage
+    m_elementScatter.resize(144 * m_elements.size());
+    for (size_t e = 0; e < m_elements.size(); ++e)
+    {
+        const Vec4i& tet     = m_elements[e];
+        int*         scatter = m_elementScatter.data() + 144 * e;
+        for (int b = 0; b < 4; ++b)
+        {
+            for (int j = 0; j < 3; ++j)
+            {
+                for (int a = 0; a < 4; ++a)
+                {
+                    const std::vector<int>& n = neighbors[tet[a]];
+                    const int               w = static_cast<int>(std::lower_bound(n.begin(), n.end(), tet[b]) - n.begin());
+                    for (int i = 0; i < 3; ++i)
+                    {
+                        scatter[(3 * b + j) * 12 + 3 * a + i] = m_rowOffsets[3 * tet[a] + i] + 3 * w + j;
+                    }
+                }
+            }
+        }
+    }
+}
+} // imstk
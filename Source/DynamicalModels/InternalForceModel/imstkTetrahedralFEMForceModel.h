@@ -0,0 +1,182 @@
+/*=========================================================================
+
+   Library: iMSTK
+
+   Copyright (c) Kitware, Inc. & Center for Modeling, Simulation,
+   & Imaging in Medicine, Rensselaer Polytechnic Institute.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+=========================================================================*/
+
+#pragma once
+
+#include "imstkInternalForceModel.h"
+
+namespace imstk
+{
+class TetrahedralMesh;
+
+///
+/// \class TetrahedralFEMForceModel
+///
+/// \brief Native linear tetrahedral finite element force model assembled in parallel.
+/// Shape function gradients and rest volumes are precomputed per element. Elements are
+/// greedily colored so that elements of the same color share no vertex, each color is
+/// then processed in parallel and scatters its 12x12 element stiffness straight into the
+/// CSR value array of the tangent stiffness without atomics
+///
+class TetrahedralFEMForceModel : public InternalForceModel
+{
+public:
+    ///
+    /// \brief Constitutive model evaluated per element
+    ///
+    enum class Material
+    {
+        Corotational, ///> Linear elasticity in the element rotated frame (stiffness warping)
+        StVK,         ///> Saint Venant-Kirchhoff
+        NeoHookean    ///> Compressible Neo-Hookean
+    };
+
+public:
+    ///
+    /// \brief Constructor, the current vertex positions of \p mesh are the rest configuration
+    /// \param youngModulus Young's modulus of the material
+    /// \param poissonRatio Poisson's ratio of the material
+    ///
+    TetrahedralFEMForceModel(std::shared_ptr<TetrahedralMesh> mesh, const Material material,
+                             const double youngModulus = 1.0e7, const double poissonRatio = 0.4);
+    TetrahedralFEMForceModel() = delete;
+
+    ///
+    /// \brief Destructor
+    ///
+    virtual ~TetrahedralFEMForceModel() override = default;
+
+    ///
+    /// \brief Compute internal force \p internalForce at state \p u
+    ///
+    void getInternalForce(const Vectord& u, Vectord& internalForce) override;
+
+    ///
+    /// \brief Compute stiffness matrix \p tangentStiffnessMatrix at state \u
+    ///
+    void getTangentStiffnessMatrix(const Vectord& u, SparseMatrixd& tangentStiffnessMatrix) override;
+
+    ///
+    /// \brief Build the sparsity pattern for stiffness matrix
+    ///
+    void getTangentStiffnessMatrixTopology(vega::SparseMatrix** tangentStiffnessMatrix) override;
+
+    ///
+    /// \brief Compute internal force \p internalForce and stiffness matrix \p tangentStiffnessMatrix at state \u
+    /// in a single pass over the elements
+    ///
+    void getForceAndMatrix(const Vectord& u, Vectord& internalForce, SparseMatrixd& tangentStiffnessMatrix) override;
+
+    ///
+    /// \brief Specify tangent stiffness matrix, only its pattern is used
+    ///
+    void setTangentStiffness(std::shared_ptr<vega::SparseMatrix> K) override { m_vegaTangentStiffnessMatrix = K; }
+
+    ///
+    /// \brief The tangent stiffness can be applied element by element
+    ///
+    bool isMatrixFree() const override { return true; }
+
+    ///
+    /// \brief Store per element the deformation state needed to apply the tangent stiffness at \p u
+    ///
+    void linearize(const Vectord& u, Vectord* internalForce = nullptr) override;
+
+    ///
+    /// \brief Compute \p y = K x element by element without assembling K
+    ///
+    void multiplyTangentStiffness(const Vectord& x, Vectord& y) const override;
+
+    ///
+    /// \brief Get the diagonal of the tangent stiffness
+    ///
+    void getTangentStiffnessDiagonal(Vectord& diagonal) const override;
+
+    ///
+    /// \brief Get the number of element colors, ie: the number of sequential parallel passes per assembly
+    ///
+    size_t getNumColors() const { return m_elementColors.size(); }
+
+protected:
+    ///
+    /// \brief Element state the tangent stiffness is evaluated at
+    ///
+    struct ElementLinearization
+    {
+        Mat3d F;           ///> Rotation for the corotational material, deformation gradient otherwise
+        Mat3d S;           ///> Second Piola-Kirchhoff stress for StVK, inverse transpose of F for Neo-Hookean
+        double logJ = 0.0; ///> Log of the volume ratio for Neo-Hookean
+    };
+
+    ///
+    /// \brief Assemble the internal force and/or the tangent stiffness, either may be null
+    ///
+    void assemble(const Vectord& u, Vectord* internalForce, SparseMatrixd* tangentStiffnessMatrix) const;
+
+    ///
+    /// \brief Compute the force and optionally the stiffness of element \p elementId, local dofs
+    /// are ordered vertex by vertex
+    ///
+    void computeElement(const int elementId, const Vectord& u,
+                        Eigen::Matrix<double, 12, 1>& force, Eigen::Matrix<double, 12, 12>* stiffness) const;
+
+    ///
+    /// \brief Fill the linearization of element \p elementId at state \p u and return its first Piola-Kirchhoff stress
+    ///
+    Mat3d linearizeElement(const int elementId, const Vectord& u, ElementLinearization& lin) const;
+
+    ///
+    /// \brief Block (a, b) of the stiffness of element \p elementId divided by its volume
+    ///
+    Mat3d stiffnessBlock(const int elementId, const ElementLinearization& lin, const int a, const int b) const;
+
+    ///
+    /// \brief Differential of the first Piola-Kirchhoff stress for the deformation gradient increment \p dF
+    ///
+    Mat3d stressDifferential(const ElementLinearization& lin, const Mat3d& dF) const;
+
+    ///
+    /// \brief Greedy coloring of the elements, elements sharing a vertex get different colors
+    ///
+    void computeElementColors();
+
+    ///
+    /// \brief Build the CSR pattern of the stiffness and the element to nonzero scatter map
+    ///
+    void computeStiffnessPattern();
+
+    Material m_material;
+    double   m_mu;     ///> First Lame parameter
+    double   m_lambda; ///> Second Lame parameter
+
+    std::vector<Vec4i> m_elements;                             ///> Vertex indices of the elements
+    std::vector<double> m_restVolumes;                         ///> Rest volume of the elements
+    std::vector<Eigen::Matrix<double, 4, 3>> m_shapeGradients; ///> Rest shape function gradients, one row per vertex
+    std::vector<std::vector<int>> m_elementColors;             ///> Element ids grouped by color
+    std::vector<ElementLinearization> m_linearization;         ///> Element states of the last linearize
+
+    std::vector<int> m_rowOffsets;     ///> CSR row offsets of the stiffness pattern
+    std::vector<int> m_columnIndices;  ///> CSR column indices of the stiffness pattern
+    std::vector<int> m_elementScatter; ///> 144 nonzero indices per element, local stiffness in column major order
+
+    std::shared_ptr<vega::SparseMatrix> m_vegaTangentStiffnessMatrix; ///> Pattern handed back by the dynamical model
+};
+} // imstk
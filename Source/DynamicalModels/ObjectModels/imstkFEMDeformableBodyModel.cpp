@@ -26,8 +26,11 @@
 #include "imstkLinearFEMForceModel.h"
 #include "imstkLogger.h"
 #include "imstkNewtonSolver.h"
+#include "imstkParallelUtils.h"
 #include "imstkPointSet.h"
 #include "imstkTaskGraph.h"
+#include "imstkTetrahedralFEMForceModel.h"
+#include "imstkTetrahedralMesh.h"
 #include "imstkTimeIntegrator.h"
 #include "imstkTypes.h"
 #include "imstkVecDataArray.h"
@@ -85,6 +88,11 @@ FEMDeformableBodyModel::configure(const std::string& configFileName)
     vegaConfigFileOptions.addOptionOptional("compressionResistance", &m_FEModelConfig->m_compressionResistance, m_FEModelConfig->m_compressionResistance);
     vegaConfigFileOptions.addOptionOptional("inversionThreshold", &m_FEModelConfig->m_inversionThreshold, m_FEModelConfig->m_inversionThreshold);
     vegaConfigFileOptions.addOptionOptional("gravity", &m_FEModelConfig->m_gravity, m_FEModelConfig->m_gravity);
+    vegaConfigFileOptions.addOptionOptional("parallelAssembly", &m_FEModelConfig->m_parallelAssembly, m_FEModelConfig->m_parallelAssembly);
+    vegaConfigFileOptions.addOptionOptional("youngModulus", &m_FEModelConfig->m_youngModulus, m_FEModelConfig->m_youngModulus);
+    vegaConfigFileOptions.addOptionOptional("poissonRatio", &m_FEModelConfig->m_poissonRatio, m_FEModelConfig->m_poissonRatio);
+    vegaConfigFileOptions.addOptionOptional("matrixFree", &m_FEModelConfig->m_matrixFree, m_FEModelConfig->m_matrixFree);
+    vegaConfigFileOptions.addOptionOptional("eliminateFixedDOFs", &m_FEModelConfig->m_eliminateFixedDOFs, m_FEModelConfig->m_eliminateFixedDOFs);
 
     // Parse the configuration file
     CHECK(vegaConfigFileOptions.parseOptions(configFileName.data()) == 0)
@@ -171,10 +179,12 @@ FEMDeformableBodyModel::initialize()
 
         nlSystem->setUnknownVector(getUnknownVec());
         nlSystem->setUpdateFunction(getUpdateFunction());
+        nlSystem->setAdditiveUpdate(m_updateType == StateUpdateType::DeltaVelocity);
         nlSystem->setUpdatePreviousStatesFunction(getUpdatePrevStateFunction());
 
         // Create a linear solver
         auto linSolver = std::make_shared<ConjugateGradient>();
+        linSolver->setWarmStart(true);
 
         if (linSolver->getType() == imstk::LinearSolver<imstk::SparseMatrixd>::Type::GaussSeidel
             && isFixedBCImplemented())
@@ -188,13 +198,28 @@ FEMDeformableBodyModel::initialize()
         nlSolver->setLinearSolver(linSolver);
         nlSolver->setSystem(nlSystem);
         setSolver(nlSolver);
+        m_nonLinearSystem = nlSystem;
     }
 
     auto physicsMesh = std::dynamic_pointer_cast<imstk::VolumetricMesh>(this->getModelGeometry());
     m_vegaPhysicsMesh = VegaMeshIO::convertVolumetricMeshToVegaMesh(physicsMesh);
     //m_vegaPhysicsMesh = physicsMesh->getAttachedVegaMesh();
-    if (!this->initializeForceModel()
-        || !this->initializeMassMatrix()
+    if (!this->initializeForceModel())
+    {
+        return false;
+    }
+
+    // Matrix-free solves need a force model that applies its stiffness element by element
+    // and the default nonlinear system to hand the effective stiffness product to
+    m_matrixFree = m_FEModelConfig->m_matrixFree && m_internalForceModel->isMatrixFree() && m_nonLinearSystem;
+    LOG_IF(WARNING, m_FEModelConfig->m_matrixFree && !m_matrixFree)
+        << "Matrix-free solve requires the parallel assembly and the default solver, assembling the system";
+    if (m_matrixFree)
+    {
+        m_nonLinearSystem->setJacobianProduct(getFunctionGradientProduct(), &m_KeffDiagonal);
+    }
+
+    if (!this->initializeMassMatrix()
         || !this->initializeDampingMatrix()
         || !this->initializeTangentStiffness()
         || !this->loadBoundaryConditions()
@@ -204,6 +229,7 @@ FEMDeformableBodyModel::initialize()
         return false;
     }
 
+    this->initializeFreeDOFs();
     this->loadInitialStates();
 
     m_Feff.resize(m_numDOF);
@@ -293,6 +319,40 @@ FEMDeformableBodyModel::initializeForceModel()
 
     m_numDOF = (size_t)m_vegaPhysicsMesh->getNumVertices() * 3;
 
+    if (m_FEModelConfig->m_parallelAssembly)
+    {
+        // Native parallel element assembly, methods and materials it does not cover stay on Vega
+        using Material = TetrahedralFEMForceModel::Material;
+        auto tetMesh   = std::dynamic_pointer_cast<TetrahedralMesh>(m_geometry);
+        bool supported = tetMesh != nullptr;
+        auto material  = Material::Corotational;
+        switch (m_FEModelConfig->m_femMethod)
+        {
+        case FEMMethodType::Corotational:
+            material = Material::Corotational;
+            break;
+        case FEMMethodType::StVK:
+            material = Material::StVK;
+            break;
+        case FEMMethodType::Invertible:
+            supported = supported && m_FEModelConfig->m_hyperElasticMaterialType != HyperElasticMaterialType::MooneyRivlin;
+            material  = (m_FEModelConfig->m_hyperElasticMaterialType == HyperElasticMaterialType::NeoHookean) ?
+                        Material::NeoHookean : Material::StVK;
+            break;
+        default:
+            supported = false;
+            break;
+        }
+
+        if (supported)
+        {
+            m_internalForceModel = std::make_shared<TetrahedralFEMForceModel>(tetMesh, material,
+                m_FEModelConfig->m_youngModulus, m_FEModelConfig->m_poissonRatio);
+            return true;
+        }
+        LOG(WARNING) << "Parallel assembly is not available for this FEM method or material, using Vega";
+    }
+
     switch (m_FEModelConfig->m_femMethod)
     {
     case FEMMethodType::StVK:
@@ -401,6 +461,12 @@ FEMDeformableBodyModel::initializeTangentStiffness()
     CHECK(m_internalForceModel != nullptr)
         << "Tangent stiffness cannot be initialized without force model";
 
+    // Neither the tangent nor the effective stiffness is assembled
+    if (m_matrixFree)
+    {
+        return true;
+    }
+
     vega::SparseMatrix* matrix = nullptr;
     m_internalForceModel->getTangentStiffnessMatrixTopology(&matrix);
 
@@ -416,7 +482,8 @@ FEMDeformableBodyModel::initializeTangentStiffness()
 
     m_vegaTangentStiffnessMatrix.reset(matrix);
 
-    this->initializeEigenMatrixFromVegaMatrix(*matrix, m_K);
+    // Allocates m_K once, the force model then only writes its values
+    m_internalForceModel->initializeTangentStiffness(m_vegaTangentStiffnessMatrix, m_K);
 
     if (m_damped)
     {
@@ -427,8 +494,6 @@ FEMDeformableBodyModel::initializeTangentStiffness()
         m_C = dampingMassCoefficient * m_M + dampingStiffnessCoefficient * m_K;
     }
 
-    m_internalForceModel->setTangentStiffness(m_vegaTangentStiffnessMatrix);
-
     return true;
 }
 
@@ -461,12 +526,13 @@ FEMDeformableBodyModel::computeImplicitSystemRHS(kinematicState&       stateAtT,
     {
     case StateUpdateType::DeltaVelocity:
 
-        m_internalForceModel->getTangentStiffnessMatrix(u, m_K);
-        m_Feff = m_K * -(uPrev - u + v * dT);
+        this->updateTangentStiffness(u);
+        this->multiplyStiffness(-(uPrev - u + v * dT), m_Feff);
 
         if (m_damped)
         {
-            m_Feff -= m_C * v;
+            this->multiplyDamping(v, m_productTemp);
+            m_Feff -= m_productTemp;
         }
 
         m_internalForceModel->getInternalForce(u, m_Finternal);
@@ -494,18 +560,19 @@ FEMDeformableBodyModel::computeSemiImplicitSystemRHS(kinematicState&       state
     //auto& v     = newState.getQDot();
 
     // Do checks if there are uninitialized matrices
-    m_internalForceModel->getTangentStiffnessMatrix(u, m_K);
+    this->updateTangentStiffness(u);
     const double dT = m_timeIntegrator->getTimestepSize();
 
     switch (updateType)
     {
     case StateUpdateType::DeltaVelocity:
 
-        m_Feff = m_K * (vPrev * -dT);
+        this->multiplyStiffness(vPrev * -dT, m_Feff);
 
         if (m_damped)
         {
-            m_Feff -= m_C * vPrev;
+            this->multiplyDamping(vPrev, m_productTemp);
+            m_Feff -= m_productTemp;
         }
 
         m_internalForceModel->getInternalForce(u, m_Finternal);
@@ -533,15 +600,10 @@ FEMDeformableBodyModel::computeImplicitSystemLHS(const kinematicState& imstkNotU
     {
     case StateUpdateType::DeltaVelocity:
         this->updateMassMatrix();
-        m_internalForceModel->getTangentStiffnessMatrix(newState.getQ(), m_K);
+        this->updateTangentStiffness(newState.getQ());
         this->updateDampingMatrix();
 
-        m_Keff = m_M;
-        if (m_damped)
-        {
-            m_Keff += dT * m_C;
-        }
-        m_Keff += (dT * dT) * m_K;
+        this->updateEffectiveStiffness(dT);
 
         break;
 
@@ -563,22 +625,18 @@ FEMDeformableBodyModel::computeSemiImplicitSystemRHSAndLHS(kinematicState&
     case StateUpdateType::DeltaVelocity:
         // LHS
         this->updateMassMatrix();
-        m_internalForceModel->getForceAndMatrix(newState.getQ(), m_Finternal, m_K);
+        this->updateInternalForceAndTangentStiffness(newState.getQ());
         this->updateDampingMatrix();
 
-        m_Keff = m_M;
-        if (m_damped)
-        {
-            m_Keff += dT * m_C;
-        }
-        m_Keff += (dT * dT) * m_K;
+        this->updateEffectiveStiffness(dT);
 
         // RHS
-        m_Feff = m_K * (vPrev * -dT);
+        this->multiplyStiffness(vPrev * -dT, m_Feff);
 
         if (m_damped)
         {
-            m_Feff -= m_C * vPrev;
+            this->multiplyDamping(vPrev, m_productTemp);
+            m_Feff -= m_productTemp;
         }
 
         m_Feff -= m_Finternal;
@@ -610,22 +668,18 @@ FEMDeformableBodyModel::computeImplicitSystemRHSAndLHS(kinematicState&       sta
     case StateUpdateType::DeltaVelocity:
         // LHS
         this->updateMassMatrix();
-        m_internalForceModel->getForceAndMatrix(u, m_Finternal, m_K);
+        this->updateInternalForceAndTangentStiffness(u);
         this->updateDampingMatrix();
 
-        m_Keff = m_M;
-        if (m_damped)
-        {
-            m_Keff += dT * m_C;
-        }
-        m_Keff += (dT * dT) * m_K;
+        this->updateEffectiveStiffness(dT);
 
         // RHS
-        m_Feff = m_K * -(uPrev - u + v * dT);
+        this->multiplyStiffness(-(uPrev - u + v * dT), m_Feff);
 
         if (m_damped)
         {
-            m_Feff -= m_C * v;
+            this->multiplyDamping(v, m_productTemp);
+            m_Feff -= m_productTemp;
         }
 
         m_Feff -= m_Finternal;
@@ -653,7 +707,8 @@ FEMDeformableBodyModel::initializeExplicitExternalForces()
 void
 FEMDeformableBodyModel::updateDampingMatrix()
 {
-    if (m_damped)
+    // The Rayleigh damping is applied through multiplyDamping
+    if (m_damped && !m_matrixFree)
     {
         const auto& dampingStiffnessCoefficient = m_FEModelConfig->m_dampingStiffnessCoefficient;
         const auto& dampingMassCoefficient      = m_FEModelConfig->m_dampingMassCoefficient;
@@ -674,6 +729,314 @@ FEMDeformableBodyModel::updateDampingMatrix()
     }
 }
 
+void
+FEMDeformableBodyModel::setUpdateType(const StateUpdateType& updateType)
+{
+    m_updateType = updateType;
+
+    // Velocity increments can be scaled by a line search, velocities replace the iterate
+    if (m_nonLinearSystem)
+    {
+        m_nonLinearSystem->setAdditiveUpdate(updateType == StateUpdateType::DeltaVelocity);
+    }
+}
+
+void
+FEMDeformableBodyModel::updateTangentStiffness(const Vectord& u)
+{
+    if (m_matrixFree)
+    {
+        // The residual needs the stiffness product at u, so every residual evaluation also
+        // relinearizes the product of the Jacobian, a lagged Jacobian only keeps its diagonal
+        m_internalForceModel->linearize(u);
+    }
+    else
+    {
+        m_internalForceModel->getTangentStiffnessMatrix(u, m_K);
+    }
+}
+
+void
+FEMDeformableBodyModel::updateInternalForceAndTangentStiffness(const Vectord& u)
+{
+    if (m_matrixFree)
+    {
+        m_internalForceModel->linearize(u, &m_Finternal);
+    }
+    else
+    {
+        m_internalForceModel->getForceAndMatrix(u, m_Finternal, m_K);
+    }
+}
+
+void
+FEMDeformableBodyModel::updateEffectiveStiffness(const double dT)
+{
+    if (!m_matrixFree)
+    {
+        if (this->useReducedSystem())
+        {
+            this->assembleReducedEffectiveStiffness(dT);
+            return;
+        }
+        m_Keff = m_M;
+        if (m_damped)
+        {
+            m_Keff += dT * m_C;
+        }
+        m_Keff += (dT * dT) * m_K;
+        return;
+    }
+
+    // Only the diagonal is formed, for the Jacobi preconditioner
+    m_internalForceModel->getTangentStiffnessDiagonal(m_productTemp);
+    m_KeffDiagonal = m_M.diagonal();
+    if (m_damped)
+    {
+        const double dampingStiffnessCoefficient = m_FEModelConfig->m_dampingStiffnessCoefficient;
+        const double dampingMassCoefficient      = m_FEModelConfig->m_dampingMassCoefficient;
+        if (dampingMassCoefficient > 0 || dampingStiffnessCoefficient > 0)
+        {
+            m_KeffDiagonal *= 1.0 + dT * std::max(dampingMassCoefficient, 0.0);
+            m_KeffDiagonal += (dT * std::max(dampingStiffnessCoefficient, 0.0)) * m_productTemp;
+        }
+        else
+        {
+            m_KeffDiagonal += dT * m_C.diagonal();
+        }
+    }
+    m_KeffDiagonal += (dT * dT) * m_productTemp;
+
+    if (this->useReducedSystem())
+    {
+        Vectord reducedDiagonal;
+        restrictToFreeDOFs(m_KeffDiagonal, reducedDiagonal);
+        m_KeffDiagonal = std::move(reducedDiagonal);
+    }
+    else if (m_implementFixedBC)
+    {
+        applyBoundaryConditions(m_KeffDiagonal);
+    }
+}
+
+void
+FEMDeformableBodyModel::multiplyStiffness(const Vectord& x, Vectord& y) const
+{
+    if (m_matrixFree)
+    {
+        m_internalForceModel->multiplyTangentStiffness(x, y);
+    }
+    else
+    {
+        y = m_K * x;
+    }
+}
+
+void
+FEMDeformableBodyModel::multiplyDamping(const Vectord& x, Vectord& y) const
+{
+    if (!m_matrixFree)
+    {
+        y = m_C * x;
+        return;
+    }
+
+    // Same Rayleigh damping as updateDampingMatrix, the Laplacian damping matrix is constant
+    const double dampingStiffnessCoefficient = m_FEModelConfig->m_dampingStiffnessCoefficient;
+    const double dampingMassCoefficient      = m_FEModelConfig->m_dampingMassCoefficient;
+    if (dampingStiffnessCoefficient > 0)
+    {
+        m_internalForceModel->multiplyTangentStiffness(x, y);
+        y *= dampingStiffnessCoefficient;
+        if (dampingMassCoefficient > 0)
+        {
+            y += dampingMassCoefficient * (m_M * x);
+        }
+    }
+    else if (dampingMassCoefficient > 0)
+    {
+        y = dampingMassCoefficient * (m_M * x);
+    }
+    else
+    {
+        y = m_C * x;
+    }
+}
+
+void
+FEMDeformableBodyModel::multiplyEffectiveStiffness(const Vectord& x, Vectord& y)
+{
+    const double dT = m_timeIntegrator->getTimestepSize();
+
+    // Keff x = M x + dT C x + dT^2 K x, rows and columns of the fixed nodes are nullified
+    m_productInput = x;
+    if (m_implementFixedBC)
+    {
+        applyBoundaryConditions(m_productInput);
+    }
+
+    y = m_M * m_productInput;
+    if (m_damped)
+    {
+        this->multiplyDamping(m_productInput, m_productTemp);
+        y += dT * m_productTemp;
+    }
+    this->multiplyStiffness(m_productInput, m_productTemp);
+    y += (dT * dT) * m_productTemp;
+
+    if (m_implementFixedBC)
+    {
+        applyBoundaryConditions(y);
+    }
+}
+
+void
+FEMDeformableBodyModel::initializeFreeDOFs()
+{
+    m_eliminateFixedDOFs  = m_FEModelConfig->m_eliminateFixedDOFs;
+    m_reducedFixedNodeIds = m_fixedNodeIds;
+    m_MReducedMap.clear();
+    m_CReducedMap.clear();
+    m_KReducedMap.clear();
+
+    std::vector<bool> fixed(m_numDOF, false);
+    for (const auto& index : m_fixedNodeIds)
+    {
+        fixed[3 * index] = fixed[3 * index + 1] = fixed[3 * index + 2] = true;
+    }
+
+    m_freeDOFs.clear();
+    m_reducedIndices.assign(m_numDOF, -1);
+    for (size_t i = 0; i < m_numDOF; ++i)
+    {
+        if (!fixed[i])
+        {
+            m_reducedIndices[i] = static_cast<int>(m_freeDOFs.size());
+            m_freeDOFs.push_back(static_cast<int>(i));
+        }
+    }
+}
+
+void
+FEMDeformableBodyModel::updateFreeDOFs()
+{
+    // The fixed nodes can be edited through getFixNodeIds after initialization
+    if (m_eliminateFixedDOFs && m_fixedNodeIds != m_reducedFixedNodeIds)
+    {
+        this->initializeFreeDOFs();
+    }
+}
+
+void
+FEMDeformableBodyModel::restrictToFreeDOFs(const Vectord& full, Vectord& reduced) const
+{
+    reduced.resize(m_freeDOFs.size());
+    for (size_t i = 0; i < m_freeDOFs.size(); ++i)
+    {
+        reduced[i] = full[m_freeDOFs[i]];
+    }
+}
+
+void
+FEMDeformableBodyModel::prolongFromFreeDOFs(const Vectord& reduced, Vectord& full) const
+{
+    full.setZero(m_numDOF);
+    for (size_t i = 0; i < m_freeDOFs.size(); ++i)
+    {
+        full[m_freeDOFs[i]] = reduced[i];
+    }
+}
+
+void
+FEMDeformableBodyModel::initializeReducedEffectiveStiffness()
+{
+    // The free block of Keff has the union of the patterns of the free blocks of M, C and K
+    const SparseMatrixd* matrices[]  = { &m_M, &m_K, &m_C };
+    std::vector<int>*    maps[]      = { &m_MReducedMap, &m_KReducedMap, &m_CReducedMap };
+    const int            numMatrices = m_damped ? 3 : 2;
+    for (int k = 0; k < numMatrices; ++k)
+    {
+        maps[k]->assign(static_cast<size_t>(matrices[k]->nonZeros()), -1);
+    }
+
+    const int        numFree = static_cast<int>(m_freeDOFs.size());
+    std::vector<int> reducedOuterIndices(numFree + 1, 0);
+    std::vector<int> reducedInnerIndices;
+    std::vector<int> rowColumns;
+    for (int row = 0; row < numFree; ++row)
+    {
+        rowColumns.clear();
+        for (int k = 0; k < numMatrices; ++k)
+        {
+            for (SparseMatrixd::InnerIterator it(*matrices[k], m_freeDOFs[row]); it; ++it)
+            {
+                if (m_reducedIndices[it.col()] >= 0)
+                {
+                    rowColumns.push_back(m_reducedIndices[it.col()]);
+                }
+            }
+        }
+        std::sort(rowColumns.begin(), rowColumns.end());
+        rowColumns.erase(std::unique(rowColumns.begin(), rowColumns.end()), rowColumns.end());
+
+        for (int k = 0; k < numMatrices; ++k)
+        {
+            const double* values = matrices[k]->valuePtr();
+            for (SparseMatrixd::InnerIterator it(*matrices[k], m_freeDOFs[row]); it; ++it)
+            {
+                const int col = m_reducedIndices[it.col()];
+                if (col >= 0)
+                {
+                    const auto pos = std::lower_bound(rowColumns.begin(), rowColumns.end(), col) - rowColumns.begin();
+                    (*maps[k])[&it.value() - values] = reducedOuterIndices[row] + static_cast<int>(pos);
+                }
+            }
+        }
+        reducedInnerIndices.insert(reducedInnerIndices.end(), rowColumns.begin(), rowColumns.end());
+        reducedOuterIndices[row + 1] = static_cast<int>(reducedInnerIndices.size());
+    }
+
+    m_KeffReduced.resize(numFree, numFree);
+    m_KeffReduced.resizeNonZeros(static_cast<Eigen::Index>(reducedInnerIndices.size()));
+    std::copy(reducedOuterIndices.begin(), reducedOuterIndices.end(), m_KeffReduced.outerIndexPtr());
+    std::copy(reducedInnerIndices.begin(), reducedInnerIndices.end(), m_KeffReduced.innerIndexPtr());
+}
+
+void
+FEMDeformableBodyModel::assembleReducedEffectiveStiffness(const double dT)
+{
+    // The patterns of M, C and K are set at initialization, the maps are rebuilt with the
+    // free DOF numbering or if one of them gets another number of nonzeros
+    if (m_MReducedMap.size() != static_cast<size_t>(m_M.nonZeros())
+        || m_KReducedMap.size() != static_cast<size_t>(m_K.nonZeros())
+        || (m_damped && m_CReducedMap.size() != static_cast<size_t>(m_C.nonZeros())))
+    {
+        this->initializeReducedEffectiveStiffness();
+    }
+
+    const SparseMatrixd*    matrices[]  = { &m_M, &m_K, &m_C };
+    const std::vector<int>* maps[]      = { &m_MReducedMap, &m_KReducedMap, &m_CReducedMap };
+    const double            scales[]    = { 1.0, dT * dT, dT };
+    const int               numMatrices = m_damped ? 3 : 2;
+
+    double* reducedValues = m_KeffReduced.valuePtr();
+    std::fill_n(reducedValues, m_KeffReduced.nonZeros(), 0.0);
+    for (int k = 0; k < numMatrices; ++k)
+    {
+        // Nonzeros of one matrix land on distinct nonzeros of the free block
+        const double*           values = matrices[k]->valuePtr();
+        const std::vector<int>& map    = *maps[k];
+        ParallelUtils::parallelFor(map.size(),
+            [&](const size_t i)
+            {
+                if (map[i] >= 0)
+                {
+                    reducedValues[map[i]] += scales[k] * values[i];
+                }
+            });
+    }
+}
+
 void
 FEMDeformableBodyModel::applyBoundaryConditions(SparseMatrixd& M, const bool withCompliance) const
 {
@@ -794,9 +1157,15 @@ FEMDeformableBodyModel::getFunction()
     // Function to evaluate the nonlinear objective function given the current state
     return [&, this](const Vectord& q, const bool semiImplicit) -> const Vectord&
            {
+               this->updateFreeDOFs();
                (semiImplicit) ?
                this->computeSemiImplicitSystemRHS(*m_previousState.get(), *m_currentState.get(), m_updateType) :
                this->computeImplicitSystemRHS(*m_previousState.get(), *m_currentState.get(), m_updateType);
+               if (this->useReducedSystem())
+               {
+                   restrictToFreeDOFs(m_Feff, m_FeffReduced);
+                   return m_FeffReduced;
+               }
                if (this->m_implementFixedBC)
                {
                    applyBoundaryConditions(m_Feff);
@@ -818,9 +1187,14 @@ FEMDeformableBodyModel::getFunctionGradient()
     // Gradient of the nonlinear objective function given the current state
     return [&, this](const Vectord& q) -> const SparseMatrixd&
            {
+               this->updateFreeDOFs();
                this->computeImplicitSystemLHS(*m_previousState.get(), *m_currentState.get(), m_updateType);
 
-               if (this->m_implementFixedBC)
+               if (this->useReducedSystem())
+               {
+                   return m_KeffReduced;
+               }
+               if (this->m_implementFixedBC && !m_matrixFree)
                {
                    applyBoundaryConditions(m_Keff);
                }
@@ -843,13 +1217,22 @@ FEMDeformableBodyModel::getFunctionAndGradient()
     // return [&, this](const Vectord& q, const bool semiImplicit) -> NonLinearSolver<SparseMatrixd>::VecMatPair
     return [&, this](const Vectord& q, const bool semiImplicit)
            {
+               this->updateFreeDOFs();
                (semiImplicit) ?
                this->computeSemiImplicitSystemRHSAndLHS(*m_previousState.get(), *m_currentState.get(), m_updateType) :
                this->computeImplicitSystemRHSAndLHS(*m_previousState.get(), *m_currentState.get(), m_updateType);
+               if (this->useReducedSystem())
+               {
+                   restrictToFreeDOFs(m_Feff, m_FeffReduced);
+                   return std::make_pair(&m_FeffReduced, &m_KeffReduced);
+               }
                if (this->m_implementFixedBC)
                {
                    applyBoundaryConditions(m_Feff);
-                   applyBoundaryConditions(m_Keff);
+                   if (!m_matrixFree)
+                   {
+                       applyBoundaryConditions(m_Keff);
+                   }
                }
                return std::make_pair(&m_Feff, &m_Keff);
            };
@@ -858,15 +1241,41 @@ FEMDeformableBodyModel::getFunctionAndGradient()
 #endif
 }
 
+NonLinearSystem<SparseMatrixd>::ProductFunctionType
+FEMDeformableBodyModel::getFunctionGradientProduct()
+{
+    // Product of the gradient evaluated by the last call of the gradient functions with a vector
+    return [this](const Vectord& x, Vectord& y)
+           {
+               if (this->useReducedSystem())
+               {
+                   prolongFromFreeDOFs(x, m_reducedInput);
+                   this->multiplyEffectiveStiffness(m_reducedInput, m_reducedOutput);
+                   restrictToFreeDOFs(m_reducedOutput, y);
+               }
+               else
+               {
+                   this->multiplyEffectiveStiffness(x, y);
+               }
+           };
+}
+
 NonLinearSystem<SparseMatrixd>::UpdateFunctionType
 FEMDeformableBodyModel::getUpdateFunction()
 {
     // Function to evaluate the nonlinear objective function given the current state
     return [&, this](const Vectord& q, const bool fullyImplicit) -> void
            {
+               // Solutions of the reduced system are scattered back, the fixed DOFs do not move
+               const Vectord* solution = &q;
+               if (this->useReducedSystem())
+               {
+                   prolongFromFreeDOFs(q, m_reducedInput);
+                   solution = &m_reducedInput;
+               }
                (fullyImplicit) ?
-               this->updateBodyIntermediateStates(q, m_updateType) :
-               this->updateBodyStates(q, m_updateType);
+               this->updateBodyIntermediateStates(*solution, m_updateType) :
+               this->updateBodyStates(*solution, m_updateType);
            };
 }
 
@@ -884,22 +1293,7 @@ void
 FEMDeformableBodyModel::initializeEigenMatrixFromVegaMatrix(const vega::SparseMatrix& vegaMatrix,
                                                             SparseMatrixd&            eigenMatrix)
 {
-    auto rowLengths    = vegaMatrix.GetRowLengths();
-    auto nonZeroValues = vegaMatrix.GetEntries();
-    auto columnIndices = vegaMatrix.GetColumnIndices();
-
-    std::vector<Eigen::Triplet<double>> triplets;
-    triplets.reserve(vegaMatrix.GetNumEntries());
-    for (int i = 0, end = vegaMatrix.GetNumRows(); i < end; ++i)
-    {
-        for (int k = 0, k_end = rowLengths[i]; k < k_end; ++k)
-        {
-            triplets.emplace_back(i, columnIndices[i][k], nonZeroValues[i][k]);
-        }
-    }
-    eigenMatrix.resize(vegaMatrix.GetNumRows(), vegaMatrix.GetNumColumns());
-    eigenMatrix.setFromTriplets(std::begin(triplets), std::end(triplets));
-    eigenMatrix.makeCompressed();
+    InternalForceModel::buildEigenMatrixFromVegaMatrix(vegaMatrix, eigenMatrix);
 }
 
 void
@@ -60,6 +60,12 @@ struct FEMModelConfig
     double m_compressionResistance       = 500.0;
     double m_inversionThreshold = -std::numeric_limits<double>::max();
     double m_gravity = 9.81;
+
+    bool   m_parallelAssembly   = false; ///> Use the native parallel element assembly for the corotational, StVK and Neo-Hookean methods
+    double m_youngModulus       = 1.0e7; ///> Young's modulus used by the native assembly
+    double m_poissonRatio       = 0.4;   ///> Poisson's ratio used by the native assembly
+    bool   m_matrixFree         = false; ///> Solve without assembling the stiffness, requires the parallel assembly and the default solver
+    bool   m_eliminateFixedDOFs = false; ///> Solve for the free DOFs only instead of nullifying the rows and columns of the fixed ones
 };
 
 ///
@@ -191,6 +197,63 @@ public:
     ///
     void updateDampingMatrix();
 
+    ///
+    /// \brief Update the tangent stiffness at \p u, only its linearization when matrix-free
+    ///
+    void updateTangentStiffness(const Vectord& u);
+
+    ///
+    /// \brief Update the internal force and the tangent stiffness at \p u
+    ///
+    void updateInternalForceAndTangentStiffness(const Vectord& u);
+
+    ///
+    /// \brief Form the effective stiffness M + dT C + dT^2 K, only its diagonal when matrix-free
+    ///
+    void updateEffectiveStiffness(const double dT);
+
+    ///
+    /// \brief Compute \p y = K x and \p y = C x, element by element when matrix-free
+    ///
+    void multiplyStiffness(const Vectord& x, Vectord& y) const;
+    void multiplyDamping(const Vectord& x, Vectord& y) const;
+
+    ///
+    /// \brief Compute \p y = Keff x with the fixed boundary conditions applied
+    ///
+    void multiplyEffectiveStiffness(const Vectord& x, Vectord& y);
+
+    ///
+    /// \brief Number the free DOFs, used when the fixed DOFs are eliminated from the system
+    ///
+    void initializeFreeDOFs();
+
+    ///
+    /// \brief Number the free DOFs again if the fixed nodes changed since they were numbered
+    ///
+    void updateFreeDOFs();
+
+    ///
+    /// \brief Whether the linear systems only contain the free DOFs
+    ///
+    bool useReducedSystem() const { return m_eliminateFixedDOFs && m_implementFixedBC && m_freeDOFs.size() < m_numDOF; }
+
+    ///
+    /// \brief Gather the free DOFs of \p full into \p reduced, and scatter them back with zero fixed DOFs
+    ///
+    void restrictToFreeDOFs(const Vectord& full, Vectord& reduced) const;
+    void prolongFromFreeDOFs(const Vectord& reduced, Vectord& full) const;
+
+    ///
+    /// \brief Allocate the free block of the effective stiffness and map the nonzeros of M, C and K into it
+    ///
+    void initializeReducedEffectiveStiffness();
+
+    ///
+    /// \brief Assemble the free block of M + dT C + dT^2 K without forming the full effective stiffness
+    ///
+    void assembleReducedEffectiveStiffness(const double dT);
+
     ///
     /// \brief Applies boundary conditions to matrix and a vector
     ///
@@ -243,6 +306,17 @@ public:
     ///
     System::VectorMatrixFunctionType getFunctionAndGradient();
 
+    ///
+    /// \brief Returns the "function" that multiplies the gradient evaluated by the
+    /// gradient functions with a vector, used by matrix-free solves
+    ///
+    System::ProductFunctionType getFunctionGradientProduct();
+
+    ///
+    /// \brief Whether the linear systems are solved without assembling the stiffness
+    ///
+    bool isMatrixFree() const { return m_matrixFree; }
+
     ///
     /// \brief Get the contact force vector
     ///
@@ -256,7 +330,7 @@ public:
     ///
     /// \brief Set/Get the update type
     ///
-    void setUpdateType(const StateUpdateType& updateType) { m_updateType = updateType; }
+    void setUpdateType(const StateUpdateType& updateType);
     const StateUpdateType& getUpdateType() const { return m_updateType; }
 
     /// \brief Returns the unknown vectors
@@ -331,6 +405,25 @@ protected:
 
     bool m_damped = false;                                                        ///> Viscous or structurally damped system
 
+    bool    m_matrixFree = false;                                                 ///> Stiffness applied element by element, K and Keff are not assembled
+    Vectord m_KeffDiagonal;                                                       ///> Diagonal of the effective stiffness when matrix-free
+    Vectord m_productInput;                                                       ///> Scratch input of the matrix-free products
+    Vectord m_productTemp;                                                        ///> Scratch storage of the stiffness and damping products
+
+    // Elimination of the fixed DOFs
+    bool             m_eliminateFixedDOFs = false;                                ///> Linear systems are restricted to the free DOFs
+    std::vector<int> m_freeDOFs;                                                  ///> Full index of every free DOF
+    std::vector<int> m_reducedIndices;                                            ///> Reduced index of every DOF, -1 if fixed
+    SparseMatrixd    m_KeffReduced;                                               ///> Free block of the effective stiffness
+    std::vector<int> m_MReducedMap;                                               ///> Position in the free block of every nonzero of M, -1 if fixed
+    std::vector<int> m_CReducedMap;                                               ///> Position in the free block of every nonzero of C, -1 if fixed
+    std::vector<int> m_KReducedMap;                                               ///> Position in the free block of every nonzero of K, -1 if fixed
+    Vectord          m_FeffReduced;                                               ///> Free DOFs of the effective force
+    Vectord          m_reducedInput;                                              ///> Full size scratch of the reduced products and updates
+    Vectord          m_reducedOutput;                                             ///> Full size scratch of the reduced products
+
+    std::vector<std::size_t> m_reducedFixedNodeIds;                               ///> Fixed nodes the free DOFs were numbered for
+
     // If this is true, the tangent stiffness and force vector will be modified to
     // accommodate (the rows and columns will be nullified) the fixed boundary conditions
     bool m_implementFixedBC = true;
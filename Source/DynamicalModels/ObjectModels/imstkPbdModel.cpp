@@ -24,6 +24,7 @@
 #include "imstkLineMesh.h"
 #include "imstkLogger.h"
 #include "imstkParallelUtils.h"
+#include "imstkReordering.h"
 //#include "imstkPbdFEMTetConstraint.h"
 #include "imstkPbdSolver.h"
 #include "imstkSurfaceMesh.h"
@@ -315,6 +316,71 @@ PbdModel::addConstraints(std::shared_ptr<std::unordered_set<size_t>> vertices)
     }
 }
 
+void
+PbdModel::reorderVertices(const std::vector<size_t>& newToOld)
+{
+    CHECK(m_mesh != nullptr && m_constraints != nullptr) << "PbdModel must be initialized before reordering its vertices";
+
+    // The mesh reorders its positions and attributes, among which the masses, velocities and
+    // accelerations. The state arrays that are not on the mesh are reordered once here
+    std::unordered_set<AbstractDataArray*> meshArrays = { m_mesh->getInitialVertexPositions().get(), m_mesh->getVertexPositions().get() };
+    for (const auto& attribute : m_mesh->getVertexAttributes())
+    {
+        meshArrays.insert(attribute.second.get());
+    }
+    std::vector<std::shared_ptr<AbstractDataArray>> stateArrays;
+
+    auto addStateArray = [&](std::shared_ptr<AbstractDataArray> data)
+                         {
+                             if (meshArrays.count(data.get()) == 0)
+                             {
+                                 stateArrays.push_back(data);
+                             }
+                         };
+    for (auto state : { m_initialState, m_previousState, m_currentState })
+    {
+        addStateArray(state->getPositions());
+        addStateArray(state->getVelocities());
+        addStateArray(state->getAccelerations());
+    }
+    addStateArray(m_mass);
+    addStateArray(m_invMass);
+
+    m_mesh->reorderVertices(newToOld);
+    Reordering::permuteArrays(stateArrays, newToOld);
+
+    const std::vector<size_t> oldToNew = Reordering::invertPermutation(newToOld);
+    for (auto& id : m_config->m_fixedNodeIds)
+    {
+        id = oldToNew[id];
+    }
+    std::unordered_map<size_t, double> fixedNodeInvMass;
+    for (const auto& fixedNode : *m_fixedNodeInvMass)
+    {
+        fixedNodeInvMass[oldToNew[fixedNode.first]] = fixedNode.second;
+    }
+    m_fixedNodeInvMass->swap(fixedNodeInvMass);
+
+    // A constraint is either solved sequentially or in a partition, the partitions stay valid
+    // since renumbering keeps which constraints share vertices
+    std::vector<std::shared_ptr<PbdConstraint>> constraints = m_constraints->getConstraints();
+    for (const auto& partition : m_constraints->getPartitionedConstraints())
+    {
+        constraints.insert(constraints.end(), partition.begin(), partition.end());
+    }
+    std::unordered_set<PbdConstraint*> renumbered;
+    for (const auto& constraint : constraints)
+    {
+        if (renumbered.insert(constraint.get()).second)
+        {
+            for (auto& vertexId : constraint->getVertexIds())
+            {
+                vertexId = oldToNew[vertexId];
+            }
+        }
+    }
+}
+
 void
 PbdModel::setParticleMass(const double val, const size_t idx)
 {
@@ -208,6 +208,15 @@ public:
     ///
     void initState();
 
+    ///
+    /// \brief Reorder the vertices of the initialized model for memory locality, for instance by
+    /// Reordering::computeMortonOrder. The mesh, the states, the masses, the fixed nodes and the
+    /// vertex ids of the constraints are renumbered consistently. Maps from or to the mesh must
+    /// be renumbered with GeometryMap::reorderVertices, see PbdObject::reorderVertices
+    /// \param newToOld Permutation where vertex i becomes the vertex newToOld[i]
+    ///
+    void reorderVertices(const std::vector<size_t>& newToOld);
+
     ///
     /// \brief Set the threshold for constraint partitioning
     ///
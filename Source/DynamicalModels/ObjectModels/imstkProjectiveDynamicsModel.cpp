@@ -0,0 +1,493 @@
+/*=========================================================================
+
+   Library: iMSTK
+
+   Copyright (c) Kitware, Inc. & Center for Modeling, Simulation,
+   & Imaging in Medicine, Rensselaer Polytechnic Institute.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+=========================================================================*/
+
+#include "imstkProjectiveDynamicsModel.h"
+#include "imstkDirectLinearSolver.h"
+#include "imstkLogger.h"
+#include "imstkParallelUtils.h"
+#include "imstkSurfaceMesh.h"
+#include "imstkTaskGraph.h"
+#include "imstkTetrahedralElement.h"
+#include "imstkTetrahedralMesh.h"
+
+#include <set>
+
+namespace imstk
+{
+ProjectiveDynamicsModel::ProjectiveDynamicsModel() : DynamicalModel(DynamicalModelType::ElastoDynamics),
+    m_config(std::make_shared<ProjectiveDynamicsModelConfig>()),
+    m_mass(std::make_shared<DataArray<double>>()),
+    m_inertialPositions(std::make_shared<VecDataArray<double, 3>>())
+{
+    m_validGeometryTypes = {
+        "SurfaceMesh",
+        "TetrahedralMesh"
+    };
+
+    m_integrationPositionNode = m_taskGraph->addFunction("ProjectiveDynamicsModel_IntegratePosition", std::bind(&ProjectiveDynamicsModel::integratePosition, this));
+    m_solveNode = m_taskGraph->addFunction("ProjectiveDynamicsModel_Solve", std::bind(&ProjectiveDynamicsModel::solve, this));
+    m_updateVelocityNode = m_taskGraph->addFunction("ProjectiveDynamicsModel_UpdateVelocity", std::bind(&ProjectiveDynamicsModel::updateVelocity, this));
+}
+
+ProjectiveDynamicsModel::~ProjectiveDynamicsModel() = default;
+
+bool
+ProjectiveDynamicsModel::initialize()
+{
+    LOG_IF(FATAL, (!this->getModelGeometry())) << "Model geometry is not yet set! Cannot initialize without model geometry.";
+
+    initState();
+
+    m_tetrahedra.clear();
+    m_shapeGradients.clear();
+    m_tetWeights.clear();
+    m_edges.clear();
+    m_restLengths.clear();
+    m_bendVertices.clear();
+    m_bendOffsets.assign(1, 0);
+    m_bendNeighbors.clear();
+    m_restCurvatures.clear();
+
+    if (auto tetMesh = std::dynamic_pointer_cast<TetrahedralMesh>(m_mesh))
+    {
+        initTetrahedralConstraints(tetMesh);
+    }
+    else if (auto surfMesh = std::dynamic_pointer_cast<SurfaceMesh>(m_mesh))
+    {
+        initSurfaceConstraints(surfMesh);
+    }
+    else
+    {
+        LOG(WARNING) << "ProjectiveDynamicsModel::initialize - " << m_mesh->getTypeName() << " is not supported";
+        return false;
+    }
+
+    initConstraintLaplacian();
+    factorizeGlobalSystem();
+
+    this->setTimeStepSizeType(m_timeStepSizeType);
+
+    return true;
+}
+
+void
+ProjectiveDynamicsModel::initState()
+{
+    m_mesh = std::dynamic_pointer_cast<PointSet>(m_geometry);
+    const int numVertices = m_mesh->getNumVertices();
+    m_numDOF = 3 * static_cast<size_t>(numVertices);
+
+    m_initialState  = std::make_shared<PbdState>(numVertices);
+    m_previousState = std::make_shared<PbdState>(numVertices);
+    m_currentState  = std::make_shared<PbdState>(numVertices);
+
+    // Set the positional values (by ptr reference)
+    m_initialState->setPositions(m_mesh->getInitialVertexPositions());
+    m_currentState->setPositions(m_mesh->getVertexPositions());
+    m_previousState->setPositions(std::make_shared<VecDataArray<double, 3>>(*m_mesh->getVertexPositions()));
+    m_inertialPositions->resize(numVertices);
+
+    // If the input mesh has masses defined, use those, if not put uniform masses on the mesh
+    std::shared_ptr<AbstractDataArray> masses = m_mesh->getVertexAttribute("Mass");
+    if (masses != nullptr && masses->getNumberOfComponents() == 1 && masses->getScalarType() == IMSTK_DOUBLE && masses->size() == numVertices)
+    {
+        m_mass = std::dynamic_pointer_cast<DataArray<double>>(masses);
+    }
+    else
+    {
+        m_mass->resize(numVertices);
+        std::fill(m_mass->begin(), m_mass->end(), m_config->m_uniformMassValue);
+        m_mesh->setVertexAttribute("Mass", m_mass);
+    }
+    m_mesh->setVertexAttribute("Velocities", m_currentState->getVelocities());
+    m_mesh->setVertexAttribute("Accelerations", m_currentState->getAccelerations());
+
+    m_fixed.assign(numVertices, false);
+    for (const auto& i : m_config->m_fixedNodeIds)
+    {
+        if (i < static_cast<size_t>(numVertices))
+        {
+            m_fixed[i] = true;
+        }
+    }
+}
+
+void
+ProjectiveDynamicsModel::initTetrahedralConstraints(std::shared_ptr<TetrahedralMesh> mesh)
+{
+    const VecDataArray<double, 3>& vertices = *mesh->getInitialVertexPositions();
+    const VecDataArray<int, 4>&    tets     = *mesh->getTetrahedraIndices();
+
+    m_tetrahedra.reserve(tets.size());
+    m_shapeGradients.reserve(tets.size());
+    m_tetWeights.reserve(tets.size());
+    for (int e = 0; e < tets.size(); ++e)
+    {
+        Eigen::Matrix<double, 4, 3> gradients;
+        const double                det = TetrahedralElement::computeShapeGradients(vertices, tets[e], gradients);
+        if (std::abs(det) < std::numeric_limits<double>::epsilon())
+        {
+            LOG(WARNING) << "Degenerate tetrahedron " << e << " skipped by ProjectiveDynamicsModel";
+            continue;
+        }
+
+        m_tetrahedra.push_back(tets[e]);
+        m_shapeGradients.push_back(gradients);
+        m_tetWeights.push_back(m_config->m_strainStiffness * std::abs(det) / 6.0);
+    }
+}
+
+void
+ProjectiveDynamicsModel::initSurfaceConstraints(std::shared_ptr<SurfaceMesh> mesh)
+{
+    const VecDataArray<double, 3>& vertices  = *mesh->getInitialVertexPositions();
+    const VecDataArray<int, 3>&    triangles = *mesh->getTriangleIndices();
+
+    std::set<std::pair<int, int>> edges;
+    for (int t = 0; t < triangles.size(); ++t)
+    {
+        const Vec3i& tri = triangles[t];
+        for (int k = 0; k < 3; ++k)
+        {
+            const int i = tri[k];
+            const int j = tri[(k + 1) % 3];
+            edges.insert(std::make_pair(std::min(i, j), std::max(i, j)));
+        }
+    }
+
+    std::vector<std::vector<int>> neighbors(vertices.size());
+    for (const auto& edge : edges)
+    {
+        m_edges.push_back(Vec2i(edge.first, edge.second));
+        m_restLengths.push_back((vertices[edge.second] - vertices[edge.first]).norm());
+        neighbors[edge.first].push_back(edge.second);
+        neighbors[edge.second].push_back(edge.first);
+    }
+
+    if (m_config->m_bendStiffness <= 0.0)
+    {
+        return;
+    }
+    for (int i = 0; i < vertices.size(); ++i)
+    {
+        if (neighbors[i].size() < 2)
+        {
+            continue;
+        }
+        Vec3d laplacian = Vec3d::Zero();
+        for (const auto& j : neighbors[i])
+        {
+            laplacian += vertices[j];
+        }
+        laplacian = laplacian / static_cast<double>(neighbors[i].size()) - vertices[i];
+
+        m_bendVertices.push_back(i);
+        m_bendNeighbors.insert(m_bendNeighbors.end(), neighbors[i].begin(), neighbors[i].end());
+        m_bendOffsets.push_back(static_cast<int>(m_bendNeighbors.size()));
+        m_restCurvatures.push_back(laplacian.norm());
+    }
+}
+
+void
+ProjectiveDynamicsModel::initConstraintLaplacian()
+{
+    const int numVertices = m_mesh->getNumVertices();
+
+    // Each constraint with selection matrix A and weight w adds w A^T A to the global matrix, and
+    // w A^T p to the right hand side of the vertices it involves, one slot per involved vertex
+    std::vector<Eigen::Triplet<double>> triplets;
+    std::vector<int>                    slotVertices;
+    for (size_t e = 0; e < m_tetrahedra.size(); ++e)
+    {
+        const auto& gradients = m_shapeGradients[e];
+        for (int a = 0; a < 4; ++a)
+        {
+            for (int b = 0; b < 4; ++b)
+            {
+                triplets.emplace_back(m_tetrahedra[e][a], m_tetrahedra[e][b], m_tetWeights[e] * gradients.row(a).dot(gradients.row(b)));
+            }
+            slotVertices.push_back(m_tetrahedra[e][a]);
+        }
+    }
+    for (const auto& edge : m_edges)
+    {
+        const double w = m_config->m_distanceStiffness;
+        triplets.emplace_back(edge[0], edge[0], w);
+        triplets.emplace_back(edge[1], edge[1], w);
+        triplets.emplace_back(edge[0], edge[1], -w);
+        triplets.emplace_back(edge[1], edge[0], -w);
+        slotVertices.push_back(edge[0]);
+        slotVertices.push_back(edge[1]);
+    }
+    for (size_t k = 0; k < m_bendVertices.size(); ++k)
+    {
+        // The bend vertex has a coefficient of -1 and its neighbors of 1/n in A
+        const int    start = m_bendOffsets[k];
+        const int    end   = m_bendOffsets[k + 1];
+        const double w     = m_config->m_bendStiffness;
+        const double c     = 1.0 / static_cast<double>(end - start);
+        triplets.emplace_back(m_bendVertices[k], m_bendVertices[k], w);
+        slotVertices.push_back(m_bendVertices[k]);
+        for (int i = start; i < end; ++i)
+        {
+            triplets.emplace_back(m_bendVertices[k], m_bendNeighbors[i], -w * c);
+            triplets.emplace_back(m_bendNeighbors[i], m_bendVertices[k], -w * c);
+            for (int j = start; j < end; ++j)
+            {
+                triplets.emplace_back(m_bendNeighbors[i], m_bendNeighbors[j], w * c * c);
+            }
+            slotVertices.push_back(m_bendNeighbors[i]);
+        }
+    }
+    m_constraintLaplacian.resize(numVertices, numVertices);
+    m_constraintLaplacian.setFromTriplets(triplets.begin(), triplets.end());
+
+    // Invert the slot to vertex map so the projection terms can be gathered per vertex without races
+    m_projections.resize(slotVertices.size());
+    m_vertexSlotOffsets.assign(numVertices + 1, 0);
+    for (const auto& vertex : slotVertices)
+    {
+        ++m_vertexSlotOffsets[vertex + 1];
+    }
+    for (int i = 0; i < numVertices; ++i)
+    {
+        m_vertexSlotOffsets[i + 1] += m_vertexSlotOffsets[i];
+    }
+    m_vertexSlots.resize(slotVertices.size());
+    std::vector<int> fill(m_vertexSlotOffsets.begin(), m_vertexSlotOffsets.end() - 1);
+    for (size_t slot = 0; slot < slotVertices.size(); ++slot)
+    {
+        m_vertexSlots[fill[slotVertices[slot]]++] = static_cast<int>(slot);
+    }
+}
+
+void
+ProjectiveDynamicsModel::factorizeGlobalSystem()
+{
+    const int    numVertices = m_mesh->getNumVertices();
+    const double dt = m_config->m_dt;
+    CHECK(dt > 0.0) << "ProjectiveDynamicsModel requires a positive time step";
+
+    std::vector<int> freeIndices(numVertices, -1);
+    m_freeVertices.clear();
+    for (int i = 0; i < numVertices; ++i)
+    {
+        if (!m_fixed[i])
+        {
+            freeIndices[i] = static_cast<int>(m_freeVertices.size());
+            m_freeVertices.push_back(i);
+        }
+    }
+    const int numFree = static_cast<int>(m_freeVertices.size());
+
+    // Split the free rows of M / dt^2 + L, the fixed columns move to the right hand side
+    const DataArray<double>&            masses = *m_mass;
+    std::vector<Eigen::Triplet<double>> systemTriplets;
+    std::vector<Eigen::Triplet<double>> couplingTriplets;
+    for (int row = 0; row < numFree; ++row)
+    {
+        const int vertex = m_freeVertices[row];
+        systemTriplets.emplace_back(row, row, masses[vertex] / (dt * dt));
+        for (SparseMatrixd::InnerIterator it(m_constraintLaplacian, vertex); it; ++it)
+        {
+            const int col = freeIndices[it.col()];
+            if (col >= 0)
+            {
+                systemTriplets.emplace_back(row, col, it.value());
+            }
+            else
+            {
+                couplingTriplets.emplace_back(row, static_cast<int>(it.col()), it.value());
+            }
+        }
+    }
+    m_systemMatrix.resize(numFree, numFree);
+    m_systemMatrix.setFromTriplets(systemTriplets.begin(), systemTriplets.end());
+    m_fixedCoupling.resize(numFree, numVertices);
+    m_fixedCoupling.setFromTriplets(couplingTriplets.begin(), couplingTriplets.end());
+
+    m_rhs.setZero(numFree);
+    m_rhsCoordinates.setZero(numFree, 3);
+    m_solver = std::make_shared<DirectLinearSolver<SparseMatrixd>>(m_systemMatrix, m_rhs,
+        DirectLinearSolver<SparseMatrixd>::Factorization::LDLT);
+    m_factorizedTimeStep = dt;
+}
+
+void
+ProjectiveDynamicsModel::integratePosition()
+{
+    VecDataArray<double, 3>& prevPos  = *m_previousState->getPositions();
+    VecDataArray<double, 3>& pos      = *m_currentState->getPositions();
+    VecDataArray<double, 3>& vel      = *m_currentState->getVelocities();
+    VecDataArray<double, 3>& accn     = *m_currentState->getAccelerations();
+    VecDataArray<double, 3>& inertial = *m_inertialPositions;
+    const double             dt       = m_config->m_dt;
+
+    ParallelUtils::parallelFor(m_mesh->getNumVertices(),
+        [&](const size_t i)
+        {
+            prevPos[i] = pos[i];
+            if (!m_fixed[i])
+            {
+                vel[i]  += (accn[i] + m_config->m_gravity) * dt;
+                accn[i]  = Vec3d::Zero();
+                pos[i]  += (1.0 - m_config->m_viscousDampingCoeff) * vel[i] * dt;
+            }
+            inertial[i] = pos[i];
+        }, m_mesh->getNumVertices() > 50);
+}
+
+void
+ProjectiveDynamicsModel::projectConstraints(const VecDataArray<double, 3>& q)
+{
+    ParallelUtils::parallelFor(m_tetrahedra.size(),
+        [&](const size_t e)
+        {
+            const Vec4i& tet       = m_tetrahedra[e];
+            const auto&  gradients = m_shapeGradients[e];
+            Mat3d        F = Mat3d::Zero();
+            for (int a = 0; a < 4; ++a)
+            {
+                F += q[tet[a]] * gradients.row(a);
+            }
+            const Mat3d R = TetrahedralElement::polarRotation(F);
+            for (int a = 0; a < 4; ++a)
+            {
+                m_projections[4 * e + a] = m_tetWeights[e] * (R * gradients.row(a).transpose());
+            }
+        });
+
+    const size_t edgeSlots = 4 * m_tetrahedra.size();
+    ParallelUtils::parallelFor(m_edges.size(),
+        [&](const size_t k)
+        {
+            const Vec3d  d      = q[m_edges[k][1]] - q[m_edges[k][0]];
+            const double length = d.norm();
+            const Vec3d  p      = (length > 0.0) ? Vec3d(m_config->m_distanceStiffness * m_restLengths[k] / length * d) : Vec3d::Zero();
+            m_projections[edgeSlots + 2 * k]     = -p;
+            m_projections[edgeSlots + 2 * k + 1] = p;
+        });
+
+    // Bend vertex k owns the slots [bendSlots + k + m_bendOffsets[k], bendSlots + k + 1 + m_bendOffsets[k + 1])
+    const size_t bendSlots = edgeSlots + 2 * m_edges.size();
+    ParallelUtils::parallelFor(m_bendVertices.size(),
+        [&](const size_t k)
+        {
+            const int    start = m_bendOffsets[k];
+            const int    end   = m_bendOffsets[k + 1];
+            const double c     = 1.0 / static_cast<double>(end - start);
+            Vec3d        laplacian = Vec3d::Zero();
+            for (int i = start; i < end; ++i)
+            {
+                laplacian += q[m_bendNeighbors[i]];
+            }
+            laplacian = c * laplacian - q[m_bendVertices[k]];
+
+            const double norm = laplacian.norm();
+            const Vec3d  p    = (norm > 0.0) ? Vec3d(m_config->m_bendStiffness * m_restCurvatures[k] / norm * laplacian) : Vec3d::Zero();
+            size_t       slot = bendSlots + k + start;
+            m_projections[slot++] = -p;
+            for (int i = start; i < end; ++i)
+            {
+                m_projections[slot++] = c * p;
+            }
+        });
+}
+
+void
+ProjectiveDynamicsModel::solve()
+{
+    if (m_config->m_dt != m_factorizedTimeStep)
+    {
+        factorizeGlobalSystem();
+    }
+
+    VecDataArray<double, 3>&       pos      = *m_currentState->getPositions();
+    const VecDataArray<double, 3>& inertial = *m_inertialPositions;
+    const DataArray<double>&       masses   = *m_mass;
+    const double                   invDt2   = 1.0 / (m_config->m_dt * m_config->m_dt);
+    const int                      numFree  = static_cast<int>(m_freeVertices.size());
+
+    using PositionMatrix = Eigen::Matrix<double, Eigen::Dynamic, 3, Eigen::RowMajor>;
+    for (unsigned int iter = 0; iter < m_config->m_iterations; ++iter)
+    {
+        // Local step
+        projectConstraints(pos);
+
+        // Global step, M / dt^2 q + L q = M / dt^2 s + sum_i w_i A_i^T p_i
+        ParallelUtils::parallelFor(numFree,
+            [&](const size_t row)
+            {
+                const int vertex = m_freeVertices[row];
+                Vec3d     b      = masses[vertex] * invDt2 * inertial[vertex];
+                for (int i = m_vertexSlotOffsets[vertex]; i < m_vertexSlotOffsets[vertex + 1]; ++i)
+                {
+                    b += m_projections[m_vertexSlots[i]];
+                }
+                m_rhsCoordinates.row(row) = b.transpose();
+            }, numFree > 50);
+        if (m_fixedCoupling.nonZeros() > 0)
+        {
+            m_rhsCoordinates -= m_fixedCoupling * Eigen::Map<const PositionMatrix>(pos.getPointer()->data(), pos.size(), 3);
+        }
+
+        for (int coord = 0; coord < 3; ++coord)
+        {
+            m_rhs = m_rhsCoordinates.col(coord);
+            m_solver->solve(m_rhs, m_solution);
+            for (int row = 0; row < numFree; ++row)
+            {
+                pos[m_freeVertices[row]][coord] = m_solution[row];
+            }
+        }
+    }
+}
+
+void
+ProjectiveDynamicsModel::updateVelocity()
+{
+    const VecDataArray<double, 3>& prevPos = *m_previousState->getPositions();
+    const VecDataArray<double, 3>& pos     = *m_currentState->getPositions();
+    VecDataArray<double, 3>&       vel     = *m_currentState->getVelocities();
+
+    if (m_config->m_dt > 0.0)
+    {
+        const double invDt = 1.0 / m_config->m_dt;
+        ParallelUtils::parallelFor(m_mesh->getNumVertices(),
+            [&](const size_t i)
+            {
+                if (!m_fixed[i])
+                {
+                    vel[i] = (pos[i] - prevPos[i]) * invDt;
+                }
+            }, m_mesh->getNumVertices() > 50);
+    }
+}
+
+void
+ProjectiveDynamicsModel::initGraphEdges(std::shared_ptr<TaskNode> source, std::shared_ptr<TaskNode> sink)
+{
+    m_taskGraph->addEdge(source, m_integrationPositionNode);
+    m_taskGraph->addEdge(m_integrationPositionNode, m_solveNode);
+    m_taskGraph->addEdge(m_solveNode, m_updateVelocityNode);
+    m_taskGraph->addEdge(m_updateVelocityNode, sink);
+}
+} // imstk
@@ -0,0 +1,211 @@
+/*=========================================================================
+
+   Library: iMSTK
+
+   Copyright (c) Kitware, Inc. & Center for Modeling, Simulation,
+   & Imaging in Medicine, Rensselaer Polytechnic Institute.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+=========================================================================*/
+
+#pragma once
+
+#include "imstkDynamicalModel.h"
+#include "imstkPbdState.h"
+
+namespace imstk
+{
+class PointSet;
+class SurfaceMesh;
+class TetrahedralMesh;
+template<typename MatrixType> class DirectLinearSolver;
+
+///
+/// \struct ProjectiveDynamicsModelConfig
+///
+/// \brief Parameters of the projective dynamics simulation
+///
+struct ProjectiveDynamicsModelConfig
+{
+    double m_dt = 0.01;                         ///> Time step size, changing it refactors the global system
+    unsigned int m_iterations    = 10;          ///> Local/global iterations per time step
+    double m_uniformMassValue    = 1.0;         ///> Mass of the vertices, not used if per vertex masses are given in geometry attributes
+    double m_viscousDampingCoeff = 0.01;        ///> Viscous damping coefficient [0, 1]
+
+    double m_strainStiffness   = 1000.0;        ///> Stiffness of the tetrahedral strain constraints, scaled by the rest volumes
+    double m_distanceStiffness = 1000.0;        ///> Stiffness of the surface edge length constraints
+    double m_bendStiffness     = 10.0;          ///> Stiffness of the surface bending constraints, 0 disables them
+
+    std::vector<std::size_t> m_fixedNodeIds;    ///> Nodal/vertex IDs of the nodes that are fixed
+    Vec3d m_gravity = Vec3d(0.0, -9.81, 0.0);   ///> Gravity acceleration
+};
+
+///
+/// \class ProjectiveDynamicsModel
+///
+/// \brief Implicit deformable body model solved with projective dynamics (Bouaziz et al. 2014).
+/// Every time step alternates a local step, projecting each constraint of the current positions
+/// onto its rest manifold in parallel, and a global step solving for the positions closest to the
+/// inertial positions and to the projections. The global matrix only depends on the masses, the
+/// time step and the constraint weights, it is factorized once and each iteration is a back substitution.
+///
+/// Tetrahedral meshes get one strain (as-rigid-as-possible) constraint per tetrahedron, surface
+/// meshes get edge length constraints and a bending constraint preserving the magnitude of the
+/// uniform Laplacian of every vertex.
+///
+class ProjectiveDynamicsModel : public DynamicalModel<PbdState>
+{
+public:
+    ///
+    /// \brief Constructor
+    ///
+    ProjectiveDynamicsModel();
+
+    ///
+    /// \brief Destructor
+    ///
+    virtual ~ProjectiveDynamicsModel() override;
+
+public:
+    ///
+    /// \brief Set simulation parameters
+    ///
+    void configure(std::shared_ptr<ProjectiveDynamicsModelConfig> config) { m_config = config; }
+
+    ///
+    /// \brief Get the simulation parameters
+    ///
+    std::shared_ptr<ProjectiveDynamicsModelConfig> getConfig() const { return m_config; }
+
+    ///
+    /// \brief Set the time step size, the global system is factorized again before the next solve
+    ///
+    virtual void setTimeStep(const double timeStep) override { m_config->m_dt = timeStep; }
+    double getTimeStep() const override { return m_config->m_dt; }
+
+    ///
+    /// \brief Initialize the constraints and factorize the global system
+    ///
+    virtual bool initialize() override;
+
+    ///
+    /// \brief Move the free vertices to their inertial positions, used as initial guess of the solve
+    ///
+    void integratePosition();
+
+    ///
+    /// \brief Run the local/global iterations
+    ///
+    void solve();
+
+    ///
+    /// \brief Update the velocities from the displacement of the time step
+    ///
+    void updateVelocity();
+
+    ///
+    /// \brief Get the number of constraints of each kind
+    ///
+    size_t getNumStrainConstraints() const { return m_tetrahedra.size(); }
+    size_t getNumDistanceConstraints() const { return m_edges.size(); }
+    size_t getNumBendConstraints() const { return m_bendVertices.size(); }
+
+    std::shared_ptr<TaskNode> getIntegratePositionNode() const { return m_integrationPositionNode; }
+
+    std::shared_ptr<TaskNode> getSolveNode() const { return m_solveNode; }
+
+    std::shared_ptr<TaskNode> getUpdateVelocityNode() const { return m_updateVelocityNode; }
+
+protected:
+    ///
+    /// \brief Setup the computational graph
+    ///
+    void initGraphEdges(std::shared_ptr<TaskNode> source, std::shared_ptr<TaskNode> sink) override;
+
+    ///
+    /// \brief Initialize the states and the masses
+    ///
+    void initState();
+
+    ///
+    /// \brief Add the strain constraints of the tetrahedra
+    ///
+    void initTetrahedralConstraints(std::shared_ptr<TetrahedralMesh> mesh);
+
+    ///
+    /// \brief Add the edge length and bending constraints of the triangles
+    ///
+    void initSurfaceConstraints(std::shared_ptr<SurfaceMesh> mesh);
+
+    ///
+    /// \brief Accumulate the constraint weights in the constant part of the global matrix
+    /// and gather, for every vertex, the projection terms it receives
+    ///
+    void initConstraintLaplacian();
+
+    ///
+    /// \brief Factorize the free block of the global matrix for the current time step
+    ///
+    void factorizeGlobalSystem();
+
+    ///
+    /// \brief Local step, project all the constraints of the positions \p q
+    ///
+    void projectConstraints(const VecDataArray<double, 3>& q);
+
+protected:
+    std::shared_ptr<ProjectiveDynamicsModelConfig> m_config = nullptr; ///> Model parameters, must be set before simulation
+    std::shared_ptr<PointSet> m_mesh = nullptr;                        ///> PointSet on which the model operates on
+    std::shared_ptr<DataArray<double>> m_mass = nullptr;               ///> Mass of nodes
+    std::vector<bool> m_fixed;                                         ///> Whether each node is fixed
+
+    // Strain constraints
+    std::vector<Vec4i> m_tetrahedra;                                   ///> Vertices of the tetrahedra
+    std::vector<Eigen::Matrix<double, 4, 3>> m_shapeGradients;         ///> Gradients of the shape functions of the tetrahedra
+    std::vector<double> m_tetWeights;                                  ///> Stiffness times rest volume
+
+    // Distance constraints
+    std::vector<Vec2i>  m_edges;                                       ///> Vertices of the edges
+    std::vector<double> m_restLengths;                                 ///> Rest lengths of the edges
+
+    // Bending constraints, the neighbors of bend vertex i are stored at [m_bendOffsets[i], m_bendOffsets[i + 1])
+    std::vector<int>    m_bendVertices;                                ///> Vertices with a bending constraint
+    std::vector<int>    m_bendOffsets;                                 ///> Start of the neighbors of each bend vertex
+    std::vector<int>    m_bendNeighbors;                               ///> One ring of the bend vertices
+    std::vector<double> m_restCurvatures;                              ///> Norm of the rest Laplacian of each bend vertex
+
+    // Local step, every constraint writes its projection terms to its own slots which are then summed per vertex
+    std::vector<Vec3d> m_projections;                                  ///> Weighted projection terms of all the constraints
+    std::vector<int>   m_vertexSlotOffsets;                            ///> Start of the slots of each vertex
+    std::vector<int>   m_vertexSlots;                                  ///> Slots received by each vertex
+
+    // Global step
+    SparseMatrixd    m_constraintLaplacian;                            ///> Sum of the weighted A^T A of the constraints
+    std::vector<int> m_freeVertices;                                   ///> Vertex of each unknown of the global system
+    SparseMatrixd    m_systemMatrix;                                   ///> Free block of M / dt^2 + constraint Laplacian
+    SparseMatrixd    m_fixedCoupling;                                  ///> Free rows and fixed columns of the constraint Laplacian
+    Vectord          m_rhs;                                            ///> Right hand side of one coordinate
+    Vectord          m_solution;                                       ///> Solution of one coordinate
+    Eigen::Matrix<double, Eigen::Dynamic, 3> m_rhsCoordinates;         ///> Right hand side of the three coordinates
+    std::shared_ptr<DirectLinearSolver<SparseMatrixd>> m_solver;       ///> LDLT factorization of the system matrix
+    double m_factorizedTimeStep = 0.0;                                 ///> Time step of the factorization
+
+    std::shared_ptr<VecDataArray<double, 3>> m_inertialPositions;      ///> Positions reached without internal forces
+
+    // Computational Nodes
+    std::shared_ptr<TaskNode> m_integrationPositionNode = nullptr;
+    std::shared_ptr<TaskNode> m_solveNode = nullptr;
+    std::shared_ptr<TaskNode> m_updateVelocityNode = nullptr;
+};
+} // imstk
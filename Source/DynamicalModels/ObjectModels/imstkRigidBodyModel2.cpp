@@ -21,7 +21,6 @@
 
 #include "imstkRigidBodyModel2.h"
 #include "imstkParallelFor.h"
-#include "imstkProjectedGaussSeidelSolver.h"
 #include "imstkRbdConstraint.h"
 #include "imstkTaskGraph.h"
 #include "imstkLogger.h"
@@ -29,8 +28,7 @@
 namespace imstk
 {
 RigidBodyModel2::RigidBodyModel2() :
-    m_config(std::make_shared<RigidBodyModel2Config>()),
-    m_pgsSolver(std::make_shared<ProjectedGaussSeidelSolver<double>>())
+    m_config(std::make_shared<RigidBodyModel2Config>())
 {
     m_computeTentativeVelocities = std::make_shared<TaskNode>(
         std::bind(&RigidBodyModel2::computeTentativeVelocities, this), "RigidBodyModel_ComputeTentativeVelocities");
@@ -85,9 +83,6 @@ RigidBodyModel2::initialize()
     StdVectorOfVec3d&    forces  = state->getForces();
     StdVectorOfVec3d&    torques = state->getTorques();
 
-    m_Minv = Eigen::SparseMatrix<double>(m_bodies.size() * 6, m_bodies.size() * 6);
-    std::vector<Eigen::Triplet<double>> mInvTriplets;
-    mInvTriplets.reserve((9 + 3) * m_bodies.size());
     for (size_t i = 0; i < m_bodies.size(); i++)
     {
         RigidBody& body = *m_bodies[i];
@@ -118,29 +113,7 @@ RigidBodyModel2::initialize()
         body.m_force  = &forces[i];
         body.m_torque = &torques[i];
         m_locations[m_bodies[i].get()] = static_cast<StorageIndex>(i);
-
-        if (!body.m_isStatic)
-        {
-            // invMass expanded to 3x3 matrix
-            const double invMass     = invMasses[i];
-            const Mat3d& invInvertia = invInteriaTensors[i];
-            int          index       = static_cast<int>(i * 6);
-            mInvTriplets.push_back(Eigen::Triplet<double>(index, index, invMass));
-            index++;
-            mInvTriplets.push_back(Eigen::Triplet<double>(index, index, invMass));
-            index++;
-            mInvTriplets.push_back(Eigen::Triplet<double>(index, index, invMass));
-            index++;
-            for (unsigned int c = 0; c < 3; c++)
-            {
-                for (unsigned int r = 0; r < 3; r++)
-                {
-                    mInvTriplets.push_back(Eigen::Triplet<double>(index + r, index + c, invInvertia(c, r)));
-                }
-            }
-        }
     }
-    m_Minv.setFromTriplets(mInvTriplets.begin(), mInvTriplets.end());
 
     // Copy to initial state
     m_initialState  = std::make_shared<RigidBodyState2>(*state);
@@ -160,9 +133,6 @@ RigidBodyModel2::updateMass()
     std::vector<double>& invMasses = state->getInvMasses();
     StdVectorOfMat3d&    invInteriaTensors = state->getInvIntertiaTensors();
 
-    m_Minv = Eigen::SparseMatrix<double>(m_bodies.size() * 6, m_bodies.size() * 6);
-    std::vector<Eigen::Triplet<double>> mInvTriplets;
-    mInvTriplets.reserve((9 + 3) * m_bodies.size());
     for (size_t i = 0; i < m_bodies.size(); i++)
     {
         RigidBody& body = *m_bodies[i];
@@ -176,29 +146,7 @@ RigidBodyModel2::updateMass()
         {
             invInteriaTensors[i] = body.m_intertiaTensor.inverse();
         }
-
-        if (!body.m_isStatic)
-        {
-            // invMass expanded to 3x3 matrix
-            const double invMass     = invMasses[i];
-            const Mat3d& invInvertia = invInteriaTensors[i];
-            int          index       = static_cast<int>(i * 6);
-            mInvTriplets.push_back(Eigen::Triplet<double>(index, index, invMass));
-            index++;
-            mInvTriplets.push_back(Eigen::Triplet<double>(index, index, invMass));
-            index++;
-            mInvTriplets.push_back(Eigen::Triplet<double>(index, index, invMass));
-            index++;
-            for (unsigned int c = 0; c < 3; c++)
-            {
-                for (unsigned int r = 0; r < 3; r++)
-                {
-                    mInvTriplets.push_back(Eigen::Triplet<double>(index + r, index + c, invInvertia(c, r)));
-                }
-            }
-        }
     }
-    m_Minv.setFromTriplets(mInvTriplets.begin(), mInvTriplets.end());
 }
 
 void
@@ -237,8 +185,8 @@ RigidBodyModel2::computeTentativeVelocities()
 void
 RigidBodyModel2::solveConstraints()
 {
-    // Clear
-    F = Eigen::VectorXd();
+    // Clear, keeping the storage
+    F.setZero();
 
     // Solves the current constraints of the system, then discards them
     if (m_constraints.size() == 0)
@@ -250,135 +198,143 @@ RigidBodyModel2::solveConstraints()
         m_constraints.resize(m_config->m_maxNumConstraints * 2);
     }
 
-    //printf("solving\n");
-
-    std::shared_ptr<RigidBodyState2> state    = getCurrentState();
-    const std::vector<bool>&         isStatic = state->getIsStatic();
+    std::shared_ptr<RigidBodyState2> state     = getCurrentState();
+    const std::vector<bool>&         isStatic  = state->getIsStatic();
+    const std::vector<double>&       invMasses = state->getInvMasses();
+    const StdVectorOfMat3d&          invInteriaTensors   = state->getInvIntertiaTensors();
     const StdVectorOfVec3d&          tentativeVelocities = state->getTentatveVelocities();
     const StdVectorOfVec3d&          tentativeAngularVelocities = state->getTentativeAngularVelocities();
     StdVectorOfVec3d&                forces  = state->getForces();
     StdVectorOfVec3d&                torques = state->getTorques();
+    const double                     dt      = m_config->m_dt;
 
-    Eigen::VectorXd V    = Eigen::VectorXd(state->size() * 6);
-    Eigen::VectorXd Fext = Eigen::VectorXd(state->size() * 6);
-
-    // Fill the forces and tenative velocities vectors
-    StorageIndex j = 0;
+    // Velocities the bodies would reach without constraints, V/dt + Minv*Fext
+    m_unconstrainedAccelerations.resize(state->size());
+    m_constraintAccelerations.resize(state->size());
     for (size_t i = 0; i < state->size(); i++)
     {
+        Vec6d& a = m_unconstrainedAccelerations[i];
         if (!isStatic[i])
         {
-            const Vec3d& velocity = tentativeVelocities[i];
-            const Vec3d& angularVelocity = tentativeAngularVelocities[i];
-            const Vec3d& force  = forces[i];
-            const Vec3d& torque = torques[i];
-            Fext(j) = force[0];
-            V(j)    = velocity[0];
-            j++;
-            Fext(j) = force[1];
-            V(j)    = velocity[1];
-            j++;
-            Fext(j) = force[2];
-            V(j)    = velocity[2];
-            j++;
-            Fext(j) = torque[0];
-            V(j)    = angularVelocity[0];
-            j++;
-            Fext(j) = torque[1];
-            V(j)    = angularVelocity[1];
-            j++;
-            Fext(j) = torque[2];
-            V(j)    = angularVelocity[2];
-            j++;
+            a.head<3>() = tentativeVelocities[i] / dt + invMasses[i] * forces[i];
+            a.tail<3>() = tentativeAngularVelocities[i] / dt + invInteriaTensors[i] * torques[i];
         }
         else
         {
-            for (StorageIndex k = 0; k < 6; k++)
+            a.setZero();
+        }
+        m_constraintAccelerations[i].setZero();
+    }
+
+    // One row of the jacobian per constraint, split in the blocks of its (at most) two bodies
+    m_constraintRows.resize(m_constraints.size());
+    size_t j = 0;
+    for (std::list<std::shared_ptr<RbdConstraint>>::iterator iter = m_constraints.begin(); iter != m_constraints.end(); iter++, j++)
+    {
+        const RbdConstraint& constraint = **iter;
+        ConstraintRow&       row = m_constraintRows[j];
+        row.diagonal = 0.0;
+        row.b        = constraint.vu / dt;
+
+        const std::shared_ptr<RigidBody> objs[2] = { constraint.m_obj1, constraint.m_obj2 };
+        for (int k = 0; k < 2; k++)
+        {
+            row.body[k] = -1;
+            row.J[k].setZero();
+            row.JMinv[k].setZero();
+            if (objs[k] == nullptr)
             {
-                Fext(j + k) = 0.0;
-                V(j + k)    = 0.0;
+                continue;
             }
-            j += 6;
+            auto location = m_locations.find(objs[k].get());
+            if (location == m_locations.end())
+            {
+                continue;
+            }
+            const StorageIndex i = location->second;
+            row.body[k] = i;
+            row.J[k].head<3>() = constraint.J.col(2 * k);
+            row.J[k].tail<3>() = constraint.J.col(2 * k + 1);
+            if (!isStatic[i])
+            {
+                row.JMinv[k].head<3>() = invMasses[i] * constraint.J.col(2 * k);
+                row.JMinv[k].tail<3>() = invInteriaTensors[i] * constraint.J.col(2 * k + 1);
+            }
+            row.diagonal += row.J[k].dot(row.JMinv[k]);
+            row.b        -= row.J[k].dot(m_unconstrainedAccelerations[i]);
         }
+        row.range[0] = constraint.range[0];
+        row.range[1] = constraint.range[1];
+        row.force    = 0.0;
     }
 
-    // Now construct the sparse jacobian matrix for every constraint (object vs constraint)
-    Eigen::SparseMatrix<double>         J(m_constraints.size(), state->size() * 6);
-    Eigen::VectorXd                     Vu(m_constraints.size());    // Push Factor
-    Eigen::MatrixXd                     cu(m_constraints.size(), 2); // Mins and maxes
-    std::vector<Eigen::Triplet<double>> JTriplets;
-    JTriplets.reserve(m_constraints.size() * 12);
-    j = 0;
-    for (std::list<std::shared_ptr<RbdConstraint>>::iterator iter = m_constraints.begin(); iter != m_constraints.end(); iter++)
+    // Projected Gauss-Seidel on J*Minv*J^T*F = b, the product of a row with the current forces
+    // is read from the accumulated body accelerations Minv*J^T*F
+    const double relaxation = m_config->m_relaxation;
+    m_energy = 0.0;
+    for (unsigned int iter = 0; iter < m_config->m_maxNumIterations; iter++)
     {
-        std::shared_ptr<RbdConstraint> constraint = *iter;
-        Vu(j) = constraint->vu;
-
-        // Object 1
-        StorageIndex k = 0;
-        if (constraint->m_obj1 != nullptr)
+        double energy = 0.0;
+        for (ConstraintRow& row : m_constraintRows)
         {
-            const StorageIndex obj1Location = m_locations[constraint->m_obj1.get()];
-            const StorageIndex start1       = obj1Location * 6;
-            for (StorageIndex c = 0; c < 2; c++)
+            // PGS can't converge without diagonal elements, rows acting on static bodies only are skipped
+            if (row.diagonal <= 0.0)
             {
-                for (StorageIndex r = 0; r < 3; r++)
+                continue;
+            }
+
+            double JMinvJF = 0.0;
+            for (int k = 0; k < 2; k++)
+            {
+                if (row.body[k] != -1)
                 {
-                    JTriplets.push_back(Eigen::Triplet<double>(j, start1 + k, constraint->J(r, c)));
-                    k++;
+                    JMinvJF += row.J[k].dot(m_constraintAccelerations[row.body[k]]);
                 }
             }
-        }
 
-        // Object 2
-        if (constraint->m_obj2 != nullptr)
-        {
-            const StorageIndex obj2Location = m_locations[constraint->m_obj2.get()];
-            const StorageIndex start2       = obj2Location * 6;
-            k = 0;
-            for (StorageIndex c = 2; c < 4; c++)
+            // Sum of the row excluding the diagonal
+            const double delta = (row.b - (JMinvJF - row.diagonal * row.force)) / row.diagonal;
+            // Apply relaxation factor, then project
+            double force = row.force + relaxation * (delta - row.force);
+            force = std::min(row.range[1], std::max(row.range[0], force));
+
+            const double dForce = force - row.force;
+            row.force = force;
+            energy   += dForce * dForce;
+            for (int k = 0; k < 2; k++)
             {
-                for (StorageIndex r = 0; r < 3; r++)
+                if (row.body[k] != -1)
                 {
-                    JTriplets.push_back(Eigen::Triplet<double>(j, start2 + k, constraint->J(r, c)));
-                    k++;
+                    m_constraintAccelerations[row.body[k]] += row.JMinv[k] * dForce;
                 }
             }
         }
 
-        cu(j, 0) = constraint->range[0];
-        cu(j, 1) = constraint->range[1];
-        j++;
+        // Check convergence
+        m_energy = std::sqrt(energy);
+        if (m_energy < m_config->m_epsilon)
+        {
+            break;
+        }
     }
-    J.setFromTriplets(JTriplets.begin(), JTriplets.end());
-
-    const double                dt = m_config->m_dt;
-    Eigen::SparseMatrix<double> A  = J * m_Minv * J.transpose();
-    Eigen::VectorXd             b  = Vu / dt - J * (V / dt + m_Minv * Fext);
-
-    /*std::cout << "Minv: " << std::endl << m_Minv.toDense() << std::endl;
-    std::cout << "J: " << std::endl << J.toDense() << std::endl;
-    std::cout << "A: " << std::endl << A.toDense() << std::endl;
-    std::cout << std::endl;
-    std::cout << "Vu: " << std::endl << Vu << std::endl;
-    std::cout << "V: " << std::endl << V << std::endl;
-    std::cout << "b: " << std::endl << b << std::endl;*/
-
-    m_pgsSolver->setA(&A);
-    //pgsSolver.setGuess(F); // Not using warm starting
-    m_pgsSolver->setMaxIterations(m_config->m_maxNumIterations);
-    m_pgsSolver->setEpsilon(m_config->m_epsilon);
-    F = J.transpose() * m_pgsSolver->solve(b, cu);   // Reaction force,torque
-
-    // Apply reaction impulse
-    j = 0;
-    for (size_t i = 0; i < state->size(); i++, j += 6)
+
+    // Apply reaction impulse, J^T*F
+    F.setZero(state->size() * 6);
+    for (const ConstraintRow& row : m_constraintRows)
     {
-        forces[i]  += Vec3d(F(j), F(j + 1), F(j + 2));
-        torques[i] += Vec3d(F(j + 3), F(j + 4), F(j + 5));
+        for (int k = 0; k < 2; k++)
+        {
+            if (row.body[k] != -1)
+            {
+                F.segment<6>(row.body[k] * 6) += row.J[k] * row.force;
+            }
+        }
+    }
+    for (size_t i = 0; i < state->size(); i++)
+    {
+        forces[i]  += F.segment<3>(i * 6);
+        torques[i] += F.segment<3>(i * 6 + 3);
     }
-
-    //std::cout << std::endl << "Forces/Torques: " << F << std::endl;
 
     m_constraints.clear();
 }
@@ -29,8 +29,6 @@
 
 namespace imstk
 {
-template<typename ScalarType>
-class ProjectedGaussSeidelSolver;
 class RbdConstraint;
 struct RigidBody;
 
@@ -43,13 +41,16 @@ struct RigidBodyModel2Config
     double m_angularVelocityDamping = 1.0;
     double m_epsilon = 1e-4;
     int m_maxNumConstraints = -1;
+    double m_relaxation     = 0.1; ///> Relaxation of the projected Gauss-Seidel iterations
 };
 
 ///
 /// \class RigidBodyModel2
 ///
 /// \brief This class implements a constraint based rigid body linear system
-/// with pgs solver
+/// with pgs solver. The system J*Minv*J^T is never assembled, the constraints
+/// are solved sequentially as impulses, with the change of velocity of every
+/// body kept up to date (O(nnz(J)) per iteration)
 ///
 class RigidBodyModel2 : public DynamicalModel<RigidBodyState2>
 {
@@ -80,7 +81,12 @@ public:
 
     std::shared_ptr<RigidBodyModel2Config> getConfig() const { return m_config; }
     const std::list<std::shared_ptr<RbdConstraint>>& getConstraints() const { return m_constraints; }
-    std::shared_ptr<ProjectedGaussSeidelSolver<double>> getSolver() const { return m_pgsSolver; }
+
+    ///
+    /// \brief Energy of the last solve, defined as the norm of the change of the
+    /// constraint forces in the last iteration
+    ///
+    double getEnergy() const { return m_energy; }
 
     ///
     /// \brief Adds a body to the system, must call initialize for changes to effect
@@ -148,8 +154,27 @@ protected:
     std::shared_ptr<TaskNode> m_integrateNode;
 
 protected:
-    std::shared_ptr<ProjectedGaussSeidelSolver<double>> m_pgsSolver;
-    Eigen::SparseMatrix<double> m_Minv;
+    ///
+    /// \brief Row of the constraint jacobian, split per body, with the body
+    /// velocity change per unit of constraint force
+    ///
+    struct ConstraintRow
+    {
+        Vec6d J[2];            ///> Linear and angular jacobian of each body
+        Vec6d JMinv[2];        ///> Minv*J^T of each body, zero for static bodies
+        StorageIndex body[2];  ///> Body locations, -1 if none
+        double diagonal;       ///> J*Minv*J^T
+        double b;              ///> Right hand side
+        double range[2];       ///> Range of the constraint force
+        double force;          ///> Constraint force, the unknown
+    };
+
+protected:
+    std::vector<ConstraintRow, Eigen::aligned_allocator<ConstraintRow>> m_constraintRows; ///> Rows of the current constraints, storage kept between solves
+    std::vector<Vec6d, Eigen::aligned_allocator<Vec6d>> m_constraintAccelerations;        ///> Minv*J^T*F per body, updated after every row
+    std::vector<Vec6d, Eigen::aligned_allocator<Vec6d>> m_unconstrainedAccelerations;     ///> V/dt+Minv*Fext per body
+    double m_energy = 0.0;                                                                 ///> Norm of the last change of the constraint forces
+
     std::list<std::shared_ptr<RbdConstraint>>    m_constraints;
     std::vector<std::shared_ptr<RigidBody>>      m_bodies;
     std::unordered_map<RigidBody*, StorageIndex> m_locations;
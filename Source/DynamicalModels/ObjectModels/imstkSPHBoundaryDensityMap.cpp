@@ -0,0 +1,146 @@
+/*=========================================================================
+
+   Library: iMSTK
+
+   Copyright (c) Kitware, Inc. & Center for Modeling, Simulation,
+   & Imaging in Medicine, Rensselaer Polytechnic Institute.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+=========================================================================*/
+
+#include "imstkSPHBoundaryDensityMap.h"
+#include "imstkParallelUtils.h"
+#include "imstkSignedDistanceField.h"
+#include "imstkSPHKernels.h"
+
+namespace imstk
+{
+void
+SPHBoundaryDensityMap::compute(std::shared_ptr<SignedDistanceField> sdf, const SPHSimulationKernels& kernels,
+                               const double kernelRadius, const double restDensity, const double spacing)
+{
+    CHECK(sdf != nullptr) << "SPHBoundaryDensityMap requires a signed distance field";
+    CHECK(spacing > 0.0) << "SPHBoundaryDensityMap requires a positive grid spacing";
+
+    Vec3d lowerCorner, upperCorner;
+    sdf->computeBoundingBox(lowerCorner, upperCorner, 0.0);
+
+    m_origin     = lowerCorner;
+    m_spacing    = Vec3d(spacing, spacing, spacing);
+    m_invSpacing = m_spacing.cwiseInverse();
+    m_dims       = (((upperCorner - lowerCorner) / spacing).array().ceil() + 1.0).cast<int>().matrix();
+    m_values.assign(static_cast<size_t>(m_dims[0]) * m_dims[1] * m_dims[2], Vec4d::Zero());
+
+    // Midpoint quadrature of the kernel support on a lattice, the solid is integrated where the distance is negative
+    const int    samplesPerRadius = 6;
+    const double sampleSpacing    = kernelRadius / samplesPerRadius;
+    const double sampleVolume     = sampleSpacing * sampleSpacing * sampleSpacing;
+    StdVectorOfVec3d offsets;
+    for (int i = -samplesPerRadius; i < samplesPerRadius; i++)
+    {
+        for (int j = -samplesPerRadius; j < samplesPerRadius; j++)
+        {
+            for (int k = -samplesPerRadius; k < samplesPerRadius; k++)
+            {
+                const Vec3d offset = (Vec3d(i, j, k) + Vec3d::Constant(0.5)) * sampleSpacing;
+                if (offset.squaredNorm() <= kernelRadius * kernelRadius)
+                {
+                    offsets.push_back(offset);
+                }
+            }
+        }
+    }
+
+    // Deep inside the solid the whole support is covered and the gradient vanishes
+    double fullDensity = 0.0;
+    for (const Vec3d& offset : offsets)
+    {
+        fullDensity += kernels.W(offset);
+    }
+    fullDensity *= restDensity * sampleVolume;
+
+    ParallelUtils::parallelFor(m_values.size(),
+        [&](const size_t index)
+        {
+            const int   x   = static_cast<int>(index % m_dims[0]);
+            const int   y   = static_cast<int>((index / m_dims[0]) % m_dims[1]);
+            const int   z   = static_cast<int>(index / (static_cast<size_t>(m_dims[0]) * m_dims[1]));
+            const Vec3d pos = m_origin + Vec3d(x, y, z).cwiseProduct(m_spacing);
+
+            const double distance = sdf->getFunctionValue(pos);
+            if (distance > kernelRadius)
+            {
+                return;
+            }
+            if (distance < -kernelRadius)
+            {
+                m_values[index] = Vec4d(fullDensity, 0.0, 0.0, 0.0);
+                return;
+            }
+
+            double density  = 0.0;
+            Vec3d  gradient = Vec3d::Zero();
+            for (const Vec3d& offset : offsets)
+            {
+                if (sdf->getFunctionValue(pos + offset) < 0.0)
+                {
+                    density  += kernels.W(offset);
+                    gradient += kernels.gradW(-offset);
+                }
+            }
+            const double scale = restDensity * sampleVolume;
+            m_values[index] = Vec4d(density * scale, gradient[0] * scale, gradient[1] * scale, gradient[2] * scale);
+        });
+}
+
+void
+SPHBoundaryDensityMap::clear()
+{
+    m_dims = Vec3i::Zero();
+    m_values.clear();
+}
+
+bool
+SPHBoundaryDensityMap::sample(const Vec3d& pos, double& density, Vec3d& gradient) const
+{
+    density  = 0.0;
+    gradient = Vec3d::Zero();
+
+    const Vec3d structuredPt = (pos - m_origin).cwiseProduct(m_invSpacing);
+    const Vec3i s1 = structuredPt.array().floor().cast<int>();
+    if (m_values.empty()
+        || (s1.array() < 0).any() || (s1.array() >= m_dims.array() - 1).any())
+    {
+        return false;
+    }
+
+    const Vec3d  t  = structuredPt - s1.cast<double>();
+    const size_t i0 = s1[0] + static_cast<size_t>(m_dims[0]) * (s1[1] + static_cast<size_t>(m_dims[1]) * s1[2]);
+    const size_t dy = m_dims[0];
+    const size_t dz = static_cast<size_t>(m_dims[0]) * m_dims[1];
+
+    // Interpolate along x, then y, then z
+    const Vec4d c00 = m_values[i0] + (m_values[i0 + 1] - m_values[i0]) * t[0];
+    const Vec4d c10 = m_values[i0 + dy] + (m_values[i0 + dy + 1] - m_values[i0 + dy]) * t[0];
+    const Vec4d c01 = m_values[i0 + dz] + (m_values[i0 + dz + 1] - m_values[i0 + dz]) * t[0];
+    const Vec4d c11 = m_values[i0 + dz + dy] + (m_values[i0 + dz + dy + 1] - m_values[i0 + dz + dy]) * t[0];
+    const Vec4d c0  = c00 + (c10 - c00) * t[1];
+    const Vec4d c1  = c01 + (c11 - c01) * t[1];
+    const Vec4d c   = c0 + (c1 - c0) * t[2];
+
+    density  = c[0];
+    gradient = c.tail<3>();
+    return density > 0.0;
+}
+} // end namespace imstk
@@ -0,0 +1,83 @@
+/*=========================================================================
+
+   Library: iMSTK
+
+   Copyright (c) Kitware, Inc. & Center for Modeling, Simulation,
+   & Imaging in Medicine, Rensselaer Polytechnic Institute.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+=========================================================================*/
+
+#pragma once
+
+#include "imstkMath.h"
+
+namespace imstk
+{
+class SignedDistanceField;
+class SPHSimulationKernels;
+
+///
+/// \class SPHBoundaryDensityMap
+/// \brief Density of a solid boundary given by a signed distance field, precomputed on a grid
+/// (Koschier and Bender 2017, Density Maps for Improved SPH Boundary Handling).
+/// Each grid node stores the density the solid would contribute to a particle at the node, and the gradient
+/// of that density with the pressure kernel, so the boundary replaces a layer of boundary particles.
+/// The solid is where the signed distance is negative
+///
+class SPHBoundaryDensityMap
+{
+public:
+    SPHBoundaryDensityMap() = default;
+    ~SPHBoundaryDensityMap() = default;
+
+public:
+    ///
+    /// \brief Compute the map over the bounds of the signed distance field
+    /// \param sdf signed distance field of the solid
+    /// \param kernels SPH kernels, their radius is the extent of the boundary layer
+    /// \param kernelRadius radius of the kernels
+    /// \param restDensity rest density of the fluid, the solid has the same density
+    /// \param spacing spacing of the map grid
+    ///
+    void compute(std::shared_ptr<SignedDistanceField> sdf, const SPHSimulationKernels& kernels,
+                 const double kernelRadius, const double restDensity, const double spacing);
+
+    ///
+    /// \brief Clear the map, sampling returns zero afterwards
+    ///
+    void clear();
+
+    ///
+    /// \brief Returns true if the map holds no values
+    ///
+    bool isEmpty() const { return m_values.empty(); }
+
+    ///
+    /// \brief Sample the boundary density and its gradient by trilinear interpolation,
+    /// both are zero outside of the map
+    /// \return false if the position is further than the kernel radius from the solid
+    ///
+    bool sample(const Vec3d& pos, double& density, Vec3d& gradient) const;
+
+    const Vec3i& getDimensions() const { return m_dims; }
+
+protected:
+    Vec3d m_origin     = Vec3d::Zero();
+    Vec3d m_spacing    = Vec3d::Ones();
+    Vec3d m_invSpacing = Vec3d::Ones();
+    Vec3i m_dims       = Vec3i::Zero();
+    StdVectorOfVec4d m_values; ///> Density and density gradient per grid node, x varying fastest
+};
+} // end namespace imstk
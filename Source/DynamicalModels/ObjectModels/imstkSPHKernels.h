@@ -519,4 +519,82 @@ protected:
     SPH::ViscosityKernel<3> m_viscosity;
     SPH::CohesionKernel<3>  m_cohesion;
 };
+
+///
+/// \class SPHBatchKernels
+/// \brief The kernels of SPHSimulationKernels evaluated for a block of neighbors at once, in Scalar precision.
+/// The relative positions are given as a structure of arrays of BlockSize values, Eigen maps the block
+/// arithmetic to the SIMD instructions enabled in the build. Unused lanes of a block should be padded
+/// with a distance larger than the kernel radius, where all kernels are zero
+///
+template<typename Scalar, int BlockSize = 8>
+class SPHBatchKernels
+{
+public:
+    using Block = Eigen::Array<Scalar, BlockSize, 1>;
+
+    ///
+    /// \brief Initialize with kernel radius \p kernelRadius
+    ///
+    void initialize(const double kernelRadius)
+    {
+        m_radius     = static_cast<Scalar>(kernelRadius);
+        m_radius2    = static_cast<Scalar>(kernelRadius * kernelRadius);
+        m_poly6K     = static_cast<Scalar>(315.0 / (64.0 * PI * std::pow(kernelRadius, 9)));
+        m_spikyL     = static_cast<Scalar>(-45.0 / (PI * std::pow(kernelRadius, 6)));
+        m_viscosityK = static_cast<Scalar>((45.0 / PI) / std::pow(kernelRadius, 6));
+        m_cohesionK  = static_cast<Scalar>(32.0 / (PI * std::pow(kernelRadius, 9)));
+        m_cohesionC  = static_cast<Scalar>(std::pow(kernelRadius, 6) / 64.0);
+    }
+
+    ///
+    /// \brief Kernel radius used to pad unused lanes, lanes at twice the radius evaluate to zero
+    ///
+    Scalar getPaddingDistance() const { return 2 * m_radius; }
+
+    ///
+    /// \brief Compute weights W using poly6 kernel from the squared distances
+    ///
+    Block W(const Block& r2) const
+    {
+        const Block rd = m_radius2 - r2;
+        return (r2 <= m_radius2).select(rd * rd * rd * m_poly6K, Block::Zero());
+    }
+
+    ///
+    /// \brief Compute the scale s of the spiky kernel gradient gradW = s * r, from the squared distances and distances
+    ///
+    Block gradWScale(const Block& r2, const Block& r) const
+    {
+        const Block hr = m_radius - r;
+        return (r2 <= m_radius2 && r2 > Scalar(1.0e-12)).select(m_spikyL * hr * hr / r, Block::Zero());
+    }
+
+    ///
+    /// \brief Compute laplacians using viscosity kernel, from the squared distances and distances
+    ///
+    Block laplace(const Block& r2, const Block& r) const
+    {
+        return (r2 <= m_radius2).select(m_viscosityK * (m_radius - r), Block::Zero());
+    }
+
+    ///
+    /// \brief Compute cohesion W using cohesion kernel, from the squared distances and distances
+    ///
+    Block cohesionW(const Block& r2, const Block& r) const
+    {
+        const Block rd   = m_radius - r;
+        const Block rdr3 = m_cohesionK * rd * rd * rd * r2 * r;
+        return (r2 <= m_radius2).select((r > Scalar(0.5) * m_radius).select(rdr3, Scalar(2) * rdr3 - m_cohesionC), Block::Zero());
+    }
+
+protected:
+    Scalar m_radius;     ///> Kernel radius
+    Scalar m_radius2;    ///> Kernel radius squared
+    Scalar m_poly6K;     ///> Poly6 kernel coefficient for W()
+    Scalar m_spikyL;     ///> Spiky kernel coefficient for gradW()
+    Scalar m_viscosityK; ///> Viscosity kernel coefficient for laplace()
+    Scalar m_cohesionK;  ///> Cohesion kernel coefficient for W()
+    Scalar m_cohesionC;  ///> Cohesion kernel offset for W()
+};
 } // end namespace imstk
@@ -22,11 +22,38 @@ limitations under the License.
 #include "imstkSPHModel.h"
 #include "imstkParallelUtils.h"
 #include "imstkPointSet.h"
+#include "imstkReordering.h"
+#include "imstkSignedDistanceField.h"
 #include "imstkTaskGraph.h"
 #include "imstkVTKMeshIO.h"
 
 namespace imstk
 {
+namespace
+{
+using KernelBlock = SPHBatchKernels<float>::Block;
+constexpr int kernelBlockSize = KernelBlock::RowsAtCompileTime;
+
+///
+/// \brief Gather the relative positions of up to a block of neighbors into structure of arrays,
+/// unused lanes are placed at the padding distance
+///
+void
+gatherRelativePositions(const NeighborInfo* neighborInfo, const int count, const float padding,
+                        KernelBlock& x, KernelBlock& y, KernelBlock& z)
+{
+    x.setConstant(padding);
+    y.setZero();
+    z.setZero();
+    for (int k = 0; k < count; k++)
+    {
+        x[k] = static_cast<float>(neighborInfo[k].xpq[0]);
+        y[k] = static_cast<float>(neighborInfo[k].xpq[1]);
+        z[k] = static_cast<float>(neighborInfo[k].xpq[2]);
+    }
+}
+}
+
 SPHModelConfig::SPHModelConfig(const double particleRadius)
 {
     // \todo Warning in all paths?
@@ -100,6 +127,7 @@ SPHModel::SPHModel() : DynamicalModel<SPHState>(DynamicalModelType::SmoothedPart
     m_computeDensityNode = m_taskGraph->addFunction("SPHModel_ComputeDensity", [&]()
         {
             computeNeighborRelativePositions();
+            sampleBoundaryDensities();
             computeDensity();
         });
 
@@ -134,6 +162,12 @@ SPHModel::SPHModel() : DynamicalModel<SPHState>(DynamicalModelType::SmoothedPart
             moveParticles(getTimeStep());
         });
 
+    m_computeForcesNode =
+        m_taskGraph->addFunction("SPHModel_ComputeForces", std::bind(&SPHModel::computeForces, this));
+
+    m_solvePressureNode =
+        m_taskGraph->addFunction("SPHModel_SolvePressure", std::bind(&SPHModel::solvePressure, this));
+
     //m_computePositionNode =
     //    m_taskGraph->addFunction("SPHModel_ComputePositions", [&]()
     //    {
@@ -167,10 +201,55 @@ SPHModel::initialize()
 
     // Initialize simulation dependent parameters and kernel data
     m_kernels.initialize(m_modelParameters->m_kernelRadius);
+    m_batchKernels.initialize(m_modelParameters->m_kernelRadius);
 
-    // Initialize neighbor searcher
+    // PCISPH pressure scale from a particle with a filled neighborhood, on a lattice of the particle spacing
+    {
+        const double spacing = 2.0 * m_modelParameters->m_particleRadius;
+        const int    extent  = static_cast<int>(std::ceil(m_modelParameters->m_kernelRadius / spacing));
+        Vec3d        sumGradW = Vec3d::Zero();
+        double       sumGradW2 = 0.0;
+        for (int i = -extent; i <= extent; i++)
+        {
+            for (int j = -extent; j <= extent; j++)
+            {
+                for (int k = -extent; k <= extent; k++)
+                {
+                    const Vec3d gradW = m_kernels.gradW(Vec3d(i, j, k) * spacing);
+                    sumGradW  += gradW;
+                    sumGradW2 += gradW.squaredNorm();
+                }
+            }
+        }
+        const double mass = m_modelParameters->m_particleMass;
+        m_pressureScale = m_modelParameters->m_restDensitySqr / (2.0 * mass * mass * (sumGradW.squaredNorm() + sumGradW2));
+    }
+
+    // Initialize neighbor searcher, with a Verlet skin the search radius is enlarged so lists can be reused
     m_neighborSearcher = std::make_shared<NeighborSearch>(m_modelParameters->m_NeighborSearchMethod,
-      m_modelParameters->m_kernelRadius);
+      m_modelParameters->m_kernelRadius + std::max(m_modelParameters->m_neighborListSkin, 0.0));
+    m_verletNeighborLists.clear();
+    m_verletBDNeighborLists.clear();
+    m_verletPositions.resize(0);
+    m_verletBDPositions.resize(0);
+
+    // The boundary density map depends only on the solid, it is computed once
+    if (m_boundarySDF)
+    {
+        const double spacing = m_modelParameters->m_boundaryMapSpacing > 0.0 ?
+                               m_modelParameters->m_boundaryMapSpacing : m_modelParameters->m_particleRadius;
+        m_boundaryDensityMap.compute(m_boundarySDF, m_kernels,
+            m_modelParameters->m_kernelRadius, m_modelParameters->m_restDensity, spacing);
+        m_boundaryDensities.assign(numParticles, 0.0);
+        m_boundaryDensityGradients.resize(numParticles);
+        LOG_IF(INFO, m_modelParameters->m_bDensityWithBoundary) << "SPHModel boundary particles are ignored, the boundary is given by the SDF";
+    }
+    else
+    {
+        m_boundaryDensityMap.clear();
+        m_boundaryDensities.clear();
+        m_boundaryDensityGradients.resize(0);
+    }
 
     m_pressureAccels = std::make_shared<VecDataArray<double, 3>>(numParticles);
     std::fill_n(m_pressureAccels->getPointer(), m_pressureAccels->size(), Vec3d(0, 0, 0));
@@ -210,18 +289,47 @@ SPHModel::initGraphEdges(std::shared_ptr<TaskNode> source, std::shared_ptr<TaskN
     m_taskGraph->addEdge(m_computeDensityNode, m_normalizeDensityNode);
     m_taskGraph->addEdge(m_normalizeDensityNode, m_collectNeighborDensityNode);
 
-    // Pressure, Surface Tension, and time step size can be done in parallel
-    m_taskGraph->addEdge(m_collectNeighborDensityNode, m_computePressureAccelNode);
-    m_taskGraph->addEdge(m_collectNeighborDensityNode, m_computeSurfaceTensionNode);
-    m_taskGraph->addEdge(m_collectNeighborDensityNode, m_computeViscosityNode);
-    m_taskGraph->addEdge(m_collectNeighborDensityNode, m_computeTimeStepSizeNode);
+    // With PCISPH the pressure is solved last, once the other accelerations and the time step are known
+    const bool incompressible = m_modelParameters->m_pressureSolver == SPHModelConfig::PressureSolverType::PCISPH;
+    if (m_modelParameters->m_bFusedForces)
+    {
+        // All accelerations are summed by one node, the unused per term nodes are removed with the graph
+        m_taskGraph->addEdge(m_collectNeighborDensityNode, m_computeForcesNode);
+        m_taskGraph->addEdge(m_collectNeighborDensityNode, m_computeTimeStepSizeNode);
 
-    m_taskGraph->addEdge(m_computePressureAccelNode, m_integrateNode);
-    m_taskGraph->addEdge(m_computeSurfaceTensionNode, m_integrateNode);
-    m_taskGraph->addEdge(m_computeViscosityNode, m_integrateNode);
-    m_taskGraph->addEdge(m_computeTimeStepSizeNode, m_integrateNode);
+        std::shared_ptr<TaskNode> accelsNode = m_updateVelocityNode;
+        if (incompressible)
+        {
+            accelsNode = m_solvePressureNode;
+            m_taskGraph->addEdge(m_solvePressureNode, m_updateVelocityNode);
+        }
+        m_taskGraph->addEdge(m_computeForcesNode, accelsNode);
+        m_taskGraph->addEdge(m_computeTimeStepSizeNode, accelsNode);
+    }
+    else
+    {
+        // Pressure, Surface Tension, and time step size can be done in parallel
+        m_taskGraph->addEdge(m_collectNeighborDensityNode, m_computeSurfaceTensionNode);
+        m_taskGraph->addEdge(m_collectNeighborDensityNode, m_computeViscosityNode);
+        m_taskGraph->addEdge(m_collectNeighborDensityNode, m_computeTimeStepSizeNode);
 
-    m_taskGraph->addEdge(m_integrateNode, m_updateVelocityNode);
+        std::shared_ptr<TaskNode> accelsNode = m_integrateNode;
+        if (incompressible)
+        {
+            accelsNode = m_solvePressureNode;
+            m_taskGraph->addEdge(m_solvePressureNode, m_integrateNode);
+        }
+        else
+        {
+            m_taskGraph->addEdge(m_collectNeighborDensityNode, m_computePressureAccelNode);
+            m_taskGraph->addEdge(m_computePressureAccelNode, m_integrateNode);
+        }
+        m_taskGraph->addEdge(m_computeSurfaceTensionNode, accelsNode);
+        m_taskGraph->addEdge(m_computeViscosityNode, accelsNode);
+        m_taskGraph->addEdge(m_computeTimeStepSizeNode, accelsNode);
+
+        m_taskGraph->addEdge(m_integrateNode, m_updateVelocityNode);
+    }
     m_taskGraph->addEdge(m_updateVelocityNode, m_moveParticlesNode);
     m_taskGraph->addEdge(m_moveParticlesNode, sink);
 }
@@ -237,9 +345,11 @@ SPHModel::computeCFLTimeStepSize()
 {
     auto maxVel = ParallelUtils::findMaxL2Norm(*getCurrentState()->getFullStepVelocities());
 
-    // dt = CFL * 2r / (speed of sound + max{|| v ||})
+    // dt = CFL * 2r / (speed of sound + max{|| v ||}), incompressible pressure does not propagate at the speed of sound
+    const double speedOfSound = m_modelParameters->m_pressureSolver == SPHModelConfig::PressureSolverType::PCISPH ?
+                                0.0 : m_modelParameters->m_speedOfSound;
     double timestep = maxVel > 1.0e-6 ?
-                      m_modelParameters->m_CFLFactor * (2.0 * m_modelParameters->m_particleRadius / (m_modelParameters->m_speedOfSound + maxVel)) :
+                      m_modelParameters->m_CFLFactor * (2.0 * m_modelParameters->m_particleRadius / (speedOfSound + maxVel)) :
                       m_modelParameters->m_maxTimestep;
 
     // clamp the time step size to be within a given range
@@ -257,89 +367,259 @@ SPHModel::computeCFLTimeStepSize()
 void
 SPHModel::findParticleNeighbors()
 {
-    m_neighborSearcher->getNeighbors(getCurrentState()->getFluidNeighborLists(), *getCurrentState()->getPositions());
+    const VecDataArray<double, 3>& positions    = *getCurrentState()->getPositions();
+    const VecDataArray<double, 3>& bdPositions  = *getCurrentState()->getBoundaryParticlePositions();
+    const bool                     withBoundary = useBoundaryParticles();
 
-    if (m_modelParameters->m_bDensityWithBoundary)   // if considering boundary particles for computing fluid density
+    if (m_modelParameters->m_reorderInterval > 0 && m_timeStepCount % m_modelParameters->m_reorderInterval == 0)
     {
-        m_neighborSearcher->getNeighbors(getCurrentState()->getBoundaryNeighborLists(),
-            *getCurrentState()->getPositions(),
-            *getCurrentState()->getBoundaryParticlePositions());
+        reorderParticles();
+    }
+
+    if (m_modelParameters->m_neighborListSkin <= 0.0)
+    {
+        m_neighborSearcher->getNeighbors(getCurrentState()->getFluidNeighborLists(), positions);
+
+        if (withBoundary)   // if considering boundary particles for computing fluid density
+        {
+            m_neighborSearcher->getNeighbors(getCurrentState()->getBoundaryNeighborLists(), positions, bdPositions);
+        }
+        return;
+    }
+
+    // Search with the enlarged radius only when the Verlet lists may have become stale
+    if (needsNeighborSearch())
+    {
+        m_neighborSearcher->getNeighbors(m_verletNeighborLists, positions);
+        m_verletPositions = positions;
+
+        if (withBoundary)
+        {
+            m_neighborSearcher->getNeighbors(m_verletBDNeighborLists, positions, bdPositions);
+            m_verletBDPositions = bdPositions;
+        }
+    }
+
+    // Filter the Verlet lists by the true distance so the kernels only see neighbors within the kernel radius
+    const double kernelRadiusSqr = m_modelParameters->m_kernelRadiusSqr;
+    getCurrentState()->getFluidNeighborLists().build(positions.size(),
+        [&](const size_t p, std::vector<uint32_t>& list)
+        {
+            const uint32_t* neighbors = m_verletNeighborLists.getNeighbors(p);
+            for (uint32_t i = 0; i < m_verletNeighborLists.getNumNeighbors(p); i++)
+            {
+                if ((positions[p] - positions[neighbors[i]]).squaredNorm() <= kernelRadiusSqr)
+                {
+                    list.push_back(neighbors[i]);
+                }
+            }
+        });
+
+    if (withBoundary)
+    {
+        getCurrentState()->getBoundaryNeighborLists().build(positions.size(),
+            [&](const size_t p, std::vector<uint32_t>& list)
+            {
+                const uint32_t* neighbors = m_verletBDNeighborLists.getNeighbors(p);
+                for (uint32_t i = 0; i < m_verletBDNeighborLists.getNumNeighbors(p); i++)
+                {
+                    if ((positions[p] - bdPositions[neighbors[i]]).squaredNorm() <= kernelRadiusSqr)
+                    {
+                        list.push_back(neighbors[i]);
+                    }
+                }
+            });
     }
 }
 
 void
-SPHModel::computeNeighborRelativePositions()
+SPHModel::reorderParticles()
 {
-    auto computeRelativePositions = [&](const Vec3d& ppos, const std::vector<size_t>& neighborList,
-                                        const VecDataArray<double, 3>& allPositions, std::vector<NeighborInfo>& neighborInfo)
-                                    {
-                                        for (const size_t q : neighborList)
-                                        {
-                                            const Vec3d& qpos = allPositions[q];
-                                            const Vec3d  r    = ppos - qpos;
-                                            neighborInfo.push_back({ r, m_modelParameters->m_restDensity });
-                                        }
-                                    };
+    const std::vector<size_t> newToOld = Reordering::computeMortonOrder(*getCurrentState()->getPositions());
 
+    // Most state arrays are shared with the geometry, positions included, or registered as its vertex
+    // attributes. Gather everything in one list such that permuteArrays reorders each array exactly once
+    std::vector<std::shared_ptr<AbstractDataArray>> arrays =
+    {
+        m_pointSetGeometry->getInitialVertexPositions(), m_pointSetGeometry->getVertexPositions(),
+        m_pressureAccels, m_surfaceTensionAccels, m_viscousAccels, m_neighborVelContr, m_particleShift
+    };
+    for (const auto& attribute : m_pointSetGeometry->getVertexAttributes())
+    {
+        arrays.push_back(attribute.second);
+    }
+    for (const auto& state : { m_currentState, m_initialState })
+    {
+        arrays.insert(arrays.end(), {
+                state->getVelocities(), state->getFullStepVelocities(), state->getHalfStepVelocities(),
+                state->getDensities(), state->getNormals(), state->getAccelerations(), state->getDiffuseVelocities() });
+    }
+    Reordering::permuteArrays(arrays, newToOld);
+    m_pointSetGeometry->postModified();
+
+    const std::vector<size_t> oldToNew = Reordering::invertPermutation(newToOld);
+    if (m_sphBoundaryConditions)
+    {
+        Reordering::permute(m_sphBoundaryConditions->getParticleTypes(), newToOld);
+        for (size_t& i : m_sphBoundaryConditions->getBufferIndices())
+        {
+            i = oldToNew[i];
+        }
+    }
+    for (size_t& i : m_minIndices)
+    {
+        i = oldToNew[i];
+    }
+
+    // Force a new neighbor search, the Verlet lists refer to the old order
+    m_verletPositions.resize(0);
+}
+
+bool
+SPHModel::needsNeighborSearch() const
+{
+    const VecDataArray<double, 3>& positions   = *getCurrentState()->getPositions();
+    const VecDataArray<double, 3>& bdPositions = *getCurrentState()->getBoundaryParticlePositions();
+
+    if (m_verletPositions.size() != positions.size()
+        || (useBoundaryParticles() && m_verletBDPositions.size() != bdPositions.size()))
+    {
+        return true;
+    }
+
+    // A pair can only come closer than the kernel radius if the displacements of both sum to more than the skin
+    double maxDisplacement = ParallelUtils::findMaxL2Distance(positions, m_verletPositions);
+    if (useBoundaryParticles())
+    {
+        maxDisplacement = std::max(maxDisplacement, ParallelUtils::findMaxL2Distance(bdPositions, m_verletBDPositions));
+    }
+    return maxDisplacement > 0.5 * m_modelParameters->m_neighborListSkin;
+}
+
+void
+SPHModel::computeNeighborRelativePositions()
+{
     std::shared_ptr<VecDataArray<double, 3>> positionsPtr = getCurrentState()->getPositions();
-    const VecDataArray<double, 3>&           positions = *positionsPtr;
+    const VecDataArray<double, 3>&           positions    = *positionsPtr;
+    const VecDataArray<double, 3>&           bdPositions  = *getCurrentState()->getBoundaryParticlePositions();
 
-    std::vector<std::vector<NeighborInfo>>& neighborInfos = getCurrentState()->getNeighborInfo();
+    const CSRNeighborList& fluidNeighborLists = getCurrentState()->getFluidNeighborLists();
+    const CSRNeighborList& bdNeighborLists    = getCurrentState()->getBoundaryNeighborLists();
+    const bool             withBoundary       = useBoundaryParticles();
 
-    ParallelUtils::parallelFor(getCurrentState()->getNumParticles(),
+    std::vector<NeighborInfo>& neighborInfos = getCurrentState()->getNeighborInfo();
+    std::vector<uint32_t>&     infoOffsets   = getCurrentState()->getNeighborInfoOffsets();
+
+    // Buffer particles get no neighbor info, others get their fluid then boundary neighbors
+    const size_t numParticles = getCurrentState()->getNumParticles();
+    infoOffsets.resize(numParticles + 1);
+    infoOffsets[0] = 0;
+    for (size_t p = 0; p < numParticles; p++)
+    {
+        uint32_t numInfo = 0;
+        if (!(m_sphBoundaryConditions
+              && m_sphBoundaryConditions->getParticleTypes()[p] == SPHBoundaryConditions::ParticleType::Buffer))
+        {
+            numInfo = fluidNeighborLists.getNumNeighbors(p) + (withBoundary ? bdNeighborLists.getNumNeighbors(p) : 0);
+        }
+        infoOffsets[p + 1] = infoOffsets[p] + numInfo;
+    }
+    neighborInfos.resize(infoOffsets[numParticles]);
+
+    ParallelUtils::parallelFor(numParticles,
         [&](const size_t p)
         {
-            if (m_sphBoundaryConditions
-                && m_sphBoundaryConditions->getParticleTypes()[p] == SPHBoundaryConditions::ParticleType::Buffer)
+            if (infoOffsets[p + 1] == infoOffsets[p])
             {
                 return;
             }
 
-            const Vec3d& ppos = positions[p];
-            std::vector<NeighborInfo>& neighborInfo = neighborInfos[p];
-            neighborInfo.resize(0);
-            neighborInfo.reserve(48);
+            const Vec3d&  ppos         = positions[p];
+            NeighborInfo* neighborInfo = neighborInfos.data() + infoOffsets[p];
 
-            computeRelativePositions(ppos, getCurrentState()->getFluidNeighborLists()[p], *getCurrentState()->getPositions(), neighborInfo);
+            const uint32_t* fluidNeighbors = fluidNeighborLists.getNeighbors(p);
+            for (uint32_t i = 0; i < fluidNeighborLists.getNumNeighbors(p); i++)
+            {
+                *neighborInfo++ = { ppos - positions[fluidNeighbors[i]], m_modelParameters->m_restDensity };
+            }
             // if considering boundary particles then also cache relative positions with them
-            if (m_modelParameters->m_bDensityWithBoundary)
+            if (withBoundary)
             {
-                computeRelativePositions(ppos, getCurrentState()->getBoundaryNeighborLists()[p], *getCurrentState()->getBoundaryParticlePositions(), neighborInfo);
+                const uint32_t* bdNeighbors = bdNeighborLists.getNeighbors(p);
+                for (uint32_t i = 0; i < bdNeighborLists.getNumNeighbors(p); i++)
+                {
+                    *neighborInfo++ = { ppos - bdPositions[bdNeighbors[i]], m_modelParameters->m_restDensity };
+                }
             }
       });
 }
 
+void
+SPHModel::sampleBoundaryDensities()
+{
+    if (m_boundaryDensities.empty())
+    {
+        return;
+    }
+
+    const VecDataArray<double, 3>& positions = *getCurrentState()->getPositions();
+    ParallelUtils::parallelFor(getCurrentState()->getNumParticles(),
+        [&](const size_t p)
+        {
+            m_boundaryDensityMap.sample(positions[p], m_boundaryDensities[p], m_boundaryDensityGradients[p]);
+        });
+}
+
 void
 SPHModel::collectNeighborDensity()
 {
     // After computing particle densities, cache them into neighborInfo variable, next to relative positions
     // this is useful because relative positions and densities are accessed together multiple times
     // caching relative positions and densities therefore can reduce computation time significantly (tested)
-    std::shared_ptr<DataArray<double>> densitiesPtr = getCurrentState()->getDensities();
-    DataArray<double>&                 densities    = *densitiesPtr;
+    std::shared_ptr<DataArray<double>> densitiesPtr   = getCurrentState()->getDensities();
+    DataArray<double>&                 densities      = *densitiesPtr;
+    VecDataArray<double, 3>&           surfaceNormals = *getCurrentState()->getNormals();
 
-    const std::vector<std::vector<size_t>>&                 neighborLists = getCurrentState()->getFluidNeighborLists();
-    const std::vector<SPHBoundaryConditions::ParticleType>& particleTypes = m_sphBoundaryConditions->getParticleTypes();
+    const CSRNeighborList&       neighborLists = getCurrentState()->getFluidNeighborLists();
+    std::vector<NeighborInfo>&   neighborInfos = getCurrentState()->getNeighborInfo();
+    const std::vector<uint32_t>& infoOffsets   = getCurrentState()->getNeighborInfoOffsets();
+
+    // The fused force pass needs the surface normals of the neighbors, they are computed here
+    // while the neighbor info is already in cache
+    const bool withNormals = m_modelParameters->m_bFusedForces && m_modelParameters->m_surfaceTensionStiffness != 0.0;
 
     ParallelUtils::parallelFor(getCurrentState()->getNumParticles(),
         [&](const size_t p)
         {
-            if (m_sphBoundaryConditions && particleTypes[p] == SPHBoundaryConditions::ParticleType::Buffer)
+            if (m_sphBoundaryConditions && m_sphBoundaryConditions->getParticleTypes()[p] == SPHBoundaryConditions::ParticleType::Buffer)
             {
                 return;
             }
 
-            auto& neighborInfo = getCurrentState()->getNeighborInfo()[p];
-            if (neighborInfo.size() <= 1)
+            if (infoOffsets[p + 1] - infoOffsets[p] <= 1)
             {
+                if (withNormals)
+                {
+                    surfaceNormals[p] = Vec3d::Zero();
+                }
                 return; // the particle has no neighbor
             }
 
-            const auto& fluidNeighborList = neighborLists[p];
-            for (size_t i = 0; i < fluidNeighborList.size(); ++i)
+            NeighborInfo*   neighborInfo      = neighborInfos.data() + infoOffsets[p];
+            const uint32_t* fluidNeighborList = neighborLists.getNeighbors(p);
+            for (uint32_t i = 0; i < neighborLists.getNumNeighbors(p); ++i)
+            {
+                neighborInfo[i].density = densities[fluidNeighborList[i]];
+            }
+
+            if (withNormals)
             {
-                auto q = fluidNeighborList[i];
-                neighborInfo[i].density = densities[q];
+                Vec3d n(0.0, 0.0, 0.0);
+                for (uint32_t i = 0; i < infoOffsets[p + 1] - infoOffsets[p]; ++i)
+                {
+                    n += (1.0 / neighborInfo[i].density) * m_kernels.gradW(neighborInfo[i].xpq);
+                }
+                surfaceNormals[p] = n * (m_modelParameters->m_kernelRadius * m_modelParameters->m_particleMass);
             }
       });
 }
@@ -350,7 +630,11 @@ SPHModel::computeDensity()
     std::shared_ptr<DataArray<double>> densitiesPtr = getCurrentState()->getDensities();
     DataArray<double>&                 densities    = *densitiesPtr;
 
-    const std::vector<std::vector<NeighborInfo>>& neighborInfos = getCurrentState()->getNeighborInfo();
+    const std::vector<NeighborInfo>& neighborInfos = getCurrentState()->getNeighborInfo();
+    const std::vector<uint32_t>&     infoOffsets   = getCurrentState()->getNeighborInfoOffsets();
+
+    const bool  singlePrecision = m_modelParameters->m_bSinglePrecisionKernels;
+    const float padding         = m_batchKernels.getPaddingDistance();
 
     ParallelUtils::parallelFor(getCurrentState()->getNumParticles(),
         [&](const size_t p)
@@ -360,18 +644,35 @@ SPHModel::computeDensity()
                 return;
             }
 
-            const std::vector<NeighborInfo>& neighborInfo = neighborInfos[p];
-            if (neighborInfo.size() <= 1)
+            if (infoOffsets[p + 1] - infoOffsets[p] <= 1 && !hasBoundaryDensity(p))
             {
                 return; // the particle has no neighbor
             }
 
             double pdensity = 0.0;
-            for (const auto& qInfo : neighborInfo)
+            if (singlePrecision)
             {
-                pdensity += m_kernels.W(qInfo.xpq);
+                KernelBlock x, y, z;
+                KernelBlock sum = KernelBlock::Zero();
+                for (uint32_t i = infoOffsets[p]; i < infoOffsets[p + 1]; i += kernelBlockSize)
+                {
+                    gatherRelativePositions(neighborInfos.data() + i, std::min<int>(kernelBlockSize, infoOffsets[p + 1] - i), padding, x, y, z);
+                    sum += m_batchKernels.W(x * x + y * y + z * z);
+                }
+                pdensity = static_cast<double>(sum.sum());
+            }
+            else
+            {
+                for (uint32_t i = infoOffsets[p]; i < infoOffsets[p + 1]; ++i)
+                {
+                    pdensity += m_kernels.W(neighborInfos[i].xpq);
+                }
+            }
+            pdensity *= m_modelParameters->m_particleMass;
+            if (hasBoundaryDensity(p))
+            {
+                pdensity += m_boundaryDensities[p];
             }
-            pdensity    *= m_modelParameters->m_particleMass;
             densities[p] = pdensity;
       });
 }
@@ -399,8 +700,9 @@ SPHModel::normalizeDensity()
     std::shared_ptr<DataArray<double>> densitiesPtr = getCurrentState()->getDensities();
     DataArray<double>&                 densities    = *densitiesPtr;
 
-    const std::vector<std::vector<size_t>>&                 neighborLists = getCurrentState()->getFluidNeighborLists();
-    const std::vector<std::vector<NeighborInfo>>&           neighborInfos = getCurrentState()->getNeighborInfo();
+    const CSRNeighborList&                                  neighborLists = getCurrentState()->getFluidNeighborLists();
+    const std::vector<NeighborInfo>&                        neighborInfos = getCurrentState()->getNeighborInfo();
+    const std::vector<uint32_t>&                            infoOffsets   = getCurrentState()->getNeighborInfoOffsets();
     const std::vector<SPHBoundaryConditions::ParticleType>& particleTypes = m_sphBoundaryConditions->getParticleTypes();
 
     ParallelUtils::parallelFor(getCurrentState()->getNumParticles(),
@@ -411,16 +713,16 @@ SPHModel::normalizeDensity()
                 return;
             }
 
-            const std::vector<NeighborInfo>& neighborInfo = neighborInfos[p];
-            if (neighborInfo.size() <= 1)
+            if (infoOffsets[p + 1] - infoOffsets[p] <= 1)
             {
                 return; // the particle has no neighbor
             }
 
-            const auto& fluidNeighborList = neighborLists[p];
-            double tmp = 0.0;
+            const NeighborInfo* neighborInfo      = neighborInfos.data() + infoOffsets[p];
+            const uint32_t*     fluidNeighborList = neighborLists.getNeighbors(p);
+            double              tmp = 0.0;
 
-            for (size_t i = 0; i < fluidNeighborList.size(); ++i)
+            for (uint32_t i = 0; i < neighborLists.getNumNeighbors(p); ++i)
             {
                 const auto& qInfo = neighborInfo[i];
 
@@ -441,7 +743,8 @@ SPHModel::computePressureAcceleration()
     const DataArray<double>&           densities      = *densitiesPtr;
     VecDataArray<double, 3>&           pressureAccels = *m_pressureAccels;
 
-    const std::vector<std::vector<NeighborInfo>>&           neighborInfos = getCurrentState()->getNeighborInfo();
+    const std::vector<NeighborInfo>&                        neighborInfos = getCurrentState()->getNeighborInfo();
+    const std::vector<uint32_t>&                            infoOffsets   = getCurrentState()->getNeighborInfoOffsets();
     const std::vector<SPHBoundaryConditions::ParticleType>& particleTypes = m_sphBoundaryConditions->getParticleTypes();
 
     ParallelUtils::parallelFor(getCurrentState()->getNumParticles(),
@@ -453,8 +756,7 @@ SPHModel::computePressureAcceleration()
             }
 
             Vec3d accel = Vec3d::Zero();
-            const std::vector<NeighborInfo>& neighborInfo = neighborInfos[p];
-            if (neighborInfo.size() <= 1)
+            if (infoOffsets[p + 1] - infoOffsets[p] <= 1 && !hasBoundaryDensity(p))
             {
                 pressureAccels[p] = accel;
                 return;
@@ -463,9 +765,9 @@ SPHModel::computePressureAcceleration()
             const auto pdensity  = densities[p];
             const auto ppressure = particlePressure(pdensity);
 
-            for (size_t idx = 0; idx < neighborInfo.size(); ++idx)
+            for (uint32_t idx = infoOffsets[p]; idx < infoOffsets[p + 1]; ++idx)
             {
-                const auto& qInfo    = neighborInfo[idx];
+                const auto& qInfo    = neighborInfos[idx];
                 const auto r         = qInfo.xpq;
                 const auto qdensity  = qInfo.density;
                 const auto qpressure = particlePressure(qdensity);
@@ -474,6 +776,11 @@ SPHModel::computePressureAcceleration()
             }
 
             accel *= m_modelParameters->m_particleMass;
+            // The boundary mirrors the pressure and density of the particle, its mass is in the density gradient
+            if (hasBoundaryDensity(p))
+            {
+                accel -= 2.0 * (ppressure / (pdensity * pdensity)) * m_boundaryDensityGradients[p];
+            }
 
             //getState().getAccelerations()[p] = accel;
             pressureAccels[p] = accel;
@@ -488,8 +795,9 @@ SPHModel::computeViscosity()
     VecDataArray<double, 3>&       particleShift      = *m_particleShift;
     const VecDataArray<double, 3>& halfStepVelocities = *getCurrentState()->getHalfStepVelocities();
 
-    const std::vector<std::vector<NeighborInfo>>& neighborInfos = getCurrentState()->getNeighborInfo();
-    const std::vector<std::vector<size_t>>&       neighborLists = getCurrentState()->getFluidNeighborLists();
+    const std::vector<NeighborInfo>& neighborInfos = getCurrentState()->getNeighborInfo();
+    const std::vector<uint32_t>&     infoOffsets   = getCurrentState()->getNeighborInfoOffsets();
+    const CSRNeighborList&           neighborLists = getCurrentState()->getFluidNeighborLists();
 
     ParallelUtils::parallelFor(getCurrentState()->getNumParticles(),
         [&](const size_t p)
@@ -501,8 +809,7 @@ SPHModel::computeViscosity()
                 return;
             }
 
-            const std::vector<NeighborInfo>& neighborInfo = neighborInfos[p];
-            if (neighborInfo.size() <= 1)
+            if (infoOffsets[p + 1] - infoOffsets[p] <= 1)
             {
                 neighborVelContr[p] = Vec3d::Zero();
                 viscousAccels[p]    = Vec3d::Zero();
@@ -514,11 +821,12 @@ SPHModel::computeViscosity()
             double neighborVelContributionsDenominator = 0.0;
             Vec3d particleShifts = Vec3d::Zero();
 
-            const Vec3d& pvel = halfStepVelocities[p];
-            const std::vector<size_t>& fluidNeighborList = neighborLists[p];
+            const Vec3d&        pvel = halfStepVelocities[p];
+            const NeighborInfo* neighborInfo      = neighborInfos.data() + infoOffsets[p];
+            const uint32_t*     fluidNeighborList = neighborLists.getNeighbors(p);
 
             Vec3d diffuseFluid = Vec3d::Zero();
-            for (size_t i = 0; i < fluidNeighborList.size(); ++i)
+            for (uint32_t i = 0; i < neighborLists.getNumNeighbors(p); ++i)
             {
                 const auto q        = fluidNeighborList[i];
                 const auto& qvel    = halfStepVelocities[q];
@@ -548,7 +856,8 @@ SPHModel::computeSurfaceTension()
 {
     VecDataArray<double, 3>& surfaceNormals = *getCurrentState()->getNormals();
 
-    const std::vector<std::vector<NeighborInfo>>& neighborInfos = getCurrentState()->getNeighborInfo();
+    const std::vector<NeighborInfo>& neighborInfos = getCurrentState()->getNeighborInfo();
+    const std::vector<uint32_t>&     infoOffsets   = getCurrentState()->getNeighborInfoOffsets();
 
     // First, compute surface normal for all particles
     ParallelUtils::parallelFor(getCurrentState()->getNumParticles(),
@@ -560,16 +869,15 @@ SPHModel::computeSurfaceTension()
             }
 
             Vec3d n(0.0, 0.0, 0.0);
-            const std::vector<NeighborInfo>& neighborInfo = neighborInfos[p];
-            if (neighborInfo.size() <= 1)
+            if (infoOffsets[p + 1] - infoOffsets[p] <= 1)
             {
                 surfaceNormals[p] = n;
                 return;
             }
 
-            for (size_t i = 0; i < neighborInfo.size(); ++i)
+            for (uint32_t i = infoOffsets[p]; i < infoOffsets[p + 1]; ++i)
             {
-                const auto& qInfo   = neighborInfo[i];
+                const auto& qInfo   = neighborInfos[i];
                 const auto r        = qInfo.xpq;
                 const auto qdensity = qInfo.density;
                 n += (1.0 / qdensity) * m_kernels.gradW(r);
@@ -582,7 +890,7 @@ SPHModel::computeSurfaceTension()
     VecDataArray<double, 3>& surfaceTensionAccels = *m_surfaceTensionAccels;
     const DataArray<double>& densities = *getCurrentState()->getDensities();
 
-    const std::vector<std::vector<size_t>>& neighborLists = getCurrentState()->getFluidNeighborLists();
+    const CSRNeighborList& neighborLists = getCurrentState()->getFluidNeighborLists();
 
     // Second, compute surface tension acceleration
     ParallelUtils::parallelFor(getCurrentState()->getNumParticles(),
@@ -595,18 +903,18 @@ SPHModel::computeSurfaceTension()
                 return;
             }
 
-            const std::vector<size_t>& fluidNeighborList = neighborLists[p];
-            if (fluidNeighborList.size() <= 1)
+            if (neighborLists.getNumNeighbors(p) <= 1)
             {
                 return; // the particle has no neighbor
             }
 
-            const Vec3d& ni          = surfaceNormals[p];
-            const double pdensity    = densities[p];
-            const auto& neighborInfo = neighborInfos[p];
+            const uint32_t*     fluidNeighborList = neighborLists.getNeighbors(p);
+            const Vec3d&        ni           = surfaceNormals[p];
+            const double        pdensity     = densities[p];
+            const NeighborInfo* neighborInfo = neighborInfos.data() + infoOffsets[p];
 
             Vec3d accel = Vec3d::Zero();
-            for (size_t i = 0; i < fluidNeighborList.size(); ++i)
+            for (uint32_t i = 0; i < neighborLists.getNumNeighbors(p); ++i)
             {
                 const size_t q = fluidNeighborList[i];
                 if (p == q)
@@ -638,6 +946,150 @@ SPHModel::computeSurfaceTension()
         });
 }
 
+void
+SPHModel::solvePressure()
+{
+    const VecDataArray<double, 3>& positions          = *getCurrentState()->getPositions();
+    const VecDataArray<double, 3>& halfStepVelocities = *getCurrentState()->getHalfStepVelocities();
+    VecDataArray<double, 3>&       accels = *getCurrentState()->getAccelerations();
+    VecDataArray<double, 3>&       pressureAccels = *m_pressureAccels;
+    const VecDataArray<double, 3>& viscousAccels  = *m_viscousAccels;
+    const VecDataArray<double, 3>& surfaceTensionAccels = *m_surfaceTensionAccels;
+
+    const std::vector<NeighborInfo>& neighborInfos = getCurrentState()->getNeighborInfo();
+    const std::vector<uint32_t>&     infoOffsets   = getCurrentState()->getNeighborInfoOffsets();
+    const CSRNeighborList&           neighborLists = getCurrentState()->getFluidNeighborLists();
+
+    const size_t numParticles = getCurrentState()->getNumParticles();
+    const double dt           = getTimeStep();
+    const double mass         = m_modelParameters->m_particleMass;
+    const double restDensity  = m_modelParameters->m_restDensity;
+    const double delta        = m_pressureScale / (dt * dt);
+
+    // The fused force pass sums the other accelerations into the particle accelerations
+    const bool fused = m_modelParameters->m_bFusedForces;
+    const bool withBoundaryMap = !m_boundaryDensities.empty();
+
+    auto isBuffer = [&](const size_t p)
+                    {
+                        return m_sphBoundaryConditions
+                               && m_sphBoundaryConditions->getParticleTypes()[p] == SPHBoundaryConditions::ParticleType::Buffer;
+                    };
+    auto isStatic = [&](const size_t p)
+                    {
+                        return m_sphBoundaryConditions
+                               && (m_sphBoundaryConditions->getParticleTypes()[p] == SPHBoundaryConditions::ParticleType::Buffer
+                                   || m_sphBoundaryConditions->getParticleTypes()[p] == SPHBoundaryConditions::ParticleType::Wall);
+                    };
+
+    m_pressures.assign(numParticles, 0.0);
+    m_densityErrors.assign(numParticles, 0.0);
+    m_predictedDisplacements.resize(static_cast<int>(numParticles));
+    ParallelUtils::parallelFor(numParticles, [&](const size_t p) { pressureAccels[p] = Vec3d::Zero(); });
+
+    for (int iter = 0; iter < m_modelParameters->m_maxPressureIterations; iter++)
+    {
+        // Predict the displacements with the current pressure
+        ParallelUtils::parallelFor(numParticles,
+            [&](const size_t p)
+            {
+                if (isStatic(p))
+                {
+                    m_predictedDisplacements[p] = Vec3d::Zero();
+                    return;
+                }
+                const Vec3d otherAccel = fused ? accels[p] : Vec3d(viscousAccels[p] + surfaceTensionAccels[p]);
+                m_predictedDisplacements[p] = dt * (halfStepVelocities[p]
+                                                    + dt * (m_modelParameters->m_gravity + otherAccel + pressureAccels[p]));
+            });
+
+        // Correct the pressures by the predicted density errors, only compression is corrected
+        ParallelUtils::parallelFor(numParticles,
+            [&](const size_t p)
+            {
+                if (isBuffer(p) || (infoOffsets[p + 1] - infoOffsets[p] <= 1 && !hasBoundaryDensity(p)))
+                {
+                    m_densityErrors[p] = 0.0;
+                    return;
+                }
+
+                const NeighborInfo* neighborInfo      = neighborInfos.data() + infoOffsets[p];
+                const uint32_t*     fluidNeighborList = neighborLists.getNeighbors(p);
+                const uint32_t      numFluidNeighbors = neighborLists.getNumNeighbors(p);
+                const Vec3d&        pDisplacement     = m_predictedDisplacements[p];
+
+                double predictedDensity = 0.0;
+                for (uint32_t i = 0; i < infoOffsets[p + 1] - infoOffsets[p]; i++)
+                {
+                    Vec3d xpq = neighborInfo[i].xpq + pDisplacement;
+                    if (i < numFluidNeighbors)
+                    {
+                        xpq -= m_predictedDisplacements[fluidNeighborList[i]];
+                    }
+                    predictedDensity += m_kernels.W(xpq);
+                }
+                predictedDensity *= mass;
+                if (withBoundaryMap)
+                {
+                    double boundaryDensity;
+                    Vec3d  boundaryGradient;
+                    m_boundaryDensityMap.sample(positions[p] + pDisplacement, boundaryDensity, boundaryGradient);
+                    predictedDensity += boundaryDensity;
+                }
+                const double densityError = std::max(predictedDensity - restDensity, 0.0);
+                m_pressures[p]    += delta * densityError;
+                m_densityErrors[p] = densityError;
+            });
+
+        // Pressure accelerations, boundary neighbors mirror the pressure of the particle
+        ParallelUtils::parallelFor(numParticles,
+            [&](const size_t p)
+            {
+                if (isStatic(p) || (infoOffsets[p + 1] - infoOffsets[p] <= 1 && !hasBoundaryDensity(p)))
+                {
+                    return;
+                }
+
+                const NeighborInfo* neighborInfo      = neighborInfos.data() + infoOffsets[p];
+                const uint32_t*     fluidNeighborList = neighborLists.getNeighbors(p);
+                const uint32_t      numFluidNeighbors = neighborLists.getNumNeighbors(p);
+                const double        ppressure         = m_pressures[p];
+
+                Vec3d accel = Vec3d::Zero();
+                for (uint32_t i = 0; i < infoOffsets[p + 1] - infoOffsets[p]; i++)
+                {
+                    const double qpressure = i < numFluidNeighbors ? m_pressures[fluidNeighborList[i]] : ppressure;
+                    accel -= (ppressure + qpressure) * m_kernels.gradW(neighborInfo[i].xpq);
+                }
+                // The boundary mirrors the pressure of the particle
+                if (hasBoundaryDensity(p))
+                {
+                    accel -= (2.0 * ppressure / mass) * m_boundaryDensityGradients[p];
+                }
+                pressureAccels[p] = accel * (mass / m_modelParameters->m_restDensitySqr);
+            });
+
+        const double maxDensityError = ParallelUtils::findMax(numParticles, [&](const size_t p) { return m_densityErrors[p]; });
+        if (iter + 1 >= m_modelParameters->m_minPressureIterations
+            && maxDensityError <= m_modelParameters->m_maxDensityError * restDensity)
+        {
+            break;
+        }
+    }
+
+    if (fused)
+    {
+        ParallelUtils::parallelFor(numParticles,
+            [&](const size_t p)
+            {
+                if (!isStatic(p))
+                {
+                    accels[p] += pressureAccels[p];
+                }
+            });
+    }
+}
+
 void
 SPHModel::sumAccels()
 {
@@ -660,6 +1112,335 @@ SPHModel::sumAccels()
       });
 }
 
+void
+SPHModel::computeForces()
+{
+    const bool pressure       = m_modelParameters->m_pressureSolver == SPHModelConfig::PressureSolverType::EquationOfState
+                                && m_modelParameters->m_pressureStiffness != 0.0;
+    const bool viscosity      = m_modelParameters->m_dynamicViscosityCoeff != 0.0;
+    const bool surfaceTension = m_modelParameters->m_surfaceTensionStiffness != 0.0;
+
+    using ForceKernel = void (SPHModel::*)();
+    static const ForceKernel kernels[8] =
+    {
+        &SPHModel::computeForcesFused<false, false, false>,
+        &SPHModel::computeForcesFused<false, false, true>,
+        &SPHModel::computeForcesFused<false, true, false>,
+        &SPHModel::computeForcesFused<false, true, true>,
+        &SPHModel::computeForcesFused<true, false, false>,
+        &SPHModel::computeForcesFused<true, false, true>,
+        &SPHModel::computeForcesFused<true, true, false>,
+        &SPHModel::computeForcesFused<true, true, true>
+    };
+    static const ForceKernel batchedKernels[8] =
+    {
+        &SPHModel::computeForcesBatched<false, false, false>,
+        &SPHModel::computeForcesBatched<false, false, true>,
+        &SPHModel::computeForcesBatched<false, true, false>,
+        &SPHModel::computeForcesBatched<false, true, true>,
+        &SPHModel::computeForcesBatched<true, false, false>,
+        &SPHModel::computeForcesBatched<true, false, true>,
+        &SPHModel::computeForcesBatched<true, true, false>,
+        &SPHModel::computeForcesBatched<true, true, true>
+    };
+    const int kernelId = (pressure ? 4 : 0) + (viscosity ? 2 : 0) + (surfaceTension ? 1 : 0);
+    (this->*(m_modelParameters->m_bSinglePrecisionKernels ? batchedKernels : kernels)[kernelId])();
+}
+
+template<bool Pressure, bool Viscosity, bool SurfaceTension>
+void
+SPHModel::computeForcesFused()
+{
+    const DataArray<double>&       densities          = *getCurrentState()->getDensities();
+    const VecDataArray<double, 3>& halfStepVelocities = *getCurrentState()->getHalfStepVelocities();
+    const VecDataArray<double, 3>& surfaceNormals     = *getCurrentState()->getNormals();
+    VecDataArray<double, 3>&       accels             = *getCurrentState()->getAccelerations();
+    VecDataArray<double, 3>&       neighborVelContr   = *m_neighborVelContr;
+    VecDataArray<double, 3>&       particleShift      = *m_particleShift;
+
+    const std::vector<NeighborInfo>& neighborInfos = getCurrentState()->getNeighborInfo();
+    const std::vector<uint32_t>&     infoOffsets   = getCurrentState()->getNeighborInfoOffsets();
+    const CSRNeighborList&           neighborLists = getCurrentState()->getFluidNeighborLists();
+
+    const double particleMass   = m_modelParameters->m_particleMass;
+    const double restDensity    = m_modelParameters->m_restDensity;
+    const double particleRadius = m_modelParameters->m_particleRadius;
+    const double shiftScale     = 4 / 3 * PI * particleRadius * particleRadius * particleRadius * 0.5 * m_modelParameters->m_kernelRadius;
+
+    ParallelUtils::parallelFor(getCurrentState()->getNumParticles(),
+        [&](const size_t p)
+        {
+            if (m_sphBoundaryConditions
+                && (m_sphBoundaryConditions->getParticleTypes()[p] == SPHBoundaryConditions::ParticleType::Buffer
+                    || m_sphBoundaryConditions->getParticleTypes()[p] == SPHBoundaryConditions::ParticleType::Wall))
+            {
+                return;
+            }
+
+            const uint32_t numInfos = infoOffsets[p + 1] - infoOffsets[p];
+            if (numInfos <= 1 && !hasBoundaryDensity(p))
+            {
+                accels[p]           = Vec3d::Zero();
+                neighborVelContr[p] = Vec3d::Zero();
+                particleShift[p]    = Vec3d::Zero();
+                return;
+            }
+
+            const NeighborInfo* neighborInfo      = neighborInfos.data() + infoOffsets[p];
+            const uint32_t*     fluidNeighborList = neighborLists.getNeighbors(p);
+            const uint32_t      numFluidNeighbors = neighborLists.getNumNeighbors(p);
+
+            const double pdensity  = densities[p];
+            const double ppressure = Pressure ? particlePressure(pdensity) / (pdensity * pdensity) : 0.0;
+            const Vec3d& pvel      = halfStepVelocities[p];
+            const Vec3d& ni        = surfaceNormals[p];
+
+            Vec3d  pressureAccel       = Vec3d::Zero();
+            Vec3d  diffuseFluid        = Vec3d::Zero();
+            Vec3d  surfaceTensionAccel = Vec3d::Zero();
+            Vec3d  neighborVelContributionsNumerator   = Vec3d::Zero();
+            double neighborVelContributionsDenominator = 0.0;
+            Vec3d  particleShifts = Vec3d::Zero();
+
+            // Fluid neighbors come first, boundary neighbors only contribute to the pressure
+            for (uint32_t i = 0; i < numInfos; ++i)
+            {
+                const NeighborInfo& qInfo    = neighborInfo[i];
+                const Vec3d&        r        = qInfo.xpq;
+                const double        qdensity = qInfo.density;
+                const Vec3d         gradW    = m_kernels.gradW(r);
+                if (Pressure)
+                {
+                    pressureAccel -= (ppressure + particlePressure(qdensity) / (qdensity * qdensity)) * gradW;
+                }
+                if (i >= numFluidNeighbors)
+                {
+                    continue;
+                }
+
+                const uint32_t q    = fluidNeighborList[i];
+                const Vec3d&   qvel = halfStepVelocities[q];
+                const double   w    = m_kernels.W(r);
+                neighborVelContributionsNumerator   += (qvel - pvel) * w;
+                neighborVelContributionsDenominator += w;
+                particleShifts += gradW;
+
+                if (Viscosity)
+                {
+                    diffuseFluid += (1.0 / qdensity) * m_kernels.laplace(r) * (qvel - pvel);
+                }
+                if (SurfaceTension && q != p)
+                {
+                    // Correction factor
+                    const double K_ij = 2.0 * restDensity / (pdensity + qdensity);
+
+                    // Cohesion acc
+                    const double d2 = r.squaredNorm();
+                    if (d2 > 1.0e-20)
+                    {
+                        surfaceTensionAccel -= K_ij * particleMass * (r / std::sqrt(d2)) * m_kernels.cohesionW(r);
+                    }
+
+                    // Curvature acc
+                    surfaceTensionAccel -= K_ij * (ni - surfaceNormals[q]);
+                }
+            }
+
+            Vec3d accel = Vec3d::Zero();
+            if (Pressure)
+            {
+                accel += pressureAccel * particleMass;
+                if (hasBoundaryDensity(p))
+                {
+                    accel -= 2.0 * ppressure * m_boundaryDensityGradients[p];
+                }
+            }
+            if (Viscosity)
+            {
+                accel += diffuseFluid * (m_modelParameters->m_dynamicViscosityCoeff * particleMass);
+            }
+            if (SurfaceTension)
+            {
+                accel += surfaceTensionAccel * m_modelParameters->m_surfaceTensionStiffness;
+            }
+            accels[p] = accel;
+
+            neighborVelContr[p] = neighborVelContributionsNumerator * m_modelParameters->m_eta / neighborVelContributionsDenominator;
+            particleShift[p]    = -particleShifts * (shiftScale * pvel.norm());
+      });
+}
+
+template<bool Pressure, bool Viscosity, bool SurfaceTension>
+void
+SPHModel::computeForcesBatched()
+{
+    const DataArray<double>&       densities          = *getCurrentState()->getDensities();
+    const VecDataArray<double, 3>& halfStepVelocities = *getCurrentState()->getHalfStepVelocities();
+    const VecDataArray<double, 3>& surfaceNormals     = *getCurrentState()->getNormals();
+    VecDataArray<double, 3>&       accels             = *getCurrentState()->getAccelerations();
+    VecDataArray<double, 3>&       neighborVelContr   = *m_neighborVelContr;
+    VecDataArray<double, 3>&       particleShift      = *m_particleShift;
+
+    const std::vector<NeighborInfo>& neighborInfos = getCurrentState()->getNeighborInfo();
+    const std::vector<uint32_t>&     infoOffsets   = getCurrentState()->getNeighborInfoOffsets();
+    const CSRNeighborList&           neighborLists = getCurrentState()->getFluidNeighborLists();
+
+    const float  particleMass      = static_cast<float>(m_modelParameters->m_particleMass);
+    const float  restDensity       = static_cast<float>(m_modelParameters->m_restDensity);
+    const float  pressureStiffness = static_cast<float>(m_modelParameters->m_pressureStiffness);
+    const float  padding           = m_batchKernels.getPaddingDistance();
+    const double particleRadius    = m_modelParameters->m_particleRadius;
+    const double shiftScale        = 4 / 3 * PI * particleRadius * particleRadius * particleRadius * 0.5 * m_modelParameters->m_kernelRadius;
+
+    // Pressure over squared density, see particlePressure
+    auto pressureTerm = [&](const KernelBlock& density)
+                        {
+                            const KernelBlock d  = density / restDensity;
+                            const KernelBlock d2 = d * d;
+                            const KernelBlock pressure = (pressureStiffness * (d2 * d2 * d2 * d - 1.0f)).max(0.0f);
+                            return KernelBlock(pressure / (density * density));
+                        };
+
+    ParallelUtils::parallelFor(getCurrentState()->getNumParticles(),
+        [&](const size_t p)
+        {
+            if (m_sphBoundaryConditions
+                && (m_sphBoundaryConditions->getParticleTypes()[p] == SPHBoundaryConditions::ParticleType::Buffer
+                    || m_sphBoundaryConditions->getParticleTypes()[p] == SPHBoundaryConditions::ParticleType::Wall))
+            {
+                return;
+            }
+
+            const uint32_t numInfos = infoOffsets[p + 1] - infoOffsets[p];
+            if (numInfos <= 1 && !hasBoundaryDensity(p))
+            {
+                accels[p]           = Vec3d::Zero();
+                neighborVelContr[p] = Vec3d::Zero();
+                particleShift[p]    = Vec3d::Zero();
+                return;
+            }
+
+            const NeighborInfo* neighborInfo      = neighborInfos.data() + infoOffsets[p];
+            const uint32_t*     fluidNeighborList = neighborLists.getNeighbors(p);
+            const uint32_t      numFluidNeighbors = neighborLists.getNumNeighbors(p);
+
+            const float  pdensity  = static_cast<float>(densities[p]);
+            const float  ppressure = Pressure ? pressureTerm(KernelBlock::Constant(pdensity))[0] : 0.0f;
+            const Vec3d& pvel      = halfStepVelocities[p];
+            const Vec3d& ni        = surfaceNormals[p];
+
+            KernelBlock x, y, z;
+            KernelBlock density, fluid, dvx, dvy, dvz, nx, ny, nz;
+            Vec3f       pressureAccel       = Vec3f::Zero();
+            Vec3f       diffuseFluid        = Vec3f::Zero();
+            Vec3f       surfaceTensionAccel = Vec3f::Zero();
+            Vec3f       neighborVelContributionsNumerator   = Vec3f::Zero();
+            float       neighborVelContributionsDenominator = 0.0f;
+            Vec3f       particleShifts = Vec3f::Zero();
+
+            // Fluid neighbors come first, boundary neighbors only contribute to the pressure
+            for (uint32_t start = 0; start < numInfos; start += kernelBlockSize)
+            {
+                const int count = std::min<int>(kernelBlockSize, numInfos - start);
+                gatherRelativePositions(neighborInfo + start, count, padding, x, y, z);
+                density.setOnes();
+                for (int k = 0; k < count; k++)
+                {
+                    density[k] = static_cast<float>(neighborInfo[start + k].density);
+                }
+
+                const KernelBlock r2    = x * x + y * y + z * z;
+                const KernelBlock r     = r2.sqrt();
+                const KernelBlock gradW = m_batchKernels.gradWScale(r2, r);
+                if (Pressure)
+                {
+                    const KernelBlock s = (ppressure + pressureTerm(density)) * gradW;
+                    pressureAccel -= Vec3f((s * x).sum(), (s * y).sum(), (s * z).sum());
+                }
+                if (start >= numFluidNeighbors)
+                {
+                    continue;
+                }
+
+                // Gather the velocities (and normals) of the fluid lanes, the other lanes are masked out
+                fluid.setZero();
+                dvx.setZero();
+                dvy.setZero();
+                dvz.setZero();
+                nx.setZero();
+                ny.setZero();
+                nz.setZero();
+                const int fluidCount = std::min<int>(count, numFluidNeighbors - start);
+                for (int k = 0; k < fluidCount; k++)
+                {
+                    const uint32_t q  = fluidNeighborList[start + k];
+                    const Vec3d    dv = halfStepVelocities[q] - pvel;
+                    fluid[k] = 1.0f;
+                    dvx[k]   = static_cast<float>(dv[0]);
+                    dvy[k]   = static_cast<float>(dv[1]);
+                    dvz[k]   = static_cast<float>(dv[2]);
+                    if (SurfaceTension && q != p)
+                    {
+                        const Vec3d dn = ni - surfaceNormals[q];
+                        nx[k] = static_cast<float>(dn[0]);
+                        ny[k] = static_cast<float>(dn[1]);
+                        nz[k] = static_cast<float>(dn[2]);
+                    }
+                }
+
+                const KernelBlock w = m_batchKernels.W(r2) * fluid;
+                neighborVelContributionsNumerator   += Vec3f((dvx * w).sum(), (dvy * w).sum(), (dvz * w).sum());
+                neighborVelContributionsDenominator += w.sum();
+                const KernelBlock fluidGradW = gradW * fluid;
+                particleShifts += Vec3f((fluidGradW * x).sum(), (fluidGradW * y).sum(), (fluidGradW * z).sum());
+
+                if (Viscosity)
+                {
+                    const KernelBlock l = m_batchKernels.laplace(r2, r) / density;
+                    diffuseFluid += Vec3f((l * dvx).sum(), (l * dvy).sum(), (l * dvz).sum());
+                }
+                if (SurfaceTension)
+                {
+                    // Correction factor, zero for the particle itself and the masked lanes
+                    KernelBlock K_ij = 2.0f * restDensity / (pdensity + density) * fluid;
+                    for (int k = 0; k < fluidCount; k++)
+                    {
+                        if (fluidNeighborList[start + k] == p)
+                        {
+                            K_ij[k] = 0.0f;
+                        }
+                    }
+
+                    // Cohesion and curvature acc
+                    const KernelBlock c = (r2 > 1.0e-20f).select(K_ij * particleMass * m_batchKernels.cohesionW(r2, r) / r, KernelBlock::Zero());
+                    surfaceTensionAccel -= Vec3f((c * x + K_ij * nx).sum(), (c * y + K_ij * ny).sum(), (c * z + K_ij * nz).sum());
+                }
+            }
+
+            Vec3d accel = Vec3d::Zero();
+            if (Pressure)
+            {
+                accel += pressureAccel.cast<double>() * m_modelParameters->m_particleMass;
+                if (hasBoundaryDensity(p))
+                {
+                    accel -= 2.0 * static_cast<double>(ppressure) * m_boundaryDensityGradients[p];
+                }
+            }
+            if (Viscosity)
+            {
+                accel += diffuseFluid.cast<double>() * (m_modelParameters->m_dynamicViscosityCoeff * m_modelParameters->m_particleMass);
+            }
+            if (SurfaceTension)
+            {
+                accel += surfaceTensionAccel.cast<double>() * m_modelParameters->m_surfaceTensionStiffness;
+            }
+            accels[p] = accel;
+
+            neighborVelContr[p] = neighborVelContributionsNumerator.cast<double>() * (m_modelParameters->m_eta / neighborVelContributionsDenominator);
+            particleShift[p]    = -particleShifts.cast<double>() * (shiftScale * pvel.norm());
+      });
+}
+
 void
 SPHModel::updateVelocity(const double timestep)
 {
@@ -700,68 +1481,106 @@ SPHModel::updateVelocity(const double timestep)
 void
 SPHModel::moveParticles(const double timestep)
 {
-    //ParallelUtils::parallelFor(getState().getNumParticles(),
-    //  [&](const size_t p) {
+    using ParticleType = SPHBoundaryConditions::ParticleType;
 
-    VecDataArray<double, 3>& neighborVelContr = *m_neighborVelContr;
-    VecDataArray<double, 3>& particleShift    = *m_particleShift;
-    VecDataArray<double, 3>& positions = *getCurrentState()->getPositions();
-    VecDataArray<double, 3>& halfStepVelocities = *getCurrentState()->getHalfStepVelocities();
-    VecDataArray<double, 3>& fullStepVelocities = *getCurrentState()->getFullStepVelocities();
+    const VecDataArray<double, 3>& neighborVelContr   = *m_neighborVelContr;
+    const VecDataArray<double, 3>& particleShift      = *m_particleShift;
+    VecDataArray<double, 3>&       positions          = *getCurrentState()->getPositions();
+    VecDataArray<double, 3>&       halfStepVelocities = *getCurrentState()->getHalfStepVelocities();
+    VecDataArray<double, 3>&       fullStepVelocities = *getCurrentState()->getFullStepVelocities();
+    const size_t                   numParticles       = getCurrentState()->getNumParticles();
 
-    for (int p = 0; p < static_cast<int>(getCurrentState()->getNumParticles()); p++)
+    if (m_sphBoundaryConditions)
     {
-        if (m_sphBoundaryConditions
-            && (m_sphBoundaryConditions->getParticleTypes()[p] == SPHBoundaryConditions::ParticleType::Buffer
-                || m_sphBoundaryConditions->getParticleTypes()[p] == SPHBoundaryConditions::ParticleType::Wall))
-        {
-            continue;
-        }
-
-        Vec3d oldPosition = positions[p];
-        Vec3d newPosition = oldPosition + particleShift[p] * timestep + (halfStepVelocities[p] + neighborVelContr[p]) * timestep;
-
-        positions[p] = newPosition;
+        m_particleEvents.resize(numParticles);
+        m_inletPositions.resize(static_cast<int>(numParticles));
+    }
 
-        if (m_sphBoundaryConditions)
+    // Each particle only changes its own type, transitions that take or return a buffer particle
+    // are recorded and resolved afterwards
+    ParallelUtils::parallelFor(numParticles,
+        [&](const size_t p)
         {
-            std::vector<SPHBoundaryConditions::ParticleType>& particleTypes = m_sphBoundaryConditions->getParticleTypes();
-            if (particleTypes[p] == SPHBoundaryConditions::ParticleType::Inlet
-                && !m_sphBoundaryConditions->isInInletDomain(newPosition))
+            if (m_sphBoundaryConditions)
             {
-                // change particle type to fluid
-                particleTypes[p] = SPHBoundaryConditions::ParticleType::Fluid;
-                // insert particle into inlet domain from buffer domain
-                // todo: come up with a better way to find buffer indices
-                // right now, the buffer index is limiting the parallel ability of this function
-                const size_t bufferParticleIndex = m_sphBoundaryConditions->getBufferIndices().back();
-                m_sphBoundaryConditions->getBufferIndices().pop_back();
-                particleTypes[bufferParticleIndex] = SPHBoundaryConditions::ParticleType::Inlet;
-
-                positions[bufferParticleIndex] = m_sphBoundaryConditions->placeParticleAtInlet(oldPosition);
-                halfStepVelocities[bufferParticleIndex] = m_sphBoundaryConditions->computeParabolicInletVelocity(positions[bufferParticleIndex]);
-                fullStepVelocities[bufferParticleIndex] = m_sphBoundaryConditions->computeParabolicInletVelocity(positions[bufferParticleIndex]);
+                m_particleEvents[p] = ParticleEvent::None;
+            }
+            if (m_sphBoundaryConditions
+                && (m_sphBoundaryConditions->getParticleTypes()[p] == ParticleType::Buffer
+                    || m_sphBoundaryConditions->getParticleTypes()[p] == ParticleType::Wall))
+            {
+                return;
             }
-            else if (particleTypes[p] == SPHBoundaryConditions::ParticleType::Outlet
-                     && !m_sphBoundaryConditions->isInOutletDomain(newPosition))
+
+            const Vec3d oldPosition = positions[p];
+            const Vec3d newPosition = oldPosition + particleShift[p] * timestep + (halfStepVelocities[p] + neighborVelContr[p]) * timestep;
+
+            positions[p] = newPosition;
+
+            if (m_sphBoundaryConditions)
             {
-                particleTypes[p] = SPHBoundaryConditions::ParticleType::Buffer;
-                // insert particle into buffer domain after it leaves outlet domain
-                positions[p] = m_sphBoundaryConditions->getBufferCoord();
-                m_sphBoundaryConditions->getBufferIndices().push_back(p);
+                ParticleType& type = m_sphBoundaryConditions->getParticleTypes()[p];
+                if (type == ParticleType::Inlet && !m_sphBoundaryConditions->isInInletDomain(newPosition))
+                {
+                    // change particle type to fluid, a buffer particle is inserted into the inlet domain in its place
+                    type                = ParticleType::Fluid;
+                    m_inletPositions[p] = m_sphBoundaryConditions->placeParticleAtInlet(oldPosition);
+                    m_particleEvents[p] = ParticleEvent::LeftInlet;
+                }
+                else if (type == ParticleType::Outlet && !m_sphBoundaryConditions->isInOutletDomain(newPosition))
+                {
+                    // insert particle into buffer domain after it leaves outlet domain
+                    type                = ParticleType::Buffer;
+                    positions[p]        = m_sphBoundaryConditions->getBufferCoord();
+                    m_particleEvents[p] = ParticleEvent::Recycled;
+                }
+                else if (type == ParticleType::Fluid && m_sphBoundaryConditions->isInOutletDomain(newPosition))
+                {
+                    type = ParticleType::Outlet;
+                }
+                else if (type == ParticleType::Fluid && !m_sphBoundaryConditions->isInFluidDomain(newPosition))
+                {
+                    type                = ParticleType::Buffer;
+                    positions[p]        = m_sphBoundaryConditions->getBufferCoord();
+                    m_particleEvents[p] = ParticleEvent::Recycled;
+                }
             }
-            else if (particleTypes[p] == SPHBoundaryConditions::ParticleType::Fluid
-                     && m_sphBoundaryConditions->isInOutletDomain(newPosition))
+        });
+
+    if (m_sphBoundaryConditions)
+    {
+        // Resolve the recorded transitions in particle order, only the few particles
+        // crossing a domain boundary this step are visited
+        ParallelUtils::findIndices(numParticles,
+            [&](const size_t p) { return m_particleEvents[p] != ParticleEvent::None; },
+            m_eventParticles);
+
+        std::vector<ParticleType>& particleTypes = m_sphBoundaryConditions->getParticleTypes();
+        std::vector<size_t>&       bufferIndices = m_sphBoundaryConditions->getBufferIndices();
+        for (const size_t p : m_eventParticles)
+        {
+            if (m_particleEvents[p] == ParticleEvent::Recycled)
             {
-                particleTypes[p] = SPHBoundaryConditions::ParticleType::Outlet;
+                bufferIndices.push_back(p);
+                continue;
             }
-            else if (particleTypes[p] == SPHBoundaryConditions::ParticleType::Fluid
-                     && !m_sphBoundaryConditions->isInFluidDomain(newPosition))
+
+            LOG_IF(WARNING, bufferIndices.empty()) << "SPH buffer is empty, no particle is inserted at the inlet";
+            if (bufferIndices.empty())
             {
-                particleTypes[p] = SPHBoundaryConditions::ParticleType::Buffer;
-                positions[p]     = m_sphBoundaryConditions->getBufferCoord();
-                m_sphBoundaryConditions->getBufferIndices().push_back(p);
+                continue;
             }
+            const size_t bufferParticleIndex = bufferIndices.back();
+            bufferIndices.pop_back();
+            particleTypes[bufferParticleIndex] = ParticleType::Inlet;
+
+            const Vec3d inletVelocity = m_sphBoundaryConditions->computeParabolicInletVelocity(m_inletPositions[p]);
+            halfStepVelocities[bufferParticleIndex] = inletVelocity;
+            fullStepVelocities[bufferParticleIndex] = inletVelocity;
+
+            // The new inlet particle moves within this step too, the shift and neighbor contributions
+            // of a buffer particle are stale so it only follows the inlet velocity
+            positions[bufferParticleIndex] = m_inletPositions[p] + inletVelocity * timestep;
         }
     }
     m_timeStepCount++;
@@ -26,10 +26,12 @@
 #include "imstkSPHKernels.h"
 #include "imstkNeighborSearch.h"
 #include "imstkSPHBoundaryConditions.h"
+#include "imstkSPHBoundaryDensityMap.h"
 
 namespace imstk
 {
 class PointSet;
+class SignedDistanceField;
 
 ///
 /// \class SPHModelConfig
@@ -64,9 +66,25 @@ public:
     bool m_bNormalizeDensity    = false;
     bool m_bDensityWithBoundary = false;
 
+    // boundary given by a signed distance field, see SPHModel::setBoundarySDF
+    double m_boundaryMapSpacing = 0.0; ///> Grid spacing of the boundary density map (0 uses the particle radius)
+
     // pressure
     double m_pressureStiffness = 50000.0;
 
+    ///
+    /// \brief Method used to compute the particle pressures
+    ///
+    enum class PressureSolverType
+    {
+        EquationOfState, ///> Weakly compressible, the pressure follows from the density and m_pressureStiffness
+        PCISPH           ///> Predictive-corrective incompressible SPH, the pressure is iterated until the density error is small
+    };
+    PressureSolverType m_pressureSolver = PressureSolverType::EquationOfState;
+    double m_maxDensityError       = 0.01; ///> PCISPH stops once the density errors are below this fraction of the rest density
+    int    m_minPressureIterations = 3;    ///> Minimum number of PCISPH iterations
+    int    m_maxPressureIterations = 50;   ///> Maximum number of PCISPH iterations
+
     // viscosity and surface tension/cohesion
     double m_dynamicViscosityCoeff   = 1.0e-2;
     double m_viscosityBoundary       = 1.0e-5;
@@ -86,6 +104,18 @@ public:
 
     // neighbor search
     NeighborSearch::Method m_NeighborSearchMethod = NeighborSearch::Method::UniformGridBasedSearch;
+    double m_neighborListSkin = 0.0; ///> Verlet skin added to the search radius, neighbor lists are reused until
+                                     ///> a particle moves more than half of it (0 searches every step)
+
+    // force evaluation
+    bool m_bFusedForces = false; ///> Accumulate pressure, viscosity and surface tension accelerations in a single
+                                 ///> traversal of the neighbors instead of one pass per term
+    bool m_bSinglePrecisionKernels = false; ///> Evaluate the kernels of the density and fused force passes in single
+                                            ///> precision for blocks of neighbors at once
+
+    // memory layout
+    int m_reorderInterval = 0; ///> Reorder the particles along a Morton curve every this many time steps
+                               ///> so spatial neighbors are close in memory (0 never reorders)
 };
 
 ///
@@ -160,6 +190,14 @@ public:
     void setBoundaryConditions(std::shared_ptr<SPHBoundaryConditions> sphBoundaryConditions) { m_sphBoundaryConditions = sphBoundaryConditions; }
     std::shared_ptr<SPHBoundaryConditions> getBoundaryConditions() { return m_sphBoundaryConditions; }
 
+    ///
+    /// \brief Set the signed distance field of a solid boundary, negative inside the solid. The solid then contributes
+    /// to the particle densities and pressures through a density map precomputed in initialize, which replaces
+    /// the boundary particles and their neighbor search. Must be set before initialization
+    ///
+    void setBoundarySDF(std::shared_ptr<SignedDistanceField> sdf) { m_boundarySDF = sdf; }
+    std::shared_ptr<SignedDistanceField> getBoundarySDF() const { return m_boundarySDF; }
+
     void setRestDensity(const double restDensity) { m_modelParameters->m_restDensity = restDensity; }
 
     std::shared_ptr<TaskNode> getFindParticleNeighborsNode() const { return m_findParticleNeighborsNode; }
@@ -195,6 +233,32 @@ private:
     ///
     void findParticleNeighbors();
 
+    ///
+    /// \brief Returns true if any particle moved more than half the Verlet skin since the last neighbor search
+    ///
+    bool needsNeighborSearch() const;
+
+    ///
+    /// \brief Reorder the particles and all per particle data along a Morton curve, the geometry
+    /// vertices are reordered alike
+    ///
+    void reorderParticles();
+
+    ///
+    /// \brief Returns true if the boundary is given by boundary particles that are neighbors of the fluid particles
+    ///
+    bool useBoundaryParticles() const { return m_modelParameters->m_bDensityWithBoundary && m_boundarySDF == nullptr; }
+
+    ///
+    /// \brief Sample the boundary density map at the particle positions
+    ///
+    void sampleBoundaryDensities();
+
+    ///
+    /// \brief Returns true if the boundary density map contributes to the particle
+    ///
+    bool hasBoundaryDensity(const size_t p) const { return !m_boundaryDensities.empty() && m_boundaryDensities[p] > 0.0; }
+
     ///
     /// \brief Pre-compute relative positions with neighbor particles
     ///
@@ -221,11 +285,37 @@ private:
     ///
     void computePressureAcceleration();
 
+    ///
+    /// \brief Compute particle acceleration due to pressure with PCISPH, predicting the densities after the
+    /// time step and correcting the pressures until the density error is within SPHModelConfig::m_maxDensityError.
+    /// The other accelerations must have been computed
+    ///
+    void solvePressure();
+
     ///
     /// \brief Sum the forces computed in parallel
     ///
     void sumAccels();
 
+    ///
+    /// \brief Compute the pressure, viscous and surface tension accelerations in a single traversal
+    /// of the neighbors and sum them into the particle accelerations, replaces the separate passes
+    /// when SPHModelConfig::m_bFusedForces is set
+    ///
+    void computeForces();
+
+    ///
+    /// \brief Fused force kernel, disabled terms are compiled out
+    ///
+    template<bool Pressure, bool Viscosity, bool SurfaceTension>
+    void computeForcesFused();
+
+    ///
+    /// \brief Fused force kernel evaluated in single precision for blocks of neighbors
+    ///
+    template<bool Pressure, bool Viscosity, bool SurfaceTension>
+    void computeForcesBatched();
+
     ///
     /// \brief Update particle velocities due to pressure, viscous, and surface tension forces
     ///
@@ -263,6 +353,8 @@ protected:
     std::shared_ptr<TaskNode> m_moveParticlesNode          = nullptr;
     std::shared_ptr<TaskNode> m_normalizeDensityNode       = nullptr;
     std::shared_ptr<TaskNode> m_collectNeighborDensityNode = nullptr;
+    std::shared_ptr<TaskNode> m_computeForcesNode          = nullptr;
+    std::shared_ptr<TaskNode> m_solvePressureNode          = nullptr;
 
 private:
     std::shared_ptr<PointSet> m_pointSetGeometry;
@@ -271,15 +363,26 @@ private:
     double m_defaultDt;                                 ///> default time step size
 
     SPHSimulationKernels m_kernels;                     ///> SPH kernels (must be initialized during model initialization)
+    SPHBatchKernels<float> m_batchKernels;              ///> Single precision SPH kernels for blocks of neighbors
     std::shared_ptr<SPHModelConfig> m_modelParameters;  ///> SPH Model parameters (must be set before simulation)
     std::shared_ptr<NeighborSearch> m_neighborSearcher; ///> Neighbor Search (must be initialized during model initialization)
 
+    CSRNeighborList         m_verletNeighborLists;      ///> Fluid neighbors within kernel radius + skin
+    CSRNeighborList         m_verletBDNeighborLists;    ///> Boundary neighbors within kernel radius + skin
+    VecDataArray<double, 3> m_verletPositions;          ///> Particle positions at the last neighbor search
+    VecDataArray<double, 3> m_verletBDPositions;        ///> Boundary particle positions at the last neighbor search
+
     std::shared_ptr<VecDataArray<double, 3>> m_pressureAccels       = nullptr;
     std::shared_ptr<VecDataArray<double, 3>> m_surfaceTensionAccels = nullptr;
     std::shared_ptr<VecDataArray<double, 3>> m_viscousAccels    = nullptr;
     std::shared_ptr<VecDataArray<double, 3>> m_neighborVelContr = nullptr;
     std::shared_ptr<VecDataArray<double, 3>> m_particleShift    = nullptr;
 
+    std::vector<double>     m_pressures;              ///> PCISPH particle pressures
+    std::vector<double>     m_densityErrors;          ///> PCISPH predicted density errors
+    VecDataArray<double, 3> m_predictedDisplacements; ///> PCISPH predicted displacements over the time step
+    double m_pressureScale = 0.0;                     ///> PCISPH pressure per density error, times the squared time step
+
     std::shared_ptr<VecDataArray<double, 3>> m_initialVelocities = nullptr;
     std::shared_ptr<DataArray<double>>       m_initialDensities  = nullptr;
 
@@ -287,6 +390,25 @@ private:
 
     std::shared_ptr<SPHBoundaryConditions> m_sphBoundaryConditions = nullptr;
 
+    std::shared_ptr<SignedDistanceField> m_boundarySDF = nullptr;
+    SPHBoundaryDensityMap   m_boundaryDensityMap;       ///> Density of the SDF boundary, precomputed on a grid
+    std::vector<double>     m_boundaryDensities;        ///> Boundary density at each particle, empty without SDF boundary
+    VecDataArray<double, 3> m_boundaryDensityGradients; ///> Boundary density gradient at each particle
+
     std::vector<size_t> m_minIndices;
+
+    ///
+    /// \brief Transitions of a particle that take or return a buffer particle
+    ///
+    enum class ParticleEvent : unsigned char
+    {
+        None,
+        LeftInlet, ///> Left the inlet domain, a buffer particle replaces it at the inlet
+        Recycled   ///> Left the fluid or outlet domain and was returned to the buffer
+    };
+
+    std::vector<ParticleEvent> m_particleEvents; ///> Transitions recorded by the parallel particle move
+    std::vector<size_t>        m_eventParticles; ///> Particles with a transition this step, in increasing order
+    VecDataArray<double, 3>    m_inletPositions; ///> Insertion positions for particles that left the inlet
 };
 } // end namespace imstk
@@ -43,8 +43,7 @@ SPHState::SPHState(const int numElements) :
     std::fill_n(m_halfStepVelocities->getPointer(), m_halfStepVelocities->size(), Vec3d(0.0, 0.0, 0.0));
     std::fill_n(m_fullStepVelocities->getPointer(), m_fullStepVelocities->size(), Vec3d(0.0, 0.0, 0.0));
 
-    m_NeighborInfo.resize(static_cast<size_t>(numElements));
-    m_NeighborLists.resize(static_cast<size_t>(numElements));
+    m_NeighborInfoOffsets.resize(static_cast<size_t>(numElements) + 1, 0);
 }
 
 void
@@ -60,9 +59,10 @@ SPHState::setState(std::shared_ptr<SPHState> rhs)
     *m_Accels            = *rhs->getAccelerations();
     *m_DiffuseVelocities = *rhs->getDiffuseVelocities();
 
-    m_NeighborLists   = rhs->getFluidNeighborLists();
-    m_BDNeighborLists = rhs->getBoundaryNeighborLists();
-    m_NeighborInfo    = rhs->getNeighborInfo();
+    m_NeighborLists       = rhs->getFluidNeighborLists();
+    m_BDNeighborLists     = rhs->getBoundaryNeighborLists();
+    m_NeighborInfo        = rhs->getNeighborInfo();
+    m_NeighborInfoOffsets = rhs->getNeighborInfoOffsets();
 
     m_positions->postModified();
 }
@@ -21,6 +21,7 @@
 
 #pragma once
 
+#include "imstkCSRNeighborList.h"
 #include "imstkMath.h"
 
 namespace imstk
@@ -110,22 +111,30 @@ public:
     std::shared_ptr<VecDataArray<double, 3>> getDiffuseVelocities() const { return m_DiffuseVelocities; }
 
     ///
-    /// \brief Returns the vector of neighbor fluid particles
+    /// \brief Returns the neighbor fluid particles of each particle
     ///
-    std::vector<std::vector<size_t>>& getFluidNeighborLists() { return m_NeighborLists; }
-    const std::vector<std::vector<size_t>>& getFluidNeighborLists() const { return m_NeighborLists; }
+    CSRNeighborList& getFluidNeighborLists() { return m_NeighborLists; }
+    const CSRNeighborList& getFluidNeighborLists() const { return m_NeighborLists; }
 
     ///
-    /// \brief Returns the vector of neighbor of boundary particles
+    /// \brief Returns the neighbor boundary particles of each particle
     ///
-    std::vector<std::vector<size_t>>& getBoundaryNeighborLists() { return m_BDNeighborLists; }
-    const std::vector<std::vector<size_t>>& getBoundaryNeighborLists() const { return m_BDNeighborLists; }
+    CSRNeighborList& getBoundaryNeighborLists() { return m_BDNeighborLists; }
+    const CSRNeighborList& getBoundaryNeighborLists() const { return m_BDNeighborLists; }
 
     ///
-    /// \brief Returns the vector of neighbor information ( {relative position, density} ), which is cached for other computation
+    /// \brief Returns the flat array of neighbor information ( {relative position, density} ), which is cached for other computation
+    /// The information of particle p is stored in [getNeighborInfoOffsets()[p], getNeighborInfoOffsets()[p + 1]),
+    /// fluid neighbors first followed by boundary neighbors
     ///
-    std::vector<std::vector<NeighborInfo>>& getNeighborInfo() { return m_NeighborInfo; }
-    const std::vector<std::vector<NeighborInfo>>& getNeighborInfo() const { return m_NeighborInfo; }
+    std::vector<NeighborInfo>& getNeighborInfo() { return m_NeighborInfo; }
+    const std::vector<NeighborInfo>& getNeighborInfo() const { return m_NeighborInfo; }
+
+    ///
+    /// \brief Returns the offsets of each particle's neighbor information (size numParticles + 1)
+    ///
+    std::vector<uint32_t>& getNeighborInfoOffsets() { return m_NeighborInfoOffsets; }
+    const std::vector<uint32_t>& getNeighborInfoOffsets() const { return m_NeighborInfoOffsets; }
 
     ///
     /// \brief Set the state to a given one
@@ -145,8 +154,9 @@ private:
     std::shared_ptr<VecDataArray<double, 3>> m_Accels;            ///>  acceleration
     std::shared_ptr<VecDataArray<double, 3>> m_DiffuseVelocities; ///>  velocity diffusion, used for computing viscosity
 
-    std::vector<std::vector<size_t>>       m_NeighborLists;       ///>  store a list of neighbors for each particle, updated each time step
-    std::vector<std::vector<size_t>>       m_BDNeighborLists;     ///>  store a list of boundary particle neighbors for each particle, updated each time step
-    std::vector<std::vector<NeighborInfo>> m_NeighborInfo;        ///>  store a list of Vec4d(Vec3d(relative position), density) for neighbors, including boundary particle
+    CSRNeighborList           m_NeighborLists;       ///>  store a list of neighbors for each particle, updated each time step
+    CSRNeighborList           m_BDNeighborLists;     ///>  store a list of boundary particle neighbors for each particle, updated each time step
+    std::vector<NeighborInfo> m_NeighborInfo;        ///>  store {relative position, density} of neighbors, including boundary particles
+    std::vector<uint32_t>     m_NeighborInfoOffsets; ///>  offsets of each particle's neighbor info in m_NeighborInfo
 };
 } // end namespace imstk
@@ -0,0 +1,111 @@
+/*=========================================================================
+
+   Library: iMSTK
+
+   Copyright (c) Kitware, Inc. & Center for Modeling, Simulation,
+   & Imaging in Medicine, Rensselaer Polytechnic Institute.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+=========================================================================*/
+
+#include "gtest/gtest.h"
+
+#include "imstkBackwardEuler.h"
+#include "imstkFEMDeformableBodyModel.h"
+#include "imstkGeometryUtilities.h"
+#include "imstkLinearSolver.h"
+#include "imstkNewtonSolver.h"
+#include "imstkTetrahedralMesh.h"
+#include "imstkVecDataArray.h"
+#include "imstkVectorizedState.h"
+
+using namespace imstk;
+
+namespace
+{
+///
+/// \brief Bar of 1x1x3 cells, by default fixed at its z = 0 end
+///
+std::shared_ptr<FEMDeformableBodyModel>
+makeBarModel(const bool eliminateFixedDOFs, const std::vector<std::size_t>& fixedNodeIds = { 0, 1, 2, 3 })
+{
+    auto mesh = GeometryUtils::createUniformMesh(Vec3d::Zero(), Vec3d(0.5, 0.5, 1.5), 1, 1, 3);
+
+    auto config = std::make_shared<FEMModelConfig>();
+    config->m_femMethod          = FEMMethodType::Corotational;
+    config->m_parallelAssembly   = true;
+    config->m_youngModulus       = 1.0e4;
+    config->m_fixedNodeIds       = fixedNodeIds;
+    config->m_eliminateFixedDOFs = eliminateFixedDOFs;
+
+    auto model = std::make_shared<FEMDeformableBodyModel>();
+    model->setModelGeometry(mesh);
+    model->configure(config);
+    model->setTimeIntegrator(std::make_shared<BackwardEuler>(0.01));
+    model->initialize();
+
+    auto solver = std::dynamic_pointer_cast<NewtonSolver<SparseMatrixd>>(model->getSolver());
+    solver->getLinearSolver()->setTolerance(1.0e-12);
+    return model;
+}
+}
+
+///
+/// \brief Solving for the free DOFs only must give the solution of the system with the rows and
+/// columns of the fixed DOFs nullified, and leave the fixed DOFs in place
+///
+TEST(imstkFEMDeformableBodyModelTest, TestEliminateFixedDOFs)
+{
+    auto nullified  = makeBarModel(false);
+    auto eliminated = makeBarModel(true);
+
+    for (int step = 0; step < 5; ++step)
+    {
+        nullified->getSolver()->solve();
+        eliminated->getSolver()->solve();
+
+        const Vectord& u        = nullified->getCurrentState()->getQ();
+        const Vectord& uReduced = eliminated->getCurrentState()->getQ();
+        ASSERT_EQ(u.size(), uReduced.size());
+        EXPECT_GT(u.norm(), 0.0);
+        EXPECT_NEAR((u - uReduced).norm() / u.norm(), 0.0, 1.0e-6);
+
+        const Vectord& v = eliminated->getCurrentState()->getQDot();
+        EXPECT_EQ(uReduced.head<12>().norm(), 0.0);
+        EXPECT_EQ(v.head<12>().norm(), 0.0);
+    }
+}
+
+///
+/// \brief Fixing nodes through getFixNodeIds after initialization numbers the free DOFs again
+///
+TEST(imstkFEMDeformableBodyModelTest, TestChangeFixedNodes)
+{
+    const std::vector<std::size_t> fixedNodeIds = { 0, 1, 2, 3, 4, 5, 6, 7 };
+    auto                           configured   = makeBarModel(true, fixedNodeIds);
+    auto                           edited       = makeBarModel(true);
+    edited->getFixNodeIds() = fixedNodeIds;
+
+    for (int step = 0; step < 3; ++step)
+    {
+        configured->getSolver()->solve();
+        edited->getSolver()->solve();
+
+        const Vectord& u       = configured->getCurrentState()->getQ();
+        const Vectord& uEdited = edited->getCurrentState()->getQ();
+        EXPECT_GT(u.norm(), 0.0);
+        EXPECT_NEAR((u - uEdited).norm() / u.norm(), 0.0, 1.0e-10);
+        EXPECT_EQ(uEdited.head<24>().norm(), 0.0);
+    }
+}
@@ -0,0 +1,177 @@
+/*=========================================================================
+
+   Library: iMSTK
+
+   Copyright (c) Kitware, Inc. & Center for Modeling, Simulation,
+   & Imaging in Medicine, Rensselaer Polytechnic Institute.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+=========================================================================*/
+
+#include "gtest/gtest.h"
+
+#include "imstkGeometryUtilities.h"
+#include "imstkProjectiveDynamicsModel.h"
+#include "imstkSurfaceMesh.h"
+#include "imstkTetrahedralMesh.h"
+#include "imstkVecDataArray.h"
+
+using namespace imstk;
+
+namespace
+{
+///
+/// \brief Square of 3x3 vertices in the xz plane
+///
+std::shared_ptr<SurfaceMesh>
+makeSquareMesh()
+{
+    const int n        = 3;
+    auto      vertices = std::make_shared<VecDataArray<double, 3>>();
+    for (int z = 0; z < n; ++z)
+    {
+        for (int x = 0; x < n; ++x)
+        {
+            vertices->push_back(Vec3d(x, 0.0, z) * 0.5);
+        }
+    }
+    auto triangles = std::make_shared<VecDataArray<int, 3>>();
+    for (int z = 0; z < n - 1; ++z)
+    {
+        for (int x = 0; x < n - 1; ++x)
+        {
+            const int i = x + n * z;
+            triangles->push_back(Vec3i(i, i + n, i + 1));
+            triangles->push_back(Vec3i(i + 1, i + n, i + n + 1));
+        }
+    }
+    auto mesh = std::make_shared<SurfaceMesh>();
+    mesh->initialize(vertices, triangles);
+    return mesh;
+}
+
+void
+step(ProjectiveDynamicsModel& model, const int numSteps)
+{
+    for (int i = 0; i < numSteps; ++i)
+    {
+        model.integratePosition();
+        model.solve();
+        model.updateVelocity();
+    }
+}
+}
+
+///
+/// \brief An undeformed body without external forces stays at rest
+///
+TEST(imstkProjectiveDynamicsModelTest, TestRestState)
+{
+    auto mesh   = GeometryUtils::createUniformMesh(Vec3d::Zero(), Vec3d(1.0, 1.0, 1.0), 2, 2, 2);
+    auto config = std::make_shared<ProjectiveDynamicsModelConfig>();
+    config->m_gravity = Vec3d::Zero();
+
+    ProjectiveDynamicsModel model;
+    model.configure(config);
+    model.setModelGeometry(mesh);
+    ASSERT_TRUE(model.initialize());
+    EXPECT_EQ(model.getNumStrainConstraints(), 48);
+
+    step(model, 10);
+
+    const VecDataArray<double, 3>& initial = *mesh->getInitialVertexPositions();
+    const VecDataArray<double, 3>& current = *mesh->getVertexPositions();
+    for (int i = 0; i < current.size(); ++i)
+    {
+        EXPECT_NEAR((current[i] - initial[i]).norm(), 0.0, 1.0e-10);
+    }
+}
+
+///
+/// \brief A cube hanging from its top face sags under gravity and comes to rest
+///
+TEST(imstkProjectiveDynamicsModelTest, TestHangingCube)
+{
+    auto mesh   = GeometryUtils::createUniformMesh(Vec3d::Zero(), Vec3d(1.0, 1.0, 1.0), 2, 2, 2);
+    auto config = std::make_shared<ProjectiveDynamicsModelConfig>();
+    config->m_viscousDampingCoeff = 0.05;
+    config->m_strainStiffness     = 1.0e4;
+    const VecDataArray<double, 3>& initial = *mesh->getInitialVertexPositions();
+    for (int i = 0; i < initial.size(); ++i)
+    {
+        if (initial[i][1] == 1.0)
+        {
+            config->m_fixedNodeIds.push_back(i);
+        }
+    }
+
+    ProjectiveDynamicsModel model;
+    model.configure(config);
+    model.setModelGeometry(mesh);
+    ASSERT_TRUE(model.initialize());
+
+    step(model, 300);
+
+    const VecDataArray<double, 3>& current    = *mesh->getVertexPositions();
+    const VecDataArray<double, 3>& velocities = *model.getCurrentState()->getVelocities();
+    for (const auto& i : config->m_fixedNodeIds)
+    {
+        EXPECT_EQ(current[i], initial[i]);
+    }
+    for (int i = 0; i < current.size(); ++i)
+    {
+        if (initial[i][1] == 0.0)
+        {
+            EXPECT_LT(current[i][1], -1.0e-4);
+            EXPECT_GT(current[i][1], -0.5);
+        }
+        EXPECT_LT(velocities[i].norm(), 1.0e-3);
+    }
+}
+
+///
+/// \brief A stretched surface recovers its edge lengths
+///
+TEST(imstkProjectiveDynamicsModelTest, TestSurfaceRestLengths)
+{
+    auto mesh   = makeSquareMesh();
+    auto config = std::make_shared<ProjectiveDynamicsModelConfig>();
+    config->m_gravity = Vec3d::Zero();
+    config->m_viscousDampingCoeff = 0.1;
+
+    ProjectiveDynamicsModel model;
+    model.configure(config);
+    model.setModelGeometry(mesh);
+    ASSERT_TRUE(model.initialize());
+    EXPECT_EQ(model.getNumDistanceConstraints(), 16);
+    EXPECT_EQ(model.getNumBendConstraints(), 9);
+
+    VecDataArray<double, 3>& positions = *mesh->getVertexPositions();
+    for (int i = 0; i < positions.size(); ++i)
+    {
+        positions[i][0] *= 1.5;
+    }
+
+    step(model, 200);
+
+    const VecDataArray<double, 3>& initial = *mesh->getInitialVertexPositions();
+    for (int i = 0; i < positions.size(); ++i)
+    {
+        for (int j = i + 1; j < positions.size(); ++j)
+        {
+            const double restLength = (initial[j] - initial[i]).norm();
+            EXPECT_NEAR((positions[j] - positions[i]).norm(), restLength, 0.02 * restLength);
+        }
+    }
+}
@@ -0,0 +1,198 @@
+/*=========================================================================
+
+   Library: iMSTK
+
+   Copyright (c) Kitware, Inc. & Center for Modeling, Simulation,
+   & Imaging in Medicine, Rensselaer Polytechnic Institute.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+=========================================================================*/
+
+#include "gtest/gtest.h"
+
+#include "imstkProjectedGaussSeidelSolver.h"
+#include "imstkRbdContactConstraint.h"
+#include "imstkRigidBodyModel2.h"
+
+using namespace imstk;
+
+namespace
+{
+///
+/// \brief Column of unit boxes resting on a static ground, one contact per pair of touching bodies
+///
+void
+stepStack(RigidBodyModel2& model, const std::vector<std::shared_ptr<RigidBody>>& bodies)
+{
+    model.computeTentativeVelocities();
+    for (size_t i = 1; i < bodies.size(); i++)
+    {
+        const Vec3d contactPt = 0.5 * (bodies[i]->getPosition() + bodies[i - 1]->getPosition());
+        const double depth    = 1.0 - (bodies[i]->getPosition() - bodies[i - 1]->getPosition())[1];
+        auto constraint       = std::make_shared<RbdContactConstraint>(bodies[i], bodies[i - 1], Vec3d(0.0, 1.0, 0.0), contactPt, depth);
+        constraint->compute(model.getTimeStep());
+        model.addConstraint(constraint);
+    }
+    model.solveConstraints();
+    model.integrate();
+}
+}
+
+///
+/// \brief Test that a stack of boxes comes to rest on the ground
+///
+TEST(imstkRigidBodyModel2Test, TestStack)
+{
+    const int       numBoxes = 5;
+    RigidBodyModel2 model;
+    model.getConfig()->m_dt = 0.01;
+    model.getConfig()->m_maxNumIterations = 500;
+    model.getConfig()->m_relaxation       = 1.0;
+    model.getConfig()->m_epsilon = 1.0e-12;
+
+    std::vector<std::shared_ptr<RigidBody>> bodies;
+    for (int i = 0; i <= numBoxes; i++)
+    {
+        std::shared_ptr<RigidBody> body = model.addRigidBody();
+        body->m_isStatic = (i == 0);
+        body->m_initPos  = Vec3d(0.0, i, 0.0);
+        bodies.push_back(body);
+    }
+    ASSERT_TRUE(model.initialize());
+
+    for (int i = 0; i < 100; i++)
+    {
+        stepStack(model, bodies);
+        EXPECT_TRUE(model.getConstraints().empty());
+    }
+
+    // The boxes neither sink into each other nor topple
+    for (int i = 1; i <= numBoxes; i++)
+    {
+        EXPECT_NEAR(bodies[i]->getPosition()[1], i, 0.05);
+        EXPECT_NEAR(bodies[i]->getVelocity().norm(), 0.0, 0.2);
+        EXPECT_NEAR(bodies[i]->getAngularVelocity().norm(), 0.0, 1.0e-8);
+    }
+}
+
+///
+/// \brief Test that the sequential impulses give the forces of PGS on the assembled J*Minv*J^T
+///
+TEST(imstkRigidBodyModel2Test, TestAssembledSystem)
+{
+    RigidBodyModel2 model;
+    model.getConfig()->m_maxNumIterations = 20;
+    model.getConfig()->m_epsilon = 0.0;
+
+    std::vector<std::shared_ptr<RigidBody>> bodies;
+    for (int i = 0; i < 4; i++)
+    {
+        std::shared_ptr<RigidBody> body = model.addRigidBody();
+        body->m_isStatic       = (i == 0);
+        body->m_mass           = 1.0 + i;
+        body->m_intertiaTensor = Vec3d(1.0, 2.0, 3.0).asDiagonal();
+        body->m_initPos        = Vec3d(0.1 * i, 0.9 * i, 0.0);
+        body->m_initVelocity   = Vec3d(0.0, -1.0, 0.0);
+        bodies.push_back(body);
+    }
+    ASSERT_TRUE(model.initialize());
+    model.computeTentativeVelocities();
+
+    // Off center contacts between consecutive bodies, and of the last body with the ground
+    std::vector<std::shared_ptr<RbdConstraint>> constraints;
+    for (size_t i = 1; i < bodies.size(); i++)
+    {
+        constraints.push_back(std::make_shared<RbdContactConstraint>(bodies[i], bodies[i - 1],
+            Vec3d(0.1, 1.0, 0.0).normalized(), bodies[i]->getPosition() - Vec3d(0.3, 0.45, 0.1), 0.1));
+    }
+    constraints.push_back(std::make_shared<RbdContactConstraint>(bodies[3], bodies[0],
+        Vec3d(0.0, 1.0, 0.0), bodies[3]->getPosition() + Vec3d(0.2, -0.5, 0.0), 0.2));
+
+    // Assemble the system
+    std::shared_ptr<RigidBodyState2> state = model.getCurrentState();
+    const Eigen::Index n = static_cast<Eigen::Index>(bodies.size()) * 6;
+    Eigen::MatrixXd    Minv = Eigen::MatrixXd::Zero(n, n);
+    Eigen::VectorXd    V    = Eigen::VectorXd::Zero(n);
+    Eigen::VectorXd    Fext = Eigen::VectorXd::Zero(n);
+    for (size_t i = 0; i < bodies.size(); i++)
+    {
+        // Static bodies have no velocity and infinite mass, they still receive the reaction forces
+        if (i > 0)
+        {
+            Minv.block<3, 3>(i * 6, i * 6)         = Mat3d::Identity() * state->getInvMasses()[i];
+            Minv.block<3, 3>(i * 6 + 3, i * 6 + 3) = state->getInvIntertiaTensors()[i];
+            V.segment<3>(i * 6)     = state->getTentatveVelocities()[i];
+            V.segment<3>(i * 6 + 3) = state->getTentativeAngularVelocities()[i];
+        }
+        Fext.segment<3>(i * 6)     = state->getForces()[i];
+        Fext.segment<3>(i * 6 + 3) = state->getTorques()[i];
+    }
+    Eigen::MatrixXd J  = Eigen::MatrixXd::Zero(constraints.size(), n);
+    Eigen::VectorXd Vu = Eigen::VectorXd::Zero(constraints.size());
+    Eigen::MatrixXd cu(constraints.size(), 2);
+    for (size_t j = 0; j < constraints.size(); j++)
+    {
+        constraints[j]->compute(model.getTimeStep());
+        model.addConstraint(constraints[j]);
+        const int objs[2] = { static_cast<int>(std::find(bodies.begin(), bodies.end(), constraints[j]->m_obj1) - bodies.begin()),
+                              static_cast<int>(std::find(bodies.begin(), bodies.end(), constraints[j]->m_obj2) - bodies.begin()) };
+        for (int k = 0; k < 2; k++)
+        {
+            J.block<1, 3>(j, objs[k] * 6)     = constraints[j]->J.col(2 * k).transpose();
+            J.block<1, 3>(j, objs[k] * 6 + 3) = constraints[j]->J.col(2 * k + 1).transpose();
+        }
+        Vu(j)    = constraints[j]->vu;
+        cu(j, 0) = constraints[j]->range[0];
+        cu(j, 1) = constraints[j]->range[1];
+    }
+    const double                dt = model.getTimeStep();
+    Eigen::SparseMatrix<double> A  = (J * Minv * J.transpose()).sparseView();
+    const Eigen::VectorXd       b  = Vu / dt - J * (V / dt + Minv * Fext);
+
+    ProjectedGaussSeidelSolver<double> solver;
+    solver.setA(&A);
+    solver.setMaxIterations(model.getConfig()->m_maxNumIterations);
+    solver.setRelaxation(model.getConfig()->m_relaxation);
+    solver.setEpsilon(model.getConfig()->m_epsilon);
+    const Eigen::VectorXd expectedF = J.transpose() * solver.solve(b, cu);
+
+    model.solveConstraints();
+    for (size_t i = 0; i < bodies.size(); i++)
+    {
+        EXPECT_TRUE((state->getForces()[i] - Fext.segment<3>(i * 6) - expectedF.segment<3>(i * 6)).isZero(1.0e-10));
+        EXPECT_TRUE((state->getTorques()[i] - Fext.segment<3>(i * 6 + 3) - expectedF.segment<3>(i * 6 + 3)).isZero(1.0e-10));
+    }
+    EXPECT_NEAR(model.getEnergy(), solver.getEnergy(), 1.0e-10);
+}
+
+///
+/// \brief Test that the constraint forces are projected on their range
+///
+TEST(imstkRigidBodyModel2Test, TestSeparatingContact)
+{
+    RigidBodyModel2 model;
+    model.getConfig()->m_relaxation = 1.0;
+
+    std::shared_ptr<RigidBody> ground = model.addRigidBody();
+    ground->m_isStatic = true;
+    std::shared_ptr<RigidBody> box = model.addRigidBody();
+    box->m_initPos      = Vec3d(0.0, 1.0, 0.0);
+    box->m_initVelocity = Vec3d(0.0, 10.0, 0.0);
+    ASSERT_TRUE(model.initialize());
+
+    // Moving away from the ground, the contact can't pull it back
+    std::vector<std::shared_ptr<RigidBody>> bodies = { ground, box };
+    stepStack(model, bodies);
+    EXPECT_NEAR(box->getVelocity()[1], 10.0 + model.getConfig()->m_gravity[1] * model.getTimeStep(), 1.0e-12);
+}
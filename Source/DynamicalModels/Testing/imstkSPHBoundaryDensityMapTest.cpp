@@ -0,0 +1,84 @@
+/*=========================================================================
+
+   Library: iMSTK
+
+   Copyright (c) Kitware, Inc. & Center for Modeling, Simulation,
+   & Imaging in Medicine, Rensselaer Polytechnic Institute.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+=========================================================================*/
+
+#include "gtest/gtest.h"
+
+#include "imstkDataArray.h"
+#include "imstkImageData.h"
+#include "imstkSignedDistanceField.h"
+#include "imstkSPHBoundaryDensityMap.h"
+#include "imstkSPHKernels.h"
+
+using namespace imstk;
+
+///
+/// \brief Test the density map of a half space, the solid is below y = 0
+///
+TEST(imstkSPHBoundaryDensityMapTest, TestHalfSpace)
+{
+    const Vec3i  dims(20, 20, 20);
+    const double spacing = 0.05;
+    const Vec3d  origin(-0.5, -0.5, -0.5);
+    auto         image = std::make_shared<ImageData>();
+    image->allocate(IMSTK_DOUBLE, 1, dims, Vec3d(spacing, spacing, spacing), origin);
+    DataArray<double>& scalars = *std::dynamic_pointer_cast<DataArray<double>>(image->getScalars());
+    for (int z = 0; z < dims[2]; z++)
+    {
+        for (int y = 0; y < dims[1]; y++)
+        {
+            for (int x = 0; x < dims[0]; x++)
+            {
+                scalars[x + dims[0] * (y + dims[1] * z)] = origin[1] + y * spacing;
+            }
+        }
+    }
+    auto sdf = std::make_shared<SignedDistanceField>(image);
+
+    const double         kernelRadius = 0.1;
+    const double         restDensity  = 1000.0;
+    SPHSimulationKernels kernels;
+    kernels.initialize(kernelRadius);
+    SPHBoundaryDensityMap densityMap;
+    densityMap.compute(sdf, kernels, kernelRadius, restDensity, 0.025);
+
+    // Locate the surface through the field, it is linear along y
+    const Vec3d  center(0.0, 0.0, 0.0);
+    const Vec3d  surface = center - Vec3d(0.0, sdf->getFunctionValue(center), 0.0);
+    double       density;
+    Vec3d        gradient;
+
+    // Half of the kernel support is in the solid at the surface, the density increases towards the solid
+    EXPECT_TRUE(densityMap.sample(surface, density, gradient));
+    EXPECT_NEAR(density, 0.5 * restDensity, 0.02 * restDensity);
+    EXPECT_LT(gradient[1], 0.0);
+    EXPECT_NEAR(gradient[0], 0.0, 1.0e-6 * std::abs(gradient[1]));
+    EXPECT_NEAR(gradient[2], 0.0, 1.0e-6 * std::abs(gradient[1]));
+
+    // The whole support is in the solid
+    EXPECT_TRUE(densityMap.sample(surface - Vec3d(0.0, 1.5 * kernelRadius, 0.0), density, gradient));
+    EXPECT_NEAR(density, restDensity, 0.02 * restDensity);
+    EXPECT_NEAR(gradient.norm(), 0.0, 1.0e-6);
+
+    // Out of reach of the solid and out of the map
+    EXPECT_FALSE(densityMap.sample(surface + Vec3d(0.0, 1.5 * kernelRadius, 0.0), density, gradient));
+    EXPECT_DOUBLE_EQ(density, 0.0);
+    EXPECT_FALSE(densityMap.sample(Vec3d(2.0, 0.0, 0.0), density, gradient));
+}
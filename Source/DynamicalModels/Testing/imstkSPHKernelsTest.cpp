@@ -0,0 +1,70 @@
+/*=========================================================================
+
+   Library: iMSTK
+
+   Copyright (c) Kitware, Inc. & Center for Modeling, Simulation,
+   & Imaging in Medicine, Rensselaer Polytechnic Institute.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+=========================================================================*/
+
+#include "gtest/gtest.h"
+
+#include "imstkSPHKernels.h"
+
+using namespace imstk;
+
+///
+/// \brief Test that the single precision block kernels agree with the double precision kernels
+///
+TEST(imstkSPHKernelsTest, TestBatchKernels)
+{
+    const double         kernelRadius = 0.4;
+    SPHSimulationKernels kernels;
+    kernels.initialize(kernelRadius);
+    SPHBatchKernels<float> batchKernels;
+    batchKernels.initialize(kernelRadius);
+
+    // Distances covering both branches of the cohesion kernel, the last lane is padding
+    using Block = SPHBatchKernels<float>::Block;
+    std::vector<Vec3d> r(Block::RowsAtCompileTime);
+    for (size_t i = 0; i < r.size(); i++)
+    {
+        r[i] = Vec3d(0.3, -0.5, 0.6).normalized() * (kernelRadius * (0.05 + 0.15 * static_cast<double>(i)));
+    }
+    r.back() = Vec3d(batchKernels.getPaddingDistance(), 0.0, 0.0);
+
+    Block x, y, z;
+    for (size_t i = 0; i < r.size(); i++)
+    {
+        x[i] = static_cast<float>(r[i][0]);
+        y[i] = static_cast<float>(r[i][1]);
+        z[i] = static_cast<float>(r[i][2]);
+    }
+    const Block r2 = x * x + y * y + z * z;
+    const Block rl = r2.sqrt();
+
+    const Block w         = batchKernels.W(r2);
+    const Block gradW     = batchKernels.gradWScale(r2, rl);
+    const Block laplace   = batchKernels.laplace(r2, rl);
+    const Block cohesionW = batchKernels.cohesionW(r2, rl);
+    for (size_t i = 0; i < r.size(); i++)
+    {
+        const double tolerance = 1.0e-5 * kernels.W0();
+        EXPECT_NEAR(w[i], kernels.W(r[i]), tolerance);
+        EXPECT_NEAR(gradW[i] * r[i][0], kernels.gradW(r[i])[0], 1.0e-4 * std::abs(kernels.gradW(r[i])[0]) + 1.0e-6);
+        EXPECT_NEAR(laplace[i], kernels.laplace(r[i]), 1.0e-5 * kernels.laplace(Vec3d::Zero()));
+        EXPECT_NEAR(cohesionW[i], kernels.cohesionW(r[i]), 1.0e-5 * std::abs(kernels.cohesionW(r[i])) + 1.0e-6);
+    }
+}
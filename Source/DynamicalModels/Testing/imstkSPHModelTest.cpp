@@ -0,0 +1,87 @@
+/*=========================================================================
+
+   Library: iMSTK
+
+   Copyright (c) Kitware, Inc. & Center for Modeling, Simulation,
+   & Imaging in Medicine, Rensselaer Polytechnic Institute.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+=========================================================================*/
+
+#include "gtest/gtest.h"
+
+#include "imstkDataArray.h"
+#include "imstkPointSet.h"
+#include "imstkSPHModel.h"
+#include "imstkSPHState.h"
+#include "imstkTaskNode.h"
+#include "imstkVecDataArray.h"
+
+using namespace imstk;
+
+///
+/// \brief Tag the velocity and density of every particle with its position, after the Morton
+/// reordering every particle must still carry its own tags
+///
+TEST(imstkSPHModelTest, ReorderParticles)
+{
+    auto      vertices = std::make_shared<VecDataArray<double, 3>>();
+    const int n        = 6;
+    for (int i = 0; i < n; i++)
+    {
+        for (int j = 0; j < n; j++)
+        {
+            for (int k = 0; k < n; k++)
+            {
+                vertices->push_back(Vec3d(i, j, k) * 0.05);
+            }
+        }
+    }
+    auto pointSet = std::make_shared<PointSet>();
+    pointSet->initialize(vertices);
+
+    auto config = std::make_shared<SPHModelConfig>(0.025);
+    config->m_reorderInterval = 1;
+    auto model = std::make_shared<SPHModel>();
+    model->setModelGeometry(pointSet);
+    model->configure(config);
+    ASSERT_TRUE(model->initialize());
+
+    auto velocityTag = [](const Vec3d& pos) { return Vec3d(pos[1], 2.0 * pos[2], 3.0 * pos[0]); };
+    auto densityTag  = [](const Vec3d& pos) { return 1000.0 + pos.dot(Vec3d(1.0, 10.0, 100.0)); };
+
+    const VecDataArray<double, 3>& positions  = *model->getCurrentState()->getPositions();
+    VecDataArray<double, 3>&       velocities = *model->getCurrentState()->getVelocities();
+    DataArray<double>&             densities  = *model->getCurrentState()->getDensities();
+    for (int i = 0; i < positions.size(); i++)
+    {
+        velocities[i] = velocityTag(positions[i]);
+        densities[i]  = densityTag(positions[i]);
+    }
+    const VecDataArray<double, 3> oldPositions = positions;
+
+    // The first neighbor search reorders the particles
+    model->getFindParticleNeighborsNode()->execute();
+
+    ASSERT_EQ(positions.size(), oldPositions.size());
+    int numMoved = 0;
+    for (int i = 0; i < positions.size(); i++)
+    {
+        numMoved += (positions[i] != oldPositions[i]) ? 1 : 0;
+        EXPECT_EQ(velocities[i], velocityTag(positions[i]));
+        EXPECT_EQ(densities[i], densityTag(positions[i]));
+        EXPECT_EQ(positions[i], (*pointSet->getVertexPositions())[i]);
+    }
+    EXPECT_GT(numMoved, 0);
+}
@@ -0,0 +1,254 @@
+/*=========================================================================
+
+   Library: iMSTK
+
+   Copyright (c) Kitware, Inc. & Center for Modeling, Simulation,
+   & Imaging in Medicine, Rensselaer Polytechnic Institute.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+=========================================================================*/
+
+#include "gtest/gtest.h"
+
+#include "imstkGeometryUtilities.h"
+#include "imstkTetrahedralFEMForceModel.h"
+#include "imstkTetrahedralMesh.h"
+#include "imstkVecDataArray.h"
+
+#include <sparseMatrix.h>
+
+using namespace imstk;
+
+namespace
+{
+///
+/// \brief Allocate the tangent stiffness of \p model the way the dynamical model does
+///
+SparseMatrixd
+allocateStiffness(TetrahedralFEMForceModel& model)
+{
+    vega::SparseMatrix* topology = nullptr;
+    model.getTangentStiffnessMatrixTopology(&topology);
+    SparseMatrixd K;
+    model.initializeTangentStiffness(std::shared_ptr<vega::SparseMatrix>(topology), K);
+    return K;
+}
+
+///
+/// \brief Check the tangent stiffness against central differences of the internal force
+///
+void
+testStiffness(const TetrahedralFEMForceModel::Material material)
+{
+    auto                     mesh = GeometryUtils::createUniformMesh(Vec3d::Zero(), Vec3d(1.0, 1.0, 1.0), 2, 2, 2);
+    TetrahedralFEMForceModel model(mesh, material, 1.0e4, 0.3);
+    SparseMatrixd            K = allocateStiffness(model);
+
+    const Vectord u = 0.05 * Vectord::Random(3 * mesh->getNumVertices());
+    Vectord       force;
+    model.getForceAndMatrix(u, force, K);
+
+    Vectord forceOnly;
+    model.getInternalForce(u, forceOnly);
+    EXPECT_NEAR((force - forceOnly).norm(), 0.0, 1.0e-10);
+
+    const double h  = 1.0e-6;
+    const Matrixd Kd = Matrixd(K);
+    for (int dof = 0; dof < u.size(); ++dof)
+    {
+        Vectord up = u, um = u, fp, fm;
+        up[dof] += h;
+        um[dof] -= h;
+        model.getInternalForce(up, fp);
+        model.getInternalForce(um, fm);
+        const Vectord column = (fp - fm) / (2.0 * h);
+        EXPECT_NEAR((column - Kd.col(dof)).norm() / column.norm(), 0.0, 1.0e-5);
+    }
+}
+
+///
+/// \brief Check the matrix-free product and diagonal against the assembled stiffness
+///
+void
+testMatrixFree(const TetrahedralFEMForceModel::Material material)
+{
+    auto                     mesh = GeometryUtils::createUniformMesh(Vec3d::Zero(), Vec3d(1.0, 1.0, 1.0), 2, 2, 2);
+    TetrahedralFEMForceModel model(mesh, material, 1.0e4, 0.3);
+    SparseMatrixd            K = allocateStiffness(model);
+
+    const Vectord u = 0.05 * Vectord::Random(3 * mesh->getNumVertices());
+    Vectord       force, linearizedForce;
+    model.getForceAndMatrix(u, force, K);
+    model.linearize(u, &linearizedForce);
+    EXPECT_NEAR((force - linearizedForce).norm(), 0.0, 1.0e-10);
+
+    const Vectord x = Vectord::Random(u.size());
+    Vectord       y, diagonal;
+    model.multiplyTangentStiffness(x, y);
+    model.getTangentStiffnessDiagonal(diagonal);
+    const Vectord Kx = K * x;
+    EXPECT_NEAR((y - Kx).norm() / Kx.norm(), 0.0, 1.0e-12);
+    EXPECT_NEAR((diagonal - Vectord(K.diagonal())).norm() / diagonal.norm(), 0.0, 1.0e-12);
+}
+}
+
+///
+/// \brief Elements of the same color must not share a vertex
+///
+TEST(imstkTetrahedralFEMForceModelTest, TestColoring)
+{
+    class ColoringModel : public TetrahedralFEMForceModel
+    {
+    public:
+        using TetrahedralFEMForceModel::TetrahedralFEMForceModel;
+        using TetrahedralFEMForceModel::m_elementColors;
+        using TetrahedralFEMForceModel::m_elements;
+    };
+
+    auto          mesh = GeometryUtils::createUniformMesh(Vec3d::Zero(), Vec3d(1.0, 1.0, 1.0), 2, 2, 2);
+    ColoringModel model(mesh, TetrahedralFEMForceModel::Material::Corotational);
+    EXPECT_GT(model.getNumColors(), 1);
+
+    size_t numElements = 0;
+    for (const std::vector<int>& color : model.m_elementColors)
+    {
+        std::vector<int> vertices;
+        for (const int e : color)
+        {
+            vertices.insert(vertices.end(), model.m_elements[e].data(), model.m_elements[e].data() + 4);
+        }
+        std::sort(vertices.begin(), vertices.end());
+        EXPECT_TRUE(std::adjacent_find(vertices.begin(), vertices.end()) == vertices.end());
+        numElements += color.size();
+    }
+    EXPECT_EQ(numElements, mesh->getNumTetrahedra());
+}
+
+///
+/// \brief The corotational force vanishes at rest and under rigid rotations
+///
+TEST(imstkTetrahedralFEMForceModelTest, TestCorotationalRigidMotion)
+{
+    auto                     mesh = GeometryUtils::createUniformMesh(Vec3d::Zero(), Vec3d(1.0, 1.0, 1.0), 2, 2, 2);
+    TetrahedralFEMForceModel model(mesh, TetrahedralFEMForceModel::Material::Corotational);
+    SparseMatrixd            K = allocateStiffness(model);
+
+    const VecDataArray<double, 3>& vertices = *mesh->getVertexPositions();
+    const Mat3d                    R        = Rotd(0.7, Vec3d(1.0, 2.0, 3.0).normalized()).toRotationMatrix();
+    Vectord                        u(3 * vertices.size());
+    for (int i = 0; i < vertices.size(); ++i)
+    {
+        u.segment<3>(3 * i) = R * vertices[i] - vertices[i] + Vec3d(0.1, 0.2, 0.3);
+    }
+
+    Vectord force;
+    model.getForceAndMatrix(u, force, K);
+    EXPECT_NEAR(force.norm(), 0.0, 1.0e-6);
+
+    // The stiffness is symmetric and the rigid translation is in its null space
+    const Matrixd Kd = Matrixd(K);
+    EXPECT_NEAR((Kd - Kd.transpose()).norm() / Kd.norm(), 0.0, 1.0e-12);
+    EXPECT_NEAR((Kd * Vec3d(1.0, 0.0, 0.0).replicate(vertices.size(), 1)).norm() / Kd.norm(), 0.0, 1.0e-12);
+}
+
+TEST(imstkTetrahedralFEMForceModelTest, TestStVKStiffness)
+{
+    testStiffness(TetrahedralFEMForceModel::Material::StVK);
+}
+
+TEST(imstkTetrahedralFEMForceModelTest, TestNeoHookeanStiffness)
+{
+    testStiffness(TetrahedralFEMForceModel::Material::NeoHookean);
+}
+
+TEST(imstkTetrahedralFEMForceModelTest, TestMatrixFreeProduct)
+{
+    testMatrixFree(TetrahedralFEMForceModel::Material::Corotational);
+    testMatrixFree(TetrahedralFEMForceModel::Material::StVK);
+    testMatrixFree(TetrahedralFEMForceModel::Material::NeoHookean);
+}
+
+///
+/// \brief Copy the assembled stiffness into a Vega matrix whose rows are in decreasing column order,
+/// unlike the sorted Eigen CSR rows. Building the Eigen matrix from it and scattering into the
+/// preallocated matrix must both give the assembled stiffness back
+///
+TEST(imstkTetrahedralFEMForceModelTest, TestVegaScatter)
+{
+    class ScatterModel : public TetrahedralFEMForceModel
+    {
+    public:
+        using TetrahedralFEMForceModel::TetrahedralFEMForceModel;
+        using TetrahedralFEMForceModel::scatterTangentStiffness;
+        using TetrahedralFEMForceModel::m_tangentStiffnessScatterMap;
+    };
+
+    auto          mesh = GeometryUtils::createUniformMesh(Vec3d::Zero(), Vec3d(1.0, 1.0, 1.0), 2, 2, 2);
+    ScatterModel  model(mesh, TetrahedralFEMForceModel::Material::StVK, 1.0e4, 0.3);
+    SparseMatrixd K = allocateStiffness(model);
+    model.getTangentStiffnessMatrix(0.05 * Vectord::Random(3 * mesh->getNumVertices()), K);
+    const Matrixd Kd = Matrixd(K);
+
+    vega::SparseMatrix* topology = nullptr;
+    model.getTangentStiffnessMatrixTopology(&topology);
+    auto     vegaMatrix = std::shared_ptr<vega::SparseMatrix>(topology);
+    int**    columns    = vegaMatrix->GetColumnIndices();
+    double** entries    = vegaMatrix->GetEntries();
+    auto     setEntries = [&](const double scale)
+                          {
+                              for (int row = 0; row < vegaMatrix->GetNumRows(); ++row)
+                              {
+                                  for (int j = 0; j < vegaMatrix->GetRowLengths()[row]; ++j)
+                                  {
+                                      entries[row][j] = scale * K.coeff(row, columns[row][j]);
+                                  }
+                              }
+                          };
+    for (int row = 0; row < vegaMatrix->GetNumRows(); ++row)
+    {
+        std::reverse(columns[row], columns[row] + vegaMatrix->GetRowLengths()[row]);
+    }
+    setEntries(1.0);
+    ASSERT_GT(vegaMatrix->GetRowLengths()[0], 1);
+    EXPECT_GT(columns[0][0], columns[0][1]);
+
+    SparseMatrixd built;
+    InternalForceModel::buildEigenMatrixFromVegaMatrix(*vegaMatrix, built);
+    ASSERT_EQ(built.nonZeros(), K.nonZeros());
+    EXPECT_TRUE(std::equal(K.outerIndexPtr(), K.outerIndexPtr() + K.outerSize() + 1, built.outerIndexPtr()));
+    EXPECT_TRUE(std::equal(K.innerIndexPtr(), K.innerIndexPtr() + K.nonZeros(), built.innerIndexPtr()));
+    EXPECT_NEAR((Matrixd(built) - Kd).norm() / Kd.norm(), 0.0, 1.0e-14);
+
+    // Every scatter into the same matrix writes the current values
+    SparseMatrixd scattered;
+    model.initializeTangentStiffness(vegaMatrix, scattered);
+    EXPECT_FALSE(model.m_tangentStiffnessScatterMap.empty());
+    for (const double scale : { 2.0, -1.0 })
+    {
+        setEntries(scale);
+        model.scatterTangentStiffness(*vegaMatrix, scattered);
+        EXPECT_NEAR((Matrixd(scattered) - scale * Kd).norm() / Kd.norm(), 0.0, 1.0e-14);
+    }
+
+    // Rows already in the CSR order are copied as they are
+    model.getTangentStiffnessMatrixTopology(&topology);
+    vegaMatrix = std::shared_ptr<vega::SparseMatrix>(topology);
+    columns    = vegaMatrix->GetColumnIndices();
+    entries    = vegaMatrix->GetEntries();
+    model.initializeTangentStiffness(vegaMatrix, scattered);
+    EXPECT_TRUE(model.m_tangentStiffnessScatterMap.empty());
+    setEntries(3.0);
+    model.scatterTangentStiffness(*vegaMatrix, scattered);
+    EXPECT_NEAR((Matrixd(scattered) - 3.0 * Kd).norm() / Kd.norm(), 0.0, 1.0e-14);
+}
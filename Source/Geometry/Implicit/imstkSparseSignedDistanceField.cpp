@@ -0,0 +1,242 @@
+/*=========================================================================
+
+   Library: iMSTK
+
+   Copyright (c) Kitware, Inc. & Center for Modeling, Simulation,
+   & Imaging in Medicine, Rensselaer Polytechnic Institute.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+=========================================================================*/
+
+#include "imstkSparseSignedDistanceField.h"
+#include "imstkDataArray.h"
+#include "imstkImageData.h"
+#include "imstkLogger.h"
+#include "imstkParallelUtils.h"
+
+namespace imstk
+{
+SparseSignedDistanceField::SparseSignedDistanceField(std::string name) : ImplicitGeometry(name)
+{
+}
+
+SparseSignedDistanceField::SparseSignedDistanceField(std::shared_ptr<ImageData> imageData, const double bandWidth, std::string name) :
+    ImplicitGeometry(name)
+{
+    build(imageData, bandWidth);
+}
+
+void
+SparseSignedDistanceField::build(std::shared_ptr<ImageData> imageData, const double bandWidth)
+{
+    CHECK(imageData != nullptr) << "SparseSignedDistanceField requires an input image";
+    CHECK(bandWidth > 0.0) << "SparseSignedDistanceField requires a positive band width";
+
+    std::shared_ptr<DataArray<double>> scalarsPtr = std::dynamic_pointer_cast<DataArray<double>>(imageData->getScalars());
+    CHECK(scalarsPtr != nullptr && imageData->getNumComponents() == 1)
+        << "SparseSignedDistanceField requires single component doubles in the input image";
+
+    m_dimensions      = imageData->getDimensions();
+    m_origin          = imageData->getOrigin();
+    m_spacing         = imageData->getSpacing();
+    m_backgroundValue = bandWidth;
+    updateGridInfo();
+
+    m_tileMap.clear();
+    m_tiles.clear();
+
+    const double* imgPtr   = scalarsPtr->getPointer();
+    const Vec3i&  dim      = m_dimensions;
+    const Vec3i   tileDim  = (dim + Vec3i(TileSize - 1, TileSize - 1, TileSize - 1)) / TileSize;
+    const int     numTiles = tileDim[0] * tileDim[1] * tileDim[2];
+
+    // Classify every tile of the dense grid, 1 if it stores samples,
+    // InsideTile if completely inside, 0 if completely outside
+    std::vector<int> tileTypes(numTiles, 0);
+    ParallelUtils::parallelFor(numTiles, [&](const int tileId)
+        {
+            const Vec3i tile  = Vec3i(tileId % tileDim[0], (tileId / tileDim[0]) % tileDim[1], tileId / (tileDim[0] * tileDim[1]));
+            const Vec3i start = tile * TileSize;
+            const Vec3i end   = (start + Vec3i(TileSize, TileSize, TileSize)).cwiseMin(dim);
+
+            bool hasInside  = false;
+            bool hasOutside = false;
+            bool inBand     = false;
+            for (int z = start[2]; z < end[2]; z++)
+            {
+                for (int y = start[1]; y < end[1]; y++)
+                {
+                    for (int x = start[0]; x < end[0]; x++)
+                    {
+                        const double val = imgPtr[ImageData::getScalarIndex(x, y, z, dim, 1)];
+                        hasInside  |= (val < 0.0);
+                        hasOutside |= (val >= 0.0);
+                        inBand     |= (std::abs(val) < bandWidth);
+                    }
+                }
+            }
+
+            // A sign change always gets samples so the zero crossing is kept
+            if (inBand || (hasInside && hasOutside))
+            {
+                tileTypes[tileId] = 1;
+            }
+            else if (hasInside)
+            {
+                tileTypes[tileId] = InsideTile;
+            }
+        });
+
+    // Assign storage to every banded tile
+    std::vector<int> tileIds(numTiles, InsideTile);
+    int              numBandTiles = 0;
+    for (int tileId = 0; tileId < numTiles; tileId++)
+    {
+        if (tileTypes[tileId] == 1)
+        {
+            tileIds[tileId] = numBandTiles++;
+        }
+    }
+    m_tiles.resize(numBandTiles);
+    m_tileMap.reserve(numTiles);
+    for (int tileId = 0; tileId < numTiles; tileId++)
+    {
+        if (tileTypes[tileId] != 0)
+        {
+            const TileKey key = getTileKey(tileId % tileDim[0], (tileId / tileDim[0]) % tileDim[1], tileId / (tileDim[0] * tileDim[1]));
+            m_tileMap[key] = tileIds[tileId];
+        }
+    }
+
+    // Copy the samples, clamped to the band
+    ParallelUtils::parallelFor(numTiles, [&](const int tileId)
+        {
+            if (tileTypes[tileId] != 1)
+            {
+                return;
+            }
+            const Vec3i tile  = Vec3i(tileId % tileDim[0], (tileId / tileDim[0]) % tileDim[1], tileId / (tileDim[0] * tileDim[1]));
+            const Vec3i start = tile * TileSize;
+            Tile&       tileData = m_tiles[tileIds[tileId]];
+            tileData.fill(static_cast<float>(bandWidth));
+            for (int z = start[2]; z < std::min(start[2] + TileSize, dim[2]); z++)
+            {
+                for (int y = start[1]; y < std::min(start[1] + TileSize, dim[1]); y++)
+                {
+                    for (int x = start[0]; x < std::min(start[0] + TileSize, dim[0]); x++)
+                    {
+                        const double val = imgPtr[ImageData::getScalarIndex(x, y, z, dim, 1)];
+                        tileData[getTileVoxelIndex(x, y, z)] = static_cast<float>(std::max(-bandWidth, std::min(val, bandWidth)));
+                    }
+                }
+            }
+        });
+}
+
+double
+SparseSignedDistanceField::getFunctionValue(const Vec3d& pos) const
+{
+    if (!(pos[0] < m_bounds[1] && pos[0] > m_bounds[0]
+          && pos[1] < m_bounds[3] && pos[1] > m_bounds[2]
+          && pos[2] < m_bounds[5] && pos[2] > m_bounds[4]))
+    {
+        // If outside of the bounds, return positive (assume not inside)
+        return IMSTK_DOUBLE_MAX;
+    }
+
+    // Structured coordinate relative to the voxel centers
+    const Vec3d structuredPt = (pos - m_origin).cwiseProduct(m_invSpacing) - Vec3d(0.5, 0.5, 0.5);
+    const Vec3d floorPt      = structuredPt.array().floor();
+    const Vec3d t            = structuredPt - floorPt;
+    const Vec3i maxCoord     = m_dimensions - Vec3i(1, 1, 1);
+    const Vec3i s1 = floorPt.cast<int>().cwiseMax(0).cwiseMin(maxCoord);
+    const Vec3i s2 = (floorPt.cast<int>() + Vec3i(1, 1, 1)).cwiseMax(0).cwiseMin(maxCoord);
+
+    double vals[8];
+    if (s1[0] / TileSize == s2[0] / TileSize
+        && s1[1] / TileSize == s2[1] / TileSize
+        && s1[2] / TileSize == s2[2] / TileSize)
+    {
+        // All samples lie in the same tile, only one lookup required
+        const auto iter = m_tileMap.find(getTileKey(s1[0] / TileSize, s1[1] / TileSize, s1[2] / TileSize));
+        if (iter == m_tileMap.end())
+        {
+            return m_backgroundValue * m_scale;
+        }
+        else if (iter->second == InsideTile)
+        {
+            return -m_backgroundValue * m_scale;
+        }
+        const Tile& tile = m_tiles[iter->second];
+        vals[0] = tile[getTileVoxelIndex(s1[0], s1[1], s1[2])];
+        vals[1] = tile[getTileVoxelIndex(s2[0], s1[1], s1[2])];
+        vals[2] = tile[getTileVoxelIndex(s1[0], s2[1], s1[2])];
+        vals[3] = tile[getTileVoxelIndex(s2[0], s2[1], s1[2])];
+        vals[4] = tile[getTileVoxelIndex(s1[0], s1[1], s2[2])];
+        vals[5] = tile[getTileVoxelIndex(s2[0], s1[1], s2[2])];
+        vals[6] = tile[getTileVoxelIndex(s1[0], s2[1], s2[2])];
+        vals[7] = tile[getTileVoxelIndex(s2[0], s2[1], s2[2])];
+    }
+    else
+    {
+        vals[0] = getVoxelValue(s1[0], s1[1], s1[2]);
+        vals[1] = getVoxelValue(s2[0], s1[1], s1[2]);
+        vals[2] = getVoxelValue(s1[0], s2[1], s1[2]);
+        vals[3] = getVoxelValue(s2[0], s2[1], s1[2]);
+        vals[4] = getVoxelValue(s1[0], s1[1], s2[2]);
+        vals[5] = getVoxelValue(s2[0], s1[1], s2[2]);
+        vals[6] = getVoxelValue(s1[0], s2[1], s2[2]);
+        vals[7] = getVoxelValue(s2[0], s2[1], s2[2]);
+    }
+
+    // Interpolate along x
+    const double ax = vals[0] + (vals[1] - vals[0]) * t[0];
+    const double bx = vals[2] + (vals[3] - vals[2]) * t[0];
+    const double dx = vals[4] + (vals[5] - vals[4]) * t[0];
+    const double ex = vals[6] + (vals[7] - vals[6]) * t[0];
+
+    // Interpolate along y
+    const double cy = ax + (bx - ax) * t[1];
+    const double fy = dx + (ex - dx) * t[1];
+
+    // Interpolate along z
+    return (cy + (fy - cy) * t[2]) * m_scale;
+}
+
+size_t
+SparseSignedDistanceField::getMemorySize() const
+{
+    return m_tiles.size() * sizeof(Tile)
+           + m_tileMap.size() * (sizeof(TileKey) + sizeof(int) + sizeof(void*))
+           + m_tileMap.bucket_count() * sizeof(void*);
+}
+
+void
+SparseSignedDistanceField::computeBoundingBox(Vec3d& min, Vec3d& max, const double imstkNotUsed(paddingPercent))
+{
+    min = Vec3d(m_bounds[0], m_bounds[2], m_bounds[4]);
+    max = Vec3d(m_bounds[1], m_bounds[3], m_bounds[5]);
+}
+
+void
+SparseSignedDistanceField::updateGridInfo()
+{
+    m_invSpacing = m_spacing.cwiseInverse();
+
+    const Vec3d size = m_spacing.cwiseProduct(m_dimensions.cast<double>());
+    m_bounds << m_origin[0], m_origin[0] + size[0],
+        m_origin[1], m_origin[1] + size[1],
+        m_origin[2], m_origin[2] + size[2];
+}
+}
@@ -0,0 +1,199 @@
+/*=========================================================================
+
+   Library: iMSTK
+
+   Copyright (c) Kitware, Inc. & Center for Modeling, Simulation,
+   & Imaging in Medicine, Rensselaer Polytechnic Institute.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+=========================================================================*/
+
+#pragma once
+
+#include "imstkImplicitGeometry.h"
+#include "imstkTypes.h"
+
+#include <array>
+#include <unordered_map>
+
+namespace imstk
+{
+class ImageData;
+
+///
+/// \class SparseSignedDistanceField
+///
+/// \brief Narrow banded signed distance field stored in 8^3 voxel tiles
+/// Only tiles that intersect the band around the zero level set store samples,
+/// they live contiguously in memory and are looked up through a hashed tile map.
+/// Tiles completely inside the object only store a flag, tiles completely
+/// outside are not stored at all. Samples outside of the band evaluate to
+/// +/- the background value (the band width). Voxel centers are located at
+/// origin + spacing * (i + 0.5), same as the images produced by
+/// SurfaceMeshDistanceTransform
+///
+class SparseSignedDistanceField : public ImplicitGeometry
+{
+public:
+    static constexpr int TileSize      = 8;   ///> Voxels along each edge of a tile
+    static constexpr int TileVoxelSize = 512; ///> Voxels in a tile
+    static constexpr int InsideTile    = -1;  ///> Tile index of a tile inside the solid, all its distances are negative and beyond the band
+
+    using Tile    = std::array<float, TileVoxelSize>;
+    using TileKey = uint64_t;
+
+public:
+    ///
+    /// \brief Constructor
+    /// \param geometry name
+    ///
+    SparseSignedDistanceField(std::string name = "");
+
+    ///
+    /// \brief Constructor, builds the field from a dense SDF image
+    /// \param ImageData of doubles to sample from (ie: SurfaceMeshDistanceTransform output)
+    /// \param width of the band about the zero level set to keep
+    /// \param geometry name
+    ///
+    SparseSignedDistanceField(std::shared_ptr<ImageData> imageData, const double bandWidth, std::string name = "");
+
+    ///
+    /// \brief Deconstructor
+    ///
+    virtual ~SparseSignedDistanceField() override = default;
+
+    ///
+    /// \brief Returns the string representing the type name of the geometry
+    ///
+    virtual const std::string getTypeName() const override { return "SparseSignedDistanceField"; }
+
+public:
+    ///
+    /// \brief Builds the tiles from a dense SDF image, any previous data is cleared
+    /// \param ImageData of doubles to sample from (ie: SurfaceMeshDistanceTransform output)
+    /// \param width of the band about the zero level set to keep
+    ///
+    void build(std::shared_ptr<ImageData> imageData, const double bandWidth);
+
+    ///
+    /// \brief Returns signed distance to surface at pos, returns IMSTK_DOUBLE_MAX if out of bounds
+    ///
+    double getFunctionValue(const Vec3d& pos) const override;
+
+    ///
+    /// \brief Returns signed distance to surface at structured coordinate, clamped to the dimensions
+    ///
+    double getFunctionValueCoord(const Vec3i& coord) const
+    {
+        const Vec3i c = coord.cwiseMax(0).cwiseMin(m_dimensions - Vec3i(1, 1, 1));
+        return getVoxelValue(c[0], c[1], c[2]) * m_scale;
+    }
+
+    ///
+    /// \brief Returns the bounds of the field
+    ///
+    const Vec6d& getBounds() const { return m_bounds; }
+
+    ///
+    /// \brief Set the isotropic scale that is used/multplied with samples
+    ///
+    void setScale(const double scale) { m_scale = scale; }
+
+    ///
+    /// \brief Get the isotropic scale
+    ///
+    double getScale() const { return m_scale; }
+
+    ///
+    /// \brief Returns the value returned for samples outside of the band
+    /// (positive outside, negative inside)
+    ///
+    double getBackgroundValue() const { return m_backgroundValue; }
+
+    ///
+    /// \brief Get the dimensions/origin/spacing of the voxel grid the tiles live in
+    ///@{
+    const Vec3i& getDimensions() const { return m_dimensions; }
+    const Vec3d& getOrigin() const { return m_origin; }
+    const Vec3d& getSpacing() const { return m_spacing; }
+    ///@}
+
+    ///
+    /// \brief Returns the number of tiles storing samples
+    ///
+    size_t getNumberOfTiles() const { return m_tiles.size(); }
+
+    ///
+    /// \brief Returns the approximate number of bytes used by the tiles and tile map
+    ///
+    size_t getMemorySize() const;
+
+    void computeBoundingBox(Vec3d& min, Vec3d& max, const double paddingPercent) override;
+
+protected:
+    friend class SparseSignedDistanceFieldIO;
+
+    ///
+    /// \brief Returns the key of the tile containing the tile coordinate
+    ///
+    static TileKey getTileKey(const int tileX, const int tileY, const int tileZ)
+    {
+        return static_cast<TileKey>(tileX & 0x1FFFFF)
+               | (static_cast<TileKey>(tileY & 0x1FFFFF) << 21)
+               | (static_cast<TileKey>(tileZ & 0x1FFFFF) << 42);
+    }
+
+    ///
+    /// \brief Returns the index of the voxel within its tile
+    ///
+    static int getTileVoxelIndex(const int x, const int y, const int z)
+    {
+        return (x & (TileSize - 1)) + TileSize * ((y & (TileSize - 1)) + TileSize * (z & (TileSize - 1)));
+    }
+
+    ///
+    /// \brief Returns the unscaled value of voxel, coordinate must be within the dimensions
+    ///
+    double getVoxelValue(const int x, const int y, const int z) const
+    {
+        const auto iter = m_tileMap.find(getTileKey(x / TileSize, y / TileSize, z / TileSize));
+        if (iter == m_tileMap.end())
+        {
+            return m_backgroundValue;
+        }
+        else if (iter->second == InsideTile)
+        {
+            return -m_backgroundValue;
+        }
+        return static_cast<double>(m_tiles[iter->second][getTileVoxelIndex(x, y, z)]);
+    }
+
+    ///
+    /// \brief Recompute the cached bounds and inverse spacing
+    ///
+    void updateGridInfo();
+
+protected:
+    Vec3i  m_dimensions      = Vec3i::Zero();
+    Vec3d  m_origin          = Vec3d::Zero();
+    Vec3d  m_spacing         = Vec3d::Ones();
+    Vec3d  m_invSpacing      = Vec3d::Ones();
+    Vec6d  m_bounds          = Vec6d::Zero();
+    double m_scale           = 1.0;
+    double m_backgroundValue = IMSTK_DOUBLE_MAX;
+
+    std::unordered_map<TileKey, int> m_tileMap; ///> Tile key -> index in m_tiles (or InsideTile)
+    std::vector<Tile>                m_tiles;   ///> Contiguous storage of the narrow band tiles
+};
+}
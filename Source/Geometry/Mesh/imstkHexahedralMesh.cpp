@@ -21,6 +21,7 @@
 
 #include "imstkHexahedralMesh.h"
 #include "imstkLogger.h"
+#include "imstkReordering.h"
 #include "imstkSurfaceMesh.h"
 #include "imstkVecDataArray.h"
 
@@ -46,6 +47,13 @@ HexahedralMesh::clear()
     m_hexahedraIndices->clear();
 }
 
+void
+HexahedralMesh::reorderVertices(const std::vector<size_t>& newToOld)
+{
+    PointSet::reorderVertices(newToOld);
+    Reordering::renumberCells(*m_hexahedraIndices, Reordering::invertPermutation(newToOld));
+}
+
 void
 HexahedralMesh::print() const
 {
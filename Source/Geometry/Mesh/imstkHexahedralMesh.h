@@ -61,6 +61,11 @@ public:
     ///
     void clear() override;
 
+    ///
+    /// \brief Reorder the vertices and renumber the hexahedra, see PointSet::reorderVertices
+    ///
+    void reorderVertices(const std::vector<size_t>& newToOld) override;
+
     ///
     /// \brief Print the hexahedral mesh
     ///
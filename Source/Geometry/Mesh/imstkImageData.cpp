@@ -142,4 +142,10 @@ ImageData::clear()
     //this->m_dataTransform->Identity();
     this->postModified();
 }
+
+void
+ImageData::reorderVertices(const std::vector<size_t>& imstkNotUsed(newToOld))
+{
+    LOG(WARNING) << "Can't reorder the vertices of an image, its vertex order is implicit";
+}
 } // imstk
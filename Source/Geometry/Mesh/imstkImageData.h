@@ -177,6 +177,11 @@ public:
     ///
     void clear() override;
 
+    ///
+    /// \brief Not supported, the vertex order of an image is implicit
+    ///
+    void reorderVertices(const std::vector<size_t>& newToOld) override;
+
 private:
     // ImageData does not use transform, consider splitting into separate class
     using Geometry::translate;
@@ -21,6 +21,7 @@
 
 #include "imstkLineMesh.h"
 #include "imstkLogger.h"
+#include "imstkReordering.h"
 #include "imstkVecDataArray.h"
 
 namespace imstk
@@ -51,6 +52,13 @@ LineMesh::clear()
     }
 }
 
+void
+LineMesh::reorderVertices(const std::vector<size_t>& newToOld)
+{
+    PointSet::reorderVertices(newToOld);
+    Reordering::renumberCells(*m_segmentIndices, Reordering::invertPermutation(newToOld));
+}
+
 void
 LineMesh::print() const
 {
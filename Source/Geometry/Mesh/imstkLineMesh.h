@@ -64,6 +64,11 @@ public:
     ///
     void clear() override;
 
+    ///
+    /// \brief Reorder the vertices and renumber the segments, see PointSet::reorderVertices
+    ///
+    void reorderVertices(const std::vector<size_t>& newToOld) override;
+
     ///
     /// \brief
     ///
@@ -21,6 +21,7 @@
 
 #include "imstkPointSet.h"
 #include "imstkParallelUtils.h"
+#include "imstkReordering.h"
 #include "imstkLogger.h"
 #include "imstkVecDataArray.h"
 
@@ -59,6 +60,22 @@ PointSet::clear()
     }
 }
 
+void
+PointSet::reorderVertices(const std::vector<size_t>& newToOld)
+{
+    CHECK(static_cast<int>(newToOld.size()) == m_initialVertexPositions->size())
+        << "Permutation does not match the number of vertices";
+
+    // The initial and post transform positions may be the same array
+    std::vector<std::shared_ptr<AbstractDataArray>> arrays = { m_initialVertexPositions, m_vertexPositions };
+    for (auto i : m_vertexAttributes)
+    {
+        arrays.push_back(i.second);
+    }
+    Reordering::permuteArrays(arrays, newToOld);
+    this->postModified();
+}
+
 void
 PointSet::print() const
 {
@@ -76,6 +76,15 @@ public:
     ///
     virtual void computeBoundingBox(Vec3d& lowerCorner, Vec3d& upperCorner, const double paddingPercent = 0.0) override;
 
+    ///
+    /// \brief Reorder the vertices, along with their initial positions and attributes,
+    /// for instance by Reordering::computeMortonOrder for memory locality. Derived meshes renumber
+    /// their cells. Constraints and maps referring to the vertices are renumbered by
+    /// PbdModel::reorderVertices and GeometryMap::reorderVertices
+    /// \param newToOld Permutation where vertex i becomes the vertex newToOld[i]
+    ///
+    virtual void reorderVertices(const std::vector<size_t>& newToOld);
+
 // Accessors
 public:
     ///
@@ -21,8 +21,11 @@
 
 #include "imstkSurfaceMesh.h"
 #include "imstkLogger.h"
+#include "imstkParallelUtils.h"
+#include "imstkReordering.h"
 #include "imstkVecDataArray.h"
 #include "imstkGeometryUtilities.h"
+#include "imstkSpatialQueryUtils.h"
 
 namespace imstk
 {
@@ -80,12 +83,40 @@ SurfaceMesh::clear()
     }
     m_vertexNeighborTriangles.clear();
     m_vertexNeighborVertices.clear();
+    m_trianglesBVH.clear();
     for (auto i : m_cellAttributes)
     {
         i.second->clear();
     }
 }
 
+void
+SurfaceMesh::reorderVertices(const std::vector<size_t>& newToOld)
+{
+    PointSet::reorderVertices(newToOld);
+
+    const std::vector<size_t> oldToNew = Reordering::invertPermutation(newToOld);
+    Reordering::renumberCells(*m_triangleIndices, oldToNew);
+    for (auto& group : m_UVSeamVertexGroups)
+    {
+        for (size_t& vertexId : *group.second)
+        {
+            vertexId = oldToNew[vertexId];
+        }
+    }
+
+    // Triangle ids are unchanged, but the neighbors are indexed by vertex
+    if (!m_vertexNeighborTriangles.empty())
+    {
+        computeVertexNeighborTriangles();
+    }
+    if (!m_vertexNeighborVertices.empty())
+    {
+        computeVertexNeighborVertices();
+    }
+    m_trianglesBVH.clear();
+}
+
 void
 SurfaceMesh::print() const
 {
@@ -814,4 +845,97 @@ SurfaceMesh::setCellActiveAttribute(std::string& activeAttributeName, std::strin
     }
     activeAttributeName = attributeName;
 }
+
+void
+SurfaceMesh::updateBoundingVolumeHierarchy()
+{
+    const VecDataArray<double, 3>& vertices  = *m_vertexPositions;
+    const VecDataArray<int, 3>&    triangles = *m_triangleIndices;
+
+    std::vector<Vec3d> lowerCorners(triangles.size());
+    std::vector<Vec3d> upperCorners(triangles.size());
+    ParallelUtils::parallelFor(triangles.size(), [&](const size_t triId) {
+            const Vec3i& tri = triangles[triId];
+            lowerCorners[triId] = vertices[tri[0]].cwiseMin(vertices[tri[1]]).cwiseMin(vertices[tri[2]]);
+            upperCorners[triId] = vertices[tri[0]].cwiseMax(vertices[tri[1]]).cwiseMax(vertices[tri[2]]);
+        });
+
+    // Refitting is only valid when the triangles are the ones the hierarchy was built from
+    const int*   indices = triangles.size() > 0 ? triangles[0].data() : nullptr;
+    const size_t numIndices = static_cast<size_t>(triangles.size()) * 3;
+    if (m_trianglesBVH.getNumBoxes() == lowerCorners.size() && !lowerCorners.empty()
+        && m_trianglesBVHIndices.size() == numIndices
+        && std::equal(indices, indices + numIndices, m_trianglesBVHIndices.begin()))
+    {
+        m_trianglesBVH.refit(lowerCorners, upperCorners);
+    }
+    else
+    {
+        m_trianglesBVH.build(lowerCorners, upperCorners);
+        m_trianglesBVHIndices.assign(indices, indices + numIndices);
+    }
+}
+
+int
+SurfaceMesh::castRay(const Vec3d& origin, const Vec3d& direction, const double maxT, double& t) const
+{
+    CHECK(m_trianglesBVH.getNumBoxes() == static_cast<size_t>(getNumTriangles()))
+        << "Bounding volume hierarchy is out of date, call updateBoundingVolumeHierarchy first";
+
+    const VecDataArray<double, 3>& vertices  = *m_vertexPositions;
+    const VecDataArray<int, 3>&    triangles = *m_triangleIndices;
+
+    int triId = -1;
+    t = maxT;
+    m_trianglesBVH.castRay(origin, direction, t,
+        [&](const size_t id, double& tMax)
+        {
+            const Vec3i& tri  = triangles[id];
+            double       tHit = 0.0;
+            if (SpatialQueryUtils::rayIntersectsTriangle(origin, direction, vertices[tri[0]], vertices[tri[1]], vertices[tri[2]], tMax, tHit))
+            {
+                tMax  = tHit;
+                triId = static_cast<int>(id);
+            }
+        });
+    return triId;
+}
+
+void
+SurfaceMesh::castRayAllHits(const Vec3d& origin, const Vec3d& direction, const double maxT, std::vector<std::pair<int, double>>& hits) const
+{
+    CHECK(m_trianglesBVH.getNumBoxes() == static_cast<size_t>(getNumTriangles()))
+        << "Bounding volume hierarchy is out of date, call updateBoundingVolumeHierarchy first";
+
+    const VecDataArray<double, 3>& vertices  = *m_vertexPositions;
+    const VecDataArray<int, 3>&    triangles = *m_triangleIndices;
+
+    hits.resize(0);
+    double tMax = maxT;
+    m_trianglesBVH.castRay(origin, direction, tMax,
+        [&](const size_t id, double&)
+        {
+            const Vec3i& tri  = triangles[id];
+            double       tHit = 0.0;
+            if (SpatialQueryUtils::rayIntersectsTriangle(origin, direction, vertices[tri[0]], vertices[tri[1]], vertices[tri[2]], maxT, tHit))
+            {
+                hits.push_back(std::make_pair(static_cast<int>(id), tHit));
+            }
+        });
+    std::sort(hits.begin(), hits.end(),
+        [](const std::pair<int, double>& a, const std::pair<int, double>& b) { return a.second < b.second; });
+}
+
+void
+SurfaceMesh::castRays(const VecDataArray<double, 3>& origins, const VecDataArray<double, 3>& directions, const double maxT,
+                      std::vector<int>& triangleIds, std::vector<double>& ts) const
+{
+    CHECK(origins.size() == directions.size()) << "Number of ray origins and directions differ";
+
+    triangleIds.resize(origins.size());
+    ts.resize(origins.size());
+    ParallelUtils::parallelFor(origins.size(), [&](const size_t rayId) {
+            triangleIds[rayId] = castRay(origins[rayId], directions[rayId], maxT, ts[rayId]);
+        });
+}
 }  // namespace imstk
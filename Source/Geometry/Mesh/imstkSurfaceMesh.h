@@ -21,6 +21,7 @@
 
 #pragma once
 
+#include "imstkAABBTree.h"
 #include "imstkPointSet.h"
 
 #include <array>
@@ -158,6 +159,11 @@ public:
     ///
     void optimizeForDataLocality();
 
+    ///
+    /// \brief Reorder the vertices and renumber the triangles, see PointSet::reorderVertices
+    ///
+    void reorderVertices(const std::vector<size_t>& newToOld) override;
+
     ///
     /// \brief Flip the normals for the whole mesh by reversing the winding order
     ///
@@ -184,6 +190,33 @@ public:
     ///
     bool isMesh() const override { return true; }
 
+    ///
+    /// \brief Build the bounding volume hierarchy of the triangles used by the ray casts from the
+    /// current vertex positions, or refit it if the triangles did not change.
+    /// Call it after the mesh moved and before casting rays
+    ///
+    void updateBoundingVolumeHierarchy();
+
+    ///
+    /// \brief Cast the ray origin + t * direction, t in [0, maxT], and find the first triangle hit.
+    /// A segment [a, b] is cast with direction b - a and maxT 1
+    /// \param t Parameter of the hit
+    /// \return Index of the triangle hit, -1 if none
+    ///
+    int castRay(const Vec3d& origin, const Vec3d& direction, const double maxT, double& t) const;
+
+    ///
+    /// \brief Cast the ray origin + t * direction, t in [0, maxT], and find all the triangles hit
+    /// \param hits Indices and hit parameters of the triangles, sorted by increasing parameter
+    ///
+    void castRayAllHits(const Vec3d& origin, const Vec3d& direction, const double maxT, std::vector<std::pair<int, double>>& hits) const;
+
+    ///
+    /// \brief Cast rays in parallel and find the first triangle hit by each, see castRay
+    ///
+    void castRays(const VecDataArray<double, 3>& origins, const VecDataArray<double, 3>& directions, const double maxT,
+                  std::vector<int>& triangleIds, std::vector<double>& ts) const;
+
 // Accessors
 public:
     ///
@@ -286,5 +319,8 @@ protected:
     std::string m_activeCellNormals  = "";
     std::string m_activeCellTangents = "";
     std::string m_activeCellScalars  = "";
+
+    AABBTree         m_trianglesBVH;        ///> Bounding volume hierarchy of the triangles for ray casts
+    std::vector<int> m_trianglesBVHIndices; ///> Triangle indices the hierarchy was built from
 };
 } // imstk
@@ -22,11 +22,62 @@
 #include "imstkTetrahedralMesh.h"
 #include "imstkLogger.h"
 #include "imstkParallelUtils.h"
+#include "imstkReordering.h"
 #include "imstkGeometryUtilities.h"
 #include "imstkSurfaceMesh.h"
 
 namespace imstk
 {
+namespace
+{
+///
+/// \brief Clip a ray against the four face planes of the tetrahedron abcd
+/// \return True if the ray is inside the tetrahedron for some t in [0, maxT], t is set to the entry parameter
+///
+bool
+rayIntersectsTetrahedron(const Vec3d& origin, const Vec3d& direction, const Vec3d& a, const Vec3d& b, const Vec3d& c, const Vec3d& d,
+                         const double maxT, double& t)
+{
+    const Vec3d* const vertices[4] = { &a, &b, &c, &d };
+    double             tEntry      = 0.0;
+    double             tExit       = maxT;
+    for (int i = 0; i < 4; ++i)
+    {
+        // Face opposite to vertex i, with its normal pointing away from vertex i
+        const Vec3d& p0 = *vertices[(i + 1) % 4];
+        const Vec3d& p1 = *vertices[(i + 2) % 4];
+        const Vec3d& p2 = *vertices[(i + 3) % 4];
+        Vec3d        n  = (p1 - p0).cross(p2 - p0);
+        if (n.dot(*vertices[i] - p0) > 0.0)
+        {
+            n = -n;
+        }
+
+        // Inside the half space for t * denom <= num
+        const double num   = n.dot(p0 - origin);
+        const double denom = n.dot(direction);
+        if (denom > 0.0)
+        {
+            tExit = std::min(tExit, num / denom);
+        }
+        else if (denom < 0.0)
+        {
+            tEntry = std::max(tEntry, num / denom);
+        }
+        else if (num < 0.0)
+        {
+            return false;
+        }
+        if (tEntry > tExit)
+        {
+            return false;
+        }
+    }
+    t = tEntry;
+    return true;
+}
+}
+
 TetrahedralMesh::TetrahedralMesh(const std::string& name) : VolumetricMesh(name),
     m_tetrahedraIndices(std::make_shared<VecDataArray<int, 4>>())
 {
@@ -47,6 +98,15 @@ TetrahedralMesh::clear()
 {
     PointSet::clear();
     m_tetrahedraIndices->clear();
+    m_tetrahedraBVH.clear();
+}
+
+void
+TetrahedralMesh::reorderVertices(const std::vector<size_t>& newToOld)
+{
+    PointSet::reorderVertices(newToOld);
+    Reordering::renumberCells(*m_tetrahedraIndices, Reordering::invertPermutation(newToOld));
+    m_tetrahedraBVH.clear();
 }
 
 void
@@ -288,4 +348,97 @@ TetrahedralMesh::getNumTetrahedra() const
 {
     return m_tetrahedraIndices->size();
 }
+
+void
+TetrahedralMesh::updateBoundingVolumeHierarchy()
+{
+    std::vector<Vec3d> lowerCorners(getNumTetrahedra());
+    std::vector<Vec3d> upperCorners(getNumTetrahedra());
+    ParallelUtils::parallelFor(lowerCorners.size(), [&](const size_t tetId) {
+            computeTetrahedronBoundingBox(tetId, lowerCorners[tetId], upperCorners[tetId]);
+        });
+
+    // Refitting is only valid when the tetrahedra are the ones the hierarchy was built from
+    const VecDataArray<int, 4>& tetrahedra = *m_tetrahedraIndices;
+    const int*                  indices    = tetrahedra.size() > 0 ? tetrahedra[0].data() : nullptr;
+    const size_t                numIndices = static_cast<size_t>(tetrahedra.size()) * 4;
+    if (m_tetrahedraBVH.getNumBoxes() == lowerCorners.size() && !lowerCorners.empty()
+        && m_tetrahedraBVHIndices.size() == numIndices
+        && std::equal(indices, indices + numIndices, m_tetrahedraBVHIndices.begin()))
+    {
+        m_tetrahedraBVH.refit(lowerCorners, upperCorners);
+    }
+    else
+    {
+        m_tetrahedraBVH.build(lowerCorners, upperCorners);
+        m_tetrahedraBVHIndices.assign(indices, indices + numIndices);
+    }
+}
+
+int
+TetrahedralMesh::castRay(const Vec3d& origin, const Vec3d& direction, const double maxT, double& t) const
+{
+    CHECK(m_tetrahedraBVH.getNumBoxes() == static_cast<size_t>(getNumTetrahedra()))
+        << "Bounding volume hierarchy is out of date, call updateBoundingVolumeHierarchy first";
+
+    const VecDataArray<double, 3>& vertices     = *m_vertexPositions;
+    const VecDataArray<int, 4>&    tetraIndices = *m_tetrahedraIndices;
+    auto                           isRemoved    = [&](const size_t id) { return id < m_removedMeshElems.size() && m_removedMeshElems[id]; };
+
+    int tetId = -1;
+    t = maxT;
+    m_tetrahedraBVH.castRay(origin, direction, t,
+        [&](const size_t id, double& tMax)
+        {
+            const Vec4i& tet  = tetraIndices[id];
+            double       tHit = 0.0;
+            if (!isRemoved(id)
+                && rayIntersectsTetrahedron(origin, direction, vertices[tet[0]], vertices[tet[1]], vertices[tet[2]], vertices[tet[3]], tMax, tHit))
+            {
+                tMax  = tHit;
+                tetId = static_cast<int>(id);
+            }
+        });
+    return tetId;
+}
+
+void
+TetrahedralMesh::castRayAllHits(const Vec3d& origin, const Vec3d& direction, const double maxT, std::vector<std::pair<int, double>>& hits) const
+{
+    CHECK(m_tetrahedraBVH.getNumBoxes() == static_cast<size_t>(getNumTetrahedra()))
+        << "Bounding volume hierarchy is out of date, call updateBoundingVolumeHierarchy first";
+
+    const VecDataArray<double, 3>& vertices     = *m_vertexPositions;
+    const VecDataArray<int, 4>&    tetraIndices = *m_tetrahedraIndices;
+    auto                           isRemoved    = [&](const size_t id) { return id < m_removedMeshElems.size() && m_removedMeshElems[id]; };
+
+    hits.resize(0);
+    double tMax = maxT;
+    m_tetrahedraBVH.castRay(origin, direction, tMax,
+        [&](const size_t id, double&)
+        {
+            const Vec4i& tet  = tetraIndices[id];
+            double       tHit = 0.0;
+            if (!isRemoved(id)
+                && rayIntersectsTetrahedron(origin, direction, vertices[tet[0]], vertices[tet[1]], vertices[tet[2]], vertices[tet[3]], maxT, tHit))
+            {
+                hits.push_back(std::make_pair(static_cast<int>(id), tHit));
+            }
+        });
+    std::sort(hits.begin(), hits.end(),
+        [](const std::pair<int, double>& a, const std::pair<int, double>& b) { return a.second < b.second; });
+}
+
+void
+TetrahedralMesh::castRays(const VecDataArray<double, 3>& origins, const VecDataArray<double, 3>& directions, const double maxT,
+                          std::vector<int>& tetrahedronIds, std::vector<double>& ts) const
+{
+    CHECK(origins.size() == directions.size()) << "Number of ray origins and directions differ";
+
+    tetrahedronIds.resize(origins.size());
+    ts.resize(origins.size());
+    ParallelUtils::parallelFor(origins.size(), [&](const size_t rayId) {
+            tetrahedronIds[rayId] = castRay(origins[rayId], directions[rayId], maxT, ts[rayId]);
+        });
+}
 }  // namespace imstk
@@ -21,6 +21,7 @@
 
 #pragma once
 
+#include "imstkAABBTree.h"
 #include "imstkVolumetricMesh.h"
 
 #include <array>
@@ -85,11 +86,43 @@ public:
     ///
     void computeTetrahedronBoundingBox(const size_t& tetId, Vec3d& min, Vec3d& max) const;
 
+    ///
+    /// \brief Reorder the vertices and renumber the tetrahedra, see PointSet::reorderVertices
+    ///
+    void reorderVertices(const std::vector<size_t>& newToOld) override;
+
     ///
     /// \brief Returns true if the geometry is a mesh, else returns false
     ///
     bool isMesh() const override { return true; }
 
+    ///
+    /// \brief Build the bounding volume hierarchy of the tetrahedrons used by the ray casts from the
+    /// current vertex positions, or refit it if the tetrahedrons did not change.
+    /// Call it after the mesh moved and before casting rays
+    ///
+    void updateBoundingVolumeHierarchy();
+
+    ///
+    /// \brief Cast the ray origin + t * direction, t in [0, maxT], and find the first tetrahedron hit.
+    /// A segment [a, b] is cast with direction b - a and maxT 1
+    /// \param t Parameter of the hit, 0 if the origin lies inside the tetrahedron
+    /// \return Index of the tetrahedron hit, -1 if none
+    ///
+    int castRay(const Vec3d& origin, const Vec3d& direction, const double maxT, double& t) const;
+
+    ///
+    /// \brief Cast the ray origin + t * direction, t in [0, maxT], and find all the tetrahedrons hit
+    /// \param hits Indices and hit parameters of the tetrahedrons, sorted by increasing parameter
+    ///
+    void castRayAllHits(const Vec3d& origin, const Vec3d& direction, const double maxT, std::vector<std::pair<int, double>>& hits) const;
+
+    ///
+    /// \brief Cast rays in parallel and find the first tetrahedron hit by each, see castRay
+    ///
+    void castRays(const VecDataArray<double, 3>& origins, const VecDataArray<double, 3>& directions, const double maxT,
+                  std::vector<int>& tetrahedronIds, std::vector<double>& ts) const;
+
 // Accessors
 public:
     ///
@@ -128,5 +161,8 @@ protected:
     std::shared_ptr<VecDataArray<int, 4>> m_tetrahedraIndices;
 
     std::vector<bool> m_removedMeshElems;
+
+    AABBTree         m_tetrahedraBVH;        ///> Bounding volume hierarchy of the tetrahedra for ray casts
+    std::vector<int> m_tetrahedraBVHIndices; ///> Tetrahedra indices the hierarchy was built from
 };
 }
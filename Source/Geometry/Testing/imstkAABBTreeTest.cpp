@@ -0,0 +1,74 @@
+/*=========================================================================
+
+   Library: iMSTK
+
+   Copyright (c) Kitware, Inc. & Center for Modeling, Simulation,
+   & Imaging in Medicine, Rensselaer Polytechnic Institute.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+=========================================================================*/
+
+#include "gtest/gtest.h"
+
+#include "imstkAABBTree.h"
+
+#include <algorithm>
+
+using namespace imstk;
+
+///
+/// \brief Compare point containment queries against brute force
+///
+TEST(imstkAABBTreeTest, CompareWithBruteForce)
+{
+    auto randD = [] { return static_cast<double>(rand()) / static_cast<double>(RAND_MAX) * 2.0 - 1.0; };
+
+    std::vector<Vec3d> lowerCorners;
+    std::vector<Vec3d> upperCorners;
+    for (int i = 0; i < 2000; ++i)
+    {
+        const Vec3d center(randD(), randD(), randD());
+        const Vec3d halfSize = Vec3d(randD() + 1.0, randD() + 1.0, randD() + 1.0) * 0.1;
+        lowerCorners.push_back(center - halfSize);
+        upperCorners.push_back(center + halfSize);
+    }
+
+    AABBTree tree;
+    tree.build(lowerCorners, upperCorners);
+    EXPECT_EQ(tree.getNumBoxes(), 2000);
+
+    std::vector<size_t> result;
+    for (int iter = 0; iter < 100; ++iter)
+    {
+        const Vec3d pos(randD(), randD(), randD());
+
+        std::vector<size_t> expected;
+        for (size_t i = 0; i < lowerCorners.size(); ++i)
+        {
+            if ((pos.array() >= lowerCorners[i].array()).all() && (pos.array() <= upperCorners[i].array()).all())
+            {
+                expected.push_back(i);
+            }
+        }
+
+        tree.getBoxesContainingPoint(result, pos);
+        std::sort(result.begin(), result.end());
+        EXPECT_EQ(result, expected);
+
+        // Only accept the box with the largest ID
+        const size_t boxId = tree.findBoxContainingPoint(pos,
+            [&](const size_t id) { return !expected.empty() && id == expected.back(); });
+        EXPECT_EQ(boxId, expected.empty() ? std::numeric_limits<size_t>::max() : expected.back());
+    }
+}
@@ -0,0 +1,154 @@
+/*=========================================================================
+
+   Library: iMSTK
+
+   Copyright (c) Kitware, Inc. & Center for Modeling, Simulation,
+   & Imaging in Medicine, Rensselaer Polytechnic Institute.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+=========================================================================*/
+
+#include "gtest/gtest.h"
+
+#include "imstkReordering.h"
+#include "imstkTetrahedralMesh.h"
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+
+using namespace imstk;
+
+namespace
+{
+bool
+isPermutation(std::vector<size_t> order, const size_t size)
+{
+    std::sort(order.begin(), order.end());
+    for (size_t i = 0; i < order.size(); ++i)
+    {
+        if (order[i] != i)
+        {
+            return false;
+        }
+    }
+    return order.size() == size;
+}
+}
+
+///
+/// \brief Hilbert order of a shuffled 8x8x8 grid visits the grid points in unit steps
+///
+TEST(imstkReorderingTest, SpaceFillingCurves)
+{
+    std::vector<Vec3d> gridPoints;
+    for (int k = 0; k < 8; ++k)
+    {
+        for (int j = 0; j < 8; ++j)
+        {
+            for (int i = 0; i < 8; ++i)
+            {
+                gridPoints.push_back(Vec3d(i, j, k));
+            }
+        }
+    }
+    std::shuffle(gridPoints.begin(), gridPoints.end(), std::mt19937(0));
+    VecDataArray<double, 3> points(static_cast<int>(gridPoints.size()));
+    for (size_t i = 0; i < gridPoints.size(); ++i)
+    {
+        points[i] = gridPoints[i];
+    }
+
+    const std::vector<size_t> mortonOrder = Reordering::computeMortonOrder(points);
+    EXPECT_TRUE(isPermutation(mortonOrder, gridPoints.size()));
+
+    const std::vector<size_t> hilbertOrder = Reordering::computeHilbertOrder(points);
+    ASSERT_TRUE(isPermutation(hilbertOrder, gridPoints.size()));
+    for (size_t i = 1; i < hilbertOrder.size(); ++i)
+    {
+        EXPECT_DOUBLE_EQ((points[hilbertOrder[i]] - points[hilbertOrder[i - 1]]).norm(), 1.0);
+    }
+
+    const std::vector<size_t> oldToNew = Reordering::invertPermutation(hilbertOrder);
+    for (size_t i = 0; i < hilbertOrder.size(); ++i)
+    {
+        EXPECT_EQ(oldToNew[hilbertOrder[i]], i);
+    }
+}
+
+///
+/// \brief Reverse Cuthill-McKee recovers bandwidth one for a shuffled chain of segments
+///
+TEST(imstkReorderingTest, ReverseCuthillMcKee)
+{
+    const int           numVertices = 100;
+    std::vector<size_t> labels(numVertices);
+    std::iota(labels.begin(), labels.end(), 0);
+    std::shuffle(labels.begin(), labels.end(), std::mt19937(0));
+
+    VecDataArray<int, 2> segments;
+    for (int i = 0; i < numVertices - 1; ++i)
+    {
+        segments.push_back(Vec2i(static_cast<int>(labels[i]), static_cast<int>(labels[i + 1])));
+    }
+
+    const std::vector<size_t> newToOld = Reordering::computeReverseCuthillMcKeeOrder(numVertices, segments);
+    ASSERT_TRUE(isPermutation(newToOld, numVertices));
+
+    Reordering::renumberCells(segments, Reordering::invertPermutation(newToOld));
+    for (const Vec2i& segment : segments)
+    {
+        EXPECT_EQ(std::abs(segment[0] - segment[1]), 1);
+    }
+}
+
+///
+/// \brief Reordering the vertices of a mesh keeps its cells and attributes
+///
+TEST(imstkReorderingTest, ReorderTetrahedralMesh)
+{
+    auto vertices = std::make_shared<VecDataArray<double, 3>>();
+    auto tets     = std::make_shared<VecDataArray<int, 4>>();
+    vertices->push_back(Vec3d(0.0, 0.0, 0.0));
+    vertices->push_back(Vec3d(1.0, 0.0, 0.0));
+    vertices->push_back(Vec3d(0.0, 1.0, 0.0));
+    vertices->push_back(Vec3d(0.0, 0.0, 1.0));
+    vertices->push_back(Vec3d(1.0, 1.0, 1.0));
+    tets->push_back(Vec4i(0, 2, 1, 3));
+    tets->push_back(Vec4i(2, 1, 3, 4));
+
+    TetrahedralMesh mesh;
+    mesh.initialize(vertices, tets);
+    auto ids = std::make_shared<DataArray<int>>(5);
+    for (int i = 0; i < 5; ++i)
+    {
+        (*ids)[i] = i;
+    }
+    mesh.setVertexAttribute("ids", ids);
+    const double volume = mesh.getVolume();
+
+    const std::vector<size_t> newToOld = { 4, 2, 0, 3, 1 };
+    mesh.reorderVertices(newToOld);
+
+    EXPECT_NEAR(mesh.getVolume(), volume, 1.0e-12);
+    const VecDataArray<double, 3>& positions = *mesh.getVertexPositions();
+    const VecDataArray<int, 4>&    cells     = *mesh.getTetrahedraIndices();
+    EXPECT_EQ(positions[0], Vec3d(1.0, 1.0, 1.0));
+    EXPECT_EQ(cells[0], Vec4i(2, 1, 4, 3));
+    EXPECT_EQ(cells[1], Vec4i(1, 4, 3, 0));
+    for (int i = 0; i < 5; ++i)
+    {
+        EXPECT_EQ((*ids)[i], static_cast<int>(newToOld[i]));
+    }
+}
@@ -0,0 +1,100 @@
+/*=========================================================================
+
+   Library: iMSTK
+
+   Copyright (c) Kitware, Inc. & Center for Modeling, Simulation,
+   & Imaging in Medicine, Rensselaer Polytechnic Institute.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+=========================================================================*/
+
+#include "imstkDataArray.h"
+#include "imstkImageData.h"
+#include "imstkSparseSignedDistanceField.h"
+
+#include <gtest/gtest.h>
+
+using namespace imstk;
+
+namespace
+{
+///
+/// \brief Creates a dense signed distance image of a sphere at the origin
+///
+std::shared_ptr<ImageData>
+createSphereSdfImage(const int dim, const double radius)
+{
+    auto         image   = std::make_shared<ImageData>();
+    const double size    = 4.0 * radius;
+    const Vec3d  spacing = Vec3d(size, size, size) / dim;
+    const Vec3d  origin  = Vec3d(-0.5 * size, -0.5 * size, -0.5 * size);
+    image->allocate(IMSTK_DOUBLE, 1, Vec3i(dim, dim, dim), spacing, origin);
+
+    DataArray<double>& scalars = *std::dynamic_pointer_cast<DataArray<double>>(image->getScalars());
+    const Vec3d        shift   = origin + spacing * 0.5;
+    int                i       = 0;
+    for (int z = 0; z < dim; z++)
+    {
+        for (int y = 0; y < dim; y++)
+        {
+            for (int x = 0; x < dim; x++, i++)
+            {
+                const Vec3d pos = Vec3i(x, y, z).cast<double>().cwiseProduct(spacing) + shift;
+                scalars[i] = pos.norm() - radius;
+            }
+        }
+    }
+    return image;
+}
+}
+
+///
+/// \brief Tests that the sparse field matches the dense field within the band
+///
+TEST(imstkSparseSignedDistanceFieldTest, FunctionValue)
+{
+    const double               radius = 1.0;
+    std::shared_ptr<ImageData> image  = createSphereSdfImage(64, radius);
+    const double               band   = image->getSpacing()[0] * 3.0;
+    SparseSignedDistanceField  sdf(image, band);
+
+    // Only tiles near the surface store samples
+    EXPECT_GT(sdf.getNumberOfTiles(), 0);
+    EXPECT_LT(sdf.getNumberOfTiles(), 8 * 8 * 8);
+
+    // Near the surface values are interpolated
+    const double tol = image->getSpacing()[0] * 0.1;
+    EXPECT_NEAR(0.0, sdf.getFunctionValue(Vec3d(radius, 0.0, 0.0)), tol);
+    EXPECT_NEAR(band * 0.5, sdf.getFunctionValue(Vec3d(0.0, radius + band * 0.5, 0.0)), tol);
+    EXPECT_NEAR(-band * 0.5, sdf.getFunctionValue(Vec3d(0.0, 0.0, -radius + band * 0.5)), tol);
+
+    // Outside the band the background value is returned with the correct sign
+    EXPECT_DOUBLE_EQ(-band, sdf.getFunctionValue(Vec3d(0.0, 0.0, 0.0)));
+    EXPECT_DOUBLE_EQ(band, sdf.getFunctionValue(Vec3d(1.8, 1.8, 1.8)));
+
+    // Outside the bounds
+    EXPECT_DOUBLE_EQ(IMSTK_DOUBLE_MAX, sdf.getFunctionValue(Vec3d(5.0, 0.0, 0.0)));
+}
+
+///
+/// \brief Tests the scale is applied to the samples
+///
+TEST(imstkSparseSignedDistanceFieldTest, Scale)
+{
+    std::shared_ptr<ImageData> image = createSphereSdfImage(32, 1.0);
+    SparseSignedDistanceField  sdf(image, 0.5);
+    const double               val = sdf.getFunctionValue(Vec3d(1.1, 0.0, 0.0));
+    sdf.setScale(2.0);
+    EXPECT_DOUBLE_EQ(val * 2.0, sdf.getFunctionValue(Vec3d(1.1, 0.0, 0.0)));
+}
@@ -260,3 +260,88 @@ TEST(imstkSurfaceMeshTest, GetVolume)
 
     EXPECT_DOUBLE_EQ(8.0, cubeSurfMesh->getVolume());
 }
+
+///
+/// \brief Compare ray casts against brute force, before and after moving the mesh
+///
+TEST(imstkSurfaceMeshTest, CastRay)
+{
+    auto randD = [] { return static_cast<double>(rand()) / static_cast<double>(RAND_MAX); };
+
+    auto verticesPtr = std::make_shared<VecDataArray<double, 3>>();
+    auto indicesPtr  = std::make_shared<VecDataArray<int, 3>>();
+    for (int i = 0; i < 500; ++i)
+    {
+        const Vec3d center(randD(), randD(), randD());
+        for (int j = 0; j < 3; ++j)
+        {
+            verticesPtr->push_back(center + Vec3d(randD(), randD(), randD()) * 0.1);
+        }
+        indicesPtr->push_back(Vec3i(3 * i, 3 * i + 1, 3 * i + 2));
+    }
+    SurfaceMesh surfMesh;
+    surfMesh.initialize(verticesPtr, indicesPtr);
+
+    for (int iter = 0; iter < 3; ++iter)
+    {
+        surfMesh.updateBoundingVolumeHierarchy();
+        for (int rayId = 0; rayId < 50; ++rayId)
+        {
+            const Vec3d origin(-0.5, randD(), randD());
+            const Vec3d direction = Vec3d(2.0, randD() - 0.5, randD() - 0.5);
+
+            // Brute force by intersecting the planes of the triangles
+            std::vector<double> expected;
+            for (int triId = 0; triId < surfMesh.getNumTriangles(); ++triId)
+            {
+                const Vec3i& tri = surfMesh.getTriangleIndices(triId);
+                const Vec3d  a   = surfMesh.getVertexPosition(tri[0]);
+                const Vec3d  b   = surfMesh.getVertexPosition(tri[1]);
+                const Vec3d  c   = surfMesh.getVertexPosition(tri[2]);
+                const Vec3d  n   = (b - a).cross(c - a);
+                const double t   = n.dot(a - origin) / n.dot(direction);
+                const Vec3d  p   = origin + direction * t;
+                if (t >= 0.0 && t <= 1.0 && n.dot((b - a).cross(p - a)) >= 0.0
+                    && n.dot((c - b).cross(p - b)) >= 0.0 && n.dot((a - c).cross(p - c)) >= 0.0)
+                {
+                    expected.push_back(t);
+                }
+            }
+            std::sort(expected.begin(), expected.end());
+
+            double    t     = 0.0;
+            const int triId = surfMesh.castRay(origin, direction, 1.0, t);
+            EXPECT_EQ(triId == -1, expected.empty());
+            if (!expected.empty())
+            {
+                EXPECT_NEAR(t, expected.front(), 1.0e-10);
+            }
+
+            std::vector<std::pair<int, double>> hits;
+            surfMesh.castRayAllHits(origin, direction, 1.0, hits);
+            ASSERT_EQ(hits.size(), expected.size());
+            for (size_t i = 0; i < hits.size(); ++i)
+            {
+                EXPECT_NEAR(hits[i].second, expected[i], 1.0e-10);
+            }
+        }
+
+        if (iter == 0)
+        {
+            // Move the triangles such that the hierarchy is refit
+            for (int i = 0; i < surfMesh.getNumVertices(); ++i)
+            {
+                surfMesh.setVertexPosition(i, surfMesh.getVertexPosition(i) * 0.8 + Vec3d(0.0, 0.1, 0.1));
+            }
+        }
+        else
+        {
+            // Reconnect the vertices keeping the number of triangles, the hierarchy must be rebuilt
+            VecDataArray<int, 3>& indices = *surfMesh.getTriangleIndices();
+            for (int i = 0; i < indices.size(); ++i)
+            {
+                indices[i] = Vec3i(3 * i, 3 * ((i + 1) % indices.size()) + 1, 3 * ((i + 7) % indices.size()) + 2);
+            }
+        }
+    }
+}
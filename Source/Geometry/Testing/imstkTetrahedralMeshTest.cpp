@@ -119,3 +119,81 @@ TEST(imstkTetrahedralMeshTest, GetVolume)
     tetMesh.initialize(verticesPtr, indicesPtr);
     EXPECT_NEAR(expectedVolume, tetMesh.getVolume(), 0.000001);
 }
+
+///
+/// \brief Test ray casts against a cube
+///
+TEST(imstkTetrahedralMeshTest, CastRay)
+{
+    TetrahedralMesh tetMesh;
+
+    // Setup a cube
+    //    0-------1
+    //   /|      /|
+    //  / |     / |
+    // 3--|----2  |
+    // |  4----|--5    +y +z
+    // | /     | /     | /
+    // 7-------6       |/__+x
+    {
+        auto verticesPtr = std::make_shared<VecDataArray<double, 3>>(8);
+        auto indicesPtr  = std::make_shared<VecDataArray<int, 4>>(5);
+
+        VecDataArray<double, 3>& vertices = *verticesPtr;
+        VecDataArray<int, 4>&    indices  = *indicesPtr;
+
+        vertices[0] = Vec3d(-0.5, 0.5, 0.5);
+        vertices[1] = Vec3d(0.5, 0.5, 0.5);
+        vertices[2] = Vec3d(0.5, 0.5, -0.5);
+        vertices[3] = Vec3d(-0.5, 0.5, -0.5);
+        vertices[4] = Vec3d(-0.5, -0.5, 0.5);
+        vertices[5] = Vec3d(0.5, -0.5, 0.5);
+        vertices[6] = Vec3d(0.5, -0.5, -0.5);
+        vertices[7] = Vec3d(-0.5, -0.5, -0.5);
+
+        indices[0] = Vec4i(0, 7, 5, 4);
+        indices[1] = Vec4i(3, 7, 2, 0);
+        indices[2] = Vec4i(2, 7, 5, 0);
+        indices[3] = Vec4i(1, 2, 0, 5);
+        indices[4] = Vec4i(2, 6, 7, 5);
+
+        tetMesh.initialize(verticesPtr, indicesPtr);
+    }
+
+    tetMesh.updateBoundingVolumeHierarchy();
+
+    // Enters the cube on its -x face
+    double t     = 0.0;
+    int    tetId = tetMesh.castRay(Vec3d(-2.0, 0.1, 0.2), Vec3d(1.0, 0.0, 0.0), 10.0, t);
+    EXPECT_NE(tetId, -1);
+    EXPECT_NEAR(t, 1.5, 1.0e-12);
+    EXPECT_GE(tetMesh.computeBarycentricWeights(tetId, Vec3d(-0.5 + 1.0e-6, 0.1, 0.2)).minCoeff(), 0.0);
+
+    // Starts inside the cube
+    tetId = tetMesh.castRay(Vec3d(0.1, 0.1, 0.1), Vec3d(0.0, 1.0, 0.0), 10.0, t);
+    EXPECT_NE(tetId, -1);
+    EXPECT_EQ(t, 0.0);
+
+    // Segment stopping short of the cube, and ray missing the cube
+    EXPECT_EQ(tetMesh.castRay(Vec3d(-2.0, 0.1, 0.2), Vec3d(1.0, 0.0, 0.0), 1.0, t), -1);
+    EXPECT_EQ(tetMesh.castRay(Vec3d(-2.0, 0.1, 0.2), Vec3d(0.0, 1.0, 0.0), 10.0, t), -1);
+
+    // Crossing the whole cube goes through at least two tetrahedra, entry parameters are sorted
+    std::vector<std::pair<int, double>> hits;
+    tetMesh.castRayAllHits(Vec3d(-2.0, 0.1, 0.2), Vec3d(1.0, 0.0, 0.0), 10.0, hits);
+    ASSERT_GE(hits.size(), 2);
+    EXPECT_NEAR(hits.front().second, 1.5, 1.0e-12);
+    for (size_t i = 1; i < hits.size(); ++i)
+    {
+        EXPECT_LE(hits[i - 1].second, hits[i].second);
+    }
+    // Reconnect keeping the number of tetrahedra, only the corner at vertex 4 stays covered
+    VecDataArray<int, 4>& indices = *tetMesh.getTetrahedraIndices();
+    for (int i = 0; i < indices.size(); ++i)
+    {
+        indices[i] = Vec4i(0, 7, 5, 4);
+    }
+    tetMesh.updateBoundingVolumeHierarchy();
+    EXPECT_EQ(tetMesh.castRay(Vec3d(0.4, 0.4, 0.4), Vec3d(0.0, 1.0, 0.0), 10.0, t), -1);
+    EXPECT_NE(tetMesh.castRay(Vec3d(-0.4, -0.4, 0.4), Vec3d(0.0, 1.0, 0.0), 10.0, t), -1);
+}
@@ -0,0 +1,156 @@
+/*=========================================================================
+
+   Library: iMSTK
+
+   Copyright (c) Kitware, Inc. & Center for Modeling, Simulation,
+   & Imaging in Medicine, Rensselaer Polytechnic Institute.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+=========================================================================*/
+
+#include "imstkAABBTree.h"
+#include "imstkLogger.h"
+#include "imstkTypes.h"
+
+#include <algorithm>
+
+namespace imstk
+{
+AABBTree::AABBTree(const uint32_t maxLeafSize) : m_MaxLeafSize(maxLeafSize)
+{
+    CHECK(maxLeafSize > 0) << "Invalid leaf size";
+}
+
+void
+AABBTree::build(const std::vector<Vec3d>& lowerCorners, const std::vector<Vec3d>& upperCorners)
+{
+    CHECK(lowerCorners.size() == upperCorners.size()) << "Number of lower and upper corners differ";
+
+    clear();
+    if (lowerCorners.empty())
+    {
+        return;
+    }
+
+    m_LowerCorners = lowerCorners;
+    m_UpperCorners = upperCorners;
+    m_BoxIds.resize(lowerCorners.size());
+    for (size_t i = 0; i < m_BoxIds.size(); ++i)
+    {
+        m_BoxIds[i] = static_cast<uint32_t>(i);
+    }
+    m_Nodes.reserve(2 * (m_BoxIds.size() / m_MaxLeafSize + 1));
+    buildNode(0, static_cast<uint32_t>(m_BoxIds.size()));
+}
+
+uint32_t
+AABBTree::buildNode(const uint32_t begin, const uint32_t end)
+{
+    const auto nodeIdx = static_cast<uint32_t>(m_Nodes.size());
+    m_Nodes.push_back(Node());
+    m_Nodes[nodeIdx].begin = begin;
+    m_Nodes[nodeIdx].end   = end;
+    m_Nodes[nodeIdx].right = 0;
+
+    Vec3d lowerCorner       = Vec3d::Constant(IMSTK_DOUBLE_MAX);
+    Vec3d upperCorner       = Vec3d::Constant(-IMSTK_DOUBLE_MAX);
+    Vec3d centerLowerCorner = Vec3d::Constant(IMSTK_DOUBLE_MAX);
+    Vec3d centerUpperCorner = Vec3d::Constant(-IMSTK_DOUBLE_MAX);
+    for (uint32_t i = begin; i < end; ++i)
+    {
+        const uint32_t boxId  = m_BoxIds[i];
+        const Vec3d    center = (m_LowerCorners[boxId] + m_UpperCorners[boxId]) * 0.5;
+        lowerCorner       = lowerCorner.cwiseMin(m_LowerCorners[boxId]);
+        upperCorner       = upperCorner.cwiseMax(m_UpperCorners[boxId]);
+        centerLowerCorner = centerLowerCorner.cwiseMin(center);
+        centerUpperCorner = centerUpperCorner.cwiseMax(center);
+    }
+    m_Nodes[nodeIdx].lowerCorner = lowerCorner;
+    m_Nodes[nodeIdx].upperCorner = upperCorner;
+
+    if (end - begin <= m_MaxLeafSize)
+    {
+        return nodeIdx;
+    }
+
+    // Median split of the box centers along their largest extent
+    int axis;
+    (centerUpperCorner - centerLowerCorner).maxCoeff(&axis);
+    const uint32_t mid = begin + (end - begin) / 2;
+    std::nth_element(m_BoxIds.begin() + begin, m_BoxIds.begin() + mid, m_BoxIds.begin() + end,
+        [&](const uint32_t a, const uint32_t b)
+        {
+            return m_LowerCorners[a][axis] + m_UpperCorners[a][axis] < m_LowerCorners[b][axis] + m_UpperCorners[b][axis];
+        });
+
+    buildNode(begin, mid);
+    const uint32_t right = buildNode(mid, end);
+    m_Nodes[nodeIdx].right = right;
+    return nodeIdx;
+}
+
+void
+AABBTree::refit(const std::vector<Vec3d>& lowerCorners, const std::vector<Vec3d>& upperCorners)
+{
+    CHECK(lowerCorners.size() == m_LowerCorners.size() && upperCorners.size() == m_UpperCorners.size())
+        << "Number of boxes differs from the tree, it must be rebuilt";
+
+    m_LowerCorners = lowerCorners;
+    m_UpperCorners = upperCorners;
+
+    // Children follow their parent in depth first order, so a reverse sweep updates them first
+    for (size_t nodeIdx = m_Nodes.size(); nodeIdx-- > 0;)
+    {
+        Node& node = m_Nodes[nodeIdx];
+        if (node.right == 0)
+        {
+            node.lowerCorner = Vec3d::Constant(IMSTK_DOUBLE_MAX);
+            node.upperCorner = Vec3d::Constant(-IMSTK_DOUBLE_MAX);
+            for (uint32_t i = node.begin; i < node.end; ++i)
+            {
+                node.lowerCorner = node.lowerCorner.cwiseMin(m_LowerCorners[m_BoxIds[i]]);
+                node.upperCorner = node.upperCorner.cwiseMax(m_UpperCorners[m_BoxIds[i]]);
+            }
+        }
+        else
+        {
+            const Node& left  = m_Nodes[nodeIdx + 1];
+            const Node& right = m_Nodes[node.right];
+            node.lowerCorner = left.lowerCorner.cwiseMin(right.lowerCorner);
+            node.upperCorner = left.upperCorner.cwiseMax(right.upperCorner);
+        }
+    }
+}
+
+void
+AABBTree::clear()
+{
+    m_Nodes.resize(0);
+    m_LowerCorners.resize(0);
+    m_UpperCorners.resize(0);
+    m_BoxIds.resize(0);
+}
+
+void
+AABBTree::getBoxesContainingPoint(std::vector<size_t>& result, const Vec3d& pos) const
+{
+    result.resize(0);
+    findBoxContainingPoint(pos,
+        [&](const size_t boxId)
+        {
+            result.push_back(boxId);
+            return false;
+        });
+}
+}
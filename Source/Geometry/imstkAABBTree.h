@@ -0,0 +1,209 @@
+/*=========================================================================
+
+   Library: iMSTK
+
+   Copyright (c) Kitware, Inc. & Center for Modeling, Simulation,
+   & Imaging in Medicine, Rensselaer Polytechnic Institute.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+=========================================================================*/
+
+#pragma once
+
+#include "imstkMath.h"
+#include "imstkSpatialQueryUtils.h"
+
+namespace imstk
+{
+///
+/// \class AABBTree
+///
+/// \brief Bounding volume hierarchy over a set of axis aligned boxes
+/// The tree is built by median splits of the box centers along the largest extent,
+/// boxes are referenced contiguously in tree order so that each leaf is a single range.
+/// Refit it when the boxes move, rebuild it when they move a lot or their number changes
+///
+class AABBTree
+{
+public:
+    ///
+    /// \brief Constructor
+    /// \param maxLeafSize Maximum number of boxes in a leaf node
+    ///
+    explicit AABBTree(const uint32_t maxLeafSize = 4);
+
+    ///
+    /// \brief Build the tree from arrays of box corners, box IDs are their indices in the arrays
+    ///
+    void build(const std::vector<Vec3d>& lowerCorners, const std::vector<Vec3d>& upperCorners);
+
+    ///
+    /// \brief Update the boxes and the bounds of the nodes, keeping the tree topology
+    ///
+    void refit(const std::vector<Vec3d>& lowerCorners, const std::vector<Vec3d>& upperCorners);
+
+    ///
+    /// \brief Clear the tree
+    ///
+    void clear();
+
+    ///
+    /// \brief Returns the number of boxes in the tree
+    ///
+    size_t getNumBoxes() const { return m_BoxIds.size(); }
+
+    ///
+    /// \brief Find IDs of all boxes containing a position
+    ///
+    void getBoxesContainingPoint(std::vector<size_t>& result, const Vec3d& pos) const;
+
+    ///
+    /// \brief Returns the ID of the first box containing pos for which pred(id) is true,
+    /// or the maximum size_t if none. Used to locate a point among elements by their bounding boxes
+    ///
+    template<typename Predicate>
+    size_t findBoxContainingPoint(const Vec3d& pos, Predicate&& pred) const
+    {
+        if (m_Nodes.empty())
+        {
+            return std::numeric_limits<size_t>::max();
+        }
+
+        uint32_t nodeStack[64];
+        uint32_t stackSize = 0;
+        nodeStack[stackSize++] = 0;
+        while (stackSize > 0) {
+            const uint32_t nodeIdx = nodeStack[--stackSize];
+            const Node&    node    = m_Nodes[nodeIdx];
+            if (!boxContains(node.lowerCorner, node.upperCorner, pos))
+            {
+                continue;
+            }
+
+            if (node.right == 0)
+            {
+                for (uint32_t i = node.begin; i < node.end; ++i)
+                {
+                    const uint32_t boxId = m_BoxIds[i];
+                    if (boxContains(m_LowerCorners[boxId], m_UpperCorners[boxId], pos) && pred(static_cast<size_t>(boxId)))
+                    {
+                        return boxId;
+                    }
+                }
+                continue;
+            }
+            nodeStack[stackSize++] = node.right;
+            nodeStack[stackSize++] = nodeIdx + 1;
+        }
+        return std::numeric_limits<size_t>::max();
+    }
+
+    ///
+    /// \brief Traverse the boxes hit by the ray origin + t * direction, t in [0, maxT], front to back.
+    /// intersect(id, maxT) is called for every box hit and may shrink maxT to the parameter of a
+    /// hit on the primitive of the box, which prunes the boxes behind it (first hit mode).
+    /// Leaving maxT unchanged visits all the boxes hit (all hits mode)
+    ///
+    template<typename Intersector>
+    void castRay(const Vec3d& origin, const Vec3d& direction, double& maxT, Intersector&& intersect) const
+    {
+        if (m_Nodes.empty())
+        {
+            return;
+        }
+
+        const Vec3d invDirection = direction.cwiseInverse();
+        double      tEntry       = 0.0;
+        if (!SpatialQueryUtils::rayIntersectsBox(origin, invDirection, m_Nodes[0].lowerCorner, m_Nodes[0].upperCorner, maxT, tEntry))
+        {
+            return;
+        }
+
+        std::pair<double, uint32_t> nodeStack[64];
+        uint32_t                    stackSize = 0;
+        nodeStack[stackSize++] = std::make_pair(tEntry, 0u);
+        while (stackSize > 0) {
+            const auto entry = nodeStack[--stackSize];
+            if (entry.first > maxT)
+            {
+                continue;
+            }
+
+            const Node& node = m_Nodes[entry.second];
+            if (node.right == 0)
+            {
+                for (uint32_t i = node.begin; i < node.end; ++i)
+                {
+                    const uint32_t boxId = m_BoxIds[i];
+                    if (SpatialQueryUtils::rayIntersectsBox(origin, invDirection, m_LowerCorners[boxId], m_UpperCorners[boxId], maxT, tEntry))
+                    {
+                        intersect(static_cast<size_t>(boxId), maxT);
+                    }
+                }
+                continue;
+            }
+
+            // Push the farther child first such that the nearer one is visited first
+            const uint32_t left = entry.second + 1;
+            double         tLeft, tRight;
+            const bool     hitLeft  = SpatialQueryUtils::rayIntersectsBox(origin, invDirection, m_Nodes[left].lowerCorner, m_Nodes[left].upperCorner, maxT, tLeft);
+            const bool     hitRight = SpatialQueryUtils::rayIntersectsBox(origin, invDirection, m_Nodes[node.right].lowerCorner, m_Nodes[node.right].upperCorner, maxT, tRight);
+            if (hitLeft && hitRight && tLeft < tRight)
+            {
+                nodeStack[stackSize++] = std::make_pair(tRight, node.right);
+                nodeStack[stackSize++] = std::make_pair(tLeft, left);
+            }
+            else
+            {
+                if (hitLeft)
+                {
+                    nodeStack[stackSize++] = std::make_pair(tLeft, left);
+                }
+                if (hitRight)
+                {
+                    nodeStack[stackSize++] = std::make_pair(tRight, node.right);
+                }
+            }
+        }
+    }
+
+protected:
+    ///
+    /// \brief Recursively build the subtree of the boxes in [begin, end), returns the node index
+    ///
+    uint32_t buildNode(const uint32_t begin, const uint32_t end);
+
+    static bool boxContains(const Vec3d& lowerCorner, const Vec3d& upperCorner, const Vec3d& pos)
+    {
+        return pos[0] >= lowerCorner[0] && pos[0] <= upperCorner[0]
+               && pos[1] >= lowerCorner[1] && pos[1] <= upperCorner[1]
+               && pos[2] >= lowerCorner[2] && pos[2] <= upperCorner[2];
+    }
+
+    struct Node
+    {
+        Vec3d lowerCorner;  ///> Lower corner of the union of the node's boxes
+        Vec3d upperCorner;  ///> Upper corner of the union of the node's boxes
+        uint32_t begin;     ///> First box of the node
+        uint32_t end;       ///> One past the last box of the node
+        uint32_t right;     ///> Index of the right child, the left child directly follows the node. Zero for leaves
+    };
+
+    uint32_t              m_MaxLeafSize;  ///> Maximum number of boxes in a leaf node
+    std::vector<Node>     m_Nodes;        ///> Nodes in depth first order, the root first
+    std::vector<Vec3d>    m_LowerCorners; ///> Lower corners of the boxes by ID
+    std::vector<Vec3d>    m_UpperCorners; ///> Upper corners of the boxes by ID
+    std::vector<uint32_t> m_BoxIds;       ///> IDs of the boxes in tree order
+};
+}
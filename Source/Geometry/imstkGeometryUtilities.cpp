@@ -1049,22 +1049,23 @@ RCM(const std::vector<NeighborContainer>& neighbors)
 {
     const size_t invalid = std::numeric_limits<size_t>::max();
 
-    // is greater in terms of degrees
-    auto isGreater = [&neighbors](const size_t i, const size_t j) {
-                         return neighbors[i].size() > neighbors[j].size() ? true : false;
+    // is smaller in terms of degrees
+    auto isSmaller = [&neighbors](const size_t i, const size_t j) {
+                         return neighbors[i].size() < neighbors[j].size();
                      };
 
     const size_t numVerts = neighbors.size();
 
+    // Each connected component starts from its vertex of lowest degree
     std::vector<size_t> P(numVerts);
     for (size_t i = 0; i < numVerts; ++i)
     {
         P[i] = i;
     }
-    std::sort(P.begin(), P.end(), isGreater);
+    std::stable_sort(P.begin(), P.end(), isSmaller);
 
     // \todo an alternative is to use std::set for P
-    // std::set<size_t, isGreater> P;
+    // std::set<size_t, isSmaller> P;
     // for (size_t i=0; i<numVerts; ++i)
     // {
     //     P.insert(i);
@@ -1109,13 +1110,11 @@ RCM(const std::vector<NeighborContainer>& neighbors)
     while (true)
     {
         size_t parent = invalid;
-        for (size_t vid = pCur; vid < isInP.size(); ++vid)
+        for (; pCur < P.size(); ++pCur)
         {
-            if (isInP[vid])
+            if (isInP[P[pCur]])
             {
-                isInP[vid] = false;
-                pCur       = vid;
-                parent     = vid;
+                parent = P[pCur];
                 break;
             }
         }
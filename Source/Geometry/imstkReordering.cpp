@@ -0,0 +1,252 @@
+/*=========================================================================
+
+   Library: iMSTK
+
+   Copyright (c) Kitware, Inc. & Center for Modeling, Simulation,
+   & Imaging in Medicine, Rensselaer Polytechnic Institute.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+=========================================================================*/
+
+#include "imstkReordering.h"
+#include "imstkAbstractDataArray.h"
+#include "imstkGeometryUtilities.h"
+#include "imstkLogger.h"
+#include "imstkParallelUtils.h"
+
+#include <tbb/parallel_sort.h>
+
+#include <cstring>
+#include <set>
+#include <unordered_set>
+
+namespace imstk
+{
+namespace Reordering
+{
+namespace
+{
+constexpr int CurveBits = 21; ///> Bits per axis of the curve codes, 63 bits in total
+
+///
+/// \brief Quantize the points on a 2^21 grid over their bounding box
+///
+std::vector<std::array<uint32_t, 3>>
+quantizePoints(const VecDataArray<double, 3>& points)
+{
+    Vec3d lowerCorner = Vec3d::Constant(IMSTK_DOUBLE_MAX);
+    Vec3d upperCorner = Vec3d::Constant(-IMSTK_DOUBLE_MAX);
+    for (int i = 0; i < points.size(); ++i)
+    {
+        lowerCorner = lowerCorner.cwiseMin(points[i]);
+        upperCorner = upperCorner.cwiseMax(points[i]);
+    }
+
+    const double maxExtent = (upperCorner - lowerCorner).maxCoeff();
+    const double scale     = maxExtent > 0.0 ? static_cast<double>((1 << CurveBits) - 1) / maxExtent : 0.0;
+
+    std::vector<std::array<uint32_t, 3>> cells(points.size());
+    ParallelUtils::parallelFor(points.size(), [&](const size_t i) {
+            for (int dim = 0; dim < 3; ++dim)
+            {
+                cells[i][dim] = static_cast<uint32_t>((points[i][dim] - lowerCorner[dim]) * scale);
+            }
+        });
+    return cells;
+}
+
+///
+/// \brief Sort the indices of the codes
+///
+std::vector<size_t>
+sortByCode(const std::vector<uint64_t>& codes)
+{
+    std::vector<std::pair<uint64_t, size_t>> keys(codes.size());
+    for (size_t i = 0; i < codes.size(); ++i)
+    {
+        keys[i] = std::make_pair(codes[i], i);
+    }
+    tbb::parallel_sort(keys.begin(), keys.end());
+
+    std::vector<size_t> newToOld(codes.size());
+    for (size_t i = 0; i < keys.size(); ++i)
+    {
+        newToOld[i] = keys[i].second;
+    }
+    return newToOld;
+}
+
+///
+/// \brief Size in bytes of a scalar type
+///
+size_t
+getScalarTypeSize(const ScalarTypeId type)
+{
+    switch (type)
+    {
+    case IMSTK_CHAR:
+        return sizeof(char);
+    case IMSTK_UNSIGNED_CHAR:
+        return sizeof(unsigned char);
+    case IMSTK_SHORT:
+        return sizeof(short);
+    case IMSTK_UNSIGNED_SHORT:
+        return sizeof(unsigned short);
+    case IMSTK_INT:
+        return sizeof(int);
+    case IMSTK_UNSIGNED_INT:
+        return sizeof(unsigned int);
+    case IMSTK_LONG:
+        return sizeof(long);
+    case IMSTK_UNSIGNED_LONG:
+        return sizeof(unsigned long);
+    case IMSTK_FLOAT:
+        return sizeof(float);
+    case IMSTK_DOUBLE:
+        return sizeof(double);
+    case IMSTK_LONG_LONG:
+        return sizeof(long long);
+    case IMSTK_UNSIGNED_LONG_LONG:
+        return sizeof(unsigned long long);
+    default:
+        return 0;
+    }
+}
+}
+
+std::vector<size_t>
+computeMortonOrder(const VecDataArray<double, 3>& points)
+{
+    const std::vector<std::array<uint32_t, 3>> cells = quantizePoints(points);
+
+    std::vector<uint64_t> codes(cells.size());
+    ParallelUtils::parallelFor(cells.size(), [&](const size_t i) {
+            codes[i] = (spreadBits(cells[i][0]) << 2) | (spreadBits(cells[i][1]) << 1) | spreadBits(cells[i][2]);
+        });
+    return sortByCode(codes);
+}
+
+std::vector<size_t>
+computeHilbertOrder(const VecDataArray<double, 3>& points)
+{
+    std::vector<std::array<uint32_t, 3>> cells = quantizePoints(points);
+
+    // Skilling's transform of the axes into the transposed Hilbert index,
+    // whose bits are then interleaved like a Morton code
+    std::vector<uint64_t> codes(cells.size());
+    ParallelUtils::parallelFor(cells.size(), [&](const size_t i) {
+            std::array<uint32_t, 3>& x = cells[i];
+            const uint32_t           m = 1u << (CurveBits - 1);
+            for (uint32_t q = m; q > 1; q >>= 1)
+            {
+                const uint32_t p = q - 1;
+                for (int dim = 0; dim < 3; ++dim)
+                {
+                    if (x[dim] & q)
+                    {
+                        x[0] ^= p;
+                    }
+                    else
+                    {
+                        const uint32_t t = (x[0] ^ x[dim]) & p;
+                        x[0]   ^= t;
+                        x[dim] ^= t;
+                    }
+                }
+            }
+
+            // Gray encode
+            x[1] ^= x[0];
+            x[2] ^= x[1];
+            uint32_t t = 0;
+            for (uint32_t q = m; q > 1; q >>= 1)
+            {
+                if (x[2] & q)
+                {
+                    t ^= q - 1;
+                }
+            }
+            x[0] ^= t;
+            x[1] ^= t;
+            x[2] ^= t;
+
+            codes[i] = (spreadBits(x[0]) << 2) | (spreadBits(x[1]) << 1) | spreadBits(x[2]);
+        });
+    return sortByCode(codes);
+}
+
+std::vector<size_t>
+computeReverseCuthillMcKeeOrder(const int numVertices, const int* const cellIndices,
+                                const int numCells, const int numVerticesPerCell)
+{
+    // Vertex adjacency given by the cells
+    std::vector<std::set<size_t>> neighbors(numVertices);
+    for (int cellId = 0; cellId < numCells; ++cellId)
+    {
+        const int* const cell = cellIndices + cellId * numVerticesPerCell;
+        for (int i = 0; i < numVerticesPerCell; ++i)
+        {
+            for (int j = 0; j < numVerticesPerCell; ++j)
+            {
+                if (i != j)
+                {
+                    neighbors[cell[i]].insert(cell[j]);
+                }
+            }
+        }
+    }
+    return GeometryUtils::reorderConnectivity(neighbors, GeometryUtils::MeshNodeRenumberingStrategy::ReverseCuthillMckee);
+}
+
+std::vector<size_t>
+invertPermutation(const std::vector<size_t>& newToOld)
+{
+    std::vector<size_t> oldToNew(newToOld.size());
+    for (size_t i = 0; i < newToOld.size(); ++i)
+    {
+        oldToNew[newToOld[i]] = i;
+    }
+    return oldToNew;
+}
+
+void
+permute(AbstractDataArray& data, const std::vector<size_t>& newToOld)
+{
+    const size_t tupleSize = getScalarTypeSize(data.getScalarType()) * data.getNumberOfComponents();
+    CHECK(tupleSize > 0) << "Cannot reorder an array of unknown scalar type";
+    CHECK(static_cast<size_t>(data.size()) == newToOld.size() * data.getNumberOfComponents())
+        << "Array size does not match the permutation";
+
+    char* const       ptr = static_cast<char*>(data.getVoidPointer());
+    std::vector<char> original(ptr, ptr + newToOld.size() * tupleSize);
+    ParallelUtils::parallelFor(newToOld.size(), [&](const size_t i) {
+            std::memcpy(ptr + i * tupleSize, original.data() + newToOld[i] * tupleSize, tupleSize);
+        });
+    data.postModified();
+}
+
+void
+permuteArrays(const std::vector<std::shared_ptr<AbstractDataArray>>& arrays, const std::vector<size_t>& newToOld)
+{
+    std::unordered_set<AbstractDataArray*> permuted;
+    for (const auto& data : arrays)
+    {
+        if (data != nullptr && permuted.insert(data.get()).second)
+        {
+            permute(*data, newToOld);
+        }
+    }
+}
+}
+}
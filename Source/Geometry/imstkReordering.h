@@ -0,0 +1,130 @@
+/*=========================================================================
+
+   Library: iMSTK
+
+   Copyright (c) Kitware, Inc. & Center for Modeling, Simulation,
+   & Imaging in Medicine, Rensselaer Polytechnic Institute.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+=========================================================================*/
+
+#pragma once
+
+#include "imstkMath.h"
+#include "imstkVecDataArray.h"
+
+namespace imstk
+{
+class AbstractDataArray;
+
+///
+/// \brief Functions to reorder the vertices of meshes or particles for memory locality
+/// Orders are given as permutations newToOld, where element i of the reordered array
+/// is element newToOld[i] of the original array
+///
+namespace Reordering
+{
+///
+/// \brief Spread the lowest 21 bits of x such that there are two zero bits between each of them,
+/// the spread bits of three coordinates are interleaved into a 63 bit Morton code
+///
+inline uint64_t
+spreadBits(uint64_t x)
+{
+    x &= 0x1fffff;
+    x  = (x | x << 32) & 0x1f00000000ffff;
+    x  = (x | x << 16) & 0x1f0000ff0000ff;
+    x  = (x | x << 8) & 0x100f00f00f00f00f;
+    x  = (x | x << 4) & 0x10c30c30c30c30c3;
+    x  = (x | x << 2) & 0x1249249249249249;
+    return x;
+}
+
+///
+/// \brief Order points along the Z-order (Morton) curve of their bounding box
+///
+std::vector<size_t> computeMortonOrder(const VecDataArray<double, 3>& points);
+
+///
+/// \brief Order points along the Hilbert curve of their bounding box. Consecutive points are
+/// always spatially adjacent, unlike with the Morton order, at a slightly higher cost
+///
+std::vector<size_t> computeHilbertOrder(const VecDataArray<double, 3>& points);
+
+///
+/// \brief Order vertices with the Reverse Cuthill-McKee algorithm, which reduces the
+/// bandwidth of the vertex adjacency given by the cells. Wraps GeometryUtils::reorderConnectivity
+/// \param numVertices Number of vertices
+/// \param cellIndices Vertex indices of the cells, numVerticesPerCell consecutive indices per cell
+/// \param numCells Number of cells
+/// \param numVerticesPerCell Number of vertices per cell
+///
+std::vector<size_t> computeReverseCuthillMcKeeOrder(const int numVertices, const int* const cellIndices,
+                                                    const int numCells, const int numVerticesPerCell);
+
+template<int N>
+std::vector<size_t>
+computeReverseCuthillMcKeeOrder(const int numVertices, const VecDataArray<int, N>& cells)
+{
+    return computeReverseCuthillMcKeeOrder(numVertices, cells.size() > 0 ? cells[0].data() : nullptr, cells.size(), N);
+}
+
+///
+/// \brief Returns the inverse permutation oldToNew of newToOld
+///
+std::vector<size_t> invertPermutation(const std::vector<size_t>& newToOld);
+
+///
+/// \brief Reorder the tuples of an array of any scalar type and number of components
+///
+void permute(AbstractDataArray& data, const std::vector<size_t>& newToOld);
+
+///
+/// \brief Reorder the tuples of every distinct array of a list, null arrays are skipped
+/// and arrays listed more than once are only reordered once
+///
+void permuteArrays(const std::vector<std::shared_ptr<AbstractDataArray>>& arrays, const std::vector<size_t>& newToOld);
+
+///
+/// \brief Reorder a vector
+///
+template<typename T>
+void
+permute(std::vector<T>& data, const std::vector<size_t>& newToOld)
+{
+    std::vector<T> reordered(newToOld.size());
+    for (size_t i = 0; i < newToOld.size(); ++i)
+    {
+        reordered[i] = data[newToOld[i]];
+    }
+    data.swap(reordered);
+}
+
+///
+/// \brief Replace the vertex indices of cells after the vertices were reordered
+///
+template<int N>
+void
+renumberCells(VecDataArray<int, N>& cells, const std::vector<size_t>& oldToNew)
+{
+    for (int cellId = 0; cellId < cells.size(); ++cellId)
+    {
+        for (int i = 0; i < N; ++i)
+        {
+            cells[cellId][i] = static_cast<int>(oldToNew[cells[cellId][i]]);
+        }
+    }
+}
+}
+}
@@ -0,0 +1,109 @@
+/*=========================================================================
+
+   Library: iMSTK
+
+   Copyright (c) Kitware, Inc. & Center for Modeling, Simulation,
+   & Imaging in Medicine, Rensselaer Polytechnic Institute.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+=========================================================================*/
+
+#pragma once
+
+#include "imstkMath.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace imstk
+{
+namespace SpatialQueryUtils
+{
+///
+/// \brief Squared distance from a position to an AABB (zero if inside)
+///
+inline double
+squaredDistanceToBox(const Vec3d& pos, const Vec3d& lowerCorner, const Vec3d& upperCorner)
+{
+    return (pos - pos.cwiseMax(lowerCorner).cwiseMin(upperCorner)).squaredNorm();
+}
+
+///
+/// \brief Test a ray against an AABB using the slab method
+/// \param invDirection Componentwise inverse of the ray direction
+/// \return True if the ray enters the box for some t in [0, maxT], tEntry is set to the entry parameter
+///
+inline bool
+rayIntersectsBox(const Vec3d& origin, const Vec3d& invDirection, const Vec3d& lowerCorner, const Vec3d& upperCorner,
+                 const double maxT, double& tEntry)
+{
+    double tMin = 0.0;
+    double tMax = maxT;
+    for (int dim = 0; dim < 3; ++dim)
+    {
+        double t0 = (lowerCorner[dim] - origin[dim]) * invDirection[dim];
+        double t1 = (upperCorner[dim] - origin[dim]) * invDirection[dim];
+        if (t0 > t1)
+        {
+            std::swap(t0, t1);
+        }
+        // Written such that NaNs (ray parallel to and on a slab plane) do not reject the box
+        tMin = t0 > tMin ? t0 : tMin;
+        tMax = t1 < tMax ? t1 : tMax;
+        if (tMin > tMax)
+        {
+            return false;
+        }
+    }
+    tEntry = tMin;
+    return true;
+}
+
+///
+/// \brief Moller-Trumbore ray triangle intersection
+/// \return True if the ray hits the triangle abc at some t in [0, maxT], t is set to the hit parameter
+///
+inline bool
+rayIntersectsTriangle(const Vec3d& origin, const Vec3d& direction, const Vec3d& a, const Vec3d& b, const Vec3d& c,
+                      const double maxT, double& t)
+{
+    const Vec3d  ab  = b - a;
+    const Vec3d  ac  = c - a;
+    const Vec3d  pv  = direction.cross(ac);
+    const double det = ab.dot(pv);
+    if (std::abs(det) < 1.0e-14)
+    {
+        return false;
+    }
+
+    const double invDet = 1.0 / det;
+    const Vec3d  tv     = origin - a;
+    const double u      = tv.dot(pv) * invDet;
+    if (u < 0.0 || u > 1.0)
+    {
+        return false;
+    }
+
+    const Vec3d  qv = tv.cross(ab);
+    const double v  = direction.dot(qv) * invDet;
+    if (v < 0.0 || u + v > 1.0)
+    {
+        return false;
+    }
+
+    t = ac.dot(qv) * invDet;
+    return t >= 0.0 && t <= maxT;
+}
+}
+}
@@ -0,0 +1,207 @@
+/*=========================================================================
+
+   Library: iMSTK
+
+   Copyright (c) Kitware, Inc. & Center for Modeling, Simulation,
+   & Imaging in Medicine, Rensselaer Polytechnic Institute.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+=========================================================================*/
+
+#include "gtest/gtest.h"
+
+#include "imstkCompositeMap.h"
+#include "imstkOneToOneMap.h"
+#include "imstkReordering.h"
+#include "imstkSurfaceMesh.h"
+#include "imstkTetraTriangleMap.h"
+#include "imstkTetrahedralMesh.h"
+#include "imstkVecDataArray.h"
+
+using namespace imstk;
+
+namespace
+{
+///
+/// \brief Unit cube split in 5 tetrahedra, with its last vertex moved by \p offset
+///
+std::shared_ptr<TetrahedralMesh>
+makeCube(const Vec3d& offset = Vec3d::Zero())
+{
+    auto vertices = std::make_shared<VecDataArray<double, 3>>();
+    for (int i = 0; i < 8; i++)
+    {
+        vertices->push_back(Vec3d(i & 1, (i >> 1) & 1, (i >> 2) & 1));
+    }
+    (*vertices)[7] += offset;
+    auto tets = std::make_shared<VecDataArray<int, 4>>();
+    tets->push_back(Vec4i(0, 1, 2, 4));
+    tets->push_back(Vec4i(1, 2, 4, 7));
+    tets->push_back(Vec4i(1, 3, 2, 7));
+    tets->push_back(Vec4i(1, 4, 5, 7));
+    tets->push_back(Vec4i(2, 4, 7, 6));
+    auto mesh = std::make_shared<TetrahedralMesh>();
+    mesh->initialize(vertices, tets);
+    return mesh;
+}
+
+///
+/// \brief Line of 10 triangles inside the unit cube
+///
+std::shared_ptr<SurfaceMesh>
+makeSurface()
+{
+    auto vertices = std::make_shared<VecDataArray<double, 3>>();
+    auto indices  = std::make_shared<VecDataArray<int, 3>>();
+    for (int i = 0; i < 10; i++)
+    {
+        for (int j = 0; j < 3; j++)
+        {
+            vertices->push_back(Vec3d(0.05 + 0.09 * i, 0.05 + 0.1 * j, 0.05 + 0.02 * i));
+        }
+        indices->push_back(Vec3i(3 * i, 3 * i + 1, 3 * i + 2));
+    }
+    auto surface = std::make_shared<SurfaceMesh>();
+    surface->initialize(vertices, indices);
+    return surface;
+}
+
+///
+/// \brief Deformation applied to the master, as a function of the position so that it
+/// does not depend on the vertex order
+///
+void
+deform(TetrahedralMesh& mesh)
+{
+    for (int i = 0; i < mesh.getNumVertices(); i++)
+    {
+        const Vec3d pos = mesh.getVertexPosition(i);
+        mesh.setVertexPosition(i, pos * 1.5 + Vec3d(0.1 * pos[0], -0.2, 0.05 * pos[1] * pos[2]));
+    }
+}
+
+///
+/// \brief Compares the composite map of cube -> cube -> surface against applying its maps in sequence
+/// \return Number of surface vertices the composite map leaves unmapped
+///
+int
+compareWithSequence(const Vec3d& offset)
+{
+    std::shared_ptr<TetrahedralMesh> master  = makeCube();
+    std::shared_ptr<TetrahedralMesh> middle  = makeCube(offset);
+    std::shared_ptr<SurfaceMesh>     surface = makeSurface();
+
+    auto         toMiddle  = std::make_shared<OneToOneMap>(master, middle);
+    auto         toSurface = std::make_shared<TetraTriangleMap>(middle, surface);
+    CompositeMap composite({ toMiddle, toSurface });
+    composite.compute();
+
+    // Deform the master, then apply the composite map and the sequence
+    deform(*master);
+    const VecDataArray<double, 3> initialSurface = *surface->getVertexPositions();
+    composite.apply();
+    const VecDataArray<double, 3> compositeSurface = *surface->getVertexPositions();
+    *surface->getVertexPositions() = initialSurface;
+    toMiddle->apply();
+    toSurface->apply();
+    const VecDataArray<double, 3>& sequenceSurface = *surface->getVertexPositions();
+
+    SparseMatrixf weights;
+    composite.getWeightMatrix(weights);
+    int numUnmapped = 0;
+    for (int i = 0; i < surface->getNumVertices(); i++)
+    {
+        // Unmapped vertices are left untouched, the others match the sequence
+        if (weights.row(i).nonZeros() == 0)
+        {
+            EXPECT_EQ(compositeSurface[i], initialSurface[i]);
+            numUnmapped++;
+        }
+        else
+        {
+            EXPECT_NEAR(weights.row(i).sum(), 1.0f, 1.0e-5f);
+            EXPECT_TRUE(compositeSurface[i].isApprox(sequenceSurface[i], 1.0e-5));
+        }
+    }
+    return numUnmapped;
+}
+}
+
+///
+/// \brief Test the composed map against the maps applied one at a time
+///
+TEST(imstkCompositeMapTest, MatchesSequence)
+{
+    EXPECT_EQ(compareWithSequence(Vec3d::Zero()), 0);
+}
+
+///
+/// \brief Test that surface vertices depending on an intermediate vertex left
+/// unmapped by the OneToOneMap are left unmapped
+///
+TEST(imstkCompositeMapTest, PartiallyMappedIntermediate)
+{
+    const int numUnmapped = compareWithSequence(Vec3d(0.3, 0.0, 0.0));
+    EXPECT_GT(numUnmapped, 0);
+    EXPECT_LT(numUnmapped, 30);
+}
+
+
+///
+/// \brief Test that reordering the vertices of the geometries renumbers the composed map and its maps
+///
+TEST(imstkCompositeMapTest, ReorderVertices)
+{
+    std::shared_ptr<TetrahedralMesh> master[2]  = { makeCube(), makeCube() };
+    std::shared_ptr<TetrahedralMesh> middle[2]  = { makeCube(), makeCube() };
+    std::shared_ptr<SurfaceMesh>     surface[2] = { makeSurface(), makeSurface() };
+
+    std::shared_ptr<OneToOneMap>      toMiddle[2];
+    std::shared_ptr<TetraTriangleMap> toSurface[2];
+    CompositeMap                      composite[2];
+    for (int k = 0; k < 2; k++)
+    {
+        toMiddle[k]  = std::make_shared<OneToOneMap>(master[k], middle[k]);
+        toSurface[k] = std::make_shared<TetraTriangleMap>(middle[k], surface[k]);
+        composite[k].setMaps({ toMiddle[k], toSurface[k] });
+        composite[k].compute();
+    }
+
+    // Reorder every geometry of the second chain
+    const std::vector<size_t> masterOrder  = { 5, 2, 7, 0, 3, 6, 1, 4 };
+    const std::vector<size_t> middleOrder  = { 3, 7, 1, 6, 0, 4, 2, 5 };
+    const std::vector<size_t> surfaceOrder = Reordering::computeMortonOrder(*surface[1]->getVertexPositions());
+    master[1]->reorderVertices(masterOrder);
+    composite[1].reorderVertices(master[1].get(), masterOrder);
+    middle[1]->reorderVertices(middleOrder);
+    composite[1].reorderVertices(middle[1].get(), middleOrder);
+    surface[1]->reorderVertices(surfaceOrder);
+    composite[1].reorderVertices(surface[1].get(), surfaceOrder);
+
+    // Both chains give the same surface, in the respective vertex orders
+    for (int k = 0; k < 2; k++)
+    {
+        deform(*master[k]);
+        composite[k].apply();
+    }
+    const VecDataArray<double, 3> compositeSurface = *surface[1]->getVertexPositions();
+    toMiddle[1]->apply();
+    toSurface[1]->apply();
+    for (int i = 0; i < surface[1]->getNumVertices(); i++)
+    {
+        const Vec3d& expected = surface[0]->getVertexPosition(surfaceOrder[i]);
+        EXPECT_TRUE(compositeSurface[i].isApprox(expected, 1.0e-5));
+        EXPECT_TRUE(surface[1]->getVertexPosition(i).isApprox(expected, 1.0e-5));
+    }
+}
@@ -0,0 +1,192 @@
+/*=========================================================================
+
+   Library: iMSTK
+
+   Copyright (c) Kitware, Inc. & Center for Modeling, Simulation,
+   & Imaging in Medicine, Rensselaer Polytechnic Institute.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+=========================================================================*/
+
+#include "imstkCompositeMap.h"
+#include "imstkLogger.h"
+#include "imstkParallelUtils.h"
+#include "imstkPointSet.h"
+#include "imstkReordering.h"
+#include "imstkVecDataArray.h"
+
+namespace imstk
+{
+void
+CompositeMap::setMaps(const std::vector<std::shared_ptr<GeometryMap>>& maps)
+{
+    CHECK(!maps.empty()) << "CompositeMap requires at least one map";
+    for (size_t i = 1; i < maps.size(); ++i)
+    {
+        CHECK(maps[i - 1]->getSlave() == maps[i]->getMaster()) << "Map " << i << " does not follow the slave of the previous map";
+    }
+
+    m_maps = maps;
+    GeometryMap::setMaster(maps.front()->getMaster());
+    GeometryMap::setSlave(maps.back()->getSlave());
+}
+
+void
+CompositeMap::compute()
+{
+    CHECK(!m_maps.empty() && m_master && m_slave) << "CompositeMap is being computed without valid maps";
+
+    SparseMatrixf mapWeights;
+    for (size_t i = 0; i < m_maps.size(); ++i)
+    {
+        m_maps[i]->compute();
+        CHECK(m_maps[i]->getWeightMatrix(mapWeights)) << m_maps[i]->getTypeName() << " is not a linear vertex map and cannot be composed";
+        if (i == 0)
+        {
+            m_weights = mapWeights;
+            m_weights.makeCompressed();
+            continue;
+        }
+
+        CHECK(mapWeights.cols() == m_weights.rows()) << "Map " << i << " does not follow the slave of the previous map";
+
+        // Applied in sequence, a row that reads an intermediate vertex left unmapped by the previous
+        // maps would use its stale position, which the product can't express. Such rows are cleared
+        // so the slave vertex is left unmapped instead of being pulled by a partial sum of weights
+        std::vector<char> validRows(mapWeights.rows(), 1);
+        for (int row = 0; row < mapWeights.rows(); ++row)
+        {
+            for (SparseMatrixf::InnerIterator it(mapWeights, row); it; ++it)
+            {
+                if (m_weights.outerIndexPtr()[it.col() + 1] == m_weights.outerIndexPtr()[it.col()])
+                {
+                    validRows[row] = 0;
+                    break;
+                }
+            }
+        }
+        m_weights = (mapWeights * m_weights).pruned();
+        m_weights.prune([&validRows](const Eigen::Index& row, const Eigen::Index&, const float&) { return validRows[row] != 0; });
+    }
+    m_weights.makeCompressed();
+
+    // A slave vertex is only mapped if every map along its path maps it, any unmapped
+    // intermediate vertex on the path leaves an empty row in the product
+    m_mappedRows.resize(m_weights.rows());
+    for (int row = 0; row < m_weights.rows(); ++row)
+    {
+        m_mappedRows[row] = m_weights.outerIndexPtr()[row + 1] > m_weights.outerIndexPtr()[row];
+    }
+}
+
+void
+CompositeMap::apply()
+{
+    // Check if map is active
+    if (!m_isActive)
+    {
+        LOG(WARNING) << "Composite map is not active";
+        return;
+    }
+
+    // Check geometries
+    CHECK(m_master && m_slave) << "Composite map is being applied without valid geometries";
+
+    auto masterMesh = static_cast<PointSet*>(m_master.get());
+    auto slaveMesh  = static_cast<PointSet*>(m_slave.get());
+
+#if defined(DEBUG) || defined(_DEBUG) || !defined(NDEBUG)
+    CHECK(dynamic_cast<PointSet*>(m_master.get()) && dynamic_cast<PointSet*>(m_slave.get()))
+        << "Fail to cast from geometry to pointsets";
+    CHECK(m_weights.rows() == slaveMesh->getNumVertices() && m_weights.cols() == masterMesh->getNumVertices())
+        << "Composite map does not match its geometries, it must be recomputed";
+#endif
+
+    const VecDataArray<double, 3>& masterVertices = *masterMesh->getVertexPositions();
+    VecDataArray<double, 3>&       slaveVertices  = *slaveMesh->getVertexPositions();
+    const int* const               rowOffsets     = m_weights.outerIndexPtr();
+    const int* const               columns        = m_weights.innerIndexPtr();
+    const float* const             values         = m_weights.valuePtr();
+
+    ParallelUtils::parallelFor(static_cast<size_t>(m_weights.rows()), [&](const size_t row) {
+            if (!m_mappedRows[row])
+            {
+                return;
+            }
+            Vec3d pos = Vec3d::Zero();
+            for (int k = rowOffsets[row]; k < rowOffsets[row + 1]; ++k)
+            {
+                pos += masterVertices[columns[k]] * static_cast<double>(values[k]);
+            }
+            slaveVertices[row] = pos;
+        });
+
+    slaveMesh->postModified();
+}
+
+bool
+CompositeMap::isValid() const
+{
+    for (const auto& map : m_maps)
+    {
+        if (!map->isValid())
+        {
+            return false;
+        }
+    }
+    return !m_maps.empty();
+}
+
+bool
+CompositeMap::getWeightMatrix(SparseMatrixf& weights) const
+{
+    weights = m_weights;
+    return true;
+}
+
+void
+CompositeMap::reorderVertices(const Geometry* geometry, const std::vector<size_t>& newToOld)
+{
+    for (const auto& map : m_maps)
+    {
+        map->reorderVertices(geometry, newToOld);
+    }
+
+    // The composed weights only refer to the first master and the last slave
+    const bool reorderMaster = (geometry == m_master.get());
+    const bool reorderSlave  = (geometry == m_slave.get());
+    if (!reorderMaster && !reorderSlave)
+    {
+        return;
+    }
+
+    const std::vector<size_t>          oldToNew = Reordering::invertPermutation(newToOld);
+    std::vector<Eigen::Triplet<float>> triplets;
+    triplets.reserve(m_weights.nonZeros());
+    for (int row = 0; row < m_weights.outerSize(); ++row)
+    {
+        for (SparseMatrixf::InnerIterator it(m_weights, row); it; ++it)
+        {
+            triplets.push_back(Eigen::Triplet<float>(reorderSlave ? static_cast<int>(oldToNew[row]) : row,
+                reorderMaster ? static_cast<int>(oldToNew[it.col()]) : static_cast<int>(it.col()), it.value()));
+        }
+    }
+    m_weights.setFromTriplets(triplets.begin(), triplets.end());
+    m_weights.makeCompressed();
+    if (reorderSlave && m_mappedRows.size() == newToOld.size())
+    {
+        Reordering::permute(m_mappedRows, newToOld);
+    }
+}
+} // imstk
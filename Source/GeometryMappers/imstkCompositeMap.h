@@ -0,0 +1,99 @@
+/*=========================================================================
+
+   Library: iMSTK
+
+   Copyright (c) Kitware, Inc. & Center for Modeling, Simulation,
+   & Imaging in Medicine, Rensselaer Polytechnic Institute.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+=========================================================================*/
+
+#pragma once
+
+#include "imstkGeometryMap.h"
+
+namespace imstk
+{
+///
+/// \class CompositeMap
+///
+/// \brief Composes a chain of linear vertex maps (such as physics -> collision -> visual)
+/// into a single sparse weight matrix when computed, and applies it with one sparse
+/// matrix-vector product from the first master to the last slave. The intermediate
+/// geometries are not updated when the composite map is applied
+///
+class CompositeMap : public GeometryMap
+{
+public:
+    ///
+    /// \brief Constructor
+    ///
+    CompositeMap() : GeometryMap(GeometryMap::Type::Composite) {}
+
+    ///
+    /// \brief Constructor
+    /// \param maps The chain of maps, the slave of each map being the master of the next one
+    ///
+    CompositeMap(const std::vector<std::shared_ptr<GeometryMap>>& maps) : GeometryMap(GeometryMap::Type::Composite)
+    {
+        this->setMaps(maps);
+    }
+
+    ///
+    /// \brief Destructor
+    ///
+    virtual ~CompositeMap() override = default;
+
+    ///
+    /// \brief Compute every map of the chain and multiply their weight matrices
+    ///
+    void compute() override;
+
+    ///
+    /// \brief Apply (if active) the composed map
+    ///
+    void apply() override;
+
+    ///
+    /// \brief Check the validity of the map
+    ///
+    bool isValid() const override;
+
+    ///
+    /// \brief Export the composed weight matrix
+    ///
+    bool getWeightMatrix(SparseMatrixf& weights) const override;
+
+    ///
+    /// \brief Renumber the maps of the chain and the composed weight matrix
+    ///
+    void reorderVertices(const Geometry* geometry, const std::vector<size_t>& newToOld) override;
+
+    ///
+    /// \brief Set the chain of maps, the master is the first map's master and
+    /// the slave is the last map's slave
+    ///
+    void setMaps(const std::vector<std::shared_ptr<GeometryMap>>& maps);
+
+    ///
+    /// \brief Get the chain of maps
+    ///
+    const std::vector<std::shared_ptr<GeometryMap>>& getMaps() const { return m_maps; }
+
+protected:
+    std::vector<std::shared_ptr<GeometryMap>> m_maps;       ///> The chain of maps
+    SparseMatrixf                             m_weights;    ///> Composed weight matrix, slave vertices by master vertices
+    std::vector<char>                         m_mappedRows; ///> Whether each slave vertex is mapped by the whole chain
+};
+} // imstk
@@ -71,6 +71,8 @@ GeometryMap::getTypeName() const
         return "Tetra-Tetra map";
     case Type::OneToOne:
         return "One-to-One nodal map";
+    case Type::Composite:
+        return "Composite map";
     default:
         return "Map type not determined!";
     }
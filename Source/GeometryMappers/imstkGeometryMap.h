@@ -41,7 +41,8 @@ public:
         OneToOne,
         TetraTriangle,
         HexaTriangle,
-        TetraTetra
+        TetraTetra,
+        Composite
     };
 
     ///
@@ -115,6 +116,21 @@ public:
     ///
     virtual size_t getMapIdx(const size_t&) { return 0; }
 
+    ///
+    /// \brief Export the map as a sparse weight matrix W such that the slave vertex positions
+    /// are W times the master vertex positions. Slave vertices with an empty row are not mapped
+    /// \return False if the map is not a linear map between vertices
+    ///
+    virtual bool getWeightMatrix(SparseMatrixf&) const { return false; }
+
+    ///
+    /// \brief Renumber the map after the vertices of its master and/or slave were reordered
+    /// with PointSet::reorderVertices. Maps that only refer to transforms have nothing to renumber
+    /// \param geometry The reordered geometry
+    /// \param newToOld Permutation where vertex i became the vertex newToOld[i]
+    ///
+    virtual void reorderVertices(const Geometry* imstkNotUsed(geometry), const std::vector<size_t>& imstkNotUsed(newToOld)) {}
+
     ///
     /// \brief Initialize the map
     ///
@@ -14,9 +14,11 @@
 =========================================================================*/
 
 #include "imstkOneToOneMap.h"
+#include "imstkKDTree.h"
 #include "imstkParallelUtils.h"
 #include "imstkLogger.h"
 #include "imstkPointSet.h"
+#include "imstkReordering.h"
 
 namespace imstk
 {
@@ -34,17 +36,19 @@ OneToOneMap::compute()
     ParallelUtils::SpinLock lock;
 
     std::shared_ptr<VecDataArray<double, 3>> masterVerticesPtr = meshMaster->getInitialVertexPositions();
-    const VecDataArray<double, 3>&           masterVertices    = *masterVerticesPtr;
     std::shared_ptr<VecDataArray<double, 3>> slaveVerticesPtr  = meshSlave->getInitialVertexPositions();
     const VecDataArray<double, 3>&           slaveVertices     = *slaveVerticesPtr;
 
+    KDTree masterTree;
+    masterTree.build(*masterVerticesPtr);
+
     // For every vertex on the slave, find corresponding one on the master
     ParallelUtils::parallelFor(meshSlave->getNumVertices(),
         [&](const size_t nodeId)
         {
-            // Find the enclosing or closest tetrahedron
+            // Find the closest master vertex within the tolerance
             size_t matchingNodeId;
-            if (!findMatchingVertex(masterVertices, slaveVertices[nodeId], matchingNodeId))
+            if (!findMatchingVertex(masterTree, slaveVertices[nodeId], matchingNodeId))
             {
                 return;
             }
@@ -65,18 +69,10 @@ OneToOneMap::compute()
 }
 
 bool
-OneToOneMap::findMatchingVertex(const VecDataArray<double, 3>& masterVertices, const Vec3d& p, size_t& nodeId)
+OneToOneMap::findMatchingVertex(const KDTree& masterTree, const Vec3d& p, size_t& nodeId) const
 {
-    const double eps2 = m_epsilon * m_epsilon;
-    for (int idx = 0; idx < masterVertices.size(); ++idx)
-    {
-        if ((masterVertices[idx] - p).squaredNorm() < eps2)
-        {
-            nodeId = idx;
-            return true;
-        }
-    }
-    return false;
+    double dist2 = 0.0;
+    return masterTree.findNearestPoint(p, nodeId, dist2) && dist2 < m_epsilon * m_epsilon;
 }
 
 bool
@@ -168,6 +164,39 @@ OneToOneMap::setSlave(std::shared_ptr<Geometry> slave)
     GeometryMap::setSlave(slave);
 }
 
+bool
+OneToOneMap::getWeightMatrix(SparseMatrixf& weights) const
+{
+    CHECK(m_master != nullptr && m_slave != nullptr) << "OneToOneMap map is being exported without valid geometries";
+
+    auto meshMaster = static_cast<PointSet*>(m_master.get());
+    auto meshSlave  = static_cast<PointSet*>(m_slave.get());
+
+    std::vector<Eigen::Triplet<float>> triplets;
+    triplets.reserve(m_oneToOneMapVector.size());
+    for (const auto& mapValue : m_oneToOneMapVector)
+    {
+        triplets.push_back(Eigen::Triplet<float>(static_cast<int>(mapValue.first), static_cast<int>(mapValue.second), 1.0f));
+    }
+    weights.resize(meshSlave->getNumVertices(), meshMaster->getNumVertices());
+    weights.setFromTriplets(triplets.begin(), triplets.end());
+    return true;
+}
+
+void
+OneToOneMap::reorderVertices(const Geometry* geometry, const std::vector<size_t>& newToOld)
+{
+    const std::vector<size_t> oldToNew = Reordering::invertPermutation(newToOld);
+    std::map<size_t, size_t>  reorderedMap;
+    for (const auto& mapValue : m_oneToOneMap)
+    {
+        const size_t slaveId  = (geometry == m_slave.get()) ? oldToNew[mapValue.first] : mapValue.first;
+        const size_t masterId = (geometry == m_master.get()) ? oldToNew[mapValue.second] : mapValue.second;
+        reorderedMap[slaveId] = masterId;
+    }
+    setMap(reorderedMap);
+}
+
 size_t
 OneToOneMap::getMapIdx(const size_t& idx)
 {
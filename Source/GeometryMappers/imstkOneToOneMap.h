@@ -21,6 +21,7 @@
 namespace imstk
 {
 template<typename T, int N> class VecDataArray;
+class KDTree;
 class PointSet;
 
 ///
@@ -94,6 +95,16 @@ public:
     ///
     size_t getMapIdx(const size_t& idx) override;
 
+    ///
+    /// \brief Export the map as a sparse weight matrix with a single unit weight per mapped slave vertex
+    ///
+    bool getWeightMatrix(SparseMatrixf& weights) const override;
+
+    ///
+    /// \brief Renumber the master and/or slave indices of the correspondence
+    ///
+    void reorderVertices(const Geometry* geometry, const std::vector<size_t>& newToOld) override;
+
     ///
     /// \brief Set the tolerance, that is the distance to consider
     /// two points equivalent/corresponding
@@ -105,9 +116,10 @@ public:
 protected:
 
     ///
-    /// \brief Returns the first matching vertex
+    /// \brief Returns the closest master vertex if it is within the tolerance
+    /// \param masterTree KD-tree of the master vertices
     ///
-    bool findMatchingVertex(const VecDataArray<double, 3>& masterMesh, const Vec3d& p, size_t& nodeId);
+    bool findMatchingVertex(const KDTree& masterTree, const Vec3d& p, size_t& nodeId) const;
 
     std::map<size_t, size_t> m_oneToOneMap;   ///> One to one mapping data
 
@@ -22,6 +22,7 @@
 #include "imstkTetraTriangleMap.h"
 #include "imstkLogger.h"
 #include "imstkParallelUtils.h"
+#include "imstkReordering.h"
 #include "imstkSurfaceMesh.h"
 #include "imstkTetrahedralMesh.h"
 #include "imstkVecDataArray.h"
@@ -50,6 +51,7 @@ TetraTriangleMap::compute()
         // calling this function inside findEnclosingTetrahedron is not thread-safe.
         updateBoundingBox();
     }
+    updateSpatialIndices();
 
     ParallelUtils::parallelFor(triMesh->getNumVertices(), [&](const size_t vertexIdx) {
             if (!bValid) // If map is invalid, no need to check further
@@ -182,64 +184,79 @@ TetraTriangleMap::setSlave(std::shared_ptr<Geometry> slave)
     GeometryMap::setSlave(slave);
 }
 
-size_t
-TetraTriangleMap::findClosestTetrahedron(const Vec3d& pos) const
+bool
+TetraTriangleMap::getWeightMatrix(SparseMatrixf& weights) const
 {
-    const auto tetMesh = std::dynamic_pointer_cast<TetrahedralMesh>(m_master);
-    double     closestDistanceSqr = MAX_D;
-    size_t     closestTetrahedron = std::numeric_limits<size_t>::max();
-    Vec3d      center(0, 0, 0);
+    CHECK(m_master && m_slave) << "TetraTriangle map is being exported without valid geometries";
 
-    for (int tetId = 0; tetId < tetMesh->getNumTetrahedra(); ++tetId)
+    auto tetMesh = static_cast<TetrahedralMesh*>(m_master.get());
+    auto triMesh = static_cast<SurfaceMesh*>(m_slave.get());
+
+    std::vector<Eigen::Triplet<float>> triplets;
+    triplets.reserve(m_verticesEnclosingTetraId.size() * 4);
+    for (size_t vertexId = 0; vertexId < m_verticesEnclosingTetraId.size(); ++vertexId)
     {
-        center = Vec3d::Zero();
-        const Vec4i& vert = tetMesh->getTetrahedronIndices(tetId);
-        for (size_t i = 0; i < 4; ++i)
+        const Vec4i& tetVerts = tetMesh->getTetrahedronIndices(m_verticesEnclosingTetraId[vertexId]);
+        for (int i = 0; i < 4; ++i)
         {
-            center += tetMesh->getInitialVertexPosition(vert[i]);
+            triplets.push_back(Eigen::Triplet<float>(static_cast<int>(vertexId), tetVerts[i], static_cast<float>(m_verticesWeights[vertexId][i])));
         }
-        center = center / 4.;
+    }
+    weights.resize(triMesh->getNumVertices(), tetMesh->getNumVertices());
+    weights.setFromTriplets(triplets.begin(), triplets.end());
+    return true;
+}
 
-        const double distSqr = (pos - center).squaredNorm();
-        if (distSqr < closestDistanceSqr)
-        {
-            closestDistanceSqr = distSqr;
-            closestTetrahedron = tetId;
-        }
+void
+TetraTriangleMap::reorderVertices(const Geometry* geometry, const std::vector<size_t>& newToOld)
+{
+    if (geometry == m_slave.get() && m_verticesWeights.size() == newToOld.size())
+    {
+        Reordering::permute(m_verticesWeights, newToOld);
+        Reordering::permute(m_verticesEnclosingTetraId, newToOld);
     }
+}
 
+size_t
+TetraTriangleMap::findClosestTetrahedron(const Vec3d& pos) const
+{
+    size_t closestTetrahedron = std::numeric_limits<size_t>::max();
+    double closestDistanceSqr = MAX_D;
+    m_tetCentroidTree.findNearestPoint(pos, closestTetrahedron, closestDistanceSqr);
     return closestTetrahedron;
 }
 
 size_t
 TetraTriangleMap::findEnclosingTetrahedron(const Vec3d& pos) const
 {
-    const auto tetMesh = std::dynamic_pointer_cast<TetrahedralMesh>(m_master);
-    size_t     enclosingTetrahedron = std::numeric_limits<size_t>::max();
-
-    for (int idx = 0; idx < tetMesh->getNumTetrahedra(); ++idx)
-    {
-        bool inBox = (pos[0] >= m_bBoxMin[idx][0] && pos[0] <= m_bBoxMax[idx][0])
-                     && (pos[1] >= m_bBoxMin[idx][1] && pos[1] <= m_bBoxMax[idx][1])
-                     && (pos[2] >= m_bBoxMin[idx][2] && pos[2] <= m_bBoxMax[idx][2]);
+    const auto tetMesh = static_cast<TetrahedralMesh*>(m_master.get());
 
-        // If the point is outside the bounding box, it is for sure not inside
-        // the element
-        if (!inBox)
+    // If the point is outside the bounding box, it is for sure not inside the element
+    return m_tetBoxTree.findBoxContainingPoint(pos,
+        [&](const size_t tetId)
         {
-            continue;
-        }
-
-        const Vec4d weights = tetMesh->computeBarycentricWeights(idx, pos);
+            const Vec4d weights = tetMesh->computeBarycentricWeights(tetId, pos);
+            return weights[0] >= 0 && weights[1] >= 0 && weights[2] >= 0 && weights[3] >= 0;
+        });
+}
 
-        if (weights[0] >= 0 && weights[1] >= 0 && weights[2] >= 0 && weights[3] >= 0)
-        {
-            enclosingTetrahedron = idx;
-            break;
-        }
-    }
+void
+TetraTriangleMap::updateSpatialIndices()
+{
+    auto tetMesh = std::dynamic_pointer_cast<TetrahedralMesh>(m_master);
+    m_tetBoxTree.build(m_bBoxMin, m_bBoxMax);
 
-    return enclosingTetrahedron;
+    VecDataArray<double, 3> centroids(tetMesh->getNumTetrahedra());
+    ParallelUtils::parallelFor(tetMesh->getNumTetrahedra(), [&](const size_t tetId) {
+            const Vec4i& vert   = tetMesh->getTetrahedronIndices(tetId);
+            Vec3d        center = Vec3d::Zero();
+            for (size_t i = 0; i < 4; ++i)
+            {
+                center += tetMesh->getInitialVertexPosition(vert[i]);
+            }
+            centroids[tetId] = center / 4.;
+        });
+    m_tetCentroidTree.build(centroids);
 }
 
 void
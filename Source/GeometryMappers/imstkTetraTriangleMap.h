@@ -21,7 +21,9 @@
 
 #pragma once
 
+#include "imstkAABBTree.h"
 #include "imstkGeometryMap.h"
+#include "imstkKDTree.h"
 
 namespace imstk
 {
@@ -86,8 +88,25 @@ public:
     ///
     void setSlave(std::shared_ptr<Geometry> slave) override;
 
+    ///
+    /// \brief Export the map as a sparse weight matrix with the four barycentric weights per slave vertex
+    ///
+    bool getWeightMatrix(SparseMatrixf& weights) const override;
+
+    ///
+    /// \brief Reorder the weights of the slave vertices. Reordering the master keeps the
+    /// order of its tetrahedra, so the enclosing tetrahedra stay valid
+    ///
+    void reorderVertices(const Geometry* geometry, const std::vector<size_t>& newToOld) override;
+
 protected:
 
+    ///
+    /// \brief Build the bounding volume hierarchy of the tetrahedra and the KD-tree of
+    /// their centroids used to locate the surface vertices
+    ///
+    void updateSpatialIndices();
+
     ///
     /// \brief Find the tetrahedron that encloses a given point in 3D space
     ///
@@ -112,6 +131,9 @@ protected:
     std::vector<Vec3d> m_bBoxMax;
     bool m_boundingBoxAvailable;
 
+    AABBTree m_tetBoxTree;      ///> Hierarchy of the tetrahedra bounding boxes
+    KDTree   m_tetCentroidTree; ///> KD-tree of the tetrahedra centroids
+
 private:
     std::shared_ptr<VecDataArray<double, 3>> m_slaveVerts;
 };
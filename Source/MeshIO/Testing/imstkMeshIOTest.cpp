@@ -22,9 +22,16 @@
 #include "gtest/gtest.h"
 
 #include "imstkMeshIO.h"
+#include "imstkDataArray.h"
 #include "imstkGeometryUtilities.h"
+#include "imstkImageData.h"
+#include "imstkSparseSignedDistanceField.h"
+#include "imstkSparseSignedDistanceFieldIO.h"
 #include "imstkSurfaceMesh.h"
 
+#include <cstdio>
+#include <fstream>
+
 using namespace imstk;
 
 TEST(imstkMeshIODeathTest, FailOnMissingFile)
@@ -39,4 +46,88 @@ TEST(imstkMeshIOTest, conversionBug)
     ASSERT_TRUE(mesh);
 
     EXPECT_NO_FATAL_FAILURE(auto data = GeometryUtils::copyToVtkPolyData(mesh));
+}
+
+TEST(imstkMeshIOTest, SparseSignedDistanceFieldReadWrite)
+{
+    // Signed distances of a plane at z = 0
+    auto image = std::make_shared<ImageData>();
+    image->allocate(IMSTK_DOUBLE, 1, Vec3i(20, 20, 20), Vec3d(0.1, 0.1, 0.1), Vec3d(-1.0, -1.0, -1.0));
+    DataArray<double>& scalars = *std::dynamic_pointer_cast<DataArray<double>>(image->getScalars());
+    for (int i = 0; i < scalars.size(); i++)
+    {
+        scalars[i] = (i / 400) * 0.1 - 0.95;
+    }
+    auto sdf = std::make_shared<SparseSignedDistanceField>(image, 0.3);
+    sdf->setScale(2.0);
+
+    const std::string fileName = ::testing::TempDir() + "sparseSdfTest.ssdf";
+    ASSERT_TRUE(SparseSignedDistanceFieldIO::write(sdf, fileName));
+    std::shared_ptr<SparseSignedDistanceField> readSdf = SparseSignedDistanceFieldIO::read(fileName);
+    std::remove(fileName.c_str());
+    ASSERT_TRUE(readSdf);
+
+    EXPECT_EQ(sdf->getNumberOfTiles(), readSdf->getNumberOfTiles());
+    EXPECT_DOUBLE_EQ(sdf->getScale(), readSdf->getScale());
+    EXPECT_DOUBLE_EQ(sdf->getBackgroundValue(), readSdf->getBackgroundValue());
+    EXPECT_TRUE(sdf->getBounds().isApprox(readSdf->getBounds()));
+    for (double z = -0.9; z < 0.9; z += 0.05)
+    {
+        const Vec3d pos = Vec3d(0.13, -0.27, z);
+        EXPECT_DOUBLE_EQ(sdf->getFunctionValue(pos), readSdf->getFunctionValue(pos));
+    }
+}
+
+TEST(imstkMeshIOTest, SparseSignedDistanceFieldReadCorrupt)
+{
+    auto image = std::make_shared<ImageData>();
+    image->allocate(IMSTK_DOUBLE, 1, Vec3i(20, 20, 20), Vec3d(0.1, 0.1, 0.1), Vec3d(-1.0, -1.0, -1.0));
+    DataArray<double>& scalars = *std::dynamic_pointer_cast<DataArray<double>>(image->getScalars());
+    for (int i = 0; i < scalars.size(); i++)
+    {
+        scalars[i] = (i / 400) * 0.1 - 0.95;
+    }
+    const std::string fileName = ::testing::TempDir() + "sparseSdfTest.ssdf";
+    const std::string corruptFileName = ::testing::TempDir() + "sparseSdfCorrupt.ssdf";
+    ASSERT_TRUE(SparseSignedDistanceFieldIO::write(std::make_shared<SparseSignedDistanceField>(image, 0.3), fileName));
+
+    std::ifstream     input(fileName, std::ios::binary);
+    const std::string bytes((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+    input.close();
+    std::remove(fileName.c_str());
+
+    // Writes the file with the header value at offset replaced
+    auto writeCorrupt = [&bytes, &corruptFileName](const size_t offset, const void* value, const size_t size, const size_t length)
+                        {
+                            std::string   corrupt = bytes.substr(0, length);
+                            std::ofstream output(corruptFileName, std::ios::binary);
+                            corrupt.replace(offset, size, static_cast<const char*>(value), size);
+                            output.write(corrupt.data(), corrupt.size());
+                        };
+
+    // Truncated tiles
+    writeCorrupt(0, bytes.data(), 0, bytes.size() / 2);
+    EXPECT_EQ(SparseSignedDistanceFieldIO::read(corruptFileName), nullptr);
+
+    // Zero dimension
+    const int zero = 0;
+    writeCorrupt(12, &zero, sizeof(int), bytes.size());
+    EXPECT_EQ(SparseSignedDistanceFieldIO::read(corruptFileName), nullptr);
+
+    // Map entries and tile counts beyond the file size
+    const uint64_t huge = uint64_t(1) << 60;
+    writeCorrupt(88, &huge, sizeof(uint64_t), bytes.size());
+    EXPECT_EQ(SparseSignedDistanceFieldIO::read(corruptFileName), nullptr);
+    writeCorrupt(96, &huge, sizeof(uint64_t), bytes.size());
+    EXPECT_EQ(SparseSignedDistanceFieldIO::read(corruptFileName), nullptr);
+
+    // Dimensions too small for the tiles
+    const int small[3] = { 4, 4, 4 };
+    writeCorrupt(12, small, sizeof(small), bytes.size());
+    EXPECT_EQ(SparseSignedDistanceFieldIO::read(corruptFileName), nullptr);
+
+    // Unchanged file still reads
+    writeCorrupt(0, bytes.data(), 0, bytes.size());
+    EXPECT_NE(SparseSignedDistanceFieldIO::read(corruptFileName), nullptr);
+    std::remove(corruptFileName.c_str());
 }
\ No newline at end of file
@@ -0,0 +1,178 @@
+/*=========================================================================
+
+   Library: iMSTK
+
+   Copyright (c) Kitware, Inc. & Center for Modeling, Simulation,
+   & Imaging in Medicine, Rensselaer Polytechnic Institute.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+=========================================================================*/
+
+#include "imstkSparseSignedDistanceFieldIO.h"
+#include "imstkLogger.h"
+#include "imstkSparseSignedDistanceField.h"
+
+#include <algorithm>
+#include <fstream>
+
+namespace imstk
+{
+static const char     ssdfMagic[4]   = { 'S', 'S', 'D', 'F' };
+static const uint32_t ssdfVersion    = 1;
+static const uint32_t ssdfTileVoxels = SparseSignedDistanceField::TileVoxelSize;
+
+template<typename T>
+static void
+writeValue(std::ofstream& file, const T& val)
+{
+    file.write(reinterpret_cast<const char*>(&val), sizeof(T));
+}
+
+template<typename T>
+static void
+readValue(std::ifstream& file, T& val)
+{
+    file.read(reinterpret_cast<char*>(&val), sizeof(T));
+}
+
+std::shared_ptr<SparseSignedDistanceField>
+SparseSignedDistanceFieldIO::read(const std::string& filePath)
+{
+    std::ifstream file(filePath, std::ios::binary);
+    if (!file.is_open())
+    {
+        LOG(WARNING) << "Error: Failed to open the input file " << filePath;
+        return nullptr;
+    }
+
+    char     magic[4];
+    uint32_t version    = 0;
+    uint32_t tileVoxels = 0;
+    file.read(magic, 4);
+    readValue(file, version);
+    readValue(file, tileVoxels);
+    if (!file || !std::equal(magic, magic + 4, ssdfMagic) || version != ssdfVersion || tileVoxels != ssdfTileVoxels)
+    {
+        LOG(WARNING) << "Error: " << filePath << " is not a supported sparse signed distance field file";
+        return nullptr;
+    }
+
+    auto sdf = std::make_shared<SparseSignedDistanceField>();
+    file.read(reinterpret_cast<char*>(sdf->m_dimensions.data()), sizeof(int) * 3);
+    file.read(reinterpret_cast<char*>(sdf->m_origin.data()), sizeof(double) * 3);
+    file.read(reinterpret_cast<char*>(sdf->m_spacing.data()), sizeof(double) * 3);
+    readValue(file, sdf->m_scale);
+    readValue(file, sdf->m_backgroundValue);
+
+    uint64_t numMapEntries = 0;
+    uint64_t numTiles      = 0;
+    readValue(file, numMapEntries);
+    readValue(file, numTiles);
+    if (!file)
+    {
+        LOG(WARNING) << "Error: Failed to read the header of " << filePath;
+        return nullptr;
+    }
+    if (sdf->m_dimensions.minCoeff() <= 0 || sdf->m_spacing.minCoeff() <= 0.0)
+    {
+        LOG(WARNING) << "Error: Invalid grid dimensions or spacing in " << filePath;
+        return nullptr;
+    }
+
+    // Bound the counts by what is left in the file before allocating anything
+    const std::streampos dataStart = file.tellg();
+    file.seekg(0, std::ios::end);
+    const uint64_t remainingSize = static_cast<uint64_t>(file.tellg() - dataStart);
+    file.seekg(dataStart);
+    const uint64_t entrySize = sizeof(SparseSignedDistanceField::TileKey) + sizeof(int32_t);
+    const uint64_t tileSize  = sizeof(SparseSignedDistanceField::Tile);
+    if (numMapEntries > remainingSize / entrySize || numTiles > remainingSize / tileSize
+        || numMapEntries * entrySize + numTiles * tileSize != remainingSize)
+    {
+        LOG(WARNING) << "Error: Tile counts of " << filePath << " don't match its size";
+        return nullptr;
+    }
+
+    // Tiles must lie within the grid
+    const Vec3i numGridTiles = (sdf->m_dimensions.array() + SparseSignedDistanceField::TileSize - 1) / SparseSignedDistanceField::TileSize;
+
+    sdf->m_tileMap.reserve(numMapEntries);
+    for (uint64_t i = 0; i < numMapEntries; i++)
+    {
+        SparseSignedDistanceField::TileKey key = 0;
+        int32_t                            id  = 0;
+        readValue(file, key);
+        readValue(file, id);
+        if (!file)
+        {
+            LOG(WARNING) << "Error: Failed to read the tile map of " << filePath;
+            return nullptr;
+        }
+        const Vec3i tile(static_cast<int>(key & 0x1FFFFF), static_cast<int>((key >> 21) & 0x1FFFFF), static_cast<int>((key >> 42) & 0x1FFFFF));
+        if (id >= static_cast<int64_t>(numTiles) || id < SparseSignedDistanceField::InsideTile
+            || (tile.array() >= numGridTiles.array()).any() || SparseSignedDistanceField::getTileKey(tile[0], tile[1], tile[2]) != key)
+        {
+            LOG(WARNING) << "Error: Invalid tile in " << filePath;
+            return nullptr;
+        }
+        sdf->m_tileMap[key] = id;
+    }
+    sdf->m_tiles.resize(numTiles);
+    file.read(reinterpret_cast<char*>(sdf->m_tiles.data()), sizeof(SparseSignedDistanceField::Tile) * numTiles);
+    if (!file)
+    {
+        LOG(WARNING) << "Error: Failed to read the tiles of " << filePath;
+        return nullptr;
+    }
+
+    sdf->updateGridInfo();
+    return sdf;
+}
+
+bool
+SparseSignedDistanceFieldIO::write(std::shared_ptr<SparseSignedDistanceField> sdf, const std::string& filePath)
+{
+    if (sdf == nullptr)
+    {
+        LOG(WARNING) << "Error: Sparse signed distance field supplied is not valid!";
+        return false;
+    }
+
+    std::ofstream file(filePath, std::ios::binary);
+    if (!file.is_open())
+    {
+        LOG(WARNING) << "Error: Failed to open the output file " << filePath;
+        return false;
+    }
+
+    file.write(ssdfMagic, 4);
+    writeValue(file, ssdfVersion);
+    writeValue(file, ssdfTileVoxels);
+    file.write(reinterpret_cast<const char*>(sdf->m_dimensions.data()), sizeof(int) * 3);
+    file.write(reinterpret_cast<const char*>(sdf->m_origin.data()), sizeof(double) * 3);
+    file.write(reinterpret_cast<const char*>(sdf->m_spacing.data()), sizeof(double) * 3);
+    writeValue(file, sdf->m_scale);
+    writeValue(file, sdf->m_backgroundValue);
+    writeValue(file, static_cast<uint64_t>(sdf->m_tileMap.size()));
+    writeValue(file, static_cast<uint64_t>(sdf->m_tiles.size()));
+    for (const auto& entry : sdf->m_tileMap)
+    {
+        writeValue(file, entry.first);
+        writeValue(file, static_cast<int32_t>(entry.second));
+    }
+    file.write(reinterpret_cast<const char*>(sdf->m_tiles.data()), sizeof(SparseSignedDistanceField::Tile) * sdf->m_tiles.size());
+
+    return static_cast<bool>(file);
+}
+}
@@ -0,0 +1,54 @@
+/*=========================================================================
+
+   Library: iMSTK
+
+   Copyright (c) Kitware, Inc. & Center for Modeling, Simulation,
+   & Imaging in Medicine, Rensselaer Polytechnic Institute.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+=========================================================================*/
+
+#pragma once
+
+#include <memory>
+#include <string>
+
+namespace imstk
+{
+class SparseSignedDistanceField;
+
+///
+/// \class SparseSignedDistanceFieldIO
+///
+/// \brief Reads/writes SparseSignedDistanceField's to a binary file (.ssdf)
+/// Only the narrow band tiles and the tile map are stored
+///
+class SparseSignedDistanceFieldIO
+{
+public:
+    SparseSignedDistanceFieldIO() = default;
+    ~SparseSignedDistanceFieldIO() = default;
+
+public:
+    ///
+    /// \brief Read a sparse signed distance field from file, returns nullptr on failure
+    ///
+    static std::shared_ptr<SparseSignedDistanceField> read(const std::string& filePath);
+
+    ///
+    /// \brief Write a sparse signed distance field to file, returns false on failure
+    ///
+    static bool write(std::shared_ptr<SparseSignedDistanceField> sdf, const std::string& filePath);
+};
+}
@@ -20,6 +20,7 @@
 =========================================================================*/
 
 #include "imstkPbdObject.h"
+#include "imstkGeometryMap.h"
 #include "imstkLogger.h"
 #include "imstkPbdModel.h"
 
@@ -46,4 +47,20 @@ PbdObject::initialize()
 
     return true;
 }
+
+void
+PbdObject::reorderVertices(const std::vector<size_t>& newToOld)
+{
+    CHECK(m_pbdModel != nullptr) << "PbdObject must be initialized before reordering its vertices";
+    m_pbdModel->reorderVertices(newToOld);
+
+    // The colliding geometry may be the physics geometry, maps renumber only the geometries they refer to
+    for (auto map : { m_physicsToCollidingGeomMap, m_physicsToVisualGeomMap, m_collidingToVisualMap })
+    {
+        if (map != nullptr)
+        {
+            map->reorderVertices(m_physicsGeometry.get(), newToOld);
+        }
+    }
+}
 } //imstk
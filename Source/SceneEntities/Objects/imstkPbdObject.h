@@ -52,6 +52,13 @@ public:
     ///
     bool initialize() override;
 
+    ///
+    /// \brief Reorder the vertices of the physics mesh of the initialized object for memory locality.
+    /// The model and the maps of the object are renumbered consistently
+    /// \param newToOld Permutation where vertex i becomes the vertex newToOld[i]
+    ///
+    void reorderVertices(const std::vector<size_t>& newToOld);
+
 protected:
     std::shared_ptr<PbdModel> m_pbdModel = nullptr;  ///> PBD mathematical model
 };
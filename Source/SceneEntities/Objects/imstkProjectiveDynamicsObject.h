@@ -0,0 +1,58 @@
+/*=========================================================================
+
+   Library: iMSTK
+
+   Copyright (c) Kitware, Inc. & Center for Modeling, Simulation,
+   & Imaging in Medicine, Rensselaer Polytechnic Institute.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+=========================================================================*/
+
+#pragma once
+
+#include "imstkDynamicObject.h"
+
+namespace imstk
+{
+class ProjectiveDynamicsModel;
+
+///
+/// \class ProjectiveDynamicsObject
+///
+/// \brief Scene objects that deform under the projective dynamics formulation,
+/// implements the ProjectiveDynamicsModel
+///
+class ProjectiveDynamicsObject : public DynamicObject
+{
+public:
+    ProjectiveDynamicsObject(const std::string& name) : DynamicObject(name) { }
+    virtual ~ProjectiveDynamicsObject() override = default;
+
+public:
+    virtual const std::string getTypeName() const override { return "ProjectiveDynamicsObject"; }
+
+    ///
+    /// \brief Get the projective dynamics model of the object
+    ///
+    std::shared_ptr<ProjectiveDynamicsModel> getProjectiveDynamicsModel();
+
+    ///
+    /// \brief Initialize the projective dynamics scene object
+    ///
+    bool initialize() override;
+
+protected:
+    std::shared_ptr<ProjectiveDynamicsModel> m_projectiveDynamicsModel = nullptr; ///> Projective dynamics mathematical model
+};
+} // imstk
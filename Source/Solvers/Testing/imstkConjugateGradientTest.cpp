@@ -0,0 +1,183 @@
+/*=========================================================================
+
+   Library: iMSTK
+
+   Copyright (c) Kitware, Inc. & Center for Modeling, Simulation,
+   & Imaging in Medicine, Rensselaer Polytechnic Institute.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+=========================================================================*/
+
+#include "gtest/gtest.h"
+
+#include "imstkConjugateGradient.h"
+#include "imstkLinearProjectionConstraint.h"
+
+using namespace imstk;
+
+namespace
+{
+///
+/// \brief Symmetric positive definite stiffness like matrix of a chain of nodes with 3 DOF each,
+/// the coupling varies along the chain so the diagonal is not constant
+///
+SparseMatrixd
+chainMatrix(const int numNodes)
+{
+    std::vector<Eigen::Triplet<double>> triplets;
+    for (int i = 0; i < numNodes - 1; i++)
+    {
+        const double k = 1.0 + 10.0 * i / numNodes;
+        for (int d = 0; d < 3; d++)
+        {
+            const int a = 3 * i + d;
+            const int b = 3 * (i + 1) + d;
+            triplets.push_back(Eigen::Triplet<double>(a, a, k));
+            triplets.push_back(Eigen::Triplet<double>(b, b, k));
+            triplets.push_back(Eigen::Triplet<double>(a, b, -k));
+            triplets.push_back(Eigen::Triplet<double>(b, a, -k));
+        }
+    }
+    for (int i = 0; i < 3 * numNodes; i++)
+    {
+        triplets.push_back(Eigen::Triplet<double>(i, i, 0.01));
+    }
+    SparseMatrixd A(3 * numNodes, 3 * numNodes);
+    A.setFromTriplets(triplets.begin(), triplets.end());
+    return A;
+}
+}
+
+///
+/// \brief Test the preconditioners and warm starting
+///
+TEST(imstkConjugateGradientTest, Preconditioners)
+{
+    const SparseMatrixd A = chainMatrix(100);
+    const Vectord       x = Vectord::LinSpaced(A.rows(), -1.0, 1.0);
+    const Vectord       b = A * x;
+
+    size_t numIterations[3];
+    for (int i = 0; i < 3; i++)
+    {
+        ConjugateGradient solver;
+        solver.setPreconditioner(static_cast<ConjugateGradient::Preconditioner>(i));
+        solver.setMaxNumIterations(1000);
+        solver.setTolerance(1.0e-10);
+        solver.setWarmStart(true);
+        solver.setSystem(std::make_shared<LinearSystem<SparseMatrixd>>(A, b));
+
+        Vectord result;
+        solver.solve(result);
+        EXPECT_LT((result - x).norm(), 1.0e-6 * x.norm());
+        numIterations[i] = solver.getNumIterations();
+
+        // Starting from the solution there is nothing left to do
+        solver.solve(result);
+        EXPECT_LT((result - x).norm(), 1.0e-6 * x.norm());
+        EXPECT_LE(solver.getNumIterations(), 1);
+    }
+    EXPECT_LE(numIterations[1], numIterations[0]);
+    EXPECT_LT(numIterations[2], numIterations[1]);
+}
+
+///
+/// \brief Test that without warm starting every solve starts from zero, whatever the previous solution
+///
+TEST(imstkConjugateGradientTest, ColdStartByDefault)
+{
+    const SparseMatrixd A = chainMatrix(100);
+    const Vectord       x = Vectord::LinSpaced(A.rows(), -1.0, 1.0);
+    const Vectord       b = A * x;
+
+    ConjugateGradient solver;
+    EXPECT_FALSE(solver.getWarmStart());
+    solver.setMaxNumIterations(1000);
+    solver.setTolerance(1.0e-10);
+    solver.setSystem(std::make_shared<LinearSystem<SparseMatrixd>>(A, b));
+
+    Vectord result;
+    solver.solve(result);
+    EXPECT_LT((result - x).norm(), 1.0e-6 * x.norm());
+    const size_t numIterations = solver.getNumIterations();
+    EXPECT_GT(numIterations, 1);
+
+    // The input is ignored too, the second solve repeats the first one
+    result.setRandom();
+    solver.solve(result);
+    EXPECT_LT((result - x).norm(), 1.0e-6 * x.norm());
+    EXPECT_EQ(solver.getNumIterations(), numIterations);
+}
+
+///
+/// \brief Test that fixed nodes keep their prescribed values with the preconditioners
+///
+TEST(imstkConjugateGradientTest, LinearProjection)
+{
+    const SparseMatrixd A = chainMatrix(20);
+    const Vectord       b = Vectord::Ones(A.rows());
+
+    std::vector<LinearProjectionConstraint> fixed;
+    fixed.push_back(LinearProjectionConstraint(0, true));
+    fixed.push_back(LinearProjectionConstraint(19, true));
+    fixed.back().setValue(Vec3d(1.0, 2.0, 3.0));
+
+    for (int i = 0; i < 3; i++)
+    {
+        ConjugateGradient solver;
+        solver.setPreconditioner(static_cast<ConjugateGradient::Preconditioner>(i));
+        solver.setMaxNumIterations(1000);
+        solver.setTolerance(1.0e-10);
+        solver.setLinearProjectors(&fixed);
+        solver.setSystem(std::make_shared<LinearSystem<SparseMatrixd>>(A, b));
+
+        Vectord result;
+        solver.solve(result);
+        EXPECT_NEAR((result.head<3>() - Vec3d::Zero()).norm(), 0.0, 1.0e-12);
+        EXPECT_NEAR((result.segment<3>(57) - Vec3d(1.0, 2.0, 3.0)).norm(), 0.0, 1.0e-12);
+
+        // The free DOF satisfy the equations
+        const Vectord residual = (b - A * result).segment(3, 54);
+        EXPECT_LT(residual.norm(), 1.0e-6 * b.norm());
+    }
+}
+
+///
+/// \brief Test that a matrix-free system gives the same solution and iterations as the assembled one
+///
+TEST(imstkConjugateGradientTest, MatrixFree)
+{
+    const SparseMatrixd A = chainMatrix(100);
+    const Vectord       x = Vectord::LinSpaced(A.rows(), -1.0, 1.0);
+    const Vectord       b = A * x;
+    const Vectord       diagonal = A.diagonal();
+    const SparseMatrixd empty;
+
+    ConjugateGradient assembled;
+    assembled.setTolerance(1.0e-10);
+    assembled.setSystem(std::make_shared<LinearSystem<SparseMatrixd>>(A, b));
+    Vectord assembledResult;
+    assembled.solve(assembledResult);
+
+    auto system = std::make_shared<LinearSystem<SparseMatrixd>>(empty, b);
+    system->setMatrixFreeProduct([&](const Vectord& v, Vectord& y) { y = A * v; }, &diagonal);
+    ConjugateGradient matrixFree;
+    matrixFree.setTolerance(1.0e-10);
+    matrixFree.setSystem(system);
+    Vectord result;
+    matrixFree.solve(result);
+
+    EXPECT_LT((result - x).norm(), 1.0e-6 * x.norm());
+    EXPECT_EQ(matrixFree.getNumIterations(), assembled.getNumIterations());
+}
@@ -0,0 +1,87 @@
+/*=========================================================================
+
+   Library: iMSTK
+
+   Copyright (c) Kitware, Inc. & Center for Modeling, Simulation,
+   & Imaging in Medicine, Rensselaer Polytechnic Institute.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+=========================================================================*/
+
+#include "gtest/gtest.h"
+
+#include "imstkDirectLinearSolver.h"
+
+using namespace imstk;
+
+namespace
+{
+///
+/// \brief Symmetric positive definite matrix of a 1D Laplacian plus a diagonal shift
+///
+SparseMatrixd
+laplacian(const int n, const double shift)
+{
+    std::vector<Eigen::Triplet<double>> triplets;
+    for (int i = 0; i < n; i++)
+    {
+        triplets.push_back(Eigen::Triplet<double>(i, i, 2.0 + shift));
+        if (i > 0)
+        {
+            triplets.push_back(Eigen::Triplet<double>(i, i - 1, -1.0));
+            triplets.push_back(Eigen::Triplet<double>(i - 1, i, -1.0));
+        }
+    }
+    SparseMatrixd A(n, n);
+    A.setFromTriplets(triplets.begin(), triplets.end());
+    return A;
+}
+}
+
+///
+/// \brief Test the sparse decompositions, refactorizing with the same and a different sparsity pattern
+///
+TEST(imstkDirectLinearSolverTest, SolveSparse)
+{
+    const int     n = 50;
+    const Vectord x = Vectord::LinSpaced(n, -1.0, 1.0);
+
+    for (auto factorization : { DirectLinearSolver<SparseMatrixd>::Factorization::LU,
+                                DirectLinearSolver<SparseMatrixd>::Factorization::LDLT })
+    {
+        SparseMatrixd A = laplacian(n, 0.1);
+        Vectord       b = A * x;
+        DirectLinearSolver<SparseMatrixd> solver(A, b, factorization);
+
+        Vectord result;
+        solver.solve(result);
+        EXPECT_LT((result - x).norm(), 1.0e-10);
+
+        // Same pattern, new values
+        SparseMatrixd A2 = laplacian(n, 1.0);
+        Vectord       b2 = A2 * x;
+        solver.setSystem(std::make_shared<LinearSystem<SparseMatrixd>>(A2, b2));
+        solver.solve(result);
+        EXPECT_LT((result - x).norm(), 1.0e-10);
+
+        // New pattern
+        SparseMatrixd A3 = laplacian(n, 1.0);
+        A3.coeffRef(0, n - 1) = -0.5;
+        A3.coeffRef(n - 1, 0) = -0.5;
+        Vectord b3 = A3 * x;
+        solver.setSystem(std::make_shared<LinearSystem<SparseMatrixd>>(A3, b3));
+        solver.solve(result);
+        EXPECT_LT((result - x).norm(), 1.0e-10);
+    }
+}
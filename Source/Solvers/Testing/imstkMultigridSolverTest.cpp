@@ -0,0 +1,199 @@
+/*=========================================================================
+
+   Library: iMSTK
+
+   Copyright (c) Kitware, Inc. & Center for Modeling, Simulation,
+   & Imaging in Medicine, Rensselaer Polytechnic Institute.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+=========================================================================*/
+
+#include "gtest/gtest.h"
+
+#include "imstkConjugateGradient.h"
+#include "imstkMultigridSolver.h"
+
+using namespace imstk;
+
+namespace
+{
+///
+/// \brief Finite difference Laplacian of a n^3 grid, plus a small shift, repeated for
+/// \p blockSize interleaved components per grid node
+///
+SparseMatrixd
+gridLaplacian(const int n, const int blockSize = 1)
+{
+    auto id = [n](int x, int y, int z) { return x + n * (y + n * z); };
+
+    std::vector<Eigen::Triplet<double>> triplets;
+    for (int z = 0; z < n; z++)
+    {
+        for (int y = 0; y < n; y++)
+        {
+            for (int x = 0; x < n; x++)
+            {
+                const int i = id(x, y, z);
+                for (int d = 0; d < blockSize; d++)
+                {
+                    triplets.push_back(Eigen::Triplet<double>(blockSize * i + d, blockSize * i + d, 6.0 + 1.0e-3));
+                }
+                const int neighbors[6][3] = { { x - 1, y, z }, { x + 1, y, z }, { x, y - 1, z },
+                                              { x, y + 1, z }, { x, y, z - 1 }, { x, y, z + 1 } };
+                for (const auto& c : neighbors)
+                {
+                    if (c[0] >= 0 && c[0] < n && c[1] >= 0 && c[1] < n && c[2] >= 0 && c[2] < n)
+                    {
+                        for (int d = 0; d < blockSize; d++)
+                        {
+                            triplets.push_back(Eigen::Triplet<double>(blockSize * i + d, blockSize * id(c[0], c[1], c[2]) + d, -1.0));
+                        }
+                    }
+                }
+            }
+        }
+    }
+    SparseMatrixd A(blockSize * n * n * n, blockSize * n * n * n);
+    A.setFromTriplets(triplets.begin(), triplets.end());
+    return A;
+}
+}
+
+///
+/// \brief Test that the V-cycles converge in a number of iterations nearly independent of the size
+///
+TEST(imstkMultigridSolverTest, Solve)
+{
+    for (auto smoother : { MultigridSolver::Smoother::GaussSeidel, MultigridSolver::Smoother::Jacobi })
+    {
+        size_t numIterations[2];
+        for (int k = 0; k < 2; k++)
+        {
+            const SparseMatrixd A = gridLaplacian(k == 0 ? 10 : 20);
+            const Vectord       x = Vectord::LinSpaced(A.rows(), -1.0, 1.0);
+            const Vectord       b = A * x;
+
+            MultigridSolver solver;
+            solver.setSmoother(smoother);
+            solver.setCoarsestSize(100);
+            solver.setTolerance(1.0e-8);
+            solver.setSystem(std::make_shared<LinearSystem<SparseMatrixd>>(A, b));
+            EXPECT_GT(solver.getNumLevels(), 2);
+
+            Vectord result;
+            solver.solve(result);
+            EXPECT_LT((b - A * result).norm(), 1.0e-8 * b.norm());
+            numIterations[k] = solver.getNumIterations();
+        }
+        EXPECT_LT(numIterations[0], 30);
+        EXPECT_LE(numIterations[1], numIterations[0] + 5);
+    }
+}
+
+///
+/// \brief Test the aggregation of 3 DOF per node and the reuse of the hierarchy for new values
+///
+TEST(imstkMultigridSolverTest, BlockSystem)
+{
+    SparseMatrixd A = gridLaplacian(8, 3);
+    const Vectord x = Vectord::LinSpaced(A.rows(), -1.0, 1.0);
+    Vectord       b = A * x;
+
+    MultigridSolver solver;
+    solver.setBlockSize(3);
+    solver.setCoarsestSize(100);
+    solver.setTolerance(1.0e-8);
+    solver.setSystem(std::make_shared<LinearSystem<SparseMatrixd>>(A, b));
+    const size_t numLevels = solver.getNumLevels();
+    EXPECT_GT(numLevels, 1);
+
+    Vectord result;
+    solver.solve(result);
+    EXPECT_LT((b - A * result).norm(), 1.0e-8 * b.norm());
+
+    // Same pattern, the aggregates are reused
+    A *= 2.0;
+    b  = A * x;
+    solver.setSystem(std::make_shared<LinearSystem<SparseMatrixd>>(A, b));
+    EXPECT_EQ(solver.getNumLevels(), numLevels);
+    solver.solve(result);
+    EXPECT_LT((result - x).norm(), 1.0e-6 * x.norm());
+}
+
+///
+/// \brief Test that a new pattern with as many nonzeros rebuilds the hierarchy
+///
+TEST(imstkMultigridSolverTest, PatternChange)
+{
+    const SparseMatrixd A = gridLaplacian(10);
+
+    // Renumbering the nodes keeps the size and the number of nonzeros but not the pattern
+    Eigen::PermutationMatrix<Eigen::Dynamic, Eigen::Dynamic, int> permutation(A.rows());
+    for (int i = 0; i < A.rows(); i++)
+    {
+        permutation.indices()[i] = (7 * i) % A.rows();
+    }
+    const SparseMatrixd permutedA = permutation * A * permutation.transpose();
+    ASSERT_EQ(permutedA.nonZeros(), A.nonZeros());
+
+    const Vectord x = Vectord::LinSpaced(A.rows(), -1.0, 1.0);
+    const Vectord b = permutedA * x;
+
+    MultigridSolver reusedSolver;
+    reusedSolver.setCoarsestSize(100);
+    reusedSolver.setTolerance(1.0e-8);
+    reusedSolver.setSystem(std::make_shared<LinearSystem<SparseMatrixd>>(A, A * x));
+    reusedSolver.setSystem(std::make_shared<LinearSystem<SparseMatrixd>>(permutedA, b));
+
+    MultigridSolver newSolver;
+    newSolver.setCoarsestSize(100);
+    newSolver.setTolerance(1.0e-8);
+    newSolver.setSystem(std::make_shared<LinearSystem<SparseMatrixd>>(permutedA, b));
+
+    Vectord reusedResult, newResult;
+    reusedSolver.solve(reusedResult);
+    newSolver.solve(newResult);
+    EXPECT_LT((b - permutedA * reusedResult).norm(), 1.0e-8 * b.norm());
+    EXPECT_EQ(reusedSolver.getNumLevels(), newSolver.getNumLevels());
+    EXPECT_EQ(reusedSolver.getNumIterations(), newSolver.getNumIterations());
+    EXPECT_LT((reusedResult - newResult).norm(), 1.0e-12 * newResult.norm());
+}
+
+///
+/// \brief Test the multigrid preconditioner of the conjugate gradient
+///
+TEST(imstkMultigridSolverTest, Preconditioner)
+{
+    const SparseMatrixd A = gridLaplacian(16);
+    const Vectord       x = Vectord::LinSpaced(A.rows(), -1.0, 1.0);
+    const Vectord       b = A * x;
+
+    size_t numIterations[2];
+    int    k = 0;
+    for (auto preconditioner : { ConjugateGradient::Preconditioner::Jacobi, ConjugateGradient::Preconditioner::Multigrid })
+    {
+        ConjugateGradient solver;
+        solver.setPreconditioner(preconditioner);
+        solver.getMultigridPreconditioner()->setCoarsestSize(100);
+        solver.setMaxNumIterations(1000);
+        solver.setTolerance(1.0e-10);
+        solver.setSystem(std::make_shared<LinearSystem<SparseMatrixd>>(A, b));
+
+        Vectord result;
+        solver.solve(result);
+        EXPECT_LT((result - x).norm(), 1.0e-6 * x.norm());
+        numIterations[k++] = solver.getNumIterations();
+    }
+    EXPECT_LT(2 * numIterations[1], numIterations[0]);
+}
@@ -91,3 +91,105 @@ TEST(imstkNewtonSolverTest, Solve)
     nlSolver->solveGivenState(x);
     EXPECT_NEAR(0.0, (x - xe).norm(), 0.00000001);
 }
+
+///
+/// \brief Lagging the Jacobian converges to the same root with fewer Jacobian updates
+///
+TEST(imstkNewtonSolverTest, SolveWithLaggedJacobian)
+{
+    const int N = 2;
+    Vectord   x(N);
+    Vectord   y(N);
+    Matrixd   A = Matrixd::Zero(N, N);
+    Vectord   xe(N);
+    xe << 1.0, 10.0;
+
+    auto func = [&y](const Vectord& x, const bool) -> const Vectord& {
+                    y[0] = x[0] * x[0] * x[0] - 1.0;
+                    y[1] = x[1] * x[1] - 100.0;
+                    return y;
+                };
+    auto funcJacobian = [&A](const Vectord& x) -> const Matrixd& {
+                            A(0, 0) = 3.0 * x[0] * x[0];
+                            A(1, 1) = 2.0 * x[1];
+                            return A;
+                        };
+    auto updateX    = [&x](const Vectord& du, const bool) { x -= du; };
+    auto updateXold = [](void) {};
+
+    size_t numUpdates[2];
+    for (const bool reuse : { false, true })
+    {
+        imstkNew<NonLinearSystem<Matrixd>> nlSystem(func, funcJacobian);
+        nlSystem->setUnknownVector(x);
+        nlSystem->setUpdateFunction(updateX);
+        nlSystem->setUpdatePreviousStatesFunction(updateXold);
+
+        imstkNew<DirectLinearSolver<Matrixd>> linSolver;
+        imstkNew<NewtonSolver<Matrixd>>       nlSolver;
+        nlSolver->setMaxIterations(100);
+        nlSolver->setRelativeTolerance(1e-8);
+        nlSolver->setSystem(nlSystem);
+        nlSolver->setLinearSolver(linSolver);
+        nlSolver->setJacobianReuse(reuse);
+        nlSolver->setMaxJacobianAge(100);
+
+        x << 1.5, 12.0;
+        nlSolver->solve();
+        EXPECT_NEAR(0.0, (x - xe).norm(), 1e-8);
+        numUpdates[reuse] = nlSolver->getNumJacobianUpdates();
+
+        // The Jacobian of the solution is kept for the next solve
+        x << 1.01, 10.1;
+        nlSolver->solve();
+        EXPECT_NEAR(0.0, (x - xe).norm(), 1e-8);
+        if (reuse)
+        {
+            EXPECT_EQ(nlSolver->getNumJacobianUpdates(), numUpdates[reuse]);
+        }
+    }
+    EXPECT_LT(numUpdates[true], numUpdates[false]);
+}
+
+///
+/// \brief Full Newton steps diverge on atan(x) = 0 when started far enough from the root,
+/// the line search makes the iteration converge
+///
+TEST(imstkNewtonSolverTest, SolveWithLineSearch)
+{
+    Vectord x(1);
+    Vectord y(1);
+    Matrixd A(1, 1);
+
+    auto func = [&y](const Vectord& x, const bool) -> const Vectord& {
+                    y[0] = std::atan(x[0]);
+                    return y;
+                };
+    auto funcJacobian = [&A](const Vectord& x) -> const Matrixd& {
+                            A(0, 0) = 1.0 / (1.0 + x[0] * x[0]);
+                            return A;
+                        };
+    auto updateX    = [&x](const Vectord& du, const bool) { x -= du; };
+    auto updateXold = [](void) {};
+
+    imstkNew<NonLinearSystem<Matrixd>> nlSystem(func, funcJacobian);
+    nlSystem->setUnknownVector(x);
+    nlSystem->setUpdateFunction(updateX);
+    nlSystem->setUpdatePreviousStatesFunction(updateXold);
+
+    imstkNew<DirectLinearSolver<Matrixd>> linSolver;
+    imstkNew<NewtonSolver<Matrixd>>       nlSolver;
+    nlSolver->setMaxIterations(3);
+    nlSolver->setSystem(nlSystem);
+    nlSolver->setLinearSolver(linSolver);
+
+    x[0] = 3.0;
+    nlSolver->solve();
+    EXPECT_GT(std::abs(x[0]), 100.0);
+
+    nlSolver->setMaxIterations(20);
+    nlSolver->setUseLineSearch(true);
+    x[0] = 3.0;
+    nlSolver->solve();
+    EXPECT_NEAR(0.0, x[0], 1e-8);
+}
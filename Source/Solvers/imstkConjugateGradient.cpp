@@ -22,14 +22,43 @@
 #include "imstkConjugateGradient.h"
 #include "imstkLinearProjectionConstraint.h"
 #include "imstkLogger.h"
+#include "imstkMultigridSolver.h"
+#include "imstkParallelUtils.h"
 
 namespace imstk
 {
+namespace
+{
+///
+/// \brief System matrix vector product y = A x, rows of an assembled matrix are computed in parallel
+///
+void
+multiply(const LinearSystem<SparseMatrixd>& system, const Vectord& x, Vectord& y)
+{
+    if (system.isMatrixFree())
+    {
+        system.multiply(x, y);
+        return;
+    }
+
+    const SparseMatrixd& A = system.getMatrix();
+    y.resize(A.rows());
+    ParallelUtils::parallelFor(static_cast<Eigen::Index>(A.rows()),
+        [&](const Eigen::Index row)
+        {
+            double sum = 0.0;
+            for (SparseMatrixd::InnerIterator it(A, row); it; ++it)
+            {
+                sum += it.value() * x[it.col()];
+            }
+            y[row] = sum;
+        });
+}
+}
+
 ConjugateGradient::ConjugateGradient()
 {
     m_type = Type::ConjugateGradient;
-    m_cgSolver.setMaxIterations(m_maxIterations);
-    m_cgSolver.setTolerance(m_tolerance);
 }
 
 ConjugateGradient::ConjugateGradient(const SparseMatrixd& A, const Vectord& rhs) : ConjugateGradient()
@@ -57,127 +86,193 @@ ConjugateGradient::applyLinearProjectionFilter(Vectord& x, const std::vector<Lin
 }
 
 void
-ConjugateGradient::solve(Vectord& x)
+ConjugateGradient::applyLinearProjectionFilters(Vectord& x, const bool setVal)
 {
-    if (!m_linearSystem)
+    if (m_DynamicLinearProjConstraints)
     {
-        LOG(WARNING) << "Linear system is not supplied for CG solver!";
-        return;
+        applyLinearProjectionFilter(x, *m_DynamicLinearProjConstraints, setVal);
     }
-
-    if (!(m_FixedLinearProjConstraints || m_DynamicLinearProjConstraints))
+    if (m_FixedLinearProjConstraints)
     {
-        x = m_cgSolver.solve(m_linearSystem->getRHSVector());
+        applyLinearProjectionFilter(x, *m_FixedLinearProjConstraints, setVal);
     }
-    else
+}
+
+std::shared_ptr<MultigridSolver>
+ConjugateGradient::getMultigridPreconditioner()
+{
+    if (!m_multigrid)
     {
-        this->modifiedCGSolve(x);
+        m_multigrid = std::make_shared<MultigridSolver>();
     }
+    return m_multigrid;
 }
 
 void
-ConjugateGradient::modifiedCGSolve(Vectord& x)
+ConjugateGradient::applyPreconditioner(const Vectord& res, Vectord& precRes) const
 {
-    const auto& b = m_linearSystem->getRHSVector();
-    const auto& A = m_linearSystem->getMatrix();
-
-    // Set the initial guess to zero
-    x.setZero();
-    if (m_DynamicLinearProjConstraints)
+    if (m_preconditioner == Preconditioner::IncompleteCholesky && m_incompleteCholeskyValid)
+    {
+        precRes = m_incompleteCholesky.solve(res);
+    }
+    else if (m_preconditioner == Preconditioner::Multigrid && m_multigrid && !m_linearSystem->isMatrixFree())
+    {
+        m_multigrid->vCycle(res, precRes);
+    }
+    else if (m_preconditioner != Preconditioner::None)
     {
-        applyLinearProjectionFilter(x, *m_DynamicLinearProjConstraints, true);
+        precRes = m_invDiagonal.cwiseProduct(res);
     }
+    else
+    {
+        precRes = res;
+    }
+}
 
-    if (m_FixedLinearProjConstraints)
+void
+ConjugateGradient::solve(Vectord& x)
+{
+    if (!m_linearSystem)
     {
-        applyLinearProjectionFilter(x, *m_FixedLinearProjConstraints, true);
+        LOG(WARNING) << "Linear system is not supplied for CG solver!";
+        return;
     }
 
-    auto res = b;
-    if (m_DynamicLinearProjConstraints)
+    this->modifiedCGSolve(x);
+}
+
+void
+ConjugateGradient::modifiedCGSolve(Vectord& x)
+{
+    const auto& b = m_linearSystem->getRHSVector();
+
+    // Start from the previous solution or zero, the constrained values are set by the filters
+    if (m_warmStart && m_previousSolution.size() == b.size())
     {
-        applyLinearProjectionFilter(res, *m_DynamicLinearProjConstraints, false);
+        x = m_previousSolution;
     }
-    if (m_FixedLinearProjConstraints)
+    else
     {
-        applyLinearProjectionFilter(res, *m_FixedLinearProjConstraints, false);
+        x.setZero(b.size());
     }
-    auto       c     = res;
-    auto       delta = res.dot(res);
-    const auto eps   = m_tolerance * m_tolerance * delta;
-    double     alpha = 0.0;
-    Vectord    q;
-    size_t     iterNum = 0;
+    applyLinearProjectionFilters(x, true);
 
-    while (delta > eps)
+    // The tolerance is relative to the right hand side rather than to the initial residual,
+    // so a good initial guess ends the iterations early
+    m_residual = b;
+    applyLinearProjectionFilters(m_residual, false);
+    applyPreconditioner(m_residual, m_precResidual);
+    const double delta0 = m_residual.dot(m_precResidual);
+    const double eps    = m_tolerance * m_tolerance * delta0;
+
+    multiply(*m_linearSystem, x, m_directionProduct);
+    m_residual = b - m_directionProduct;
+    applyLinearProjectionFilters(m_residual, false);
+    applyPreconditioner(m_residual, m_precResidual);
+    m_direction = m_precResidual;
+    applyLinearProjectionFilters(m_direction, false);
+
+    double delta = m_residual.dot(m_precResidual);
+    size_t iterNum = 0;
+    while (delta > eps && iterNum < m_maxIterations)
     {
-        q = A * c;
-        if (m_DynamicLinearProjConstraints)
-        {
-            applyLinearProjectionFilter(q, *m_DynamicLinearProjConstraints, false);
-        }
-        if (m_FixedLinearProjConstraints)
-        {
-            applyLinearProjectionFilter(q, *m_FixedLinearProjConstraints, false);
-        }
-        double dotval = c.dot(q);
-        if (dotval != 0.0)
-        {
-            alpha = delta / dotval;
-        }
-        else
+        multiply(*m_linearSystem, m_direction, m_directionProduct);
+        applyLinearProjectionFilters(m_directionProduct, false);
+
+        const double dotval = m_direction.dot(m_directionProduct);
+        if (dotval == 0.0)
         {
             LOG(WARNING) << "Warning: denominator zero. Terminating MCG iteration!";
-            return;
+            break;
         }
-        x   += alpha * c;
-        res -= alpha * q;
+        const double alpha = delta / dotval;
+        x          += alpha * m_direction;
+        m_residual -= alpha * m_directionProduct;
+
+        applyPreconditioner(m_residual, m_precResidual);
         const double deltaPrev = delta;
-        delta = res.dot(res);
-        c    *= delta / deltaPrev;
-        c    += res;
-        if (m_DynamicLinearProjConstraints)
-        {
-            applyLinearProjectionFilter(c, *m_DynamicLinearProjConstraints, false);
-        }
-        if (m_FixedLinearProjConstraints)
-        {
-            applyLinearProjectionFilter(c, *m_FixedLinearProjConstraints, false);
-        }
+        delta        = m_residual.dot(m_precResidual);
+        m_direction *= delta / deltaPrev;
+        m_direction += m_precResidual;
+        applyLinearProjectionFilters(m_direction, false);
 
-        if (++iterNum >= m_maxIterations)
-        {
-            //LOG(WARNING) << "ConjugateGradient::modifiedCGSolve - The solver did not converge after max. iterations";
-            break;
-        }
+        ++iterNum;
     }
+
+    m_numIterations    = iterNum;
+    m_relativeResidual = delta0 > 0.0 ? std::sqrt(std::max(delta, 0.0) / delta0) : 0.0;
+    m_previousSolution = x;
 }
 
 double
 ConjugateGradient::getResidual(const Vectord&)
 {
-    return m_cgSolver.error();
+    return m_relativeResidual;
 }
 
 void
 ConjugateGradient::setTolerance(const double epsilon)
 {
     IterativeLinearSolver::setTolerance(epsilon);
-    m_cgSolver.setTolerance(epsilon);
 }
 
 void
 ConjugateGradient::setMaxNumIterations(const size_t maxIter)
 {
     IterativeLinearSolver::setMaxNumIterations(maxIter);
-    m_cgSolver.setMaxIterations(maxIter);
 }
 
 void
 ConjugateGradient::setSystem(std::shared_ptr<LinearSystem<SparseMatrixd>> newSystem)
 {
     LinearSolver<SparseMatrixd>::setSystem(newSystem);
-    m_cgSolver.compute(m_linearSystem->getMatrix());
+
+    const SparseMatrixd& A = m_linearSystem->getMatrix();
+    const bool           matrixFree = m_linearSystem->isMatrixFree();
+    if (m_preconditioner == Preconditioner::IncompleteCholesky)
+    {
+        m_incompleteCholeskyValid = false;
+        if (matrixFree)
+        {
+            LOG(WARNING) << "Incomplete Cholesky needs an assembled matrix, using the Jacobi preconditioner";
+        }
+        else
+        {
+            m_incompleteCholesky.compute(A);
+            m_incompleteCholeskyValid = m_incompleteCholesky.info() == Eigen::Success;
+            LOG_IF(WARNING, !m_incompleteCholeskyValid) << "Incomplete Cholesky factorization failed, using the Jacobi preconditioner";
+        }
+    }
+    else if (m_preconditioner == Preconditioner::Multigrid)
+    {
+        if (matrixFree)
+        {
+            LOG(WARNING) << "Multigrid needs an assembled matrix, using the Jacobi preconditioner";
+        }
+        else
+        {
+            getMultigridPreconditioner()->setSystem(newSystem);
+        }
+    }
+
+    // Also the fallback of the incomplete Cholesky preconditioner, zero diagonal entries are left unscaled.
+    // Matrix-free systems provide their diagonal, without it the preconditioner is the identity
+    if (m_preconditioner != Preconditioner::None)
+    {
+        if (matrixFree)
+        {
+            const Vectord* diagonal = m_linearSystem->getMatrixFreeDiagonal();
+            m_invDiagonal = diagonal ? *diagonal : Vectord::Zero(m_linearSystem->getRHSVector().size());
+        }
+        else
+        {
+            m_invDiagonal = A.diagonal();
+        }
+        for (Eigen::Index i = 0; i < m_invDiagonal.size(); i++)
+        {
+            m_invDiagonal[i] = m_invDiagonal[i] != 0.0 ? 1.0 / m_invDiagonal[i] : 1.0;
+        }
+    }
 }
 
 void
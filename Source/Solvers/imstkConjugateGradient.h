@@ -28,11 +28,26 @@
 namespace imstk
 {
 class LinearProjectionConstraint;
+class MultigridSolver;
 ///
-/// \brief Conjugate gradient sparse linear solver for SPD matrices
+/// \brief Preconditioned conjugate gradient sparse linear solver for SPD matrices.
+///     Linear projection constraints are enforced by filtering the iterates (Baraff and Witkin 1998),
+///     the solve starts from the previous solution unless warm starting is disabled
 ///
 class ConjugateGradient : public IterativeLinearSolver
 {
+public:
+    ///
+    /// \brief Preconditioner applied to the residual
+    ///
+    enum class Preconditioner
+    {
+        None,
+        Jacobi,            ///> Inverse of the diagonal
+        IncompleteCholesky, ///> Incomplete Cholesky factorization with AMD ordering, refactorized for every system
+        Multigrid           ///> One V-cycle of the algebraic multigrid solver, rebuilt for every system
+    };
+
 public:
     ///
     /// \brief Constructors/Destructor
@@ -83,6 +98,30 @@ public:
     ///
     void setTolerance(const double tolerance);
 
+    ///
+    /// \brief Set/Get the preconditioner, takes effect on the next system set
+    ///
+    void setPreconditioner(const Preconditioner preconditioner) { m_preconditioner = preconditioner; }
+    Preconditioner getPreconditioner() const { return m_preconditioner; }
+
+    ///
+    /// \brief Get the multigrid solver applied by the multigrid preconditioner, eg: to set its block size.
+    /// It is created on the first call or when a system is set with the multigrid preconditioner
+    ///
+    std::shared_ptr<MultigridSolver> getMultigridPreconditioner();
+
+    ///
+    /// \brief Set/Get whether the solve starts from the previous solution instead of zero,
+    /// off by default
+    ///
+    void setWarmStart(const bool warmStart) { m_warmStart = warmStart; }
+    bool getWarmStart() const { return m_warmStart; }
+
+    ///
+    /// \brief Returns the number of iterations of the last solve
+    ///
+    size_t getNumIterations() const { return m_numIterations; }
+
     ///
     /// \brief Print solver information
     ///
@@ -129,10 +168,34 @@ private:
     ///
     void modifiedCGSolve(Vectord& x);
 
-    ///> Pointer to the Eigen's Conjugate gradient solver
-    Eigen::ConjugateGradient<SparseMatrixd> m_cgSolver;
+    ///
+    /// \brief Apply the dynamic and fixed linear projection filters
+    ///
+    void applyLinearProjectionFilters(Vectord& x, const bool setVal);
+
+    ///
+    /// \brief Apply the preconditioner to the residual
+    ///
+    void applyPreconditioner(const Vectord& res, Vectord& precRes) const;
 
     std::vector<LinearProjectionConstraint>* m_FixedLinearProjConstraints   = nullptr;
     std::vector<LinearProjectionConstraint>* m_DynamicLinearProjConstraints = nullptr;
+
+    Preconditioner m_preconditioner = Preconditioner::Jacobi;
+    Vectord        m_invDiagonal;                                                                      ///> Jacobi preconditioner
+    Eigen::IncompleteCholesky<double, Eigen::Lower, Eigen::AMDOrdering<int>> m_incompleteCholesky; ///> Incomplete Cholesky preconditioner
+    bool m_incompleteCholeskyValid = false;                                                             ///> False if the factorization failed
+    std::shared_ptr<MultigridSolver> m_multigrid;                                                       ///> Multigrid preconditioner, created on demand
+
+    bool    m_warmStart = false;
+    Vectord m_previousSolution;    ///> Solution of the last solve, initial guess of the next one
+
+    // Work vectors kept between solves, the residual is IterativeLinearSolver::m_residual
+    Vectord m_precResidual;        ///> Preconditioned residual
+    Vectord m_direction;           ///> Search direction
+    Vectord m_directionProduct;    ///> System matrix times the search direction
+
+    size_t m_numIterations    = 0;   ///> Iterations of the last solve
+    double m_relativeResidual = 0.0; ///> Preconditioned residual norm of the last solve relative to the right hand side
 };
 } // imstk
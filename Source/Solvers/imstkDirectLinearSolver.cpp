@@ -40,10 +40,12 @@ setSystem(std::shared_ptr<LinearSystem<Matrixd>> newSystem)
 }
 
 DirectLinearSolver<SparseMatrixd>::
-DirectLinearSolver(const SparseMatrixd& matrix, const Vectord& b)
+DirectLinearSolver(const SparseMatrixd& matrix, const Vectord& b, const Factorization factorization) :
+    m_factorization(factorization)
 {
+    m_type = Type::LUFactorization;
     m_linearSystem = std::make_shared<LinearSystem<SparseMatrixd>>(matrix, b);
-    m_solver.compute(matrix);
+    factorize(matrix);
 }
 
 void
@@ -51,7 +53,71 @@ DirectLinearSolver<SparseMatrixd>::
 setSystem(std::shared_ptr<LinearSystem<SparseMatrixd>> newSystem)
 {
     LinearSolver<SparseMatrixd>::setSystem(newSystem);
-    m_solver.compute(m_linearSystem->getMatrix());
+    factorize(m_linearSystem->getMatrix());
+}
+
+void
+DirectLinearSolver<SparseMatrixd>::setFactorization(const Factorization factorization)
+{
+    if (factorization != m_factorization)
+    {
+        m_factorization   = factorization;
+        m_patternAnalyzed = false;
+    }
+}
+
+bool
+DirectLinearSolver<SparseMatrixd>::hasAnalyzedPattern(const SparseMatrixd& matrix) const
+{
+    return m_patternAnalyzed
+           && matrix.rows() == m_patternRows
+           && static_cast<size_t>(matrix.nonZeros()) == m_patternInnerIndices.size()
+           && std::equal(m_patternOuterIndices.begin(), m_patternOuterIndices.end(), matrix.outerIndexPtr())
+           && std::equal(m_patternInnerIndices.begin(), m_patternInnerIndices.end(), matrix.innerIndexPtr());
+}
+
+void
+DirectLinearSolver<SparseMatrixd>::factorize(const SparseMatrixd& matrix)
+{
+    // The pattern is compared on the compressed storage
+    const SparseMatrixd* compressedMatrix = &matrix;
+    if (!matrix.isCompressed())
+    {
+        m_compressedMatrix = matrix;
+        m_compressedMatrix.makeCompressed();
+        compressedMatrix = &m_compressedMatrix;
+    }
+    const SparseMatrixd& A = *compressedMatrix;
+
+    // Ordering and symbolic analysis only when the sparsity pattern changed
+    if (!hasAnalyzedPattern(A))
+    {
+        if (m_factorization == Factorization::LDLT)
+        {
+            m_ldltSolver.analyzePattern(A);
+        }
+        else
+        {
+            m_luSolver.analyzePattern(A);
+        }
+        m_patternRows = A.rows();
+        m_patternOuterIndices.assign(A.outerIndexPtr(), A.outerIndexPtr() + A.outerSize() + 1);
+        m_patternInnerIndices.assign(A.innerIndexPtr(), A.innerIndexPtr() + A.nonZeros());
+        m_patternAnalyzed = true;
+    }
+
+    Eigen::ComputationInfo info;
+    if (m_factorization == Factorization::LDLT)
+    {
+        m_ldltSolver.factorize(A);
+        info = m_ldltSolver.info();
+    }
+    else
+    {
+        m_luSolver.factorize(A);
+        info = m_luSolver.info();
+    }
+    LOG_IF(WARNING, info != Eigen::Success) << "DirectLinearSolver: factorization of the sparse matrix failed";
 }
 
 void
@@ -61,7 +127,14 @@ DirectLinearSolver<SparseMatrixd>::solve(const Vectord& rhs, Vectord& x)
     {
         LOG(FATAL) << "Linear system has not been set";
     }
-    x = m_solver.solve(rhs);
+    if (m_factorization == Factorization::LDLT)
+    {
+        x = m_ldltSolver.solve(rhs);
+    }
+    else
+    {
+        x = m_luSolver.solve(rhs);
+    }
 }
 
 void
@@ -71,10 +144,7 @@ DirectLinearSolver<SparseMatrixd>::solve(Vectord& x)
     {
         LOG(FATAL) << "Linear system has not been set";
     }
-    x.setZero();
-
-    auto b = m_linearSystem->getRHSVector();
-    x = m_solver.solve(b);
+    solve(m_linearSystem->getRHSVector(), x);
 }
 
 void
@@ -30,6 +30,7 @@
 #endif
 #include <Eigen/Sparse>
 #include <Eigen/SparseLU>
+#include <Eigen/SparseCholesky>
 #ifdef WIN32
 #pragma warning( pop )
 #endif
@@ -93,22 +94,34 @@ private:
 
 ///
 /// \brief Sparse direct solvers. Solves a sparse system of equations using a sparse LU
-///     decomposition.
+///     decomposition, or a sparse LDLT decomposition for symmetric positive definite systems.
+///     The ordering and symbolic analysis are only redone when the sparsity pattern of the
+///     matrix changes, setting a system with the same pattern only repeats the numeric factorization.
 ///
 template<>
 class DirectLinearSolver<SparseMatrixd>: public LinearSolver<SparseMatrixd>
 {
+public:
+    ///
+    /// \brief Decomposition used to factorize the matrix
+    ///
+    enum class Factorization
+    {
+        LU,  ///> Sparse LU with COLAMD ordering, for general square matrices
+        LDLT ///> Simplicial LDLT with AMD ordering, for symmetric positive definite matrices, only the lower triangle is read
+    };
+
 public:
     ///
     /// \brief Default constructor/destructor
     ///
-    DirectLinearSolver() = default;
+    DirectLinearSolver() { m_type = Type::LUFactorization; }
     virtual ~DirectLinearSolver() override = default;
 
     ///
     /// \brief Constructor
     ///
-    DirectLinearSolver(const SparseMatrixd& matrix, const Vectord& b);
+    DirectLinearSolver(const SparseMatrixd& matrix, const Vectord& b, const Factorization factorization = Factorization::LU);
 
     ///
     /// \brief Sets the system. System of linear equations.
@@ -125,7 +138,43 @@ public:
     ///
     void solve(const Vectord& rhs, Vectord& x);
 
+    ///
+    /// \brief Set the decomposition, the next system set is analyzed anew
+    ///
+    void setFactorization(const Factorization factorization);
+
+    ///
+    /// \brief Get the decomposition
+    ///
+    Factorization getFactorization() const { return m_factorization; }
+
+    ///
+    /// \brief Returns true if the solver is iterative
+    ///
+    bool isIterative() const override
+    {
+        return false;
+    };
+
 private:
-    Eigen::SparseLU<SparseMatrixd, Eigen::COLAMDOrdering<MatrixType::StorageIndex>> m_solver;  //?
+    ///
+    /// \brief Factorize the matrix, the symbolic analysis of the last matrix is reused if the pattern is the same
+    ///
+    void factorize(const SparseMatrixd& matrix);
+
+    ///
+    /// \brief Returns true if the matrix has the sparsity pattern of the last symbolic analysis
+    ///
+    bool hasAnalyzedPattern(const SparseMatrixd& matrix) const;
+
+    Factorization m_factorization = Factorization::LU;
+    Eigen::SparseLU<SparseMatrixd, Eigen::COLAMDOrdering<MatrixType::StorageIndex>>                  m_luSolver;
+    Eigen::SimplicialLDLT<SparseMatrixd, Eigen::Lower, Eigen::AMDOrdering<MatrixType::StorageIndex>> m_ldltSolver;
+
+    bool         m_patternAnalyzed = false;                      ///> True once a pattern was analyzed
+    Eigen::Index m_patternRows     = 0;                          ///> Size of the analyzed matrix
+    std::vector<MatrixType::StorageIndex> m_patternOuterIndices; ///> Row starts of the analyzed matrix
+    std::vector<MatrixType::StorageIndex> m_patternInnerIndices; ///> Column indices of the analyzed matrix
+    SparseMatrixd m_compressedMatrix;                            ///> Compressed copy of a matrix given in uncompressed mode
 };
 } // imstk
@@ -96,6 +96,39 @@ GaussSeidel::gaussSeidelSolve(Vectord& x)
     }
 }
 
+void
+GaussSeidel::relax(Vectord& x, const size_t numSweeps, const bool backward) const
+{
+    const auto& b = m_linearSystem->getRHSVector();
+    const auto& A = m_linearSystem->getMatrix();
+
+    const Eigen::Index n = A.outerSize();
+    for (size_t sweep = 0; sweep < numSweeps; ++sweep)
+    {
+        for (Eigen::Index i = 0; i < n; ++i)
+        {
+            const Eigen::Index k         = backward ? n - 1 - i : i;
+            double             diagEle   = 0.;
+            double             aggregate = 0.;
+            for (SparseMatrixd::InnerIterator it(A, k); it; ++it)
+            {
+                if (it.col() != k)
+                {
+                    aggregate += it.value() * x[it.col()];
+                }
+                else
+                {
+                    diagEle = it.value();
+                }
+            }
+            if (diagEle != 0.0)
+            {
+                x[k] = (b[k] - aggregate) / diagEle;
+            }
+        }
+    }
+}
+
 double
 GaussSeidel::getResidual(const Vectord&)
 {
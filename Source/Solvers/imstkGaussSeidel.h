@@ -56,6 +56,12 @@ public:
     ///
     void gaussSeidelSolve(Vectord& x);
 
+    ///
+    /// \brief Apply \p numSweeps Gauss-Seidel sweeps to \p x, starting from its current value.
+    ///     Used as smoother, backward sweeps after forward ones keep a multigrid cycle symmetric
+    ///
+    void relax(Vectord& x, const size_t numSweeps, const bool backward = false) const;
+
     ///
     /// \brief Solve the system of equations
     ///
@@ -97,6 +97,35 @@ Jacobi::JacobiSolve(Vectord& x)
     }
 }
 
+void
+Jacobi::relax(Vectord& x, const size_t numSweeps, const double weight)
+{
+    const auto& b = m_linearSystem->getRHSVector();
+    const auto& A = m_linearSystem->getMatrix();
+
+    for (size_t sweep = 0; sweep < numSweeps; ++sweep)
+    {
+        m_xOld = x;
+        for (auto k = 0; k < A.outerSize(); ++k)
+        {
+            double diagEle  = 0.;
+            double residual = b[k];
+            for (SparseMatrixd::InnerIterator it(A, k); it; ++it)
+            {
+                if (it.col() == k)
+                {
+                    diagEle = it.value();
+                }
+                residual -= it.value() * m_xOld[it.col()];
+            }
+            if (diagEle != 0.0)
+            {
+                x[k] += weight * residual / diagEle;
+            }
+        }
+    }
+}
+
 double
 Jacobi::getResidual(const Vectord&)
 {
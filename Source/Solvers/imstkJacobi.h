@@ -56,6 +56,12 @@ public:
     ///
     void JacobiSolve(Vectord& x);
 
+    ///
+    /// \brief Apply \p numSweeps weighted Jacobi sweeps to \p x, starting from its current value.
+    ///     Used as smoother, the weight is usually 2/3 for that purpose
+    ///
+    void relax(Vectord& x, const size_t numSweeps, const double weight = 1.0);
+
     ///
     /// \brief Solve the system of equations.
     ///
@@ -126,6 +132,8 @@ public:
 
 private:
 
+    Vectord m_xOld; ///> Previous iterate of the sweeps
+
     std::vector<LinearProjectionConstraint>* m_FixedLinearProjConstraints   = nullptr;
     std::vector<LinearProjectionConstraint>* m_DynamicLinearProjConstraints = nullptr;
 };
@@ -44,6 +44,7 @@ public:
         SuccessiveOverRelaxation,
         Jacobi,
         GMRES,
+        Multigrid,
         None
     };
 
@@ -96,12 +96,44 @@ public:
         m_A = newMatrix;
     }
 
+    ///
+    /// \brief Apply the matrix through \p product instead of the stored matrix,
+    /// \p diagonal is the diagonal of the operator if available
+    ///
+    void setMatrixFreeProduct(const typename NonLinearSystem<SystemMatrixType>::ProductFunctionType& product,
+                              const Vectord* diagonal = nullptr)
+    {
+        this->m_dFProduct  = product;
+        this->m_dFDiagonal = diagonal;
+    }
+
+    ///
+    /// \brief Returns the diagonal of the matrix-free operator, null if not available
+    ///
+    const Vectord* getMatrixFreeDiagonal() const { return this->m_dFDiagonal; }
+
+    ///
+    /// \brief Compute \f$ y = Ax \f$, through the matrix-free product if set
+    ///
+    void multiply(const Vectord& x, Vectord& y) const
+    {
+        if (this->m_dFProduct)
+        {
+            this->m_dFProduct(x, y);
+        }
+        else
+        {
+            y = m_A * x;
+        }
+    }
+
     ///
     /// \brief Compute the residual as \f$\left \| b-Ax \right \|_2\f$.
     ///
     void computeResidual(const Vectord& x, Vectord& r) const
     {
-        r = m_b - m_A * x;
+        multiply(x, r);
+        r = m_b - r;
     }
 
     ///
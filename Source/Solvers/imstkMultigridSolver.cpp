@@ -0,0 +1,412 @@
+/*=========================================================================
+
+   Library: iMSTK
+
+   Copyright (c) Kitware, Inc. & Center for Modeling, Simulation,
+   & Imaging in Medicine, Rensselaer Polytechnic Institute.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+=========================================================================*/
+
+#include "imstkMultigridSolver.h"
+#include "imstkDirectLinearSolver.h"
+#include "imstkGaussSeidel.h"
+#include "imstkJacobi.h"
+#include "imstkLogger.h"
+
+#include <algorithm>
+
+namespace imstk
+{
+namespace
+{
+///
+/// \brief Number of unknowns aggregated together in \p A, blocks that do not divide the size are not used
+///
+int
+getEffectiveBlockSize(const SparseMatrixd& A, const int blockSize)
+{
+    return (blockSize > 1 && A.rows() % blockSize == 0) ? blockSize : 1;
+}
+
+///
+/// \brief Estimate the spectral radius of D^-1 A with power iterations
+///
+double
+estimateSpectralRadius(const SparseMatrixd& A, const Vectord& invDiagonal)
+{
+    Vectord v = Vectord::LinSpaced(A.rows(), 1.0, 2.0).normalized();
+    Vectord w;
+    double  rho = 0.0;
+    for (int i = 0; i < 15; ++i)
+    {
+        w   = invDiagonal.cwiseProduct(A * v);
+        rho = w.norm();
+        if (rho == 0.0)
+        {
+            break;
+        }
+        v = w / rho;
+    }
+    return rho;
+}
+}
+
+MultigridSolver::MultigridSolver()
+{
+    m_type = Type::Multigrid;
+}
+
+MultigridSolver::MultigridSolver(const SparseMatrixd& A, const Vectord& rhs) : MultigridSolver()
+{
+    this->setSystem(std::make_shared<LinearSystem<SparseMatrixd>>(A, rhs));
+}
+
+MultigridSolver::~MultigridSolver() = default;
+
+void
+MultigridSolver::aggregate(const SparseMatrixd& A, std::vector<int>& aggregates, int& numAggregates) const
+{
+    const int bs = getEffectiveBlockSize(A, m_blockSize);
+    const int numBlocks = static_cast<int>(A.rows()) / bs;
+
+    // Squared Frobenius norms of the diagonal blocks
+    std::vector<double> diagonalNorms(numBlocks, 0.0);
+    for (int row = 0; row < A.rows(); ++row)
+    {
+        for (SparseMatrixd::InnerIterator it(A, row); it; ++it)
+        {
+            if (it.col() / bs == row / bs)
+            {
+                diagonalNorms[row / bs] += it.value() * it.value();
+            }
+        }
+    }
+
+    // Blocks I and J are strongly connected if |A_IJ| >= threshold * sqrt(|A_II| |A_JJ|)
+    std::vector<int>    strongOffsets(numBlocks + 1, 0);
+    std::vector<int>    strongNeighbors;
+    std::vector<double> couplings(numBlocks, 0.0);
+    std::vector<int>    touched;
+    const double        thresholdSqr = m_strengthThreshold * m_strengthThreshold;
+    for (int I = 0; I < numBlocks; ++I)
+    {
+        for (int row = I * bs; row < (I + 1) * bs; ++row)
+        {
+            for (SparseMatrixd::InnerIterator it(A, row); it; ++it)
+            {
+                const int J = static_cast<int>(it.col()) / bs;
+                if (J != I && it.value() != 0.0)
+                {
+                    if (couplings[J] == 0.0)
+                    {
+                        touched.push_back(J);
+                    }
+                    couplings[J] += it.value() * it.value();
+                }
+            }
+        }
+        for (const auto& J : touched)
+        {
+            if (couplings[J] >= thresholdSqr * std::sqrt(diagonalNorms[I] * diagonalNorms[J]))
+            {
+                strongNeighbors.push_back(J);
+            }
+            couplings[J] = 0.0;
+        }
+        touched.clear();
+        strongOffsets[I + 1] = static_cast<int>(strongNeighbors.size());
+    }
+
+    // Blocks without strong connections are left to the smoother
+    aggregates.assign(numBlocks, -1);
+    numAggregates = 0;
+
+    // Phase 1, blocks whose strong neighborhood is free become the roots of new aggregates
+    for (int I = 0; I < numBlocks; ++I)
+    {
+        if (aggregates[I] != -1 || strongOffsets[I] == strongOffsets[I + 1])
+        {
+            continue;
+        }
+        bool isFree = true;
+        for (int k = strongOffsets[I]; k < strongOffsets[I + 1] && isFree; ++k)
+        {
+            isFree = aggregates[strongNeighbors[k]] == -1;
+        }
+        if (isFree)
+        {
+            aggregates[I] = numAggregates;
+            for (int k = strongOffsets[I]; k < strongOffsets[I + 1]; ++k)
+            {
+                aggregates[strongNeighbors[k]] = numAggregates;
+            }
+            ++numAggregates;
+        }
+    }
+
+    // Phase 2, remaining blocks join an aggregate of phase 1 they are strongly connected to
+    const std::vector<int> roots = aggregates;
+    for (int I = 0; I < numBlocks; ++I)
+    {
+        for (int k = strongOffsets[I]; k < strongOffsets[I + 1] && aggregates[I] == -1; ++k)
+        {
+            aggregates[I] = roots[strongNeighbors[k]];
+        }
+    }
+
+    // Phase 3, what is left forms aggregates with its free strong neighbors
+    for (int I = 0; I < numBlocks; ++I)
+    {
+        if (aggregates[I] != -1 || strongOffsets[I] == strongOffsets[I + 1])
+        {
+            continue;
+        }
+        aggregates[I] = numAggregates;
+        for (int k = strongOffsets[I]; k < strongOffsets[I + 1]; ++k)
+        {
+            if (aggregates[strongNeighbors[k]] == -1)
+            {
+                aggregates[strongNeighbors[k]] = numAggregates;
+            }
+        }
+        ++numAggregates;
+    }
+}
+
+void
+MultigridSolver::buildProlongation(Level& level) const
+{
+    const SparseMatrixd& A  = *level.A;
+    const int            bs = getEffectiveBlockSize(A, m_blockSize);
+
+    // Tentative prolongation, piecewise constant over the aggregates for every component of the blocks
+    SparseMatrixd tentative(A.rows(), level.numAggregates * bs);
+    tentative.reserve(Eigen::VectorXi::Ones(A.rows()));
+    for (int row = 0; row < A.rows(); ++row)
+    {
+        const int aggregate = level.aggregates[row / bs];
+        if (aggregate != -1)
+        {
+            tentative.insert(row, aggregate * bs + row % bs) = 1.0;
+        }
+    }
+    tentative.makeCompressed();
+
+    // Smoothing, P = (I - omega D^-1 A) tentative with omega = 4 / (3 rho(D^-1 A))
+    Vectord invDiagonal = A.diagonal();
+    for (Eigen::Index i = 0; i < invDiagonal.size(); ++i)
+    {
+        invDiagonal[i] = invDiagonal[i] != 0.0 ? 1.0 / invDiagonal[i] : 0.0;
+    }
+    const double rho   = estimateSpectralRadius(A, invDiagonal);
+    const double omega = rho > 0.0 ? 4.0 / (3.0 * rho) : 0.0;
+
+    SparseMatrixd smoothing = A * tentative;
+    for (int row = 0; row < smoothing.outerSize(); ++row)
+    {
+        for (SparseMatrixd::InnerIterator it(smoothing, row); it; ++it)
+        {
+            it.valueRef() *= omega * invDiagonal[row];
+        }
+    }
+    level.P = tentative - smoothing;
+    level.R = level.P.transpose();
+}
+
+void
+MultigridSolver::setSystem(std::shared_ptr<LinearSystem<SparseMatrixd>> newSystem)
+{
+    LinearSolver<SparseMatrixd>::setSystem(newSystem);
+    CHECK(!m_linearSystem->isMatrixFree()) << "MultigridSolver needs an assembled matrix";
+
+    const SparseMatrixd& A = m_linearSystem->getMatrix();
+
+    // The aggregates only depend on the sparsity pattern in practice, they are kept while it is the same.
+    // Uncompressed matrices have gaps in their inner indices and always rebuild
+    const int* outerBegin = A.outerIndexPtr();
+    const int* outerEnd   = outerBegin + A.outerSize() + 1;
+    const int* innerBegin = A.innerIndexPtr();
+    const int* innerEnd   = innerBegin + A.nonZeros();
+    const bool reuseAggregates = !m_levels.empty() && A.isCompressed()
+                                 && std::equal(outerBegin, outerEnd, m_patternOuterIndices.begin(), m_patternOuterIndices.end())
+                                 && std::equal(innerBegin, innerEnd, m_patternInnerIndices.begin(), m_patternInnerIndices.end());
+    if (!reuseAggregates)
+    {
+        // Levels point to each other's operators, they must not be reallocated
+        m_levels.clear();
+        m_levels.reserve(std::max<size_t>(m_maxNumLevels, 1));
+        m_levels.emplace_back();
+        if (A.isCompressed())
+        {
+            m_patternOuterIndices.assign(outerBegin, outerEnd);
+            m_patternInnerIndices.assign(innerBegin, innerEnd);
+        }
+        else
+        {
+            m_patternOuterIndices.clear();
+            m_patternInnerIndices.clear();
+        }
+    }
+
+    m_levels[0].A = &A;
+    for (size_t l = 0; l + 1 < m_maxNumLevels; ++l)
+    {
+        if (!reuseAggregates)
+        {
+            Level& level = m_levels[l];
+            if (static_cast<size_t>(level.A->rows()) <= m_coarsestSize)
+            {
+                break;
+            }
+            aggregate(*level.A, level.aggregates, level.numAggregates);
+
+            // Stop when the coarsening stagnates
+            const int bs = getEffectiveBlockSize(*level.A, m_blockSize);
+            if (level.numAggregates == 0 || 5 * level.numAggregates * bs > 4 * level.A->rows())
+            {
+                level.aggregates.clear();
+                level.numAggregates = 0;
+                break;
+            }
+            m_levels.emplace_back();
+        }
+        else if (l + 1 == m_levels.size())
+        {
+            break;
+        }
+
+        Level& level = m_levels[l];
+        buildProlongation(level);
+        Level& next = m_levels[l + 1];
+        next.coarseA = level.R * (*level.A * level.P);
+        next.A       = &next.coarseA;
+    }
+
+    // The operators do not move anymore, setup the smoothers and the coarsest factorization
+    for (auto& level : m_levels)
+    {
+        level.b.setZero(level.A->rows());
+        level.x.setZero(level.A->rows());
+        level.r.setZero(level.A->rows());
+        level.system = std::make_shared<LinearSystem<SparseMatrixd>>(*level.A, level.b);
+        level.jacobi.reset();
+        level.gaussSeidel.reset();
+        if (m_smoother == Smoother::Jacobi)
+        {
+            level.jacobi = std::make_shared<Jacobi>();
+            level.jacobi->setSystem(level.system);
+        }
+        else
+        {
+            level.gaussSeidel = std::make_shared<GaussSeidel>();
+            level.gaussSeidel->setSystem(level.system);
+        }
+    }
+    if (m_coarseSolver == nullptr)
+    {
+        m_coarseSolver = std::make_shared<DirectLinearSolver<SparseMatrixd>>();
+        m_coarseSolver->setFactorization(DirectLinearSolver<SparseMatrixd>::Factorization::LDLT);
+    }
+    m_coarseSolver->setSystem(m_levels.back().system);
+}
+
+void
+MultigridSolver::smooth(Level& level, const bool postSmoothing)
+{
+    if (level.jacobi)
+    {
+        level.jacobi->relax(level.x, m_numSmoothingSteps, 2.0 / 3.0);
+    }
+    else
+    {
+        level.gaussSeidel->relax(level.x, m_numSmoothingSteps, postSmoothing);
+    }
+}
+
+void
+MultigridSolver::cycle(const size_t l)
+{
+    Level& level = m_levels[l];
+    if (l + 1 == m_levels.size())
+    {
+        m_coarseSolver->solve(level.x);
+        return;
+    }
+
+    smooth(level, false);
+
+    level.r.noalias() = *level.A * level.x;
+    level.r = level.b - level.r;
+
+    Level& next = m_levels[l + 1];
+    next.b.noalias() = level.R * level.r;
+    next.x.setZero();
+    cycle(l + 1);
+    level.x.noalias() += level.P * next.x;
+
+    smooth(level, true);
+}
+
+void
+MultigridSolver::vCycle(const Vectord& b, Vectord& x)
+{
+    m_levels[0].b = b;
+    m_levels[0].x.setZero();
+    cycle(0);
+    x = m_levels[0].x;
+}
+
+void
+MultigridSolver::solve(Vectord& x)
+{
+    if (!m_linearSystem)
+    {
+        LOG(WARNING) << "Linear system is not supplied for multigrid solver!";
+        return;
+    }
+
+    Level&       finest = m_levels[0];
+    const auto&  b      = m_linearSystem->getRHSVector();
+    const double bNorm  = b.norm();
+    finest.b = b;
+    finest.x.setZero();
+
+    m_numIterations = 0;
+    while (m_numIterations < m_maxIterations && getResidual(finest.x) > m_tolerance * bNorm)
+    {
+        cycle(0);
+        ++m_numIterations;
+    }
+    x = finest.x;
+}
+
+double
+MultigridSolver::getResidual(const Vectord& x)
+{
+    m_residual = m_linearSystem->getRHSVector() - m_linearSystem->getMatrix() * x;
+    return m_residual.norm();
+}
+
+void
+MultigridSolver::print() const
+{
+    IterativeLinearSolver::print();
+
+    LOG(INFO) << "Solver: Multigrid";
+    LOG(INFO) << "Levels: " << m_levels.size();
+    LOG(INFO) << "Tolerance: " << m_tolerance;
+    LOG(INFO) << "max. iterations: " << m_maxIterations;
+}
+} // imstk
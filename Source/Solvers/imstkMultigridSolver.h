@@ -0,0 +1,199 @@
+/*=========================================================================
+
+   Library: iMSTK
+
+   Copyright (c) Kitware, Inc. & Center for Modeling, Simulation,
+   & Imaging in Medicine, Rensselaer Polytechnic Institute.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0.txt
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+=========================================================================*/
+
+#pragma once
+
+#include "imstkIterativeLinearSolver.h"
+
+namespace imstk
+{
+class GaussSeidel;
+class Jacobi;
+template<typename MatrixType> class DirectLinearSolver;
+
+///
+/// \brief Algebraic multigrid solver with smoothed aggregation (Vanek et al. 1996) for sparse
+///     symmetric positive definite systems. Unknowns are aggregated by blocks, eg: the three
+///     displacements of a FEM node, over the graph of strong connections. The tentative prolongation
+///     of every level is smoothed with one damped Jacobi step, coarse operators are the Galerkin
+///     products and the coarsest level is factorized. A V-cycle costs O(N), the number of cycles
+///     to reach a given tolerance is nearly independent of the size of the system.
+///
+///     The Jacobi or Gauss-Seidel solvers relax every level, with backward sweeps after the coarse
+///     correction for the latter, so the V-cycle is symmetric and can precondition the conjugate gradient.
+///     The aggregates are kept while the sparsity pattern of the system is the same, new values only
+///     recompute the Galerkin products.
+///
+class MultigridSolver : public IterativeLinearSolver
+{
+public:
+    ///
+    /// \brief Relaxation applied on every level
+    ///
+    enum class Smoother
+    {
+        Jacobi,     ///> Jacobi damped by 2/3
+        GaussSeidel ///> Forward sweeps before and backward sweeps after the coarse correction
+    };
+
+public:
+    ///
+    /// \brief Constructors/Destructor
+    ///
+    MultigridSolver();
+    MultigridSolver(const SparseMatrixd& A, const Vectord& rhs);
+    virtual ~MultigridSolver() override;
+
+    ///
+    /// \brief Remove specific constructor signatures
+    ///
+    MultigridSolver(const MultigridSolver&) = delete;
+    MultigridSolver& operator=(const MultigridSolver&) = delete;
+
+    ///
+    /// \brief Sets the system and builds the hierarchy of levels
+    ///
+    void setSystem(std::shared_ptr<LinearSystemType> newSystem) override;
+
+    ///
+    /// \brief Solve the system with V-cycles from a zero initial guess, until the residual is
+    ///     smaller than the tolerance relative to the right hand side
+    ///
+    void solve(Vectord& x) override;
+
+    ///
+    /// \brief Apply one V-cycle to \p b from a zero initial guess, used as preconditioner
+    ///
+    void vCycle(const Vectord& b, Vectord& x);
+
+    ///
+    /// \brief Return the 2-norm of the residual of \p x
+    ///
+    double getResidual(const Vectord& x) override;
+
+    ///
+    /// \brief Set/Get the smoother, takes effect on the next system set
+    ///
+    void setSmoother(const Smoother smoother) { m_smoother = smoother; }
+    Smoother getSmoother() const { return m_smoother; }
+
+    ///
+    /// \brief Set/Get the number of sweeps before and after the coarse correction
+    ///
+    void setNumSmoothingSteps(const size_t numSteps) { m_numSmoothingSteps = numSteps; }
+    size_t getNumSmoothingSteps() const { return m_numSmoothingSteps; }
+
+    ///
+    /// \brief Set/Get the number of unknowns aggregated together, 3 for the nodes of FEM systems
+    ///
+    void setBlockSize(const int blockSize) { m_blockSize = blockSize; }
+    int getBlockSize() const { return m_blockSize; }
+
+    ///
+    /// \brief Set/Get the threshold above which the coupling of two blocks is strong,
+    ///     relative to the geometric mean of their diagonal blocks
+    ///
+    void setStrengthThreshold(const double threshold) { m_strengthThreshold = threshold; }
+    double getStrengthThreshold() const { return m_strengthThreshold; }
+
+    ///
+    /// \brief Set/Get the number of unknowns below which a level is solved directly
+    ///
+    void setCoarsestSize(const size_t size) { m_coarsestSize = size; }
+    size_t getCoarsestSize() const { return m_coarsestSize; }
+
+    ///
+    /// \brief Set/Get the maximum number of levels
+    ///
+    void setMaxNumLevels(const size_t numLevels) { m_maxNumLevels = numLevels; }
+    size_t getMaxNumLevels() const { return m_maxNumLevels; }
+
+    ///
+    /// \brief Get the number of levels of the current hierarchy
+    ///
+    size_t getNumLevels() const { return m_levels.size(); }
+
+    ///
+    /// \brief Returns the number of V-cycles of the last solve
+    ///
+    size_t getNumIterations() const { return m_numIterations; }
+
+    ///
+    /// \brief Print solver information
+    ///
+    void print() const override;
+
+private:
+    ///
+    /// \brief One level of the hierarchy, the prolongation maps the next coarser level to this one
+    ///
+    struct Level
+    {
+        const SparseMatrixd* A = nullptr;              ///> Operator, the one of the system on the finest level
+        SparseMatrixd coarseA;                         ///> Galerkin product owned by the coarse levels
+        SparseMatrixd P;                               ///> Smoothed prolongation from the next level
+        SparseMatrixd R;                               ///> Restriction to the next level, transpose of P
+        std::vector<int> aggregates;                   ///> Aggregate of every block, -1 if not coarsened
+        int numAggregates = 0;                         ///> Number of blocks of the next level
+
+        Vectord b;                                     ///> Right hand side of the cycle
+        Vectord x;                                     ///> Correction of the cycle
+        Vectord r;                                     ///> Residual of the cycle
+        std::shared_ptr<LinearSystem<SparseMatrixd>> system;
+        std::shared_ptr<Jacobi>      jacobi;
+        std::shared_ptr<GaussSeidel> gaussSeidel;
+    };
+
+    ///
+    /// \brief Aggregate the blocks of \p A strongly connected to each other
+    ///
+    void aggregate(const SparseMatrixd& A, std::vector<int>& aggregates, int& numAggregates) const;
+
+    ///
+    /// \brief Build the smoothed prolongation of \p level from its aggregates
+    ///
+    void buildProlongation(Level& level) const;
+
+    ///
+    /// \brief Relax the correction of \p level, backward for the Gauss-Seidel post-smoothing
+    ///
+    void smooth(Level& level, const bool postSmoothing);
+
+    ///
+    /// \brief Recursive V-cycle on \p level, the right hand side is in level.b and the correction in level.x
+    ///
+    void cycle(const size_t level);
+
+    Smoother m_smoother          = Smoother::GaussSeidel;
+    size_t   m_numSmoothingSteps = 1;
+    int      m_blockSize         = 1;
+    double   m_strengthThreshold = 0.08;
+    size_t   m_coarsestSize      = 500;
+    size_t   m_maxNumLevels      = 10;
+
+    std::vector<Level> m_levels;                                     ///> Levels from the finest to the coarsest
+    std::shared_ptr<DirectLinearSolver<SparseMatrixd>> m_coarseSolver; ///> Factorization of the coarsest level
+    std::vector<int> m_patternOuterIndices;                          ///> Outer indices of the finest matrix of the hierarchy
+    std::vector<int> m_patternInnerIndices;                          ///> Inner indices of the finest matrix of the hierarchy
+
+    size_t m_numIterations = 0;                                      ///> V-cycles of the last solve
+};
+} // imstk
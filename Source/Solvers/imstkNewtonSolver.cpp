@@ -30,7 +30,6 @@ namespace imstk
 {
 template<>
 NewtonSolver<SparseMatrixd>::NewtonSolver() :
-    m_linearSolver(std::make_shared<ConjugateGradient>()),
     m_forcingTerm(0.9),
     m_absoluteTolerance(1e-3),
     m_relativeTolerance(1e-6),
@@ -39,6 +38,10 @@ NewtonSolver<SparseMatrixd>::NewtonSolver() :
     m_maxIterations(1),
     m_useArmijo(true)
 {
+    // Successive Newton corrections are close, each linear solve starts from the previous one
+    auto linearSolver = std::make_shared<ConjugateGradient>();
+    linearSolver->setWarmStart(true);
+    m_linearSolver = linearSolver;
 }
 
 template<>
@@ -116,10 +119,33 @@ NewtonSolver<SystemMatrix>::solve()
     Vectord     du     = u; // make this a class member in future
     double      error0 = MAX_D;
 
+    double previousError   = MAX_D;
+    double lineSearchError = -1.0; // Residual norm at the iterate accepted by the line search
+
+    // Shortening a step applies a negative increment to the iterate
+    const bool lineSearch = m_useLineSearch && !this->m_isSemiImplicit;
+    CHECK(!lineSearch || this->m_nonLinearSystem->isAdditiveUpdate())
+        << "NewtonMethod::solve - The line search requires an update function that adds the step to the iterate";
+
     double epsilon = m_relativeTolerance * m_relativeTolerance;
     for (iterNum = 0; iterNum < m_maxIterations; ++iterNum)
     {
-        double error = updateJacobian(u);
+        // Keep the lagged Jacobian while it reduces the residual fast enough
+        bool   updateNeeded = !m_reuseJacobian || !m_hasJacobian || m_jacobianAge >= m_maxJacobianAge;
+        double error = 0.0;
+        if (!updateNeeded)
+        {
+            error = (lineSearchError >= 0.0) ? lineSearchError :
+                    this->m_nonLinearSystem->m_F(u, this->m_isSemiImplicit).norm();
+            updateNeeded = iterNum > 0 && error > m_jacobianRefreshRatio * previousError;
+        }
+        if (updateNeeded)
+        {
+            error = updateJacobian(u);
+        }
+        ++m_jacobianAge;
+        previousError   = error;
+        lineSearchError = -1.0;
 
         if (iterNum == 0)
         {
@@ -135,6 +161,11 @@ NewtonSolver<SystemMatrix>::solve()
 
         m_linearSolver->solve(du);
         this->m_nonLinearSystem->m_FUpdate(du, this->m_isSemiImplicit);
+
+        if (lineSearch)
+        {
+            lineSearchError = this->backtrack(du, error);
+        }
     }
 
     this->m_nonLinearSystem->m_FUpdatePrevState();
@@ -168,19 +199,47 @@ NewtonSolver<SystemMatrix>::updateJacobian(const Vectord& x)
     const auto& vecAndMat = this->m_nonLinearSystem->m_F_dF(x, this->m_isSemiImplicit);
     auto&       b = *vecAndMat.first;
     auto&       A = *vecAndMat.second;
-    if (A.innerSize() == 0)
+    const bool  matrixFree = this->m_nonLinearSystem->isMatrixFree();
+    if (A.innerSize() == 0 && !matrixFree)
     {
         LOG(WARNING) << "NewtonMethod::updateJacobian - Size of matrix is 0!";
         return -1;
     }
 
     auto linearSystem = std::make_shared<typename LinearSolverType::LinearSystemType>(A, b);
+    if (matrixFree)
+    {
+        CHECK(m_linearSolver->getType() == LinearSolverType::Type::ConjugateGradient)
+            << "NewtonMethod::updateJacobian - Matrix-free systems require the conjugate gradient solver";
+        linearSystem->setMatrixFreeProduct(this->m_nonLinearSystem->m_dFProduct, this->m_nonLinearSystem->m_dFDiagonal);
+    }
     //linearSystem->setLinearProjectors(this->m_nonLinearSystem->getLinearProjectors()); /// \todo Left for near future reference. Clear in future.
     m_linearSolver->setSystem(linearSystem);
+    m_hasJacobian = true;
+    m_jacobianAge = 0;
+    ++m_numJacobianUpdates;
 
     return std::sqrt(b.dot(b));
 }
 
+template<typename SystemMatrix>
+double
+NewtonSolver<SystemMatrix>::backtrack(const Vectord& dx, const double fnorm)
+{
+    const auto& u       = this->m_nonLinearSystem->getUnknownVector();
+    double      lambda  = 1.0;
+    double      newNorm = this->m_nonLinearSystem->m_F(u, this->m_isSemiImplicit).norm();
+    for (size_t i = 0; i < this->m_armijoMax && newNorm >= (1.0 - this->m_alpha * lambda) * fnorm; ++i)
+    {
+        // The step is shortened in place, only the intermediate state is updated
+        const double newLambda = this->m_sigma[1] * lambda;
+        this->m_nonLinearSystem->m_FUpdate((newLambda - lambda) * dx, true);
+        lambda  = newLambda;
+        newNorm = this->m_nonLinearSystem->m_F(u, this->m_isSemiImplicit).norm();
+    }
+    return newNorm;
+}
+
 template<typename SystemMatrix>
 void
 NewtonSolver<SystemMatrix>::updateForcingTerm(const double ratio, const double stopTolerance, const double fnorm)
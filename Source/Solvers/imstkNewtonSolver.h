@@ -193,6 +193,59 @@ public:
     ///
     double getForcingTerm() const { return m_forcingTerm; }
 
+    ///
+    /// \brief Set whether the Jacobian is kept across iterations and time steps by solve(). Only the
+    ///     residual is evaluated while the Jacobian is lagged, and the linear solver keeps its system,
+    ///     so direct solvers also reuse their factorization. The Jacobian is updated when a lagged step
+    ///     reduces the residual by less than the refresh ratio, or after the maximum age.
+    ///     A matrix-free system whose residual evaluation relinearizes its product, as the FEM model
+    ///     does, always multiplies by the current Jacobian, only its diagonal and the linear system are lagged
+    ///
+    void setJacobianReuse(const bool value)
+    {
+        m_reuseJacobian = value;
+        m_hasJacobian   = false;
+    }
+
+    ///
+    /// \brief Get whether the Jacobian is kept across iterations and time steps
+    ///
+    bool getJacobianReuse() const { return m_reuseJacobian; }
+
+    ///
+    /// \brief Set/Get the residual ratio of consecutive iterations above which a lagged Jacobian is updated
+    ///
+    void setJacobianRefreshRatio(const double ratio) { m_jacobianRefreshRatio = ratio; }
+    double getJacobianRefreshRatio() const { return m_jacobianRefreshRatio; }
+
+    ///
+    /// \brief Set/Get the maximum number of iterations a Jacobian is used for, counted across time steps
+    ///
+    void setMaxJacobianAge(const size_t age) { m_maxJacobianAge = age; }
+    size_t getMaxJacobianAge() const { return m_maxJacobianAge; }
+
+    ///
+    /// \brief Force a Jacobian update at the next iteration, eg: when the time step changes
+    ///
+    void invalidateJacobian() { m_hasJacobian = false; }
+
+    ///
+    /// \brief Get the number of Jacobian updates since construction
+    ///
+    size_t getNumJacobianUpdates() const { return m_numJacobianUpdates; }
+
+    ///
+    /// \brief Set whether solve() backtracks along the Newton direction until the residual
+    ///     sufficiently decreases. Uses the alpha, sigma and armijoMax parameters of the line search.
+    ///     The update function of the system must be additive, see NonLinearSystem::setAdditiveUpdate
+    ///
+    void setUseLineSearch(const bool value) { m_useLineSearch = value; }
+
+    ///
+    /// \brief Get whether solve() backtracks along the Newton direction
+    ///
+    bool getUseLineSearch() const { return m_useLineSearch; }
+
     ///
     /// \brief Set the Newton solver to be fully implicit
     ///
@@ -210,6 +263,13 @@ public:
         m_maxIterations = 1;
     }
 
+private:
+    ///
+    /// \brief Backtrack along \p dx, already applied to the iterate, until the residual norm
+    ///     sufficiently decreases from \p fnorm. Returns the residual norm at the accepted iterate
+    ///
+    double backtrack(const Vectord& dx, const double fnorm);
+
 private:
     std::shared_ptr<LinearSolverType> m_linearSolver; ///> Linear solver to use
     double m_forcingTerm;                             ///> Method's forcing term
@@ -220,5 +280,13 @@ private:
     size_t m_maxIterations;                           ///> Maximum number of nonlinear iterations
     bool   m_useArmijo;                               ///> True if Armijo liner search is desired
     std::vector<double> m_fnorms;                     ///> Consecutive function norms
+
+    bool   m_reuseJacobian        = false;            ///> Lag the Jacobian across iterations and time steps
+    double m_jacobianRefreshRatio = 0.5;              ///> Residual ratio above which a lagged Jacobian is updated
+    size_t m_maxJacobianAge       = 10;               ///> Maximum number of iterations a Jacobian is used for
+    size_t m_jacobianAge          = 0;                ///> Number of iterations since the last Jacobian update
+    bool   m_hasJacobian          = false;            ///> True if the linear solver holds a Jacobian that can be reused
+    size_t m_numJacobianUpdates   = 0;                ///> Number of Jacobian updates
+    bool   m_useLineSearch        = false;            ///> Backtrack the Newton steps of solve()
 };
 } // imstk
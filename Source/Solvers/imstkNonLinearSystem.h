@@ -42,6 +42,7 @@ public:
     using VectorMatrixFunctionType    = std::function<VecMatPair(const Vectord&, const bool)>;
     using UpdateFunctionType          = std::function<void (const Vectord&, const bool)>;
     using UpdatePrevStateFunctionType = std::function<void ()>;
+    using ProductFunctionType         = std::function<void (const Vectord&, Vectord&)>;
 
 public:
     ///
@@ -103,6 +104,22 @@ public:
         return *m_LinearProjConstraints;
     }*/
 
+    ///
+    /// \brief Set the product of the gradient with a vector and the diagonal of the gradient.
+    /// When set the linear systems are solved matrix-free and the matrix returned along with
+    /// the function value is not used
+    ///
+    void setJacobianProduct(const ProductFunctionType& product, const Vectord* diagonal)
+    {
+        m_dFProduct  = product;
+        m_dFDiagonal = diagonal;
+    }
+
+    ///
+    /// \brief Whether the gradient is only available through its product with a vector
+    ///
+    bool isMatrixFree() const { return static_cast<bool>(m_dFProduct); }
+
     ///
     /// \brief Set the update function
     ///
@@ -119,6 +136,13 @@ public:
         m_FUpdatePrevState = updateFunc;
     }
 
+    ///
+    /// \brief Set/Get whether the update function adds its argument to the iterate, the line search
+    /// of the Newton solver relies on it to shorten a step. Updates that overwrite the iterate are not additive
+    ///
+    void setAdditiveUpdate(const bool additive) { m_additiveUpdate = additive; }
+    bool isAdditiveUpdate() const { return m_additiveUpdate; }
+
 /// \brief Get the vector denoting the filter
 ///
 /*void setDynamicLinearProjectors(std::vector<LinearProjectionConstraint>* f)
@@ -137,10 +161,13 @@ public:
     VectorFunctionType       m_F;  ///> Nonlinear function
     MatrixFunctionType       m_dF; ///> Gradient of the Nonlinear function with respect to the unknown vector
     VectorMatrixFunctionType m_F_dF;
+    ProductFunctionType      m_dFProduct;            ///> Product of the gradient with a vector (matrix-free)
+    const Vectord*           m_dFDiagonal = nullptr; ///> Diagonal of the gradient (matrix-free)
     Vectord* m_unknown = nullptr;
 
     UpdateFunctionType m_FUpdate;
     UpdatePrevStateFunctionType m_FUpdatePrevState;
+    bool m_additiveUpdate = true; ///> The update function adds its argument to the iterate
     /*std::vector<LinearProjectionConstraint>  *m_LinearProjConstraints;
     std::vector<LinearProjectionConstraint>  *m_DynamicLinearProjConstraints;*/
 };
@@ -64,37 +64,37 @@ public:
 
     Eigen::Matrix<Scalar, -1, 1>& solve(const Eigen::Matrix<Scalar, -1, 1>& b, const Eigen::Matrix<Scalar, -1, 2>& cu)
     {
-        const Eigen::SparseMatrix<Scalar>& A = *m_A;
+        // Iterate the rows through their nonzeros, a column major A is transposed once per solve
+        m_rowMajorA = *m_A;
+        const Eigen::SparseMatrix<Scalar, Eigen::RowMajor>& A = m_rowMajorA;
 
-        // Allocate new results
-        m_x = Eigen::Matrix<Scalar, -1, 1>(b.rows());
+        // Results and the previous iterate keep their storage between solves
+        m_x.resize(b.rows());
         m_x.setZero();
+        m_diagonal = A.diagonal();
 
         m_conv = 0.0;
 
-        // Naive implementation of PGS
         // Consider graph coloring and TBB parallizing
-        Eigen::Matrix<Scalar, -1, 1> xOld;
         for (unsigned int i = 0; i < m_maxIterations; i++)
         {
-            xOld = m_x;
+            m_xOld = m_x;
             for (Eigen::Index r = 0; r < A.rows(); r++)
             {
                 Scalar delta = 0.0;
 
                 // Sum up rows (skip r)
-                for (Eigen::Index c = 0; c < r; c++)
+                for (typename Eigen::SparseMatrix<Scalar, Eigen::RowMajor>::InnerIterator it(A, r); it; ++it)
                 {
-                    delta += A.coeff(r, c) * m_x[c];
-                }
-                for (Eigen::Index c = r + 1; c < A.cols(); c++)
-                {
-                    delta += A.coeff(r, c) * m_x[c];
+                    if (it.col() != r)
+                    {
+                        delta += it.value() * m_x[it.col()];
+                    }
                 }
 
                 // PGS can't converge for non-diagonal elements so its assumed
                 // we have these
-                delta = (b[r] - delta) / A.coeff(r, r);
+                delta = (b[r] - delta) / m_diagonal[r];
                 // Apply relaxation factor
                 m_x(r) += m_relaxation * (delta - m_x(r));
                 // Do projection *every iteration*
@@ -102,16 +102,13 @@ public:
             }
 
             // Check convergence
-            m_conv = (m_x - xOld).norm();
-            //printf(" %d: %f\n", i, m_conv);
+            m_conv = (m_x - m_xOld).norm();
             if (m_conv < m_epsilon)
             {
-                //printf("Eps: %f\n", conv);
                 return m_x;
             }
         }
 
-        //printf("Eps: %f\n", conv);
         return m_x;
     }
 
@@ -121,6 +118,9 @@ private:
     Scalar       m_epsilon       = 1.0e-4; ///> Convergence criteria
     Scalar       m_conv = 0.0;
     Eigen::Matrix<Scalar, -1, 1> m_x;      ///> Results
+    Eigen::Matrix<Scalar, -1, 1> m_xOld;   ///> Previous iterate
+    Eigen::Matrix<Scalar, -1, 1> m_diagonal;
     Eigen::SparseMatrix<Scalar>* m_A = nullptr;
+    Eigen::SparseMatrix<Scalar, Eigen::RowMajor> m_rowMajorA;
 };
 }
\ No newline at end of file